@@ -976,6 +976,13 @@ test_profiling() {
 	$UCX_READ_PROFILE -r ucx_jenkins.prof | grep "printf" -C 20
 	$UCX_READ_PROFILE -r ucx_jenkins.prof | grep -q "calc_pi"
 	$UCX_READ_PROFILE -r ucx_jenkins.prof | grep -q "print_pi"
+	$UCX_READ_PROFILE -c ucx_jenkins.prof | grep -q '"traceEvents"'
+	$UCX_READ_PROFILE -c ucx_jenkins.prof | grep -q '"name":"calc_pi"'
+
+	# Profile without any thread records
+	UCX_PROFILE_MODE=log UCX_PROFILE_FILE=ucx_jenkins_empty.prof \
+		${ucx_inst}/bin/ucx_info -v
+	$UCX_READ_PROFILE -c ucx_jenkins_empty.prof | grep -q '"process_name"'
 }
 
 test_ucs_load() {
@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <errno.h>
+#include <inttypes.h>
 
 
 #define INDENT             4
@@ -65,6 +66,8 @@ typedef enum {
 typedef struct options {
     const char                   *filename;
     int                          raw;
+    int                          timeline;
+    int                          chrome_trace;
     time_units_t                 time_units;
     int                          thread_list[MAX_THREADS + 1];
 } options_t;
@@ -96,6 +99,25 @@ typedef struct {
 } profile_sorted_location_t;
 
 
+/* Request state when exporting to Chrome trace format */
+typedef struct {
+    size_t                       id;           /* Async slice id */
+    uint32_t                     location;     /* Location which created the
+                                                  request, names the slice */
+    int                          thread_idx;   /* Thread of last request event */
+    uint64_t                     timestamp;    /* Time of last request event */
+} chrome_request_t;
+
+
+/* Chrome trace export state */
+typedef struct {
+    const profile_data_t         *data;
+    uint64_t                     start_time;
+    int                          first_event;
+    size_t                       flow_id;
+} chrome_trace_t;
+
+
 /* Used to redirect output to a "less" command */
 static int output_pipefds[2] = {-1, -1};
 
@@ -465,6 +487,7 @@ out:
 }
 
 KHASH_MAP_INIT_INT64(request_ids, size_t)
+KHASH_MAP_INIT_INT64(chrome_requests, chrome_request_t)
 
 static void show_profile_data_log(profile_data_t *data, options_t *opts,
                                   int thread_idx)
@@ -629,6 +652,343 @@ static void show_profile_data_log(profile_data_t *data, options_t *opts,
     free(scope_ends);
 }
 
+static const char *timeline_request_action(ucs_profile_type_t type)
+{
+    switch (type) {
+    case UCS_PROFILE_TYPE_REQUEST_NEW:
+        return "NEW ";
+    case UCS_PROFILE_TYPE_REQUEST_FREE:
+        return "FREE";
+    default:
+        return "";
+    }
+}
+
+/* Get the earliest timestamp of the selected threads */
+static uint64_t timeline_start_time(const profile_data_t *data,
+                                    const options_t *opts)
+{
+    uint64_t start_time = UINT64_MAX;
+    const profile_thread_data_t *thread;
+    const int *t;
+
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        if ((thread->header->num_records > 0) &&
+            (thread->records[0].timestamp < start_time)) {
+            start_time = thread->records[0].timestamp;
+        }
+    }
+
+    return (start_time == UINT64_MAX) ? 0 : start_time;
+}
+
+/* Get the next record of the selected threads, in timestamp order */
+static const ucs_profile_record_t *
+timeline_next_record(const profile_data_t *data, const options_t *opts,
+                     size_t *next_record, int *thread_idx_p)
+{
+    const ucs_profile_record_t *rec = NULL;
+    const profile_thread_data_t *thread;
+    const int *t;
+
+    /* Find the thread whose next record is the earliest */
+    for (t = opts->thread_list; *t != -1; ++t) {
+        thread = &data->threads[*t - 1];
+        if ((next_record[*t - 1] < thread->header->num_records) &&
+            ((rec == NULL) ||
+             (thread->records[next_record[*t - 1]].timestamp <
+              rec->timestamp))) {
+            *thread_idx_p = *t - 1;
+            rec           = &thread->records[next_record[*thread_idx_p]];
+        }
+    }
+
+    if (rec != NULL) {
+        ++next_record[*thread_idx_p];
+    }
+
+    return rec;
+}
+
+/* Show the records of all selected threads merged by timestamp */
+static void show_profile_data_timeline(profile_data_t *data, options_t *opts)
+{
+    size_t next_record[MAX_THREADS] = {0};
+    int nesting[MAX_THREADS]        = {0};
+    const ucs_profile_location_t *loc;
+    const ucs_profile_record_t *rec;
+    uint64_t start_time;
+    int thread_idx;
+    char buf[80];
+
+    printf("\n");
+    printf("%sTimeline of threads %s%s\n", HEAD_COLOR,
+           thread_list_str(opts->thread_list, buf, sizeof(buf)), CLEAR_COLOR);
+    printf("\n");
+
+    start_time = timeline_start_time(data, opts);
+    while ((rec = timeline_next_record(data, opts, next_record,
+                                       &thread_idx)) != NULL) {
+        loc = &data->locations[rec->location];
+        if ((loc->type == UCS_PROFILE_TYPE_SCOPE_END) &&
+            (nesting[thread_idx] > 0)) {
+            --nesting[thread_idx];
+        }
+
+        printf("%s%12.3f%s  %s[%d]%s %*s", TS_COLOR,
+               time_to_units(data, opts, rec->timestamp - start_time),
+               CLEAR_COLOR, HEAD_COLOR, thread_idx + 1, CLEAR_COLOR,
+               INDENT * nesting[thread_idx], "");
+        switch (loc->type) {
+        case UCS_PROFILE_TYPE_REQUEST_NEW:
+        case UCS_PROFILE_TYPE_REQUEST_EVENT:
+        case UCS_PROFILE_TYPE_REQUEST_FREE:
+            printf("%s%s%s 0x%" PRIx64 "%s", REQ_COLOR,
+                   timeline_request_action(loc->type), loc->name, rec->param64,
+                   CLEAR_COLOR);
+            break;
+        case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+            printf("{");
+            break;
+        case UCS_PROFILE_TYPE_SCOPE_END:
+            printf("} %s%s%s", NAME_COLOR, loc->name, CLEAR_COLOR);
+            break;
+        default:
+            printf("%s%s%s", NAME_COLOR, loc->name, CLEAR_COLOR);
+            break;
+        }
+        printf("  %s%s:%d %s()%s\n", LOC_COLOR, ucs_basename(loc->file),
+               loc->line, loc->function, CLEAR_COLOR);
+
+        if (loc->type == UCS_PROFILE_TYPE_SCOPE_BEGIN) {
+            ++nesting[thread_idx];
+        }
+    }
+}
+
+static void chrome_trace_print_string(const char *str)
+{
+    const char *p;
+
+    putchar('"');
+    for (p = str; *p != '\0'; ++p) {
+        if ((*p == '"') || (*p == '\\')) {
+            printf("\\%c", *p);
+        } else if ((unsigned char)*p < ' ') {
+            printf("\\u%04x", (unsigned char)*p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+/* Start a trace event with common fields, the caller adds specific fields and
+ * closes the event with '}'. If thread_idx is -1, the event belongs to the
+ * process rather than to one of its threads. */
+static void chrome_trace_event_begin(chrome_trace_t *trace, const char *name,
+                                     const char *category, const char *phase,
+                                     int thread_idx, uint64_t timestamp)
+{
+    const profile_data_t *data = trace->data;
+    uint32_t tid;
+
+    tid = (thread_idx < 0) ? data->header->pid :
+                             data->threads[thread_idx].header->tid;
+
+    printf("%s\n    {\"name\":", trace->first_event ? "" : ",");
+    chrome_trace_print_string(name);
+    /* Chrome trace timestamps are in microseconds */
+    printf(",\"cat\":\"%s\",\"ph\":\"%s\",\"pid\":%d,\"tid\":%u,"
+           "\"ts\":%.3f", category, phase, data->header->pid, tid,
+           (timestamp - trace->start_time) * 1e6 / data->header->one_second);
+    trace->first_event = 0;
+}
+
+static void chrome_trace_location_args(const ucs_profile_location_t *loc)
+{
+    char buf[256];
+
+    snprintf(buf, sizeof(buf), "%s:%d %s()", ucs_basename(loc->file),
+             loc->line, loc->function);
+    printf(",\"args\":{\"location\":");
+    chrome_trace_print_string(buf);
+}
+
+static void chrome_trace_request(chrome_trace_t *trace,
+                                 khash_t(chrome_requests) *requests,
+                                 size_t *reqid_ctr,
+                                 const ucs_profile_record_t *rec,
+                                 int thread_idx)
+{
+    const profile_data_t *data        = trace->data;
+    const ucs_profile_location_t *loc = &data->locations[rec->location];
+    chrome_request_t *req;
+    const char *phase;
+    khiter_t hash_it;
+    int hash_status;
+
+    if (loc->type == UCS_PROFILE_TYPE_REQUEST_NEW) {
+        /* A request which was not released is replaced by the new one */
+        hash_it = kh_put(chrome_requests, requests, rec->param64, &hash_status);
+        if (hash_status == UCS_KH_PUT_FAILED) {
+            return;
+        }
+
+        req             = &kh_value(requests, hash_it);
+        req->id         = (*reqid_ctr)++;
+        req->location   = rec->location;
+        req->thread_idx = thread_idx;
+        req->timestamp  = rec->timestamp;
+        phase           = "b";
+    } else {
+        hash_it = kh_get(chrome_requests, requests, rec->param64);
+        if (hash_it == kh_end(requests)) {
+            return; /* request was created before profiling started */
+        }
+
+        req   = &kh_value(requests, hash_it);
+        phase = (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE) ? "e" : "n";
+
+        /* Link the threads which touch the request with a flow arrow */
+        if (req->thread_idx != thread_idx) {
+            chrome_trace_event_begin(trace, "request", "request_flow", "s",
+                                     req->thread_idx, req->timestamp);
+            printf(",\"id\":%zu}", trace->flow_id);
+            chrome_trace_event_begin(trace, "request", "request_flow", "f",
+                                     thread_idx, rec->timestamp);
+            printf(",\"id\":%zu,\"bp\":\"e\"}", trace->flow_id);
+            ++trace->flow_id;
+        }
+
+        req->thread_idx = thread_idx;
+        req->timestamp  = rec->timestamp;
+    }
+
+    /* Async slices are matched by category and id, and named by the location
+     * which created the request */
+    chrome_trace_event_begin(trace,
+                             (loc->type == UCS_PROFILE_TYPE_REQUEST_EVENT) ?
+                             loc->name : data->locations[req->location].name,
+                             "request", phase, thread_idx, rec->timestamp);
+    printf(",\"id\":\"0x%zx\"", req->id);
+    chrome_trace_location_args(loc);
+    printf(",\"request\":\"0x%" PRIx64 "\",\"param32\":%u}}",
+           rec->param64, rec->param32);
+
+    if (loc->type == UCS_PROFILE_TYPE_REQUEST_FREE) {
+        kh_del(chrome_requests, requests, hash_it);
+    }
+}
+
+/*
+ * Export the records of the selected threads in Chrome Trace Event format,
+ * which can be loaded by chrome://tracing or https://ui.perfetto.dev.
+ * Scopes are shown as complete slices, and requests as async slices.
+ */
+static int show_profile_data_chrome_trace(profile_data_t *data,
+                                          options_t *opts)
+{
+    size_t next_record[MAX_THREADS] = {0};
+    int depth[MAX_THREADS]          = {0};
+    size_t reqid_ctr                = 1;
+    const ucs_profile_location_t *loc;
+    const ucs_profile_record_t *rec;
+    khash_t(chrome_requests) requests;
+    chrome_trace_t trace;
+    uint64_t *scope_begin;
+    int thread_idx;
+    char buf[32];
+    int *t;
+
+    scope_begin = calloc(MAX_THREADS * UCS_PROFILE_STACK_MAX,
+                         sizeof(*scope_begin));
+    if (scope_begin == NULL) {
+        print_error("failed to allocate scope stack");
+        return -ENOMEM;
+    }
+
+    trace.data        = data;
+    trace.start_time  = timeline_start_time(data, opts);
+    trace.first_event = 1;
+    trace.flow_id     = 1;
+    kh_init_inplace(chrome_requests, &requests);
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    /* Process and thread names. The thread list is empty if the profile has
+     * no threads, and then only the process name is emitted. */
+    chrome_trace_event_begin(&trace, "process_name", "__metadata", "M", -1,
+                             trace.start_time);
+    printf(",\"args\":{\"name\":");
+    chrome_trace_print_string(data->header->cmdline);
+    printf("}}");
+    for (t = opts->thread_list; *t != -1; ++t) {
+        chrome_trace_event_begin(&trace, "thread_name", "__metadata", "M",
+                                 *t - 1, trace.start_time);
+        snprintf(buf, sizeof(buf), "thread %d%s", *t,
+                 (data->threads[*t - 1].header->tid == data->header->pid) ?
+                 " (main)" : "");
+        printf(",\"args\":{\"name\":\"%s\"}}", buf);
+    }
+
+    while ((rec = timeline_next_record(data, opts, next_record,
+                                       &thread_idx)) != NULL) {
+        loc = &data->locations[rec->location];
+        switch (loc->type) {
+        case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+            if (depth[thread_idx] < UCS_PROFILE_STACK_MAX) {
+                scope_begin[(thread_idx * UCS_PROFILE_STACK_MAX) +
+                            depth[thread_idx]] = rec->timestamp;
+            }
+            ++depth[thread_idx];
+            break;
+        case UCS_PROFILE_TYPE_SCOPE_END:
+            /* Scope end record holds the name, so emit a complete event */
+            if (depth[thread_idx] == 0) {
+                break; /* scope started before profiling */
+            }
+
+            if (--depth[thread_idx] < UCS_PROFILE_STACK_MAX) {
+                uint64_t begin = scope_begin[(thread_idx *
+                                              UCS_PROFILE_STACK_MAX) +
+                                             depth[thread_idx]];
+                chrome_trace_event_begin(&trace, loc->name, "scope", "X",
+                                         thread_idx, begin);
+                printf(",\"dur\":%.3f",
+                       (rec->timestamp - begin) * 1e6 /
+                       data->header->one_second);
+                chrome_trace_location_args(loc);
+                printf("}}");
+            }
+            break;
+        case UCS_PROFILE_TYPE_SAMPLE:
+            chrome_trace_event_begin(&trace, loc->name, "sample", "i",
+                                     thread_idx, rec->timestamp);
+            printf(",\"s\":\"t\"");
+            chrome_trace_location_args(loc);
+            printf(",\"param64\":%" PRIu64 ",\"param32\":%u}}",
+                   rec->param64, rec->param32);
+            break;
+        case UCS_PROFILE_TYPE_REQUEST_NEW:
+        case UCS_PROFILE_TYPE_REQUEST_EVENT:
+        case UCS_PROFILE_TYPE_REQUEST_FREE:
+            chrome_trace_request(&trace, &requests, &reqid_ctr, rec,
+                                 thread_idx);
+            break;
+        default:
+            break;
+        }
+    }
+
+    printf("\n]}\n");
+
+    kh_destroy_inplace(chrome_requests, &requests);
+    free(scope_begin);
+    return 0;
+}
+
 static void close_pipes()
 {
     close(output_pipefds[0]);
@@ -660,7 +1020,8 @@ static int redirect_output(const profile_data_t *data, options_t *opts)
                      1; /* locations footer */
     }
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (data->header->mode & (UCS_BIT(UCS_PROFILE_MODE_LOG) |
+                              UCS_BIT(UCS_PROFILE_MODE_RING))) {
         for (t = opts->thread_list; *t != -1; ++t) {
             num_lines += 3; /* thread header */
             /* Suppressing a false positive for null value dereference */
@@ -798,6 +1159,10 @@ static int show_profile_data(profile_data_t *data, options_t *opts)
         }
     }
 
+    if (opts->chrome_trace) {
+        return show_profile_data_chrome_trace(data, opts);
+    }
+
     /* redirect output if needed */
     if (!opts->raw) {
         ret = redirect_output(data, opts);
@@ -813,7 +1178,13 @@ static int show_profile_data(profile_data_t *data, options_t *opts)
         printf("\n");
     }
 
-    if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    /* Ring mode records are sparse, so show them as a single timeline */
+    if ((data->header->mode & UCS_BIT(UCS_PROFILE_MODE_RING)) ||
+        (opts->timeline &&
+         (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)))) {
+        show_profile_data_timeline(data, opts);
+        printf("\n");
+    } else if (data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
         for (t = opts->thread_list; *t != -1; ++t) {
             show_profile_data_log(data, opts, *t - 1);
         }
@@ -828,6 +1199,12 @@ static void usage()
     printf("Usage: ucx_read_profile [options] [profile-file]\n");
     printf("Options are:\n");
     printf("  -r              Show raw output\n");
+    printf("  -m              Merge the records of all threads into a single "
+           "timeline\n");
+    printf("  -c              Export the records in Chrome Trace Event JSON "
+           "format,\n"
+           "                  which can be loaded by chrome://tracing or "
+           "Perfetto UI\n");
     printf("  -T <threads>    Comma-separated list of threads to show, "
            "e.g. \"1,2,3\", or \"all\" to show all threads\n");
     printf("  -t <units>      Select time units to use:\n");
@@ -842,18 +1219,26 @@ static int parse_args(int argc, char **argv, options_t *opts)
 {
     int ret, c;
 
-    opts->raw         = !isatty(fileno(stdout));
-    opts->time_units  = TIME_UNITS_USEC;
+    opts->raw          = !isatty(fileno(stdout));
+    opts->timeline     = 0;
+    opts->chrome_trace = 0;
+    opts->time_units   = TIME_UNITS_USEC;
     ret = parse_thread_list(opts->thread_list, "all");
     if (ret < 0) {
         return ret;
     }
 
-    while ( (c = getopt(argc, argv, "rT:t:h")) != -1 ) {
+    while ( (c = getopt(argc, argv, "rmcT:t:h")) != -1 ) {
         switch (c) {
         case 'r':
             opts->raw = 1;
             break;
+        case 'm':
+            opts->timeline = 1;
+            break;
+        case 'c':
+            opts->chrome_trace = 1;
+            break;
         case 'T':
             ret = parse_thread_list(opts->thread_list, optarg);
             if (ret < 0) {
@@ -8,6 +8,7 @@
 #define VFS_DAEMON_H_
 
 #include <ucs/vfs/sock/vfs_sock.h>
+#include <ucs/stats/libstats.h>
 #include <ucs/sys/compiler_def.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -18,6 +19,8 @@
 
 #define VFS_DEFAULT_MOUNTPOINT_DIR "/tmp/ucx"
 #define VFS_FUSE_MOUNT_PROG        "fusermount3"
+#define VFS_STATS_INTERVAL_MS      1000
+#define VFS_STATS_FILE             "ucs/stats/binary"
 
 
 enum {
@@ -25,6 +28,21 @@ enum {
 };
 
 
+/* Statistics stream frame type */
+typedef enum {
+    VFS_STATS_FRAME_FULL,  /* binary statistics snapshot */
+    VFS_STATS_FRAME_DELTA  /* difference from the previous snapshot */
+} vfs_stats_frame_type_t;
+
+
+/* Header of every frame in the statistics stream, followed by the payload */
+typedef struct {
+    uint8_t  type;      /* vfs_stats_frame_type_t */
+    uint32_t length;    /* payload length */
+    uint64_t timestamp; /* snapshot time, in microseconds */
+} UCS_S_PACKED vfs_stats_frame_hdr_t;
+
+
 #define vfs_error ucs_error
 #define vfs_log   ucs_debug
 
@@ -35,16 +53,22 @@ typedef struct {
     int        verbose;
     const char *mountpoint_dir;
     const char *mount_opts;
+    unsigned   stats_interval_ms;
+    pid_t      stats_pid;
 } vfs_opts_t;
 
 
 extern vfs_opts_t g_opts;
 extern const char *vfs_action_names[];
 
+char *vfs_get_mountpoint(pid_t pid);
+
 int vfs_mount(int pid);
 
 int vfs_unmount(int pid);
 
 int vfs_server_loop(int listen_fd);
 
+int vfs_top_loop(int connfd);
+
 #endif
@@ -21,17 +21,20 @@
 
 
 vfs_opts_t g_opts = {
-    .action         = VFS_DAEMON_ACTION_START,
-    .foreground     = 0,
-    .verbose        = 0,
-    .mountpoint_dir = VFS_DEFAULT_MOUNTPOINT_DIR,
-    .mount_opts     = ""
+    .action            = VFS_DAEMON_ACTION_START,
+    .foreground        = 0,
+    .verbose           = 0,
+    .mountpoint_dir    = VFS_DEFAULT_MOUNTPOINT_DIR,
+    .mount_opts        = "",
+    .stats_interval_ms = 0,
+    .stats_pid         = -1
 };
 
 const char *vfs_action_names[] = {
     [UCS_VFS_SOCK_ACTION_STOP]  = "stop",
     [UCS_VFS_SOCK_ACTION_MOUNT] = "mount",
-    [VFS_DAEMON_ACTION_START]   = "start"
+    [VFS_DAEMON_ACTION_START]   = "start",
+    [UCS_VFS_SOCK_ACTION_STATS] = "top"
 };
 
 static struct sockaddr_un g_sockaddr;
@@ -107,7 +110,7 @@ static int vfs_run_fusermount(char **extra_argv)
     return 0;
 }
 
-static char *vfs_get_mountpoint(pid_t pid)
+char *vfs_get_mountpoint(pid_t pid)
 {
     ucs_status_t status;
     char *mountpoint;
@@ -362,8 +365,10 @@ static int vfs_connect_and_act()
         vfs_log("sending action '%s'", vfs_action_names[g_opts.action]);
 
         /* send action */
-        vfs_msg_out.action = g_opts.action;
-        ret                = ucs_vfs_sock_send(connfd, &vfs_msg_out);
+        vfs_msg_out.action      = g_opts.action;
+        vfs_msg_out.pid         = g_opts.stats_pid;
+        vfs_msg_out.interval_ms = g_opts.stats_interval_ms;
+        ret                     = ucs_vfs_sock_send(connfd, &vfs_msg_out);
         if (ret < 0) {
             vfs_error("failed to send: %d", ret);
             goto out_close;
@@ -372,6 +377,10 @@ static int vfs_connect_and_act()
         ret = 0;
     }
 
+    if (g_opts.action == UCS_VFS_SOCK_ACTION_STATS) {
+        ret = vfs_top_loop(connfd);
+    }
+
 out_close:
     close(connfd);
 out:
@@ -428,7 +437,7 @@ out:
 
 static void vfs_usage()
 {
-    printf("Usage:   ucx_vfs [options]  [action]\n");
+    printf("Usage:   ucx_vfs [options]  [action] [pid]\n");
     printf("\n");
     printf("Options:\n");
     printf("  -d <dir>   Set parent directory for mount points (default: %s)\n",
@@ -436,12 +445,17 @@ static void vfs_usage()
     printf("  -o <opts>  Pass these mount options to mount.fuse\n");
     printf("  -f         Do not daemonize; run in foreground\n");
     printf("  -v         Enable verbose logging (requires -f)\n");
+    printf("  -i <ms>    Statistics streaming interval in milliseconds\n");
+    printf("             (daemon default: %d)\n", VFS_STATS_INTERVAL_MS);
     printf("\n");
     printf("Actions:\n");
     printf("   start     Run the daemon and listen for connection from UCX\n");
     printf("             If a daemon is already running, do nothing\n");
     printf("             This is the default action.\n");
     printf("   stop      Stop the running daemon\n");
+    printf("   top <pid> Show live statistics rates of a process, streamed by\n");
+    printf("             the running daemon. The process should run with\n");
+    printf("             statistics enabled, for example UCX_STATS_DEST=vfs\n");
     printf("\n");
 }
 
@@ -450,7 +464,7 @@ static int vfs_parse_args(int argc, char **argv)
     const char *action_str;
     int c, i;
 
-    while ((c = getopt(argc, argv, "d:o:vfh")) != -1) {
+    while ((c = getopt(argc, argv, "d:o:i:vfh")) != -1) {
         switch (c) {
         case 'd':
             g_opts.mountpoint_dir = optarg;
@@ -464,6 +478,9 @@ static int vfs_parse_args(int argc, char **argv)
         case 'f':
             g_opts.foreground = 1;
             break;
+        case 'i':
+            g_opts.stats_interval_ms = strtoul(optarg, NULL, 0);
+            break;
         case 'h':
         default:
             vfs_usage();
@@ -494,6 +511,16 @@ static int vfs_parse_args(int argc, char **argv)
         ++optind;
     }
 
+    if (g_opts.action == UCS_VFS_SOCK_ACTION_STATS) {
+        if (optind >= argc) {
+            vfs_error("action 'top' requires a process id");
+            vfs_usage();
+            return -1;
+        }
+
+        g_opts.stats_pid = strtol(argv[optind++], NULL, 0);
+    }
+
     if (optind < argc) {
         vfs_error("only one action can be specified");
         vfs_usage();
@@ -518,6 +545,13 @@ int main(int argc, char **argv)
         return -1;
     }
 
+    ucs_vfs_sock_get_address(&g_sockaddr);
+
+    /* Statistics consumer runs in foreground and does not need FUSE */
+    if (g_opts.action == UCS_VFS_SOCK_ACTION_STATS) {
+        return vfs_connect_and_act();
+    }
+
     ret = vfs_test_fuse();
     if (ret < 0) {
         return -1;
@@ -527,8 +561,6 @@ int main(int argc, char **argv)
         fuse_daemonize(0);
     }
 
-    ucs_vfs_sock_get_address(&g_sockaddr);
-
     switch (g_opts.action) {
     case VFS_DAEMON_ACTION_START:
         return vfs_start();
@@ -12,8 +12,15 @@
 
 #include <ucs/datastruct/khash.h>
 #include <ucs/debug/log_def.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <ucs/time/time.h>
 #include <sys/poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <ctype.h>
 
 
 #define VFS_MAX_FDS 1024
@@ -23,6 +30,8 @@ typedef enum {
     VFS_FD_STATE_ACCEPTED,
     VFS_FD_STATE_MOUNTED,
     VFS_FD_STATE_FD_SENT,
+    VFS_FD_STATE_STATS,
+    VFS_FD_STATE_STATS_READER,
     VFS_FD_STATE_CLOSED
 } vfs_socket_state_t;
 
@@ -30,6 +39,19 @@ typedef struct {
     vfs_socket_state_t state;
     pid_t              pid;
     int                fuse_fd;
+
+    /* Statistics stream state, valid if state==STATS or STATS_READER */
+    struct {
+        ucs_time_t       interval;
+        ucs_time_t       next_time; /* STATS_READER: read deadline */
+        ucs_stats_node_t *prev;     /* Last snapshot sent to the consumer */
+        int              peer_fd;   /* STATS: pipe of the running reader,
+                                       STATS_READER: consumer socket */
+        pid_t            reader_pid; /* Process which reads the snapshot */
+        FILE             *stream;   /* Data received from the reader */
+        char             *data;
+        size_t           size;
+    } stats;
 } vfs_serever_fd_state_t;
 
 typedef struct {
@@ -42,11 +64,13 @@ typedef struct {
 static vfs_server_context_t vfs_server_context;
 
 static const char *vfs_server_fd_state_names[] = {
-    [VFS_FD_STATE_LISTENING] = "LISTENING",
-    [VFS_FD_STATE_ACCEPTED]  = "ACCEPTED",
-    [VFS_FD_STATE_MOUNTED]   = "MOUNTED",
-    [VFS_FD_STATE_FD_SENT]   = "FD_SENT",
-    [VFS_FD_STATE_CLOSED]    = "CLOSED"
+    [VFS_FD_STATE_LISTENING]    = "LISTENING",
+    [VFS_FD_STATE_ACCEPTED]     = "ACCEPTED",
+    [VFS_FD_STATE_MOUNTED]      = "MOUNTED",
+    [VFS_FD_STATE_FD_SENT]      = "FD_SENT",
+    [VFS_FD_STATE_STATS]        = "STATS",
+    [VFS_FD_STATE_STATS_READER] = "READER",
+    [VFS_FD_STATE_CLOSED]       = "CLOSED"
 };
 
 static void vfs_server_log_context(int events)
@@ -84,13 +108,41 @@ static void vfs_server_log_context(int events)
     }
 }
 
+static int vfs_server_poll_timeout()
+{
+    ucs_time_t next_time = UCS_TIME_INFINITY;
+    ucs_time_t now;
+    int idx;
+
+    for (idx = 0; idx < vfs_server_context.nfds; ++idx) {
+        if ((vfs_server_context.fd_state[idx].state == VFS_FD_STATE_STATS) ||
+            (vfs_server_context.fd_state[idx].state ==
+             VFS_FD_STATE_STATS_READER)) {
+            next_time = ucs_min(next_time,
+                                vfs_server_context.fd_state[idx].stats.next_time);
+        }
+    }
+
+    if (next_time == UCS_TIME_INFINITY) {
+        return -1;
+    }
+
+    now = ucs_get_time();
+    if (next_time <= now) {
+        return 0;
+    }
+
+    return (int)ucs_time_to_msec(next_time - now) + 1;
+}
+
 static int vfs_server_poll_events()
 {
     int ret;
 
     vfs_server_log_context(0);
 
-    ret = poll(vfs_server_context.poll_fds, vfs_server_context.nfds, -1);
+    ret = poll(vfs_server_context.poll_fds, vfs_server_context.nfds,
+               vfs_server_poll_timeout());
     if (ret < 0) {
         ret = -errno;
         if (errno != EINTR) {
@@ -121,8 +173,10 @@ static void vfs_server_log_fd(int idx, const char *message)
             fd_state->pid);
 }
 
+/* Returns the index of the new entry, or negative error code */
 static int vfs_server_add_fd(int fd, vfs_socket_state_t state)
 {
+    vfs_serever_fd_state_t *fd_state;
     int idx, ret;
 
     ret = fcntl(fd, F_GETFL);
@@ -138,17 +192,93 @@ static int vfs_server_add_fd(int fd, vfs_socket_state_t state)
     }
 
     idx                                      = vfs_server_context.nfds++;
-    vfs_server_context.fd_state[idx].state   = state;
-    vfs_server_context.fd_state[idx].pid     = -1;
-    vfs_server_context.fd_state[idx].fuse_fd = -1;
+    fd_state                                 = &vfs_server_context.fd_state[idx];
+    fd_state->state                          = state;
+    fd_state->pid                            = -1;
+    fd_state->fuse_fd                        = -1;
+    fd_state->stats.prev                     = NULL;
+    fd_state->stats.peer_fd                  = -1;
+    fd_state->stats.reader_pid               = -1;
+    fd_state->stats.stream                   = NULL;
     vfs_server_context.poll_fds[idx].events  = POLLIN;
     vfs_server_context.poll_fds[idx].fd      = fd;
     vfs_server_context.poll_fds[idx].revents = 0;
 
     vfs_server_log_fd(idx, "added");
-    return 0;
+    return idx;
+}
+
+static int vfs_server_find_fd(int fd)
+{
+    int idx;
+
+    for (idx = 0; idx < vfs_server_context.nfds; ++idx) {
+        if (vfs_server_context.poll_fds[idx].fd == fd) {
+            return idx;
+        }
+    }
+
+    return -1;
 }
 
+#ifdef ENABLE_STATS
+static void vfs_server_remove_fd(int idx);
+
+static void vfs_server_stats_cleanup(int idx)
+{
+    vfs_serever_fd_state_t *fd_state = &vfs_server_context.fd_state[idx];
+    int peer_idx;
+
+    if (fd_state->stats.prev != NULL) {
+        ucs_stats_free(fd_state->stats.prev);
+        fd_state->stats.prev = NULL;
+    }
+
+    if (fd_state->stats.peer_fd < 0) {
+        return;
+    }
+
+    /* Unlink the consumer and its reader, the reader is not needed anymore */
+    peer_idx                = vfs_server_find_fd(fd_state->stats.peer_fd);
+    fd_state->stats.peer_fd = -1;
+    if (peer_idx < 0) {
+        return;
+    }
+
+    vfs_server_context.fd_state[peer_idx].stats.peer_fd = -1;
+    if (vfs_server_context.fd_state[peer_idx].state ==
+        VFS_FD_STATE_STATS_READER) {
+        vfs_server_remove_fd(peer_idx);
+    }
+}
+
+static void vfs_server_stats_reader_cleanup(int idx)
+{
+    vfs_serever_fd_state_t *fd_state = &vfs_server_context.fd_state[idx];
+
+    if (fd_state->stats.reader_pid > 0) {
+        /* The reader may be blocked on a process which does not respond */
+        kill(fd_state->stats.reader_pid, SIGKILL);
+        waitpid(fd_state->stats.reader_pid, NULL, 0);
+        fd_state->stats.reader_pid = -1;
+    }
+
+    if (fd_state->stats.stream != NULL) {
+        fclose(fd_state->stats.stream);
+        free(fd_state->stats.data);
+        fd_state->stats.stream = NULL;
+    }
+}
+#else
+static void vfs_server_stats_cleanup(int idx)
+{
+}
+
+static void vfs_server_stats_reader_cleanup(int idx)
+{
+}
+#endif
+
 static void vfs_server_remove_fd(int idx)
 {
     vfs_server_log_fd(idx, "removing");
@@ -159,6 +289,12 @@ static void vfs_server_remove_fd(int idx)
         vfs_server_close_fd(vfs_server_context.fd_state[idx].fuse_fd);
         vfs_unmount(vfs_server_context.fd_state[idx].pid);
         /* Fall through */
+    case VFS_FD_STATE_STATS_READER:
+        vfs_server_stats_reader_cleanup(idx);
+        /* Fall through */
+    case VFS_FD_STATE_STATS:
+        vfs_server_stats_cleanup(idx);
+        /* Fall through */
     case VFS_FD_STATE_ACCEPTED:
         vfs_server_close_fd(vfs_server_context.poll_fds[idx].fd);
         /* Fall through */
@@ -222,6 +358,368 @@ static void vfs_server_mount(int idx, pid_t pid)
     vfs_server_context.poll_fds[idx].events |= POLLOUT;
 }
 
+#ifdef ENABLE_STATS
+/* Only a consumer which runs as the owner of the process, or as root, may
+ * read its statistics */
+static int vfs_server_stats_check_peer(int idx, pid_t pid)
+{
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    struct stat st;
+    char path[64];
+
+    if (getsockopt(vfs_server_context.poll_fds[idx].fd, SOL_SOCKET,
+                   SO_PEERCRED, &cred, &len) < 0) {
+        vfs_error("getsockopt(SO_PEERCRED) failed: %m");
+        return -errno;
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d", pid);
+    if (stat(path, &st) < 0) {
+        vfs_error("failed to stat '%s': %m", path);
+        return -errno;
+    }
+
+    if ((cred.uid != 0) && (cred.uid != st.st_uid)) {
+        vfs_error("pid %d with uid %d is not allowed to read statistics of "
+                  "pid %d", cred.pid, cred.uid, pid);
+        return -EPERM;
+    }
+
+    return 0;
+}
+
+static void vfs_server_stats_start(int idx, pid_t pid, uint32_t interval_ms)
+{
+    vfs_serever_fd_state_t *fd_state = &vfs_server_context.fd_state[idx];
+
+    if (pid <= 0) {
+        vfs_error("received invalid statistics pid: %d", pid);
+        vfs_server_remove_fd(idx);
+        return;
+    }
+
+    if (vfs_server_stats_check_peer(idx, pid) < 0) {
+        vfs_server_remove_fd(idx);
+        return;
+    }
+
+    if (interval_ms == 0) {
+        interval_ms = (g_opts.stats_interval_ms != 0) ?
+                      g_opts.stats_interval_ms : VFS_STATS_INTERVAL_MS;
+    }
+
+    fd_state->state           = VFS_FD_STATE_STATS;
+    fd_state->pid             = pid;
+    fd_state->stats.interval  = ucs_time_from_msec(interval_ms);
+    fd_state->stats.next_time = ucs_get_time();
+    fd_state->stats.prev      = NULL;
+}
+
+/* Runs in a child process: copy the statistics file of a process to the pipe */
+static void vfs_server_stats_reader_main(pid_t pid, int pipe_fd)
+{
+    char buffer[4096];
+    ssize_t nread;
+    char *path;
+    int fd;
+
+    if (ucs_string_alloc_formatted_path(&path, "stats_path", "%s/%d/%s",
+                                        g_opts.mountpoint_dir, pid,
+                                        VFS_STATS_FILE) != UCS_OK) {
+        _exit(1);
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        _exit(1);
+    }
+
+    while ((nread = read(fd, buffer, sizeof(buffer))) > 0) {
+        if (write(pipe_fd, buffer, nread) != nread) {
+            _exit(1);
+        }
+    }
+
+    _exit((nread < 0) ? 1 : 0);
+}
+
+/*
+ * Reading the FUSE file blocks until the process serves it, and the process
+ * may be stopped or hung. So the file is read by a child process, and the
+ * daemon polls its output with the streaming interval as a deadline.
+ */
+static void vfs_server_stats_read_start(int idx)
+{
+    vfs_serever_fd_state_t *fd_state = &vfs_server_context.fd_state[idx];
+    vfs_serever_fd_state_t *reader;
+    int pipefds[2];
+    int reader_idx;
+    pid_t pid;
+
+    fd_state->stats.next_time = ucs_get_time() + fd_state->stats.interval;
+    if (fd_state->stats.peer_fd >= 0) {
+        return; /* previous read is still in progress */
+    }
+
+    if (pipe2(pipefds, O_CLOEXEC) < 0) {
+        vfs_error("pipe() failed: %m");
+        return;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        vfs_error("fork() failed: %m");
+        close(pipefds[0]);
+        close(pipefds[1]);
+        return;
+    } else if (pid == 0) {
+        close(pipefds[0]);
+        vfs_server_stats_reader_main(fd_state->pid, pipefds[1]);
+    }
+
+    close(pipefds[1]);
+    reader_idx = vfs_server_add_fd(pipefds[0], VFS_FD_STATE_STATS_READER);
+    if (reader_idx < 0) {
+        close(pipefds[0]);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        return;
+    }
+
+    /* Adding an entry does not move the existing ones */
+    reader                    = &vfs_server_context.fd_state[reader_idx];
+    reader->pid               = fd_state->pid;
+    reader->stats.reader_pid  = pid;
+    reader->stats.next_time   = fd_state->stats.next_time;
+    reader->stats.peer_fd     = vfs_server_context.poll_fds[idx].fd;
+    reader->stats.stream      = open_memstream(&reader->stats.data,
+                                               &reader->stats.size);
+    if (reader->stats.stream == NULL) {
+        vfs_error("open_memstream() failed: %m");
+        vfs_server_remove_fd(reader_idx);
+        return;
+    }
+
+    fd_state->stats.peer_fd = pipefds[0];
+}
+
+/* Decode the statistics snapshot, which is hex-encoded since VFS files are
+ * text */
+static int vfs_server_stats_decode(const char *hex, size_t hex_size,
+                                   char **data_p, size_t *size_p)
+{
+    int nibble, value, num_nibbles;
+    FILE *stream;
+    size_t i;
+
+    stream = open_memstream(data_p, size_p);
+    if (stream == NULL) {
+        vfs_error("open_memstream() failed: %m");
+        return -errno;
+    }
+
+    value       = 0;
+    num_nibbles = 0;
+    for (i = 0; i < hex_size; ++i) {
+        if (!isxdigit(hex[i])) {
+            continue;
+        }
+
+        nibble = isdigit(hex[i]) ? (hex[i] - '0') :
+                                   (tolower(hex[i]) - 'a' + 10);
+        value  = (value << 4) | nibble;
+        if ((++num_nibbles % 2) == 0) {
+            fputc(value, stream);
+            value = 0;
+        }
+    }
+
+    fclose(stream);
+    if (*size_p == 0) {
+        free(*data_p);
+        return -ENODATA;
+    }
+
+    return 0;
+}
+
+static void vfs_server_stats_send(int idx, char *data, size_t size)
+{
+    vfs_serever_fd_state_t *fd_state = &vfs_server_context.fd_state[idx];
+    ucs_stats_node_t *root;
+    vfs_stats_frame_hdr_t hdr;
+    char *delta_data;
+    size_t delta_size;
+    struct iovec iov[2];
+    struct msghdr msgh;
+    FILE *stream;
+    ssize_t nsent;
+
+    stream = fmemopen(data, size, "rb");
+    if (stream == NULL) {
+        vfs_error("fmemopen() failed: %m");
+        goto err;
+    }
+
+    if (ucs_stats_deserialize(stream, &root) != UCS_OK) {
+        fclose(stream);
+        goto err;
+    }
+
+    fclose(stream);
+
+    /* Send only the difference from the previous snapshot, unless the layout
+     * of the statistics tree has changed */
+    delta_data = NULL;
+    hdr.type   = VFS_STATS_FRAME_FULL;
+    if (fd_state->stats.prev != NULL) {
+        stream = open_memstream(&delta_data, &delta_size);
+        if (stream == NULL) {
+            vfs_error("open_memstream() failed: %m");
+            goto err_free_root;
+        }
+
+        if (ucs_stats_serialize_delta(stream, fd_state->stats.prev, root) ==
+            UCS_OK) {
+            hdr.type = VFS_STATS_FRAME_DELTA;
+        }
+
+        fclose(stream);
+    }
+
+    hdr.timestamp = (uint64_t)ucs_time_to_usec(ucs_get_time());
+    if (hdr.type == VFS_STATS_FRAME_DELTA) {
+        hdr.length      = delta_size;
+        iov[1].iov_base = delta_data;
+    } else {
+        hdr.length      = size;
+        iov[1].iov_base = data;
+    }
+
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len  = sizeof(hdr);
+    iov[1].iov_len  = hdr.length;
+    memset(&msgh, 0, sizeof(msgh));
+    msgh.msg_iov    = iov;
+    msgh.msg_iovlen = 2;
+
+    do {
+        nsent = sendmsg(vfs_server_context.poll_fds[idx].fd, &msgh,
+                        MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while ((nsent < 0) && (errno == EINTR));
+
+    free(delta_data);
+
+    if ((nsent < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+        /* Slow consumer: drop this snapshot, next delta is still relative to
+         * the last snapshot it has received */
+        vfs_log("dropped statistics frame for pid %d", fd_state->pid);
+        ucs_stats_free(root);
+        return;
+    } else if (nsent != (sizeof(hdr) + hdr.length)) {
+        /* Consumer is gone, or the stream got out of sync */
+        ucs_stats_free(root);
+        vfs_server_remove_fd(idx);
+        return;
+    }
+
+    if (fd_state->stats.prev != NULL) {
+        ucs_stats_free(fd_state->stats.prev);
+    }
+    fd_state->stats.prev = root;
+    return;
+
+err_free_root:
+    ucs_stats_free(root);
+err:
+    vfs_server_remove_fd(idx);
+}
+
+static void vfs_server_stats_read_progress(int idx)
+{
+    vfs_serever_fd_state_t *reader = &vfs_server_context.fd_state[idx];
+    char buffer[4096];
+    int consumer_idx, status;
+    size_t size;
+    ssize_t nread;
+    char *data;
+    int ret;
+
+    do {
+        nread = read(vfs_server_context.poll_fds[idx].fd, buffer,
+                     sizeof(buffer));
+        if (nread > 0) {
+            fwrite(buffer, 1, nread, reader->stats.stream);
+        }
+    } while ((nread > 0) || ((nread < 0) && (errno == EINTR)));
+
+    if ((nread < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+        return; /* wait for more data */
+    }
+
+    /* The reader has finished */
+    waitpid(reader->stats.reader_pid, &status, 0);
+    reader->stats.reader_pid = -1;
+    fflush(reader->stats.stream);
+
+    consumer_idx = vfs_server_find_fd(reader->stats.peer_fd);
+    if ((consumer_idx < 0) ||
+        (vfs_server_context.fd_state[consumer_idx].state !=
+         VFS_FD_STATE_STATS)) {
+        vfs_server_remove_fd(idx);
+        return;
+    }
+
+    /* Fails if the process exited, so stop streaming */
+    if ((nread < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        vfs_error("failed to read statistics of pid %d", reader->pid);
+        vfs_server_remove_fd(idx);
+        vfs_server_remove_fd(consumer_idx);
+        return;
+    }
+
+    ret = vfs_server_stats_decode(reader->stats.data, reader->stats.size,
+                                  &data, &size);
+    vfs_server_remove_fd(idx);
+    if (ret < 0) {
+        vfs_error("statistics of pid %d are empty",
+                  vfs_server_context.fd_state[consumer_idx].pid);
+        vfs_server_remove_fd(consumer_idx);
+        return;
+    }
+
+    vfs_server_stats_send(consumer_idx, data, size);
+    free(data);
+}
+
+static void vfs_server_stats_read_timeout(int idx)
+{
+    /* The frame is skipped, the next one is read after the interval */
+    vfs_error("statistics of pid %d were not read in time, skipping",
+              vfs_server_context.fd_state[idx].pid);
+    vfs_server_remove_fd(idx);
+}
+#else
+static void vfs_server_stats_start(int idx, pid_t pid, uint32_t interval_ms)
+{
+    vfs_error("statistics streaming requires UCX built with --enable-stats");
+    vfs_server_remove_fd(idx);
+}
+
+static void vfs_server_stats_read_start(int idx)
+{
+}
+
+static void vfs_server_stats_read_progress(int idx)
+{
+}
+
+static void vfs_server_stats_read_timeout(int idx)
+{
+}
+#endif
+
 static void vfs_server_recv(int idx)
 {
     ucs_vfs_sock_message_t vfs_msg_in;
@@ -250,6 +748,9 @@ static void vfs_server_recv(int idx)
     case UCS_VFS_SOCK_ACTION_NOP:
         vfs_server_remove_fd(idx);
         break;
+    case UCS_VFS_SOCK_ACTION_STATS:
+        vfs_server_stats_start(idx, vfs_msg_in.pid, vfs_msg_in.interval_ms);
+        break;
     default:
         vfs_error("ignoring invalid action %d", vfs_msg_in.action);
         vfs_server_remove_fd(idx);
@@ -267,8 +768,12 @@ static void vfs_server_handle_pollin(int idx)
         vfs_server_recv(idx);
         break;
     case VFS_FD_STATE_FD_SENT:
+    case VFS_FD_STATE_STATS:
         vfs_server_remove_fd(idx);
         break;
+    case VFS_FD_STATE_STATS_READER:
+        vfs_server_stats_read_progress(idx);
+        break;
     default:
         vfs_server_log_fd(idx, "unexpected POLLIN event on");
         vfs_server_remove_fd(idx);
@@ -332,6 +837,7 @@ static void vfs_server_set_sighandler()
 
 int vfs_server_loop(int listen_fd)
 {
+    vfs_serever_fd_state_t *fd_state;
     int idx, valid_idx;
     int ret;
 
@@ -354,17 +860,30 @@ int vfs_server_loop(int listen_fd)
 
         valid_idx = 0;
         for (idx = 0; idx < vfs_server_context.nfds; ++idx) {
+            fd_state = &vfs_server_context.fd_state[idx];
+            if (fd_state->state == VFS_FD_STATE_CLOSED) {
+                continue; /* removed while handling another entry */
+            }
+
             if (vfs_server_context.poll_fds[idx].events == 0) {
                 vfs_server_copy_fd_state(valid_idx++, idx);
                 continue;
             }
 
-            if (vfs_server_context.poll_fds[idx].revents & POLLIN) {
+            /* A pipe of a finished statistics reader reports only POLLHUP */
+            if (vfs_server_context.poll_fds[idx].revents & (POLLIN | POLLHUP)) {
                 vfs_server_handle_pollin(idx);
             }
             if (vfs_server_context.poll_fds[idx].revents & POLLOUT) {
                 vfs_server_handle_pollout(idx);
             }
+            if (ucs_get_time() >= fd_state->stats.next_time) {
+                if (fd_state->state == VFS_FD_STATE_STATS) {
+                    vfs_server_stats_read_start(idx);
+                } else if (fd_state->state == VFS_FD_STATE_STATS_READER) {
+                    vfs_server_stats_read_timeout(idx);
+                }
+            }
 
             if (vfs_server_context.fd_state[idx].state != VFS_FD_STATE_CLOSED) {
                 vfs_server_copy_fd_state(valid_idx++, idx);
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vfs_daemon.h"
+
+#include <ucs/datastruct/string_buffer.h>
+#include <ucs/debug/log_def.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#ifdef ENABLE_STATS
+
+typedef struct {
+    ucs_stats_counter_t *values;     /* Values from the previous snapshot, in
+                                        tree walk order */
+    size_t              num_values;
+    size_t              pos;         /* Current position in the tree walk */
+    double              elapsed;     /* Seconds since the previous snapshot,
+                                        0 to only save the values */
+} vfs_top_context_t;
+
+
+static int vfs_top_recv(int connfd, void *buffer, size_t length)
+{
+    ssize_t nrecvd;
+
+    do {
+        nrecvd = recv(connfd, buffer, length, MSG_WAITALL);
+    } while ((nrecvd < 0) && (errno == EINTR));
+
+    if (nrecvd < 0) {
+        vfs_error("recv() failed: %m");
+        return -errno;
+    } else if (nrecvd != length) {
+        /* Daemon closed the stream, for example if the process exited */
+        return -ECONNRESET;
+    }
+
+    return 0;
+}
+
+static size_t vfs_top_count_values(ucs_stats_node_t *node)
+{
+    size_t num_values = ucs_stats_class_num_values(node->cls);
+    ucs_stats_node_t *child;
+
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
+        num_values += vfs_top_count_values(child);
+    }
+
+    return num_values;
+}
+
+static void vfs_top_show_rate(ucs_string_buffer_t *strb, int depth,
+                              const char *name, double rate)
+{
+    char buf[32];
+
+    ucs_string_buffer_appendc(strb, ' ', (depth + 1) * 2);
+    if (!strncmp(name, "bytes", 5)) {
+        /* Show bandwidth counters in memory units */
+        ucs_memunits_to_str((size_t)rate, buf, sizeof(buf));
+        ucs_string_buffer_appendf(strb, "%s: %s/s\n", name, buf);
+    } else {
+        ucs_string_buffer_appendf(strb, "%s: %.1f/s\n", name, rate);
+    }
+}
+
+/* Returns nonzero if the node or any of its children changed */
+static int vfs_top_show_node(vfs_top_context_t *ctx, ucs_stats_node_t *node,
+                             int depth, ucs_string_buffer_t *strb)
+{
+    ucs_stats_counter_t buckets[UCS_STATS_HISTOGRAM_NUM_BUCKETS];
+    ucs_stats_counter_t *values, *prev_values;
+    ucs_string_buffer_t node_strb, children_strb;
+    ucs_stats_class_t *cls = node->cls;
+    ucs_stats_node_t *child;
+    uint64_t count;
+    int changed;
+    unsigned i, j;
+
+    values      = node->counters;
+    prev_values = ctx->values + ctx->pos;
+    ctx->pos   += ucs_stats_class_num_values(cls);
+
+    ucs_string_buffer_init(&node_strb);
+    changed = 0;
+
+    if (ctx->elapsed > 0) {
+        for (i = 0; i < cls->num_counters; ++i) {
+            if (values[i] != prev_values[i]) {
+                vfs_top_show_rate(&node_strb, depth, cls->counter_names[i],
+                                  (int64_t)(values[i] - prev_values[i]) /
+                                  ctx->elapsed);
+                changed = 1;
+            }
+        }
+
+        /* Show percentiles of the values accounted during the interval */
+        for (i = 0; i < cls->num_histograms; ++i) {
+            for (j = 0; j < UCS_STATS_HISTOGRAM_NUM_BUCKETS; ++j) {
+                buckets[j] = ucs_stats_node_histogram(node, i)[j] -
+                             prev_values[cls->num_counters +
+                                         (i * UCS_STATS_HISTOGRAM_NUM_BUCKETS) +
+                                         j];
+            }
+
+            count = ucs_stats_histogram_count(buckets);
+            if (count == 0) {
+                continue;
+            }
+
+            ucs_string_buffer_appendc(&node_strb, ' ', (depth + 1) * 2);
+            ucs_string_buffer_appendf(&node_strb,
+                                      "%s: %.1f/s p50 %" PRIu64 " p99 %" PRIu64
+                                      "\n", cls->histogram_names[i],
+                                      count / ctx->elapsed,
+                                      ucs_stats_histogram_percentile(buckets,
+                                                                     50.0),
+                                      ucs_stats_histogram_percentile(buckets,
+                                                                     99.0));
+            changed = 1;
+        }
+    }
+
+    memcpy(prev_values, values,
+           ucs_stats_class_num_values(cls) * sizeof(*values));
+
+    ucs_string_buffer_init(&children_strb);
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
+        changed |= vfs_top_show_node(ctx, child, depth + 1, &children_strb);
+    }
+
+    /* Show only the active part of the tree, with the path to it */
+    if (changed) {
+        ucs_string_buffer_appendc(strb, ' ', depth * 2);
+        ucs_string_buffer_appendf(strb, UCS_STATS_NODE_FMT ":\n",
+                                  UCS_STATS_NODE_ARG(node));
+        ucs_string_buffer_appendf(strb, "%s%s",
+                                  ucs_string_buffer_cstr(&node_strb),
+                                  ucs_string_buffer_cstr(&children_strb));
+    }
+
+    ucs_string_buffer_cleanup(&children_strb);
+    ucs_string_buffer_cleanup(&node_strb);
+    return changed;
+}
+
+static void vfs_top_show(vfs_top_context_t *ctx, ucs_stats_node_t *root,
+                         double elapsed)
+{
+    ucs_string_buffer_t strb;
+    int changed;
+
+    ucs_string_buffer_init(&strb);
+
+    ctx->pos     = 0;
+    ctx->elapsed = elapsed;
+    changed      = vfs_top_show_node(ctx, root, 0, &strb);
+
+    if (elapsed > 0) {
+        /* Clear the screen and move the cursor home */
+        printf("\033[H\033[2J");
+        printf("ucx_vfs top - pid %d, interval %.0f ms\n\n", g_opts.stats_pid,
+               elapsed * 1e3);
+        printf("%s", changed ? ucs_string_buffer_cstr(&strb) :
+                               "no activity\n");
+        fflush(stdout);
+    }
+
+    ucs_string_buffer_cleanup(&strb);
+}
+
+static int vfs_top_apply_frame(vfs_top_context_t *ctx,
+                               const vfs_stats_frame_hdr_t *hdr, char *payload,
+                               ucs_stats_node_t **root_p)
+{
+    ucs_stats_counter_t *values;
+    ucs_status_t status;
+    FILE *stream;
+
+    stream = fmemopen(payload, hdr->length, "rb");
+    if (stream == NULL) {
+        vfs_error("fmemopen() failed: %m");
+        return -errno;
+    }
+
+    if (hdr->type == VFS_STATS_FRAME_FULL) {
+        /* The layout of the tree has changed, start over */
+        if (*root_p != NULL) {
+            ucs_stats_free(*root_p);
+            *root_p = NULL;
+        }
+
+        status = ucs_stats_deserialize(stream, root_p);
+        if (status == UCS_OK) {
+            ctx->num_values = vfs_top_count_values(*root_p);
+            values          = ucs_realloc(ctx->values,
+                                          ctx->num_values * sizeof(*values),
+                                          "vfs_top_values");
+            if (values == NULL) {
+                status = UCS_ERR_NO_MEMORY;
+            } else {
+                ctx->values = values;
+            }
+        }
+    } else if ((hdr->type == VFS_STATS_FRAME_DELTA) && (*root_p != NULL)) {
+        status = ucs_stats_deserialize_delta(stream, *root_p);
+    } else {
+        vfs_error("unexpected statistics frame type %d", hdr->type);
+        status = UCS_ERR_INVALID_PARAM;
+    }
+
+    fclose(stream);
+    return (status == UCS_OK) ? 0 : -EINVAL;
+}
+
+int vfs_top_loop(int connfd)
+{
+    vfs_top_context_t ctx      = {};
+    ucs_stats_node_t *root     = NULL;
+    uint64_t prev_timestamp    = 0;
+    vfs_stats_frame_hdr_t hdr;
+    char *payload;
+    int ret;
+
+    for (;;) {
+        ret = vfs_top_recv(connfd, &hdr, sizeof(hdr));
+        if (ret < 0) {
+            break;
+        }
+
+        payload = ucs_malloc(hdr.length, "vfs_top_payload");
+        if (payload == NULL) {
+            ret = -ENOMEM;
+            break;
+        }
+
+        ret = vfs_top_recv(connfd, payload, hdr.length);
+        if (ret == 0) {
+            ret = vfs_top_apply_frame(&ctx, &hdr, payload, &root);
+        }
+
+        ucs_free(payload);
+        if (ret < 0) {
+            break;
+        }
+
+        /* Rates are known starting from the second snapshot of a tree */
+        vfs_top_show(&ctx, root,
+                     (hdr.type == VFS_STATS_FRAME_DELTA) ?
+                     (hdr.timestamp - prev_timestamp) * 1e-6 : 0);
+        prev_timestamp = hdr.timestamp;
+    }
+
+    if (ret == -ECONNRESET) {
+        printf("statistics stream of pid %d has ended\n", g_opts.stats_pid);
+        ret = 0;
+    }
+
+    if (root != NULL) {
+        ucs_stats_free(root);
+    }
+    ucs_free(ctx.values);
+    return ret;
+}
+
+#else
+
+int vfs_top_loop(int connfd)
+{
+    vfs_error("statistics streaming requires UCX built with --enable-stats");
+    return -ENOTSUP;
+}
+
+#endif
@@ -248,7 +248,7 @@ static UCS_F_ALWAYS_INLINE size_t ucp_am_eager_multi_zcopy_add_payload(
 
     return ucp_datatype_iter_next_iov(&req->send.state.dt_iter, max_payload,
                                       lpriv->super.md_index,
-                                      UCP_DT_MASK_CONTIG_IOV, next_iter, iov,
+                                      UCP_DT_MASK_ZCOPY, next_iter, iov,
                                       lpriv->super.max_iov - 1);
 }
 
@@ -340,7 +340,7 @@ ucp_am_eager_multi_zcopy_proto_progress(uct_pending_req_t *self)
     /* coverity[tainted_data_downcast] */
     return ucp_proto_multi_zcopy_progress(
             req, req->send.proto_config->priv, ucp_am_eager_multi_zcopy_init,
-            UCT_MD_MEM_ACCESS_LOCAL_READ, UCP_DT_MASK_CONTIG_IOV,
+            UCT_MD_MEM_ACCESS_LOCAL_READ, UCP_DT_MASK_ZCOPY,
             ucp_am_eager_multi_zcopy_send_func,
             ucp_request_invoke_uct_completion_success,
             ucp_am_eager_zcopy_completion);
@@ -350,7 +350,7 @@ ucp_proto_t ucp_am_eager_multi_zcopy_proto = {
     .name     = "am/egr/multi/zcopy",
     .desc     = UCP_PROTO_MULTI_FRAG_DESC " " UCP_PROTO_ZCOPY_DESC,
     .flags    = 0,
-    .dt_mask  = UCP_DT_MASK_CONTIG_IOV,
+    .dt_mask  = UCP_DT_MASK_ZCOPY,
     .probe    = ucp_am_eager_multi_zcopy_proto_probe,
     .query    = ucp_proto_multi_query,
     .progress = {ucp_am_eager_multi_zcopy_proto_progress},
@@ -421,7 +421,7 @@ ucp_am_eager_multi_zcopy_psn_proto_progress(uct_pending_req_t *self)
     status = ucp_proto_multi_zcopy_progress(
             req, req->send.proto_config->priv,
             ucp_am_eager_multi_zcopy_psn_init, UCT_MD_MEM_ACCESS_LOCAL_READ,
-            UCP_DT_MASK_CONTIG_IOV, ucp_am_eager_multi_zcopy_psn_send_func,
+            UCP_DT_MASK_ZCOPY, ucp_am_eager_multi_zcopy_psn_send_func,
             ucp_request_invoke_uct_completion_success,
             ucp_am_eager_multi_zcopy_psn_completion);
     if (status == UCS_INPROGRESS) {
@@ -436,7 +436,7 @@ static ucs_status_t ucp_am_eager_multi_zcopy_psn_reset(ucp_request_t *req)
     ucs_status_t status;
 
     status = ucp_am_proto_request_zcopy_reset(req);
-    ucp_datatype_iter_rewind(&req->send.state.dt_iter, UCP_DT_MASK_CONTIG_IOV);
+    ucp_datatype_iter_rewind(&req->send.state.dt_iter, UCP_DT_MASK_ZCOPY);
     /* Restart the request from the very first fragment */
     req->send.msg_proto.am.internal_flags &= ~UCP_REQUEST_AM_FLAG_HEADER_SENT;
     /* Mark restart as a retransmit so the receiver can evict any orphan
@@ -454,7 +454,7 @@ ucp_proto_t ucp_am_eager_multi_zcopy_psn_proto = {
     .name     = "am/egr/multi/zcopy/psn",
     .desc     = UCP_PROTO_MULTI_FRAG_DESC " " UCP_PROTO_ZCOPY_DESC " psn",
     .flags    = 0,
-    .dt_mask  = UCP_DT_MASK_CONTIG_IOV,
+    .dt_mask  = UCP_DT_MASK_ZCOPY,
     .probe    = ucp_am_eager_multi_zcopy_psn_proto_probe,
     .query    = ucp_proto_multi_query,
     .progress = {ucp_am_eager_multi_zcopy_psn_proto_progress},
@@ -244,7 +244,16 @@ typedef enum {
     /**< Pack addresses of network devices only. Using such shortened addresses
      *   for the remote node peers will reduce the amount of wireup data being
      *   exchanged during connection establishment phase. */
-    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0)
+    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0),
+
+    /**< Pack the address relative to the address template set by
+     *   @ref ucp_worker_set_address_template
+     *   "ucp_worker_set_address_template()", so that only the parts which
+     *   differ from the template are included. When all workers of a job have
+     *   similar resources, such address is much smaller than the full address.
+     *   A peer can connect to a compact address only if it has set the same
+     *   address template. */
+    UCP_WORKER_ADDRESS_FLAG_COMPACT  = UCS_BIT(1)
 } ucp_worker_address_flags_t;
 
 
@@ -297,7 +306,7 @@ enum ucp_ep_params_flags_field {
                                                            send to a particular
                                                            remote endpoint, for
                                                            example stream */
-    UCP_EP_PARAMS_FLAGS_SEND_CLIENT_ID = UCS_BIT(2)   /**< Send client id
+    UCP_EP_PARAMS_FLAGS_SEND_CLIENT_ID = UCS_BIT(2),  /**< Send client id
                                                            when connecting to remote
                                                            socket address as part of the
                                                            connection request payload.
@@ -305,6 +314,25 @@ enum ucp_ep_params_flags_field {
                                                            can be obtained from
                                                            @ref ucp_conn_request_h using
                                                            @ref ucp_conn_request_query */
+    UCP_EP_PARAMS_FLAGS_LAZY_CONNECT   = UCS_BIT(3)   /**< Defer the connection
+                                                           to a remote worker
+                                                           address until the
+                                                           first operation on
+                                                           the endpoint, or until
+                                                           the remote peer
+                                                           connects to it.
+                                                           Until then, the
+                                                           endpoint holds only a
+                                                           copy of the address
+                                                           and does not allocate
+                                                           transport resources.
+                                                           Once connected, RMA
+                                                           lanes which do not
+                                                           need a connection
+                                                           handshake are opened
+                                                           on their first use.
+                                                           Ignored for endpoints
+                                                           to a socket address */
 };
 
 
@@ -803,7 +831,28 @@ typedef enum {
      * data by calling @ref ucp_am_recv_data_nbx routine. This flag is mutually
      * exclusive with @a UCP_AM_RECV_ATTR_FLAG_DATA.
      */
-    UCP_AM_RECV_ATTR_FLAG_RNDV         = UCS_BIT(17)
+    UCP_AM_RECV_ATTR_FLAG_RNDV         = UCS_BIT(17),
+
+    /**
+     * Indicates that the data was received to the buffer returned by
+     * @ref ucp_am_handler_param_t.buffer_cb. In this case @a data parameter of
+     * the @ref ucp_am_recv_callback_t points to that buffer, which is owned by
+     * the user, and the callback must return UCS_OK. This flag is mutually
+     * exclusive with @a UCP_AM_RECV_ATTR_FLAG_DATA and
+     * @a UCP_AM_RECV_ATTR_FLAG_RNDV.
+     */
+    UCP_AM_RECV_ATTR_FLAG_USER_BUFFER  = UCS_BIT(18),
+
+    /**
+     * Indicates that the message, which was being received to the buffer
+     * returned by @ref ucp_am_handler_param_t.buffer_cb, was dropped before it
+     * was fully received, for example because the endpoint was closed. In this
+     * case @a data parameter of the @ref ucp_am_recv_callback_t points to that
+     * buffer, its content is undefined, and UCP does not access it anymore.
+     * This flag is always set together with
+     * @a UCP_AM_RECV_ATTR_FLAG_USER_BUFFER.
+     */
+    UCP_AM_RECV_ATTR_FLAG_ABORTED      = UCS_BIT(19)
 } ucp_am_recv_attr_t;
 
 
@@ -830,7 +879,36 @@ enum ucp_am_handler_param_field {
     /**
      * Indicates that @ref ucp_am_handler_param_t.arg field is valid.
      */
-    UCP_AM_HANDLER_PARAM_FIELD_ARG     = UCS_BIT(3)
+    UCP_AM_HANDLER_PARAM_FIELD_ARG     = UCS_BIT(3),
+    /**
+     * Indicates that @ref ucp_am_handler_param_t.buffer_cb field is valid.
+     */
+    UCP_AM_HANDLER_PARAM_FIELD_BUFFER_CB = UCS_BIT(4)
+};
+
+
+/**
+ * @ingroup UCP_WORKER
+ * @brief UCP AM buffer pool parameters field mask.
+ *
+ * The enumeration allows specifying which fields in
+ * @ref ucp_am_buffer_pool_params_t are present. It is used to enable backward
+ * compatibility support.
+ */
+enum ucp_am_buffer_pool_params_field {
+    /**
+     * Indicates that @ref ucp_am_buffer_pool_params_t.address field is valid.
+     */
+    UCP_AM_BUFFER_POOL_PARAM_FIELD_ADDRESS     = UCS_BIT(0),
+    /**
+     * Indicates that @ref ucp_am_buffer_pool_params_t.length field is valid.
+     */
+    UCP_AM_BUFFER_POOL_PARAM_FIELD_LENGTH      = UCS_BIT(1),
+    /**
+     * Indicates that @ref ucp_am_buffer_pool_params_t.buffer_size field is
+     * valid.
+     */
+    UCP_AM_BUFFER_POOL_PARAM_FIELD_BUFFER_SIZE = UCS_BIT(2)
 };
 
 
@@ -911,6 +989,79 @@ typedef struct ucp_dt_iov {
 } ucp_dt_iov_t;
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Maximal number of dimensions of a strided datatype.
+ */
+#define UCP_DT_STRIDED_MAX_DIMS 3
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Strided datatype parameters field mask.
+ *
+ * The enumeration allows specifying which fields in
+ * @ref ucp_dt_strided_params_t are present.
+ */
+enum ucp_dt_strided_params_field {
+    UCP_DT_STRIDED_PARAM_FIELD_BLOCK_SIZE = UCS_BIT(0), /**< block_size */
+    UCP_DT_STRIDED_PARAM_FIELD_DIMS       = UCS_BIT(1)  /**< num_dims and dims */
+};
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Dimension of a strided datatype.
+ */
+typedef struct ucp_dt_strided_dim {
+    size_t  count;    /**< Number of items in this dimension */
+    size_t  stride;   /**< Distance in bytes between the start addresses of
+                           two consecutive items in this dimension */
+} ucp_dt_strided_dim_t;
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Parameters for creating a strided datatype.
+ *
+ * A strided datatype describes a regular multidimensional layout of equally
+ * sized contiguous blocks. The innermost dimension @a dims[0] places
+ * @a dims[0].count blocks of @a block_size bytes, @a dims[0].stride bytes
+ * apart. Every outer dimension @a dims[i] repeats the whole layout of the
+ * dimension @a dims[i-1] @a dims[i].count times, @a dims[i].stride bytes
+ * apart. To keep the blocks from overlapping, @a dims[0].stride must be at
+ * least @a block_size, and @a dims[i].stride must be at least
+ * @a dims[i-1].count times @a dims[i-1].stride.
+ *
+ * One element of the datatype spans @a dims[num_dims-1].count times
+ * @a dims[num_dims-1].stride bytes, and the @a count parameter of a
+ * communication routine specifies the number of consecutive elements.
+ */
+typedef struct ucp_dt_strided_params {
+    /**
+     * Mask of valid fields in this structure, using bits from
+     * @ref ucp_dt_strided_params_field. All fields are mandatory.
+     */
+    uint64_t             field_mask;
+
+    /**
+     * Size in bytes of a contiguous block.
+     */
+    size_t               block_size;
+
+    /**
+     * Number of valid entries in @a dims, up to
+     * @ref UCP_DT_STRIDED_MAX_DIMS.
+     */
+    unsigned             num_dims;
+
+    /**
+     * Dimensions, starting from the innermost one.
+     */
+    ucp_dt_strided_dim_t dims[UCP_DT_STRIDED_MAX_DIMS];
+} ucp_dt_strided_params_t;
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Flags for specifying valid fields in @ref ucp_dt_local_sgl_t.
@@ -1996,6 +2147,86 @@ typedef struct {
 } ucp_request_param_t;
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Type of an operation submitted by @ref ucp_send_batch_nbx.
+ */
+typedef enum {
+    UCP_BATCH_OP_TAG_SEND, /**< Tagged send, see @ref ucp_tag_send_nbx */
+    UCP_BATCH_OP_AM_SEND,  /**< Active Message send, see
+                                @ref ucp_am_send_nbx */
+    UCP_BATCH_OP_PUT       /**< Remote memory put, see @ref ucp_put_nbx */
+} ucp_batch_op_type_t;
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Operation descriptor for @ref ucp_send_batch_nbx.
+ *
+ * Describes a single operation of a batch. The arguments have the same meaning
+ * as the arguments of the corresponding non-batched routine.
+ */
+typedef struct ucp_batch_op {
+    /**
+     * Type of the operation.
+     */
+    ucp_batch_op_type_t      type;
+
+    /**
+     * Destination endpoint, which must be created on the worker passed to
+     * @ref ucp_send_batch_nbx.
+     */
+    ucp_ep_h                 ep;
+
+    /**
+     * Pointer to the local source buffer.
+     */
+    const void               *buffer;
+
+    /**
+     * Number of elements of type @ref ucp_request_param_t.datatype to send.
+     */
+    size_t                   count;
+
+    union {
+        /**
+         * Message tag of @ref UCP_BATCH_OP_TAG_SEND operation.
+         */
+        ucp_tag_t            tag;
+
+        /**
+         * Arguments of @ref UCP_BATCH_OP_AM_SEND operation.
+         */
+        struct {
+            unsigned         id;            /**< Active Message id */
+            const void       *header;       /**< User defined header */
+            size_t           header_length; /**< User header length */
+        } am;
+
+        /**
+         * Arguments of @ref UCP_BATCH_OP_PUT operation.
+         */
+        struct {
+            uint64_t         remote_addr;   /**< Remote destination address */
+            ucp_rkey_h       rkey;          /**< Remote memory key */
+        } rma;
+    } args;
+
+    /**
+     * User data passed to the completion callback of this operation instead
+     * of @ref ucp_request_param_t.user_data. If NULL, the user data from the
+     * common parameters is used.
+     */
+    void                     *user_data;
+
+    /**
+     * [out] Result of the operation, with the same meaning as the return value
+     * of the corresponding non-batched routine.
+     */
+    ucs_status_ptr_t         request;
+} ucp_batch_op_t;
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Attributes of a particular request.
@@ -2066,12 +2297,56 @@ typedef struct ucp_am_handler_param {
 
     /**
      * Active Message argument, which will be passed in to every invocation of
-     * @ref ucp_am_recv_callback_t function as the @a arg argument.
+     * @ref ucp_am_recv_callback_t and @ref ucp_am_recv_buffer_callback_t
+     * functions as the @a arg argument.
      */
     void                     *arg;
+
+    /**
+     * Callback which provides a user buffer to receive a multi-fragment eager
+     * Active Message to, see @ref ucp_am_recv_buffer_callback_t. If not set,
+     * such messages are assembled in an internal buffer.
+     */
+    ucp_am_recv_buffer_callback_t buffer_cb;
 } ucp_am_handler_param_t;
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Active Message buffer pool parameters passed to
+ *        @ref ucp_worker_set_am_buffer_pool routine.
+ */
+typedef struct ucp_am_buffer_pool_params {
+    /**
+     * Mask of valid fields in this structure, using bits from
+     * @ref ucp_am_buffer_pool_params_field. Fields not specified in this mask
+     * will be ignored. Provides ABI compatibility with respect to adding new
+     * fields. All the fields are mandatory.
+     */
+    uint64_t                 field_mask;
+
+    /**
+     * Host memory region to carve the receive buffers from. The memory may be
+     * allocated on a specific NUMA node or from huge pages, and may be mapped
+     * by the user with @ref ucp_mem_map. UCP never releases this memory; it
+     * must remain valid until @ref ucp_worker_destroy returns, and may be
+     * freed by the application after that.
+     */
+    void                     *address;
+
+    /**
+     * Length of the memory region in bytes.
+     */
+    size_t                   length;
+
+    /**
+     * Maximal length of the Active Message data which is received to a buffer
+     * from the pool. Larger messages are received to internal buffers.
+     */
+    size_t                   buffer_size;
+} ucp_am_buffer_pool_params_t;
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Operation parameters provided in @ref ucp_am_recv_callback_t callback.
@@ -2437,6 +2712,33 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream);
 void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Set the address template for compact worker addresses.
+ *
+ * This routine sets the address template, which compact worker addresses are
+ * encoded relative to. Typically, all workers of a job set the full address of
+ * one worker, for example rank 0, as the template, and then exchange compact
+ * addresses obtained by @ref ucp_worker_query "ucp_worker_query()" with
+ * @ref UCP_WORKER_ADDRESS_FLAG_COMPACT flag. The template should be set
+ * before creating endpoints to compact addresses, and stay the same while
+ * such endpoints are being created.
+ *
+ * @param [in]  worker          Worker object.
+ * @param [in]  address         Full worker address to use as a template. The
+ *                              address is copied, so it can be released after
+ *                              the routine returns.
+ * @param [in]  address_length  Length of the template address.
+ *
+ * @return Error code as defined by @ref ucs_status_t. The routine fails with
+ *         UCS_ERR_INVALID_PARAM if the template is a compact address, or its
+ *         address version is not v2 (see UCX_ADDRESS_VERSION).
+ */
+ucs_status_t ucp_worker_set_address_template(ucp_worker_h worker,
+                                             const ucp_address_t *address,
+                                             size_t address_length);
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Get attributes of the particular worker address.
@@ -2803,6 +3105,47 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
                            ucp_ep_h *ep_p);
 
 
+/**
+ * @ingroup UCP_ENDPOINT
+ * @brief Create and connect multiple endpoints.
+ *
+ * This routine creates an array of @ref ucp_ep_h "endpoints" to remote
+ * @ref ucp_ep_params_t::address "worker addresses", with a single call. It is
+ * equivalent to calling @ref ucp_ep_create for every element of @a params, but
+ * the transport selection is done once for all the addresses with the same
+ * set of transports and devices, and the connection establishment messages to
+ * all the peers are sent before waiting for any of the replies.
+ *
+ * The returned request is completed when all the endpoints are connected,
+ * except the endpoints created with @ref UCP_EP_PARAMS_FLAGS_LAZY_CONNECT which
+ * are connected on their first use. The endpoints can be used for
+ * communications before the request is completed.
+ *
+ * @param [in]  worker      Handle to the worker; the endpoints are associated
+ *                          with the worker.
+ * @param [in]  params      Array of @a count endpoint parameters. Every element
+ *                          must specify @ref ucp_ep_params_t::address.
+ * @param [in]  count       Number of endpoints to create.
+ * @param [out] eps         Array of @a count elements, filled with the created
+ *                          endpoints.
+ * @param [in]  param       Operation parameters, see @ref ucp_request_param_t.
+ *
+ * @return UCS_OK               - All the endpoints were created and connected.
+ * @return UCS_PTR_IS_ERR(_ptr) - The operation failed, and no endpoints were
+ *                                created.
+ * @return otherwise            - All the endpoints were created, and the
+ *                                request handle is returned to the application
+ *                                in order to track their connection. The
+ *                                application is responsible for releasing the
+ *                                handle using @ref ucp_request_free
+ *                                "ucp_request_free()" routine.
+ */
+ucs_status_ptr_t ucp_ep_create_bulk_nbx(ucp_worker_h worker,
+                                        const ucp_ep_params_t *params,
+                                        unsigned count, ucp_ep_h *eps,
+                                        const ucp_request_param_t *param);
+
+
 /**
  * @ingroup UCP_ENDPOINT
  *
@@ -3381,6 +3724,39 @@ ucs_status_t ucp_worker_set_am_recv_handler(ucp_worker_h worker,
                                             const ucp_am_handler_param_t *param);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Provide memory for receiving Active Messages.
+ *
+ * This routine sets a user memory region, from which the worker allocates
+ * the buffers for incoming eager Active Messages. The pool is used instead of
+ * internal buffers wherever UCP would copy the data anyway: a multi-fragment
+ * message is assembled directly in a pool buffer, and a single-fragment
+ * message is copied to a pool buffer only if the transport can't lend its own
+ * receive descriptor, so the pool never adds a memory copy. The data passed to
+ * @ref ucp_am_recv_callback_t with @ref UCP_AM_RECV_ATTR_FLAG_DATA flag is
+ * returned to the pool by @ref ucp_am_data_release. If the pool is exhausted,
+ * or the message data does not fit @a params->buffer_size, the data is
+ * received to an internal buffer as usual.
+ *
+ * @param [in]  worker      UCP worker to set the buffer pool on.
+ * @param [in]  params      Buffer pool parameters, as defined by
+ *                          @ref ucp_am_buffer_pool_params_t.
+ *
+ * @return UCS_ERR_ALREADY_EXISTS if the pool was already set on the worker,
+ *         UCS_ERR_INVALID_PARAM if the memory region is too small to hold
+ *         a single buffer, or other error code on failure.
+ *
+ * @note All data received to the pool must be released by
+ *       @ref ucp_am_data_release before the worker is destroyed. The pool
+ *       cannot be detached from a worker, so the memory region is reclaimed
+ *       by the application only after @ref ucp_worker_destroy returns.
+ */
+ucs_status_t
+ucp_worker_set_am_buffer_pool(ucp_worker_h worker,
+                              const ucp_am_buffer_pool_params_t *params);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Send Active Message.
@@ -3874,6 +4250,40 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
                              const ucp_request_param_t *param);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Submit a batch of non-blocking send operations.
+ *
+ * This routine submits an array of tagged send, Active Message send and put
+ * operations, possibly to different endpoints of the same worker, with a
+ * single call. The worker lock is taken once for the whole batch, and small
+ * Active Messages in host memory to the same endpoint are packed to a single
+ * network message, which is sent before the routine returns, as if
+ * UCX_AM_COALESCE was enabled for the duration of the call. Operations to the
+ * same endpoint are submitted in the array order.
+ *
+ * The result of every operation is returned in its @a request field, which
+ * must be handled as the return value of the corresponding non-batched
+ * routine: a request handle must be released by @ref ucp_request_free.
+ *
+ * @param [in]    worker     Worker on which the endpoints were created.
+ * @param [inout] ops        Array of the operations to submit.
+ * @param [in]    count      Number of elements in @a ops.
+ * @param [in]    param      Operation parameters, which are common to all the
+ *                           operations of the batch, see
+ *                           @ref ucp_request_param_t. A non-NULL
+ *                           @ref ucp_batch_op_t.user_data replaces
+ *                           @ref ucp_request_param_t.user_data for its
+ *                           operation.
+ *
+ * @return UCS_OK if all the operations were submitted without an error, or the
+ *         status of the first failed operation. All the operations are
+ *         submitted even if some of them fail.
+ */
+ucs_status_t ucp_send_batch_nbx(ucp_worker_h worker, ucp_batch_op_t *ops,
+                                size_t count, const ucp_request_param_t *param);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Non-blocking remote memory get operation.
@@ -4146,6 +4556,30 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
                                    ucp_datatype_t *datatype_p);
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a strided datatype.
+ *
+ * This routine creates a datatype object which describes a regular
+ * multidimensional layout, as defined by @ref ucp_dt_strided_params_t.
+ * Data of a strided datatype is packed and unpacked by the library, and sent
+ * with zero-copy when the transport supports enough scatter-gather entries.
+ * The application is responsible for releasing the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @note The strided datatype is supported only by the protocols enabled with
+ *       UCX_PROTO_ENABLE=y.
+ *
+ * @param [in]  params       Strided datatype parameters as defined by
+ *                           @ref ucp_dt_strided_params_t.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_strided(const ucp_dt_strided_params_t *params,
+                                   ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Destroy a datatype and release its resources.
@@ -4153,7 +4587,8 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
  * This routine destroys the @a datatype object and
  * releases any resources that are associated with the object.
  * The @a datatype object must be allocated using @ref ucp_dt_create_generic
- * "ucp_dt_create_generic()" routine.
+ * "ucp_dt_create_generic()" or @ref ucp_dt_create_strided
+ * "ucp_dt_create_strided()" routine.
  *
  * @warning
  * @li Once the @a datatype object is released an access to this object may
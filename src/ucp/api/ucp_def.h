@@ -700,6 +700,46 @@ typedef ucs_status_t (*ucp_am_recv_callback_t)(void *arg, const void *header,
                                                const ucp_am_recv_param_t *param);
 
 
+/**
+ * @ingroup UCP_ENDPOINT
+ * @brief Callback to provide a receive buffer for an incoming Active Message.
+ *
+ * The callback is invoked when the first fragment of an eager Active Message,
+ * which is sent in multiple fragments, arrives. If it returns a buffer, the
+ * data of all fragments is unpacked directly to this buffer, and when the
+ * whole message is received, @ref ucp_am_recv_callback_t is invoked with
+ * @a data pointing to the buffer and @ref UCP_AM_RECV_ATTR_FLAG_USER_BUFFER
+ * flag set. It avoids allocating an internal buffer for the message and
+ * copying the data from it.
+ *
+ * The callback is always called from the progress context, therefore calling
+ * @ref ucp_worker_progress() is not allowed.
+ *
+ * @param [in]  arg           User-defined argument.
+ * @param [in]  header        User defined active message header.
+ *                            If @a header_length is 0, this value is undefined
+ *                            and must not be accessed.
+ * @param [in]  header_length Active message header length in bytes.
+ * @param [in]  length        Length of the message data.
+ * @param [in]  param         Data receive parameters.
+ *
+ * @return Pointer to a host memory buffer of at least @a length bytes, which
+ *         must remain valid until @ref ucp_am_recv_callback_t is invoked for
+ *         the message, or NULL to receive the message to an internal buffer.
+ *         If the message is dropped before it is fully received, for example
+ *         because the endpoint is closed, @ref ucp_am_recv_callback_t is
+ *         invoked with @ref UCP_AM_RECV_ATTR_FLAG_ABORTED flag to return the
+ *         buffer to the user.
+ *
+ * @note This callback should be set and released
+ *       by @ref ucp_worker_set_am_recv_handler function.
+ */
+typedef void *(*ucp_am_recv_buffer_callback_t)(void *arg, const void *header,
+                                               size_t header_length,
+                                               size_t length,
+                                               const ucp_am_recv_param_t *param);
+
+
 /**
  * @ingroup UCP_ENDPOINT
  * @brief Tuning parameters for the UCP endpoint.
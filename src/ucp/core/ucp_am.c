@@ -36,6 +36,8 @@ static ucs_mpool_ops_t ucp_am_frag_tree_mpool_ops = {
     .obj_str       = NULL
 };
 
+static unsigned ucp_am_coalesce_progress(void *arg);
+
 ucs_status_t ucp_am_init(ucp_worker_h worker)
 {
     ucs_mpool_params_t mp_params;
@@ -61,16 +63,31 @@ ucs_status_t ucp_am_init(ucp_worker_h worker)
         return status;
     }
 
+    ucs_list_head_init(&worker->am.coalesce_frames);
+    worker->am.coalesce_progress     = 0;
+    worker->am.user_pool.buffer_size = 0;
     return UCS_OK;
 }
 
+static int
+ucp_am_coalesce_progress_filter(const ucs_callbackq_elem_t *elem, void *arg)
+{
+    return elem->cb == ucp_am_coalesce_progress;
+}
+
 void ucp_am_cleanup(ucp_worker_h worker)
 {
     if (!(worker->context->config.features & UCP_FEATURE_AM)) {
         return;
     }
 
+    ucs_assert(ucs_list_is_empty(&worker->am.coalesce_frames));
+    ucs_callbackq_remove_oneshot(&worker->uct->progress_q, worker,
+                                 ucp_am_coalesce_progress_filter, NULL);
     ucs_mpool_cleanup(&worker->am.frag_tree_mpool, 0);
+    if (worker->am.user_pool.buffer_size != 0) {
+        ucs_mpool_cleanup(&worker->am.user_pool.mp, 1);
+    }
     ucs_array_cleanup_dynamic(&worker->am.cbs);
 }
 
@@ -79,9 +96,9 @@ void ucp_am_ep_init(ucp_ep_h ep)
     ucp_ep_ext_t *ep_ext = ep->ext;
 
     if (ep->worker->context->config.features & UCP_FEATURE_AM) {
-        ucs_list_head_init(&ep_ext->am.started_ams);
-        ucs_queue_head_init(&ep_ext->am.mid_rdesc_q);
-        ep_ext->am.psn = 0;
+        ep_ext->am.frags    = NULL;
+        ep_ext->am.psn      = 0;
+        ep_ext->am.coalesce = NULL;
     }
 }
 
@@ -91,37 +108,132 @@ static UCS_F_ALWAYS_INLINE void ucp_am_release_long_desc(ucp_recv_desc_t *desc)
     ucs_free((char*)desc - desc->release_desc_offset);
 }
 
-void ucp_am_ep_cleanup(ucp_ep_h ep)
+/* Pointer to the user buffer, which is stored after the headers */
+static UCS_F_ALWAYS_INLINE void **
+ucp_am_rdesc_user_buffer_p(ucp_recv_desc_t *first_rdesc)
 {
-    ucp_ep_ext_t *ep_ext = ep->ext;
+    ucs_assert(first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER);
+    return UCS_PTR_BYTE_OFFSET(first_rdesc + 1, UCP_AM_FIRST_FRAG_META_LEN);
+}
+
+/* Drop a partially received message. If it was being received to a user
+ * buffer, return the buffer to the user by invoking the AM callback with
+ * UCP_AM_RECV_ATTR_FLAG_ABORTED flag. */
+static void
+ucp_am_release_first_rdesc(ucp_worker_h worker, ucp_recv_desc_t *first_rdesc)
+{
+    ucp_am_first_ftr_t *first_ftr = (ucp_am_first_ftr_t*)(first_rdesc + 1);
+    ucp_am_hdr_t *hdr             = (ucp_am_hdr_t*)(first_ftr + 1);
+    ucp_am_entry_t *am_cb;
+    ucp_am_recv_param_t param;
+    ucs_status_t status;
+
+    ucs_list_del(&first_rdesc->am_first.list);
+    ucs_interval_tree_cleanup(ucp_am_rdesc_frag_tree(first_rdesc));
+
+    if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_POOL) {
+        ucp_recv_desc_release(
+                (ucp_recv_desc_t*)*ucp_am_rdesc_user_buffer_p(first_rdesc) - 1);
+    } else if ((first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) &&
+               (hdr->am_id < ucs_array_length(&worker->am.cbs))) {
+        am_cb = &ucs_array_elem(&worker->am.cbs, hdr->am_id);
+        if (am_cb->cb != NULL) {
+            param.recv_attr = UCP_AM_RECV_ATTR_FLAG_USER_BUFFER |
+                              UCP_AM_RECV_ATTR_FLAG_ABORTED;
+            param.reply_ep  = NULL;
+            status          = am_cb->cb(am_cb->context,
+                                        UCS_PTR_BYTE_OFFSET(
+                                            first_rdesc + 1,
+                                            first_rdesc->payload_offset),
+                                        hdr->header_length,
+                                        *ucp_am_rdesc_user_buffer_p(
+                                                first_rdesc),
+                                        first_ftr->total_size, &param);
+            if (ucs_unlikely(status != UCS_OK)) {
+                ucs_error("AM callback must return UCS_OK for data received"
+                          " to a user buffer");
+            }
+        }
+    }
+
+    ucp_am_release_long_desc(first_rdesc);
+}
+
+static void ucp_am_ep_frags_cleanup(ucp_ep_h ep)
+{
+    ucp_am_ep_frags_t *frags = ep->ext->am.frags;
     ucp_recv_desc_t *rdesc, *tmp_rdesc;
     ucs_queue_iter_t iter;
     size_t count;
 
-    if (!(ep->worker->context->config.features & UCP_FEATURE_AM)) {
+    if (frags == NULL) {
         return;
     }
 
     count = 0;
-    ucs_list_for_each_safe(rdesc, tmp_rdesc, &ep_ext->am.started_ams,
+    ucs_list_for_each_safe(rdesc, tmp_rdesc, &frags->started_ams,
                            am_first.list) {
-        ucs_list_del(&rdesc->am_first.list);
-        ucs_interval_tree_cleanup(ucp_am_rdesc_frag_tree(rdesc));
-        ucp_am_release_long_desc(rdesc);
+        ucp_am_release_first_rdesc(ep->worker, rdesc);
         ++count;
     }
     ucs_trace_data("worker %p: %zu unhandled first AM fragments have been"
                    " dropped on ep %p", ep->worker, count, ep);
 
     count = 0;
-    ucs_queue_for_each_safe(rdesc, iter, &ep_ext->am.mid_rdesc_q,
-                            am_mid_queue) {
-        ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+    ucs_queue_for_each_safe(rdesc, iter, &frags->mid_rdesc_q, am_mid_queue) {
+        ucs_queue_del_iter(&frags->mid_rdesc_q, iter);
         ucp_recv_desc_release(rdesc);
         ++count;
     }
     ucs_trace_data("worker %p: %zu unhandled middle AM fragments have been"
                    " dropped on ep %p", ep->worker, count, ep);
+
+    ucs_free(frags);
+    ep->ext->am.frags = NULL;
+}
+
+void ucp_am_ep_cleanup(ucp_ep_h ep)
+{
+    ucp_ep_ext_t *ep_ext = ep->ext;
+
+    if (!(ep->worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
+
+    ucp_am_ep_frags_cleanup(ep);
+
+    if (ep_ext->am.coalesce != NULL) {
+        if (ep_ext->am.coalesce->length > 0) {
+            ucs_list_del(&ep_ext->am.coalesce->list);
+            ucs_trace_data("worker %p: %zu bytes of coalesced AMs have been"
+                           " dropped on ep %p", ep->worker,
+                           ep_ext->am.coalesce->length, ep);
+        }
+
+        ucs_free(ep_ext->am.coalesce);
+        ep_ext->am.coalesce = NULL;
+    }
+}
+
+size_t ucp_am_ep_memory_usage(ucp_ep_h ep)
+{
+    ucp_context_h context = ep->worker->context;
+    size_t usage          = 0;
+
+    if (!(context->config.features & UCP_FEATURE_AM)) {
+        return 0;
+    }
+
+    if (ep->ext->am.frags != NULL) {
+        usage += sizeof(*ep->ext->am.frags);
+    }
+
+    if (ep->ext->am.coalesce != NULL) {
+        usage += sizeof(*ep->ext->am.coalesce) +
+                 context->config.ext.am_coalesce_frame_size;
+    }
+
+    return usage;
 }
 
 static void ucp_am_rndv_send_ats(ucp_worker_h worker, ucp_rndv_rts_hdr_t *rts,
@@ -198,12 +310,14 @@ UCS_PROFILE_FUNC_VOID(ucp_am_data_release, (worker, data),
 static void ucp_worker_am_init_handler(ucp_worker_h worker, uint16_t id,
                                        void *context, unsigned flags,
                                        ucp_am_callback_t cb_old,
-                                       ucp_am_recv_callback_t cb)
+                                       ucp_am_recv_callback_t cb,
+                                       ucp_am_recv_buffer_callback_t buffer_cb)
 {
     ucp_am_entry_t *am_cb = &ucs_array_elem(&worker->am.cbs, id);
 
-    am_cb->context = context;
-    am_cb->flags   = flags;
+    am_cb->context   = context;
+    am_cb->flags     = flags;
+    am_cb->buffer_cb = buffer_cb;
 
     if (cb_old != NULL) {
         ucs_assert(cb == NULL);
@@ -218,9 +332,10 @@ static ucs_status_t ucp_worker_set_am_handler_common(ucp_worker_h worker,
                                                      unsigned flags)
 {
     static const ucp_am_entry_t empty_am_handler = {
-        .cb      = NULL,
-        .context = NULL,
-        .flags   = 0
+        .cb        = NULL,
+        .buffer_cb = NULL,
+        .context   = NULL,
+        .flags     = 0
     };
 
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_AM,
@@ -254,7 +369,7 @@ ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
         goto out;
     }
 
-    ucp_worker_am_init_handler(worker, id, arg, flags, cb, NULL);
+    ucp_worker_am_init_handler(worker, id, arg, flags, cb, NULL, NULL);
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -353,6 +468,90 @@ static ucs_status_t ucp_am_check_id(unsigned am_id)
     return UCS_OK;
 }
 
+static ucs_status_t
+ucp_am_user_pool_chunk_alloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
+{
+    ucp_worker_h worker = ucs_container_of(mp, ucp_worker_t, am.user_pool.mp);
+
+    /* The whole user memory is given to the first chunk */
+    if (worker->am.user_pool.address == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    *chunk_p                     = worker->am.user_pool.address;
+    *size_p                      = worker->am.user_pool.length;
+    worker->am.user_pool.address = NULL;
+    worker->am.user_pool.length  = 0;
+    return UCS_OK;
+}
+
+static ucs_mpool_ops_t ucp_am_user_pool_mpool_ops = {
+    .chunk_alloc   = ucp_am_user_pool_chunk_alloc,
+    .chunk_release = (ucs_mpool_chunk_release_func_t)ucs_empty_function,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL,
+    .obj_str       = NULL
+};
+
+ucs_status_t
+ucp_worker_set_am_buffer_pool(ucp_worker_h worker,
+                              const ucp_am_buffer_pool_params_t *params)
+{
+    ucs_mpool_params_t mp_params;
+    ucs_status_t status;
+
+    if (!ucs_test_all_flags(params->field_mask,
+                            UCP_AM_BUFFER_POOL_PARAM_FIELD_ADDRESS |
+                            UCP_AM_BUFFER_POOL_PARAM_FIELD_LENGTH |
+                            UCP_AM_BUFFER_POOL_PARAM_FIELD_BUFFER_SIZE) ||
+        (params->address == NULL) || (params->buffer_size == 0)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_AM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    if (worker->am.user_pool.buffer_size != 0) {
+        ucs_error("worker %p: AM buffer pool is already set", worker);
+        status = UCS_ERR_ALREADY_EXISTS;
+        goto out;
+    }
+
+    ucs_mpool_params_reset(&mp_params);
+    mp_params.elem_size       = params->buffer_size + UCP_WORKER_HEADROOM_SIZE +
+                                worker->am.alignment;
+    if (params->length < mp_params.elem_size) {
+        ucs_error("worker %p: AM buffer pool length %zu is smaller than a "
+                  "single buffer (%zu)", worker, params->length,
+                  mp_params.elem_size);
+        status = UCS_ERR_INVALID_PARAM;
+        goto out;
+    }
+
+    mp_params.alignment       = UCS_SYS_CACHE_LINE_SIZE;
+    mp_params.elems_per_chunk = UINT_MAX;
+    mp_params.max_chunk_size  = params->length;
+    mp_params.malloc_safe     = 1; /* Do not complain when exhausted */
+    mp_params.ops             = &ucp_am_user_pool_mpool_ops;
+    mp_params.name            = "ucp_am_user_bufs";
+    status = ucs_mpool_init(&mp_params, &worker->am.user_pool.mp);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    worker->am.user_pool.address     = params->address;
+    worker->am.user_pool.length      = params->length;
+    worker->am.user_pool.buffer_size = params->buffer_size;
+    ucs_debug("worker %p: AM buffer pool %p length %zu buffer size %zu",
+              worker, params->address, params->length, params->buffer_size);
+
+out:
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+    return status;
+}
+
 ucs_status_t ucp_worker_set_am_recv_handler(ucp_worker_h worker,
                                             const ucp_am_handler_param_t *param)
 {
@@ -384,7 +583,9 @@ ucs_status_t ucp_worker_set_am_recv_handler(ucp_worker_h worker,
     ucp_worker_am_init_handler(worker, id,
                                UCP_PARAM_VALUE(AM_HANDLER, param, arg, ARG, NULL),
                                flags | UCP_AM_CB_PRIV_FLAG_NBX,
-                               NULL, param->cb);
+                               NULL, param->cb,
+                               UCP_PARAM_VALUE(AM_HANDLER, param, buffer_cb,
+                                               BUFFER_CB, NULL));
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -904,6 +1105,17 @@ ucp_am_send_req(ucp_request_t *req, size_t count,
     return req + 1;
 }
 
+static UCS_F_ALWAYS_INLINE uint8_t ucp_am_send_nbx_get_op_flag(uint32_t flags)
+{
+    if (flags & UCP_AM_SEND_FLAG_EAGER) {
+        return UCP_PROTO_SELECT_OP_FLAG_AM_EAGER;
+    } else if (flags & UCP_AM_SEND_FLAG_RNDV) {
+        return UCP_PROTO_SELECT_OP_FLAG_AM_RNDV;
+    }
+
+    return 0;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_am_try_send_short(ucp_ep_h ep, uint16_t id, uint32_t flags,
                       const void *header, size_t header_length,
@@ -911,28 +1123,282 @@ ucp_am_try_send_short(ucp_ep_h ep, uint16_t id, uint32_t flags,
                       const ucp_memtype_thresh_t *max_eager_short,
                       const ucp_request_param_t *param)
 {
+    ucs_time_t UCS_V_UNUSED start_time;
+    ucs_time_t tune_start_time;
+    ucs_status_t status;
+
     if (ucs_unlikely(flags & UCP_AM_SEND_FLAG_RNDV)) {
         return UCS_ERR_NO_RESOURCE;
     }
 
     if (ucp_proto_is_inline(ep, max_eager_short,
                             header_length + length, param)) {
-        return ucp_am_send_short(ep, id, flags, header, header_length, buffer,
-                                 length, flags & UCP_AM_SEND_FLAG_REPLY);
+        start_time      = ucp_ep_stats_lat_start(ep);
+        tune_start_time = ucp_proto_tune_short_start(ep->worker);
+        status          = ucp_am_send_short(ep, id, flags, header,
+                                            header_length, buffer, length,
+                                            flags & UCP_AM_SEND_FLAG_REPLY);
+        ucp_ep_stats_lat_inline(ep, UCP_EP_STAT_LAT_AM, start_time, status);
+        ucp_proto_tune_short_end(ep, UCP_WORKER_CFG_INDEX_NULL,
+                                 (flags & UCP_AM_SEND_FLAG_REPLY) ?
+                                 UCP_OP_ID_AM_SEND_REPLY : UCP_OP_ID_AM_SEND,
+                                 param, ucp_am_send_nbx_get_op_flag(flags),
+                                 header_length + length, tune_start_time,
+                                 status);
+        return status;
     }
 
     return UCS_ERR_NO_RESOURCE;
 }
 
-static UCS_F_ALWAYS_INLINE uint8_t ucp_am_send_nbx_get_op_flag(uint32_t flags)
+static size_t ucp_am_coalesce_pack(void *dest, void *arg)
 {
-    if (flags & UCP_AM_SEND_FLAG_EAGER) {
-        return UCP_PROTO_SELECT_OP_FLAG_AM_EAGER;
-    } else if (flags & UCP_AM_SEND_FLAG_RNDV) {
-        return UCP_PROTO_SELECT_OP_FLAG_AM_RNDV;
+    ucp_am_coalesce_frame_t *frame = arg;
+
+    memcpy(dest, frame + 1, frame->length);
+    return frame->length;
+}
+
+static ucs_status_t
+ucp_am_coalesce_send_frame(ucp_ep_h ep, ucp_am_coalesce_frame_t *frame)
+{
+    ssize_t packed_len;
+
+    packed_len = uct_ep_am_bcopy(ucp_ep_get_am_uct_ep(ep),
+                                 UCP_AM_ID_AM_COALESCED, ucp_am_coalesce_pack,
+                                 frame, 0);
+    if (ucs_unlikely(packed_len < 0)) {
+        return (ucs_status_t)packed_len;
     }
 
-    return 0;
+    ucs_assert(packed_len == frame->length);
+    return UCS_OK;
+}
+
+/* The coalesced messages are lost, so the endpoint can't be used anymore */
+static void ucp_am_coalesce_send_failed(ucp_ep_h ep, ucs_status_t status)
+{
+    if (ep->flags & UCP_EP_FLAG_FAILED) {
+        ucs_debug("ep %p: failed to send coalesced AMs: %s", ep,
+                  ucs_status_string(status));
+        return;
+    }
+
+    ucs_error("ep %p: failed to send coalesced AMs: %s", ep,
+              ucs_status_string(status));
+    ucp_ep_set_lanes_failed_schedule(ep, UCS_BIT(ucp_ep_get_am_lane(ep)),
+                                     status);
+}
+
+static void ucp_am_coalesce_frame_completion(uct_completion_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t,
+                                          send.state.uct_comp);
+
+    ucs_free(req->send.buffer);
+    ucp_request_put(req);
+}
+
+static ucs_status_t ucp_am_coalesce_progress_pending(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_ep_h ep        = req->send.ep;
+    ucs_status_t status;
+
+    status = ucp_am_coalesce_send_frame(ep, req->send.buffer);
+    if (status == UCS_ERR_NO_RESOURCE) {
+        req->send.lane = ucp_ep_get_am_lane(ep);
+        return UCS_ERR_NO_RESOURCE;
+    } else if (status != UCS_OK) {
+        ucp_am_coalesce_send_failed(ep, status);
+    }
+
+    ucp_am_coalesce_frame_completion(&req->send.state.uct_comp);
+    return UCS_OK;
+}
+
+static void ucp_am_coalesce_flush_frame(ucp_ep_h ep)
+{
+    ucp_am_coalesce_frame_t *frame = ep->ext->am.coalesce;
+    ucs_status_t status;
+    ucp_request_t *req;
+
+    ucs_assert(frame->length > 0);
+    ucs_list_del(&frame->list);
+
+    status = ucp_am_coalesce_send_frame(ep, frame);
+    if (ucs_likely(status == UCS_OK)) {
+        frame->length = 0;
+        return;
+    } else if (status != UCS_ERR_NO_RESOURCE) {
+        ucp_am_coalesce_send_failed(ep, status);
+        frame->length = 0;
+        return;
+    }
+
+    /* Hand over the frame to a request on the pending queue, so it is sent
+     * before any following operation on the lane */
+    req = ucp_request_get(ep->worker);
+    if (ucs_unlikely(req == NULL)) {
+        ucp_am_coalesce_send_failed(ep, UCS_ERR_NO_MEMORY);
+        frame->length = 0;
+        return;
+    }
+
+    req->flags                      = 0;
+    req->send.ep                    = ep;
+    req->send.buffer                = frame;
+    req->send.lane                  = ucp_ep_get_am_lane(ep);
+    req->send.uct.func              = ucp_am_coalesce_progress_pending;
+    req->send.state.uct_comp.func   = ucp_am_coalesce_frame_completion;
+    req->send.state.uct_comp.count  = 0;
+    req->send.state.uct_comp.status = UCS_OK;
+    ep->ext->am.coalesce            = NULL;
+    ucp_request_send(req);
+}
+
+void ucp_am_coalesce_flush(ucp_ep_h ep)
+{
+    ucp_am_coalesce_frame_t *frame;
+
+    if (!(ep->worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
+
+    frame = ep->ext->am.coalesce;
+    if ((frame != NULL) && (frame->length > 0)) {
+        ucp_am_coalesce_flush_frame(ep);
+    }
+}
+
+void ucp_am_coalesce_flush_all(ucp_worker_h worker)
+{
+    ucp_am_coalesce_frame_t *frame, *tmp_frame;
+
+    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
+
+    ucs_list_for_each_safe(frame, tmp_frame, &worker->am.coalesce_frames,
+                           list) {
+        ucp_am_coalesce_flush_frame(frame->ep);
+    }
+}
+
+static unsigned ucp_am_coalesce_progress(void *arg)
+{
+    ucp_worker_h worker = arg;
+    unsigned count      = ucs_list_length(&worker->am.coalesce_frames);
+
+    worker->am.coalesce_progress = 0;
+    ucp_am_coalesce_flush_all(worker);
+    return count;
+}
+
+static ucs_status_t
+ucp_am_coalesce_add(ucp_ep_h ep, uint16_t id, const void *header,
+                    size_t header_length, const void *buffer, size_t length)
+{
+    ucp_worker_h worker      = ep->worker;
+    ucp_context_h context    = worker->context;
+    size_t msg_length        = sizeof(ucp_am_coalesce_hdr_t) + length +
+                               header_length;
+    size_t padded_length     = ucs_align_up_pow2(msg_length,
+                                                 UCP_AM_COALESCE_ALIGN);
+    size_t max_length        = ucs_min(context->config.ext.am_coalesce_frame_size,
+                                       ucp_ep_config(ep)->am.max_bcopy);
+    ucp_am_coalesce_frame_t *frame;
+    ucp_am_coalesce_hdr_t *hdr;
+
+    if (ucs_unlikely(padded_length > max_length)) {
+        ucp_am_coalesce_flush(ep);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    frame = ep->ext->am.coalesce;
+    if ((frame != NULL) && (frame->length > 0) &&
+        (((frame->length + padded_length) > max_length) ||
+         ((ucs_get_time() - frame->start) >
+          context->config.ext.am_coalesce_timeout))) {
+        ucp_am_coalesce_flush_frame(ep);
+        /* The frame could be handed over to a pending request */
+        frame = ep->ext->am.coalesce;
+    }
+
+    if (ucs_unlikely(frame == NULL)) {
+        frame = ucs_malloc(sizeof(*frame) +
+                           context->config.ext.am_coalesce_frame_size,
+                           "ucp_am_coalesce_frame");
+        if (frame == NULL) {
+            return UCS_ERR_NO_RESOURCE;
+        }
+
+        frame->ep            = ep;
+        frame->length        = 0;
+        ep->ext->am.coalesce = frame;
+    }
+
+    if (frame->length == 0) {
+        frame->start = ucs_get_time();
+        ucs_list_add_tail(&worker->am.coalesce_frames, &frame->list);
+        if (!worker->am.coalesce_progress) {
+            worker->am.coalesce_progress = 1;
+            ucs_callbackq_add_oneshot(&worker->uct->progress_q, worker,
+                                      ucp_am_coalesce_progress, worker);
+        }
+    }
+
+    hdr                = UCS_PTR_BYTE_OFFSET(frame + 1, frame->length);
+    hdr->am_id         = id;
+    hdr->length        = length;
+    hdr->header_length = header_length;
+    memcpy(hdr + 1, buffer, length);
+    if (header_length != 0) {
+        memcpy(UCS_PTR_BYTE_OFFSET(hdr + 1, length), header, header_length);
+    }
+    memset(UCS_PTR_BYTE_OFFSET(hdr, msg_length), 0, padded_length - msg_length);
+    frame->length += padded_length;
+
+    if ((frame->length + UCP_AM_COALESCE_ALIGN) > max_length) {
+        ucp_am_coalesce_flush_frame(ep);
+    }
+
+    return UCS_OK;
+}
+
+/*
+ * Coalesce a small single fragment message in host memory. Returns
+ * UCS_ERR_NO_RESOURCE if the message should be sent by a regular protocol,
+ * after sending the coalesced messages of the endpoint to keep the order.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_am_try_coalesce(ucp_ep_h ep, uint16_t id, uint32_t flags,
+                    const void *header, size_t header_length,
+                    const void *buffer, size_t length,
+                    const ucp_request_param_t *param)
+{
+    ucp_context_h context = ep->worker->context;
+    size_t total_length   = length + header_length;
+
+    /* Rendezvous threshold is respected only if it is set explicitly */
+    if (ucs_unlikely((flags & (UCP_AM_SEND_FLAG_REPLY |
+                               UCP_AM_SEND_FLAG_RNDV)) ||
+                     (total_length > context->config.ext.am_coalesce_thresh) ||
+                     (total_length >=
+                      ucs_min(context->config.ext.rndv_intra_thresh,
+                              context->config.ext.rndv_inter_thresh)) ||
+                     (length > UINT16_MAX) ||
+                     (ep->flags & UCP_EP_FLAG_FAILED) ||
+                     !((context->num_mem_type_detect_mds == 0) ||
+                       ucs_memtype_cache_is_empty() ||
+                       ((param->op_attr_mask &
+                         UCP_OP_ATTR_FIELD_MEMORY_TYPE) &&
+                        (param->memory_type == UCS_MEMORY_TYPE_HOST))))) {
+        ucp_am_coalesce_flush(ep);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    return ucp_am_coalesce_add(ep, id, header, header_length, buffer, length);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -970,6 +1436,38 @@ ucp_am_send_nbx_check_header_length(ucp_worker_h worker, size_t header_length)
     return UCS_OK;
 }
 
+ucs_status_t ucp_am_batch_coalesce(ucp_ep_h ep, unsigned id,
+                                   const void *header, size_t header_length,
+                                   const void *buffer, size_t count,
+                                   const ucp_request_param_t *param)
+{
+    ucp_worker_h worker = ep->worker;
+    uint32_t attr_mask  = param->op_attr_mask &
+                          (UCP_OP_ATTR_FIELD_DATATYPE |
+                           UCP_OP_ATTR_FIELD_MEMH |
+                           UCP_OP_ATTR_FLAG_NO_IMM_CMPL);
+    size_t length;
+
+    /* Invalid parameters are reported by the regular send routine */
+    if (!(worker->context->config.features & UCP_FEATURE_AM) ||
+        (id > UINT16_MAX) || (header_length > worker->max_am_header)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (attr_mask == 0) {
+        length = count;
+    } else if ((attr_mask == UCP_OP_ATTR_FIELD_DATATYPE) &&
+               UCP_DT_IS_CONTIG(param->datatype)) {
+        length = ucp_contig_dt_length(param->datatype, count);
+    } else {
+        ucp_am_coalesce_flush(ep);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    return ucp_am_try_coalesce(ep, id, ucp_request_param_flags(param), header,
+                               header_length, buffer, length, param);
+}
+
 UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
                  (ep, id, header, header_length, buffer, count, param),
                  ucp_ep_h ep, unsigned id, const void *header,
@@ -1025,6 +1523,22 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
         goto out;
     }
 
+    if (ucs_unlikely(worker->context->config.ext.am_coalesce)) {
+        if ((attr_mask == 0) ||
+            ((attr_mask == UCP_OP_ATTR_FIELD_DATATYPE) &&
+             UCP_DT_IS_CONTIG(param->datatype))) {
+            contig_length = (attr_mask == 0) ?
+                            count :
+                            ucp_contig_dt_length(param->datatype, count);
+            status        = ucp_am_try_coalesce(ep, id, flags, header,
+                                                header_length, buffer,
+                                                contig_length, param);
+            ucp_request_send_check_status(status, ret, goto out);
+        } else {
+            ucp_am_coalesce_flush(ep);
+        }
+    }
+
     if (ucs_likely(attr_mask == 0)) {
         status = ucp_am_try_send_short(ep, id, flags, header, header_length,
                                        buffer, count, max_short, param);
@@ -1277,6 +1791,36 @@ ucp_am_invoke_cb(ucp_worker_h worker, uint16_t am_id, void *user_hdr,
     return am_cb->cb_old(am_cb->context, data, data_length, reply_ep, flags);
 }
 
+/* Get a descriptor for the data of the given length from the user buffer
+ * pool, if possible */
+static UCS_F_ALWAYS_INLINE ucp_recv_desc_t *
+ucp_am_user_pool_desc_get(ucp_worker_h worker, size_t length, const char *name)
+{
+    ucp_recv_desc_t *rdesc;
+    size_t padding;
+
+    if (ucs_likely((worker->am.user_pool.buffer_size == 0) ||
+                   (length > worker->am.user_pool.buffer_size))) {
+        return NULL;
+    }
+
+    rdesc = ucs_mpool_get_inline(&worker->am.user_pool.mp);
+    if (rdesc == NULL) {
+        return NULL;
+    }
+
+    padding = ucs_padding((uintptr_t)(rdesc + 1), worker->am.alignment);
+    rdesc   = UCS_PTR_BYTE_OFFSET(rdesc, padding);
+
+    /* Released by ucp_recv_desc_release() like a descriptor from am_mps */
+    rdesc->release_desc_offset = padding;
+    rdesc->flags               = UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
+    rdesc->length              = length;
+    rdesc->payload_offset      = 0;
+    ucp_recv_desc_set_name(rdesc, name);
+    return rdesc;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t ucp_am_handler_common(
         ucp_worker_h worker, ucp_am_hdr_t *am_hdr, size_t total_length,
         ucp_ep_h reply_ep, unsigned am_flags, uint64_t recv_flags,
@@ -1307,30 +1851,44 @@ static UCS_F_ALWAYS_INLINE ucs_status_t ucp_am_handler_common(
      */
     if ((am_flags & UCT_CB_PARAM_FLAG_DESC) ||
         (am_cb->flags & UCP_AM_FLAG_PERSISTENT_DATA)) {
-
         /* UCT may not support AM data alignment. If unaligned data ptr is
-         * provided in UCT descriptor, allocate new aligned data buffer from UCP
-         * AM mpool instead of using UCT descriptor directly.
+         * provided in UCT descriptor, allocate new aligned data buffer
+         * from UCP AM mpool instead of using UCT descriptor directly.
          */
         if (ucs_unlikely((uintptr_t)data % worker->am.alignment)) {
             am_flags &= ~UCT_CB_PARAM_FLAG_DESC;
         }
 
-        /* User header can not be accessed outside the user callback, so do not
-         * include it to the total descriptor length. It helps to avoid extra
-         * memory copy of the user header if the message is short/inlined
-         * (i.e. received without UCT_CB_PARAM_FLAG_DESC flag).
-         */
-        desc_status = ucp_recv_desc_init(worker, data, data_length, 0, am_flags,
-                                         0, UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS,
-                                         -(int)sizeof(*am_hdr),
-                                         worker->am.alignment, name, &desc);
-        if (ucs_unlikely(UCS_STATUS_IS_ERR(desc_status))) {
-            ucs_error("worker %p could not allocate descriptor for active"
-                      " message on callback : %u",
-                      worker, am_id);
-            return UCS_OK;
+        /* The user buffer pool is used only when the data has to be copied
+         * anyway, UCT descriptor is passed to the user without a copy */
+        if (!(am_flags & UCT_CB_PARAM_FLAG_DESC)) {
+            desc = ucp_am_user_pool_desc_get(worker, data_length, name);
         }
+
+        if (ucs_unlikely(desc != NULL)) {
+            UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
+                                   desc + 1, data, data_length,
+                                   UCS_ARCH_MEMCPY_NT_SOURCE, data_length);
+        } else {
+            /* User header can not be accessed outside the user callback, so
+             * do not include it to the total descriptor length. It helps to
+             * avoid extra memory copy of the user header if the message is
+             * short/inlined (i.e. received without UCT_CB_PARAM_FLAG_DESC
+             * flag).
+             */
+            desc_status = ucp_recv_desc_init(worker, data, data_length, 0,
+                                             am_flags, 0,
+                                             UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS,
+                                             -(int)sizeof(*am_hdr),
+                                             worker->am.alignment, name, &desc);
+            if (ucs_unlikely(UCS_STATUS_IS_ERR(desc_status))) {
+                ucs_error("worker %p could not allocate descriptor for active"
+                          " message on callback : %u",
+                          worker, am_id);
+                return UCS_OK;
+            }
+        }
+
         data        = desc + 1;
         recv_flags |= UCP_AM_RECV_ATTR_FLAG_DATA;
     }
@@ -1393,6 +1951,66 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_handler,
                                  "am_handler");
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_am_coalesce_handler,
+                 (am_arg, am_data, am_length, am_flags),
+                 void *am_arg, void *am_data, size_t am_length,
+                 unsigned am_flags)
+{
+    ucp_worker_h worker = am_arg;
+    size_t offset       = 0;
+    ucp_am_coalesce_hdr_t *hdr;
+    size_t msg_length;
+
+    UCS_STATIC_ASSERT(sizeof(ucp_am_coalesce_hdr_t) == sizeof(ucp_am_hdr_t));
+    UCS_STATIC_ASSERT(ucs_offsetof(ucp_am_coalesce_hdr_t, am_id) ==
+                      ucs_offsetof(ucp_am_hdr_t, am_id));
+    UCS_STATIC_ASSERT(ucs_offsetof(ucp_am_coalesce_hdr_t, header_length) ==
+                      ucs_offsetof(ucp_am_hdr_t, header_length));
+
+    while (offset < am_length) {
+        hdr        = UCS_PTR_BYTE_OFFSET(am_data, offset);
+        msg_length = sizeof(*hdr) + hdr->length + hdr->header_length;
+        ucs_assertv((offset + msg_length) <= am_length,
+                    "offset=%zu msg_length=%zu am_length=%zu", offset,
+                    msg_length, am_length);
+
+        /* The frame is shared by all its messages, so the callbacks which
+         * keep the data get a copy of it */
+        ucp_am_handler_common(worker, (ucp_am_hdr_t*)hdr, msg_length, NULL,
+                              am_flags & ~UCT_CB_PARAM_FLAG_DESC, 0ul,
+                              "am_coalesce_handler");
+        offset += ucs_align_up_pow2(msg_length, UCP_AM_COALESCE_ALIGN);
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t ucp_am_ep_frags_get(ucp_ep_h ep, ucp_am_ep_frags_t **frags_p)
+{
+    ucp_am_ep_frags_t *frags = ep->ext->am.frags;
+
+    if (ucs_likely(frags != NULL)) {
+        *frags_p = frags;
+        return UCS_OK;
+    }
+
+    frags = ucs_malloc(sizeof(*frags), "ucp_am_ep_frags");
+    if (frags == NULL) {
+        /* Fragments of this message are dropped, so the stream of AMs on the
+         * endpoint is broken and it can't be used anymore */
+        ucs_error("ep %p: failed to allocate AM reassembly state", ep);
+        ucp_ep_set_lanes_failed_schedule(ep, 0, UCS_ERR_NO_MEMORY);
+        *frags_p = NULL;
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_list_head_init(&frags->started_ams);
+    ucs_queue_head_init(&frags->mid_rdesc_q);
+    ep->ext->am.frags = frags;
+    *frags_p          = frags;
+    return UCS_OK;
+}
+
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t *
 ucp_am_find_first_rdesc(ucp_worker_h worker, ucp_ep_ext_t *ep_ext,
                         uint64_t msg_id)
@@ -1400,7 +2018,11 @@ ucp_am_find_first_rdesc(ucp_worker_h worker, ucp_ep_ext_t *ep_ext,
     ucp_recv_desc_t *rdesc;
     ucp_am_first_ftr_t *first_ftr;
 
-    ucs_list_for_each(rdesc, &ep_ext->am.started_ams, am_first.list) {
+    if (ep_ext->am.frags == NULL) {
+        return NULL;
+    }
+
+    ucs_list_for_each(rdesc, &ep_ext->am.frags->started_ams, am_first.list) {
         first_ftr = (ucp_am_first_ftr_t*)(rdesc + 1);
         if (first_ftr->super.msg_id == msg_id) {
             return rdesc;
@@ -1414,9 +2036,17 @@ static UCS_F_ALWAYS_INLINE void
 ucp_am_copy_data_fragment(ucp_recv_desc_t *first_rdesc, void *data,
                           size_t length, size_t offset)
 {
-    UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
-                           UCS_PTR_BYTE_OFFSET(first_rdesc + 1, offset),
-                           data, length, UCS_ARCH_MEMCPY_NT_SOURCE, length);
+    void *dest;
+
+    if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) {
+        dest = UCS_PTR_BYTE_OFFSET(*ucp_am_rdesc_user_buffer_p(first_rdesc),
+                                   offset - first_rdesc->payload_offset);
+    } else {
+        dest = UCS_PTR_BYTE_OFFSET(first_rdesc + 1, offset);
+    }
+
+    UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed, dest, data,
+                           length, UCS_ARCH_MEMCPY_NT_SOURCE, length);
 
     ucs_interval_tree_insert(ucp_am_rdesc_frag_tree(first_rdesc),
                              (ucs_interval_tree_range_t){offset,
@@ -1445,7 +2075,7 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *rdesc,
     ucp_ep_ext_t *ep_ext = reply_ep->ext;
     ucp_am_hdr_t *hdr;
     ucp_am_first_ftr_t *first_ftr;
-    ucp_recv_desc_t *tmp_rdesc, *first_rdesc;
+    ucp_recv_desc_t *tmp_rdesc, *first_rdesc, *pool_desc;
     ucs_status_t status;
     void *payload, *user_hdr;
     uint64_t recv_flags;
@@ -1454,8 +2084,8 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *rdesc,
 
     ucp_am_copy_data_fragment(rdesc, data, length, offset);
 
-    ucs_list_for_each_safe(first_rdesc, tmp_rdesc, &ep_ext->am.started_ams,
-                           am_first.list) {
+    ucs_list_for_each_safe(first_rdesc, tmp_rdesc,
+                           &ep_ext->am.frags->started_ams, am_first.list) {
         if (first_rdesc == NULL) {
             return;
         }
@@ -1480,11 +2110,53 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *rdesc,
         recv_flags      = ucp_am_hdr_reply_ep(worker, hdr->flags, reply_ep,
                                             &reply_ep) |
                           UCP_AM_RECV_ATTR_FLAG_DATA;
-        payload         = UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
-                                              first_rdesc->payload_offset);
         am_id           = hdr->am_id;
         user_hdr_length = hdr->header_length;
         total_size      = first_ftr->total_size;
+
+        if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_POOL) {
+            /* The data is already in the user pool buffer, which is passed
+             * to the user as a regular data descriptor */
+            user_hdr  = UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
+                                            first_rdesc->payload_offset);
+            pool_desc = (ucp_recv_desc_t*)*ucp_am_rdesc_user_buffer_p(
+                                first_rdesc) - 1;
+            status    = ucp_am_invoke_cb(worker, am_id, user_hdr,
+                                         user_hdr_length, pool_desc + 1,
+                                         total_size, reply_ep, recv_flags);
+            if (!ucp_am_rdesc_in_progress(pool_desc, status)) {
+                ucp_recv_desc_release(pool_desc);
+            } else {
+                pool_desc->flags &= ~UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
+            }
+
+            ucp_am_release_long_desc(first_rdesc);
+            continue;
+        }
+
+        if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) {
+            /* The data is already in the user buffer, only the headers need
+             * to be released */
+            user_hdr   = UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
+                                             first_rdesc->payload_offset);
+            recv_flags = (recv_flags & ~UCP_AM_RECV_ATTR_FLAG_DATA) |
+                         UCP_AM_RECV_ATTR_FLAG_USER_BUFFER;
+            status     = ucp_am_invoke_cb(worker, am_id, user_hdr,
+                                          user_hdr_length,
+                                          *ucp_am_rdesc_user_buffer_p(
+                                                  first_rdesc),
+                                          total_size, reply_ep, recv_flags);
+            if (ucs_unlikely(status != UCS_OK)) {
+                ucs_error("AM callback must return UCS_OK for data received"
+                          " to a user buffer");
+            }
+
+            ucp_am_release_long_desc(first_rdesc);
+            continue;
+        }
+
+        payload         = UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
+                                              first_rdesc->payload_offset);
         user_hdr        = UCS_PTR_BYTE_OFFSET(payload, total_size);
 
         /* Need to reinit descriptor, because we have headers between rdesc and
@@ -1526,12 +2198,16 @@ static void ucp_am_release_mid_fragments_by_msg_id(ucp_ep_ext_t *ep_ext,
     ucp_am_mid_ftr_t *mid_ftr;
     ucs_queue_iter_t iter;
 
-    ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.mid_rdesc_q,
+    if (ep_ext->am.frags == NULL) {
+        return;
+    }
+
+    ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.frags->mid_rdesc_q,
                             am_mid_queue) {
         mid_ftr = UCS_PTR_BYTE_OFFSET(mid_rdesc + 1,
                                       mid_rdesc->length - sizeof(*mid_ftr));
         if (mid_ftr->msg_id == msg_id) {
-            ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+            ucs_queue_del_iter(&ep_ext->am.frags->mid_rdesc_q, iter);
             ucp_recv_desc_release(mid_rdesc);
         }
     }
@@ -1546,14 +2222,38 @@ static void ucp_am_release_partial_msg(ucp_worker_h worker,
     ucp_recv_desc_t *first_rdesc = ucp_am_find_first_rdesc(worker, ep_ext,
                                                            msg_id);
     if (first_rdesc != NULL) {
-        ucs_list_del(&first_rdesc->am_first.list);
-        ucs_interval_tree_cleanup(ucp_am_rdesc_frag_tree(first_rdesc));
-        ucp_am_release_long_desc(first_rdesc);
+        ucp_am_release_first_rdesc(worker, first_rdesc);
     }
 
     ucp_am_release_mid_fragments_by_msg_id(ep_ext, msg_id);
 }
 
+/* Ask the user for a buffer to receive a multi-fragment message to */
+static void *ucp_am_recv_user_buffer(ucp_worker_h worker, ucp_am_hdr_t *hdr,
+                                     const void *user_hdr, size_t length,
+                                     ucp_ep_h ep)
+{
+    ucp_am_entry_t *am_cb;
+    ucp_am_recv_param_t param;
+
+    if (ucs_unlikely(hdr->am_id >= ucs_array_length(&worker->am.cbs))) {
+        return NULL;
+    }
+
+    am_cb = &ucs_array_elem(&worker->am.cbs, hdr->am_id);
+    if ((am_cb->buffer_cb == NULL) ||
+        !(am_cb->flags & UCP_AM_CB_PRIV_FLAG_NBX)) {
+        return NULL;
+    }
+
+    param.recv_attr = ucp_am_hdr_reply_ep(worker, hdr->flags, ep,
+                                          &param.reply_ep) |
+                      UCP_AM_RECV_ATTR_FLAG_USER_BUFFER;
+
+    return am_cb->buffer_cb(am_cb->context, user_hdr, hdr->header_length,
+                            length, &param);
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
                  (am_arg, am_data, am_length, am_flags),
                  void *am_arg, void *am_data, size_t am_length,
@@ -1563,16 +2263,18 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     ucp_am_hdr_t *hdr      = am_data;
     size_t user_hdr_length = hdr->header_length;
     size_t first_payload_length;
-    ucp_recv_desc_t *mid_rdesc, *first_rdesc;
+    ucp_recv_desc_t *mid_rdesc, *first_rdesc, *pool_desc;
     ucp_am_mid_hdr_t *mid_hdr;
     ucp_am_mid_ftr_t *mid_ftr;
     ucp_am_first_ftr_t *first_ftr;
     ucs_queue_iter_t iter;
+    ucp_am_ep_frags_t *frags;
+    ucs_status_t status;
     ucp_ep_h ep;
     ucp_ep_ext_t *ep_ext;
     size_t total_length, padding;
     uint64_t recv_flags;
-    void *user_hdr, *buffer;
+    void *user_hdr, *buffer, *user_buffer;
 
     first_payload_length = am_length - sizeof(*first_ftr);
     first_ftr = UCS_PTR_BYTE_OFFSET(am_data, first_payload_length);
@@ -1599,7 +2301,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     }
 
     /* This is the first fragment, other fragments (if arrived) should be on
-     * ep_ext->am.mid_rdesc_q queue */
+     * ep_ext->am.frags->mid_rdesc_q queue */
     first_rdesc = ucp_am_find_first_rdesc(worker, ep_ext,
                                           first_ftr->super.msg_id);
 
@@ -1607,35 +2309,83 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         goto out;
     }
 
-    /* Alloc buffer for the data and its desc, as we know total_size.
-     * Need to allocate a separate rdesc which would be in one contiguous chunk
-     * with data buffer. The layout of assembled message is below:
-     *
-     * +-----------+-------+-----------+--------+---------+---------+----------+
-     * | frag_tree | rdesc | first_ftr | am_hdr | padding | payload | user hdr |
-     * +-----------+-------+-----------+--------+---------+---------+----------+
-     *
-     * Note: frag_tree storage is allocated before rdesc, and footer is added
-     * right after rdesc (unlike wire format) for easier access while processing
-     * incoming fragments.
-     */
-    buffer = ucs_malloc(total_length + sizeof(ucp_recv_desc_t) +
-                        sizeof(ucs_interval_tree_t) + worker->am.alignment,
-                        "ucp recv desc for long AM");
+    status = ucp_am_ep_frags_get(ep, &frags);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return UCS_OK; /* release UCT desc */
+    }
+
+    user_hdr    = UCS_PTR_BYTE_OFFSET(first_ftr, -user_hdr_length);
+    user_buffer = ucp_am_recv_user_buffer(worker, hdr, user_hdr,
+                                          first_ftr->total_size, ep);
+    pool_desc   = NULL;
+    if (user_buffer == NULL) {
+        /* Assemble the message directly in a buffer from the user pool */
+        pool_desc = ucp_am_user_pool_desc_get(worker, first_ftr->total_size,
+                                              "am_long_first_handler");
+        if (pool_desc != NULL) {
+            user_buffer = pool_desc + 1;
+        }
+    }
+
+    if (user_buffer != NULL) {
+        /* The data is unpacked directly to the user buffer, so only the
+         * headers need to be kept until the message is assembled:
+         *
+         * +-----------+-------+-----------+--------+-------------+----------+
+         * | frag_tree | rdesc | first_ftr | am_hdr | user buffer | user hdr |
+         * +-----------+-------+-----------+--------+-------------+----------+
+         */
+        buffer = ucs_malloc(sizeof(ucs_interval_tree_t) +
+                            sizeof(ucp_recv_desc_t) +
+                            UCP_AM_FIRST_FRAG_META_LEN + sizeof(void*) +
+                            user_hdr_length,
+                            "ucp recv desc for long AM user buffer");
+    } else {
+        /* Alloc buffer for the data and its desc, as we know total_size.
+         * Need to allocate a separate rdesc which would be in one contiguous
+         * chunk with data buffer. The layout of assembled message is below:
+         *
+         * +-----------+-------+-----------+--------+---------+---------+----------+
+         * | frag_tree | rdesc | first_ftr | am_hdr | padding | payload | user hdr |
+         * +-----------+-------+-----------+--------+---------+---------+----------+
+         *
+         * Note: frag_tree storage is allocated before rdesc, and footer is
+         * added right after rdesc (unlike wire format) for easier access while
+         * processing incoming fragments.
+         */
+        buffer = ucs_malloc(total_length + sizeof(ucp_recv_desc_t) +
+                            sizeof(ucs_interval_tree_t) + worker->am.alignment,
+                            "ucp recv desc for long AM");
+    }
+
     if (ucs_unlikely(buffer == NULL)) {
         ucs_error("failed to allocate buffer for assembling UCP AM (id %u)",
                   hdr->am_id);
+        if (pool_desc != NULL) {
+            ucp_recv_desc_release(pool_desc);
+        }
         /* Release any middle fragments that arrived earlier for this message */
         ucp_am_release_mid_fragments_by_msg_id(ep_ext, first_ftr->super.msg_id);
         return UCS_OK; /* release UCT desc */
     }
 
     first_rdesc = UCS_PTR_BYTE_OFFSET(buffer, sizeof(ucs_interval_tree_t));
-    padding     = ucs_padding((uintptr_t)UCS_PTR_BYTE_OFFSET(
-                              first_rdesc + 1, UCP_AM_FIRST_FRAG_META_LEN),
+    if (user_buffer != NULL) {
+        first_rdesc->flags          = UCP_RECV_DESC_FLAG_AM_USER_BUFFER |
+                                      ((pool_desc != NULL) ?
+                                       UCP_RECV_DESC_FLAG_AM_USER_POOL : 0);
+        first_rdesc->payload_offset = UCP_AM_FIRST_FRAG_META_LEN +
+                                      sizeof(void*);
+        *ucp_am_rdesc_user_buffer_p(first_rdesc) = user_buffer;
+    } else {
+        padding = ucs_padding((uintptr_t)UCS_PTR_BYTE_OFFSET(
+                                      first_rdesc + 1,
+                                      UCP_AM_FIRST_FRAG_META_LEN),
                               worker->am.alignment);
+        first_rdesc->flags          = 0;
+        first_rdesc->payload_offset = UCP_AM_FIRST_FRAG_META_LEN + padding;
+    }
 
-    first_rdesc->payload_offset      = UCP_AM_FIRST_FRAG_META_LEN + padding;
     first_rdesc->release_desc_offset = sizeof(ucs_interval_tree_t);
     /* Initialize frag_tree in the allocated storage before rdesc */
     ucs_interval_tree_init(ucp_am_rdesc_frag_tree(first_rdesc),
@@ -1652,17 +2402,18 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
                            hdr, sizeof(*hdr), UCS_ARCH_MEMCPY_NT_SOURCE,
                            sizeof(*hdr));
 
-    /* Copy user header to the end of message */
-    user_hdr = UCS_PTR_BYTE_OFFSET(first_ftr, -user_hdr_length);
+    /* Copy user header to the end of message, or right after the headers if
+     * the data goes to the user buffer */
     UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
                            UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
                                                first_rdesc->payload_offset +
-                                                       first_ftr->total_size),
+                                               ((user_buffer != NULL) ? 0 :
+                                                first_ftr->total_size)),
                            user_hdr, user_hdr_length,
                            UCS_ARCH_MEMCPY_NT_SOURCE, user_hdr_length);
 
     /* Copy all already arrived middle fragments to the data buffer */
-    ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.mid_rdesc_q,
+    ucs_queue_for_each_safe(mid_rdesc, iter, &frags->mid_rdesc_q,
                             am_mid_queue) {
         mid_ftr = UCS_PTR_BYTE_OFFSET(mid_rdesc + 1,
                                       mid_rdesc->length - sizeof(*mid_ftr));
@@ -1671,7 +2422,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         }
 
         mid_hdr = (ucp_am_mid_hdr_t*)(mid_rdesc + 1);
-        ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+        ucs_queue_del_iter(&frags->mid_rdesc_q, iter);
         ucp_am_copy_data_fragment(first_rdesc, mid_hdr + 1,
                                   mid_rdesc->length - UCP_AM_MID_FRAG_META_LEN,
                                   mid_hdr->offset +
@@ -1679,7 +2430,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         ucp_recv_desc_release(mid_rdesc);
     }
 
-    ucs_list_add_tail(&ep_ext->am.started_ams, &first_rdesc->am_first.list);
+    ucs_list_add_tail(&frags->started_ams, &first_rdesc->am_first.list);
 
 out:
     /* Note: copy first chunk of data together with AM header, which contains
@@ -1701,6 +2452,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     ucp_am_mid_hdr_t *mid_hdr  = am_data;
     ucp_recv_desc_t *mid_rdesc = NULL, *first_rdesc = NULL;
     ucp_am_mid_ftr_t *mid_ftr;
+    ucp_am_ep_frags_t *frags;
     ucp_ep_ext_t *ep_ext;
     ucp_ep_h ep;
     ucs_status_t status;
@@ -1724,6 +2476,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
         return UCS_OK; /* data is copied, release UCT desc */
     }
 
+    status = ucp_am_ep_frags_get(ep, &frags);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return UCS_OK; /* release UCT desc */
+    }
+
     /* Init desc and put it on the queue in ep AM extension, because data
      * buffer is not allocated yet. When first fragment arrives (carrying total
      * data size), all middle fragments will be copied to the data buffer. */
@@ -1737,7 +2494,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     }
 
     ucs_assert(mid_rdesc != NULL);
-    ucs_queue_push(&ep_ext->am.mid_rdesc_q, &mid_rdesc->am_mid_queue);
+    ucs_queue_push(&frags->mid_rdesc_q, &mid_rdesc->am_mid_queue);
 
     return status;
 }
@@ -1906,6 +2663,8 @@ UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_AM, UCP_AM_ID_AM_FIRST_PSN,
                          ucp_am_handler_first_psn, NULL, 0);
 UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_AM, UCP_AM_ID_AM_MIDDLE_PSN,
                          ucp_am_handler_middle_psn, NULL, 0);
+UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_AM, UCP_AM_ID_AM_COALESCED,
+                         ucp_am_coalesce_handler, NULL, 0);
 
 const ucp_request_send_proto_t ucp_am_proto = {
     .contig_short           = ucp_am_contig_short,
@@ -12,6 +12,7 @@
 #include <ucs/datastruct/array.h>
 #include <ucs/datastruct/interval_tree.h>
 #include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/queue_types.h>
 #include <ucp/rndv/rndv.h>
 
 #define ucp_am_hdr_from_rts(_rts) \
@@ -42,6 +43,8 @@ typedef struct ucp_am_entry {
         ucp_am_callback_t      cb_old;   /* user defined callback, used by legacy API */
         ucp_am_recv_callback_t cb;       /* user defined callback */
     };
+    ucp_am_recv_buffer_callback_t buffer_cb; /* user defined callback to get
+                                                a receive buffer */
     void                       *context;   /* user defined callback argument */
     unsigned                   flags;      /* flags affecting callback behavior
                                               (set by the user) */
@@ -52,6 +55,22 @@ typedef struct ucp_am_info {
     size_t                                alignment;
     ucs_array_s(unsigned, ucp_am_entry_t) cbs;
     ucs_mpool_t                           frag_tree_mpool;
+    ucs_list_link_t                       coalesce_frames; /* Non-empty frames
+                                                              of coalesced
+                                                              messages */
+    int                                   coalesce_progress; /* Whether frames
+                                                                are sent on
+                                                                next progress */
+    struct {
+        ucs_mpool_t                       mp;          /* Descriptors in the
+                                                          user memory */
+        void                              *address;    /* User memory which is
+                                                          not used by mp yet */
+        size_t                            length;      /* Length of the
+                                                          unused memory */
+        size_t                            buffer_size; /* Maximal data length,
+                                                          0 if not set */
+    } user_pool;
 } ucp_am_info_t;
 
 
@@ -80,6 +99,12 @@ typedef struct ucp_am_info {
  *  +------------------+---------+------------------+
  *  | ucp_am_mid_hdr_t | payload | ucp_am_mid_ftr_t |
  *  +------------------+---------+------------------+
+ *
+ * Frame of coalesced single fragment messages, every message is padded to
+ * UCP_AM_COALESCE_ALIGN:
+ *  +-----------------------+---------+----------+-----+-----------------------+
+ *  | ucp_am_coalesce_hdr_t | payload | user hdr | pad | ucp_am_coalesce_hdr_t | ...
+ *  +-----------------------+---------+----------+-----+-----------------------+
  */
 
 
@@ -113,6 +138,44 @@ typedef struct {
 } UCS_S_PACKED ucp_am_mid_hdr_t;
 
 
+/* Alignment of the messages in a coalesced frame */
+#define UCP_AM_COALESCE_ALIGN sizeof(uint64_t)
+
+
+/*
+ * Header of a message in a coalesced frame. It has the same layout as
+ * @ref ucp_am_hdr_t, but the flags are replaced by the payload length, which
+ * is not needed for single fragment messages without reply.
+ */
+typedef struct {
+    uint16_t                 am_id;         /* index into callback array */
+    uint16_t                 length;        /* payload length */
+    uint32_t                 header_length; /* user header length */
+} UCS_S_PACKED ucp_am_coalesce_hdr_t;
+
+
+/*
+ * Frame of coalesced messages to an endpoint, followed by the packed messages
+ */
+struct ucp_am_coalesce_frame {
+    ucs_list_link_t          list;   /* entry in the worker list of frames */
+    ucp_ep_h                 ep;     /* endpoint to send the frame to */
+    ucs_time_t               start;  /* time when the first message was added */
+    size_t                   length; /* total length of the packed messages */
+};
+
+
+/*
+ * Reassembly state of fragmented messages from an endpoint, allocated when the
+ * first fragment arrives
+ */
+struct ucp_am_ep_frags {
+    ucs_list_link_t          started_ams; /* first fragments of unfinished AMs */
+    ucs_queue_head_t         mid_rdesc_q; /* middle fragments, which arrived
+                                             before the first one */
+};
+
+
 typedef struct {
     uint64_t                 ep_id; /* ep which can be used for reply */
 } UCS_S_PACKED ucp_am_reply_ftr_t;
@@ -151,6 +214,24 @@ void ucp_am_ep_init(ucp_ep_h ep);
 
 void ucp_am_ep_cleanup(ucp_ep_h ep);
 
+ucs_status_t ucp_am_ep_frags_get(ucp_ep_h ep, ucp_am_ep_frags_t **frags_p);
+
+size_t ucp_am_ep_memory_usage(ucp_ep_h ep);
+
+void ucp_am_coalesce_flush(ucp_ep_h ep);
+
+void ucp_am_coalesce_flush_all(ucp_worker_h worker);
+
+/*
+ * Add a message to the coalesced frame of the endpoint regardless of
+ * AM_COALESCE configuration. Returns UCS_ERR_NO_RESOURCE if the message has to
+ * be sent by @ref ucp_am_send_nbx.
+ */
+ucs_status_t ucp_am_batch_coalesce(ucp_ep_h ep, unsigned id,
+                                   const void *header, size_t header_length,
+                                   const void *buffer, size_t count,
+                                   const ucp_request_param_t *param);
+
 ucs_status_t ucp_proto_progress_am_rndv_rts(uct_pending_req_t *self);
 
 ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucp_am.h"
+#include "ucp_ep.h"
+#include "ucp_worker.h"
+#include "ucp_request.inl"
+
+#include <ucs/debug/log.h>
+#include <ucs/profile/profile.h>
+
+
+static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
+ucp_batch_op_submit(const ucp_batch_op_t *op, const ucp_request_param_t *param,
+                    int *coalesced_p)
+{
+    switch (op->type) {
+    case UCP_BATCH_OP_TAG_SEND:
+        return ucp_tag_send_nbx(op->ep, op->buffer, op->count, op->args.tag,
+                                param);
+    case UCP_BATCH_OP_AM_SEND:
+        /* Small messages are packed to one frame per endpoint, which is sent
+         * at the end of the batch */
+        if (ucp_am_batch_coalesce(op->ep, op->args.am.id, op->args.am.header,
+                                  op->args.am.header_length, op->buffer,
+                                  op->count, param) == UCS_OK) {
+            *coalesced_p = 1;
+            return NULL;
+        }
+
+        return ucp_am_send_nbx(op->ep, op->args.am.id, op->args.am.header,
+                               op->args.am.header_length, op->buffer,
+                               op->count, param);
+    case UCP_BATCH_OP_PUT:
+        return ucp_put_nbx(op->ep, op->buffer, op->count,
+                           op->args.rma.remote_addr, op->args.rma.rkey, param);
+    default:
+        ucs_error("invalid batch operation type %d", op->type);
+        return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
+    }
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_send_batch_nbx,
+                 (worker, ops, count, param), ucp_worker_h worker,
+                 ucp_batch_op_t *ops, size_t count,
+                 const ucp_request_param_t *param)
+{
+    ucs_status_t status = UCS_OK;
+    int coalesced       = 0;
+    ucp_request_param_t op_param;
+    const ucp_request_param_t *cur_param;
+    ucp_batch_op_t *op;
+
+    op_param               = *param;
+    op_param.op_attr_mask |= UCP_OP_ATTR_FIELD_USER_DATA;
+
+    /* The lock is recursive, so taking it once for the batch makes the
+     * locking in the send routines cheap */
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    for (op = ops; op < ops + count; ++op) {
+        ucs_assertv(op->ep->worker == worker,
+                    "op[%zu]: ep %p worker %p, expected worker %p", op - ops,
+                    op->ep, op->ep->worker, worker);
+
+        /* The user data of the operation, if set, replaces the common one */
+        if (op->user_data != NULL) {
+            op_param.user_data = op->user_data;
+            cur_param          = &op_param;
+        } else {
+            cur_param = param;
+        }
+
+        op->request = ucp_batch_op_submit(op, cur_param, &coalesced);
+        if (ucs_unlikely(UCS_PTR_IS_ERR(op->request) && (status == UCS_OK))) {
+            status = UCS_PTR_STATUS(op->request);
+        }
+    }
+
+    if (coalesced) {
+        ucp_am_coalesce_flush_all(worker);
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    ucs_trace_req("worker %p: submitted batch of %zu operations: %s", worker,
+                  count, ucs_status_string(status));
+    return status;
+}
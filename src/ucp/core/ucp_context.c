@@ -62,7 +62,9 @@
     _macro(UCP_AM_ID_AM_MIDDLE) \
     _macro(UCP_AM_ID_AM_SINGLE_REPLY) \
     _macro(UCP_AM_ID_AM_FIRST_PSN) \
-    _macro(UCP_AM_ID_AM_MIDDLE_PSN)
+    _macro(UCP_AM_ID_AM_MIDDLE_PSN) \
+    _macro(UCP_AM_ID_AM_COALESCED) \
+    _macro(UCP_AM_ID_RNDV_DATA_COMPRESSED)
 
 #define UCP_AM_HANDLER_DECL(_id) extern ucp_am_handler_t ucp_am_handler_##_id;
 
@@ -119,6 +121,12 @@ static const char *ucp_rndv_modes[] = {
     [UCP_RNDV_MODE_LAST]         = NULL,
 };
 
+static const char *ucp_multi_lane_striping_names[] = {
+    [UCP_MULTI_LANE_STRIPING_STATIC]  = "static",
+    [UCP_MULTI_LANE_STRIPING_DYNAMIC] = "dynamic",
+    [UCP_MULTI_LANE_STRIPING_LAST]    = NULL
+};
+
 static size_t ucp_rndv_frag_default_sizes[] = {
     [UCS_MEMORY_TYPE_HOST]         = 512 * UCS_KBYTE,
     [UCS_MEMORY_TYPE_CUDA]         = 4 * UCS_MBYTE,
@@ -212,6 +220,18 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "protocol. Lanes slower than the specified ratio will not be used.",
    ucs_offsetof(ucp_context_config_t, multi_lane_max_ratio), UCS_CONFIG_TYPE_DOUBLE},
 
+  {"MULTI_LANE_STRIPING", "static",
+   "How to distribute the fragments of a message between the lanes of a\n"
+   "multi-lane protocol:\n"
+   " static  - in a round-robin order, with fragment sizes proportional to the\n"
+   "           configured bandwidth of every lane.\n"
+   " dynamic - in addition, skip lanes which are out of send resources, and\n"
+   "           shrink the fragments of lanes which recently ran out of send\n"
+   "           resources, so less congested lanes send a larger part of every\n"
+   "           message.",
+   ucs_offsetof(ucp_context_config_t, multi_lane_striping),
+   UCS_CONFIG_TYPE_ENUM(ucp_multi_lane_striping_names)},
+
   {"MULTI_PATH_RATIO", "auto",
    "Bandwidth efficiency ratio when more than one path per device is used.\n"
    "This value represents the fraction of bandwidth taken by each connection\n"
@@ -241,6 +261,34 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "Maximal number of devices on which a RMA operation may be executed in parallel",
    ucs_offsetof(ucp_context_config_t, max_rma_lanes), UCS_CONFIG_TYPE_UINT},
 
+  {"AM_COALESCE", "n",
+   "Coalesce consecutive small active messages to the same endpoint into a\n"
+   "single buffered copy frame. The frame is sent when it is full, when its\n"
+   "first message is older than AM_COALESCE_TIMEOUT, on the next worker\n"
+   "progress, or before any other active message to the endpoint.\n"
+   "Coalesced messages are completed immediately, and the receiver invokes the\n"
+   "active message callbacks for them one by one, in order.",
+   ucs_offsetof(ucp_context_config_t, am_coalesce), UCS_CONFIG_TYPE_BOOL},
+
+  {"AM_COALESCE_THRESH", "256",
+   "Maximal total size of user header and data of an active message which\n"
+   "can be coalesced. Messages in non-host memory, above RNDV_THRESH, or with\n"
+   "reply or rendezvous flags are never coalesced.",
+   ucs_offsetof(ucp_context_config_t, am_coalesce_thresh),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"AM_COALESCE_FRAME_SIZE", "8k",
+   "Maximal size of a coalesced active messages frame. It is also limited by\n"
+   "the maximal buffered copy size of the active message transport.",
+   ucs_offsetof(ucp_context_config_t, am_coalesce_frame_size),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"AM_COALESCE_TIMEOUT", "10us",
+   "Maximal time an active message may wait in a coalesced frame when the\n"
+   "worker is not progressed.",
+   ucs_offsetof(ucp_context_config_t, am_coalesce_timeout),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
   {"MIN_RNDV_CHUNK_SIZE", "16k",
    "Minimum chunk size to split the message sent with rendezvous protocol on\n"
    "multiple rails. Must be greater than 0.",
@@ -395,11 +443,51 @@ static ucs_config_field_t ucp_context_config_table[] = {
    ucs_offsetof(ucp_context_config_t, rndv_shm_cuda_staging_force),
    UCS_CONFIG_TYPE_BOOL},
 
+  {"RNDV_PIPELINE_ADAPTIVE", "y",
+   "Adapt the fragment size of the pipelined rendezvous protocol to the message\n"
+   "size: start with small fragments to reduce latency, and double the size of\n"
+   "each next fragment while it still improves the bandwidth, up to the maximal\n"
+   "fragment size of the staging protocol (RNDV_FRAG_SIZE). When disabled, all\n"
+   "fragments have the maximal size.",
+   ucs_offsetof(ucp_context_config_t, rndv_ppln_adaptive), UCS_CONFIG_TYPE_BOOL},
+
+  {"RNDV_PIPELINE_MAX_INFLIGHT", "auto",
+   "Maximal number of fragments of a single message which the pipelined\n"
+   "rendezvous protocol keeps in flight. The remaining fragments are sent as\n"
+   "earlier ones complete, which limits the staging memory used by a single\n"
+   "large message. Must be at least 1.\n"
+   "'auto' derives the depth from the staging pool occupancy: a message adds a\n"
+   "fragment while the fragments in flight on the worker fit in the staging\n"
+   "buffers allocated at once (RNDV_FRAG_ALLOC_COUNT), and always keeps at\n"
+   "least one fragment in flight.",
+   ucs_offsetof(ucp_context_config_t, rndv_ppln_max_inflight),
+   UCS_CONFIG_TYPE_ULUNITS},
+
   {"RNDV_PIPELINE_ERROR_HANDLING", "n",
    "Allow using error handling protocol in the rendezvous pipeline protocol\n"
    "even if invalidation workflow isn't supported",
    ucs_offsetof(ucp_context_config_t, rndv_errh_ppln_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"RNDV_COMPRESS", "n",
+   "Enable the rendezvous protocol which compresses the payload with a fast\n"
+   "LZ4-compatible block codec. Every fragment is compressed separately while\n"
+   "the previous ones are in flight, and decompressed directly to the receive\n"
+   "buffer. The protocol is selected only when the performance model predicts\n"
+   "it is faster than sending the raw data, which is usually the case for slow\n"
+   "transports such as TCP.",
+   ucs_offsetof(ucp_context_config_t, rndv_compress), UCS_CONFIG_TYPE_BOOL},
+
+  {"RNDV_COMPRESS_RATIO", "2.0",
+   "Expected compression ratio of the rendezvous payload, used by the\n"
+   "performance model of the compressed rendezvous protocol.",
+   ucs_offsetof(ucp_context_config_t, rndv_compress_ratio),
+   UCS_CONFIG_TYPE_DOUBLE},
+
+  {"RNDV_COMPRESS_BW", "1000MBs",
+   "Estimation of the payload compression bandwidth, used by the performance\n"
+   "model of the compressed rendezvous protocol.",
+   ucs_offsetof(ucp_context_config_t, rndv_compress_bw), UCS_CONFIG_TYPE_BW},
+
   {"RMA_PPLN_ENABLE", "n",
    "Force-enable the RMA rendezvous put/get protocols.",
    ucs_offsetof(ucp_context_config_t, rma_ppln_enable), UCS_CONFIG_TYPE_BOOL},
@@ -541,6 +629,35 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "directory.",
    ucs_offsetof(ucp_context_config_t, proto_info_dir), UCS_CONFIG_TYPE_STRING},
 
+  {"PROTO_TUNE", "n",
+   "Correct the estimated performance of protocols according to the measured\n"
+   "completion times of send operations, and recalculate the protocol selection\n"
+   "thresholds at runtime.",
+   ucs_offsetof(ucp_context_config_t, proto_tune), UCS_CONFIG_TYPE_BOOL},
+
+  {"PROTO_TUNE_SAMPLES", "1000",
+   "Number of completion time samples of a protocol which are used to correct\n"
+   "its estimated performance. The number is doubled after every correction, so\n"
+   "the selection thresholds settle instead of following the measurement noise.\n"
+   "Relevant only when PROTO_TUNE is enabled.",
+   ucs_offsetof(ucp_context_config_t, proto_tune_samples), UCS_CONFIG_TYPE_UINT},
+
+  {"PROTO_TUNE_FILE", "",
+   "If non-empty, learned protocol performance corrections are loaded from this\n"
+   "file when a worker is created, and saved to it when the worker is destroyed.\n"
+   "Relevant only when PROTO_TUNE is enabled.",
+   ucs_offsetof(ucp_context_config_t, proto_tune_file), UCS_CONFIG_TYPE_STRING},
+
+  {"PROTO_CACHE_FILE", "",
+   "If non-empty, the protocol selection tables of a worker are saved to this\n"
+   "file when the worker is destroyed. When a worker selects protocols for an\n"
+   "endpoint with the same transport resources, it probes only the protocols of\n"
+   "the saved table and uses its thresholds, instead of comparing the\n"
+   "performance of all protocols. The file is ignored if it was written on a\n"
+   "different host or by a different UCX version, and a saved table is ignored\n"
+   "if any of its protocols is not available or has a configured threshold.",
+   ucs_offsetof(ucp_context_config_t, proto_cache_file), UCS_CONFIG_TYPE_STRING},
+
   {"REG_NONBLOCK_MEM_TYPES", "",
    "Perform only non-blocking memory registration for these memory types.\n"
    "Non-blocking registration means that the page registration may be\n"
@@ -619,6 +736,13 @@ static ucs_config_field_t ucp_context_config_table[] = {
    ucs_offsetof(ucp_context_config_t, connect_all_to_all),
    UCS_CONFIG_TYPE_BOOL},
 
+  {"WIREUP_SELECT_CACHE", "y",
+   "Cache the lanes selection results of a worker by the transport and device\n"
+   "attributes of the remote address, so new endpoints to peers with the same\n"
+   "configuration skip the selection.",
+   ucs_offsetof(ucp_context_config_t, wireup_select_cache),
+   UCS_CONFIG_TYPE_BOOL},
+
   {"SINGLE_NET_DEVICE", "n",
    "Restrict each protocol's lanes to one network device.\n"
    "The device is picked among the closest eligible network devices using \n"
@@ -695,6 +819,13 @@ static ucs_config_field_t ucp_config_table[] = {
    " and disables aliasing.",
    ucs_offsetof(ucp_config_t, tls), UCS_CONFIG_TYPE_ALLOW_LIST},
 
+  {"LAZY_TL_MODULES", "y",
+   "Load only the transport modules which provide the transports selected by\n"
+   "UCX_TLS and the connection managers in UCX_SOCKADDR_TLS_PRIORITY, according\n"
+   "to the module manifests. It has no effect when UCX_TLS is 'all' or a\n"
+   "negated list. Modules which detect memory types are always loaded.",
+   ucs_offsetof(ucp_config_t, lazy_tl_modules), UCS_CONFIG_TYPE_BOOL},
+
   {"PROTOS", UCP_RSC_CONFIG_ALL,
    "Comma-separated list of glob patterns specifying protocols to use.\n"
    "The order is not meaningful.\n"
@@ -804,21 +935,120 @@ const ucp_tl_bitmap_t ucp_tl_bitmap_max = {{UINT64_MAX, UINT64_MAX}};
 const ucp_tl_bitmap_t ucp_tl_bitmap_min = {{0}};
 
 
-static void ucp_load_uct_components(void)
+static ucs_status_t
+ucp_tl_providers_add(ucs_string_set_t *providers, const char *name)
+{
+    /* Strip the explicit name prefix and the auxiliary suffix */
+    if (name[0] == '\\') {
+        ++name;
+    }
+
+    return ucs_string_set_addf(providers, "%.*s", (int)strcspn(name, ":"),
+                               name);
+}
+
+/*
+ * Collect the names of the transports and connection managers which can be
+ * used with the given configuration. Returns 0 if all the transport modules
+ * should be loaded.
+ */
+static int ucp_config_get_tl_providers(const ucp_config_t *config,
+                                       ucs_string_set_t *providers)
+{
+    const ucs_config_names_array_t *tls = &config->tls.array;
+    const char * const *alias_tl;
+    const ucp_tl_alias_t *alias;
+    const char *cm_tl, *tl;
+    size_t tl_len;
+    unsigned i;
+
+    if (!config->lazy_tl_modules ||
+        (config->tls.mode != UCS_CONFIG_ALLOW_LIST_ALLOW)) {
+        return 0;
+    }
+
+    for (i = 0; i < config->sockaddr_cm_tls.count; ++i) {
+        cm_tl = config->sockaddr_cm_tls.cm_tls[i];
+        if (!strcmp(cm_tl, "*") ||
+            (ucp_tl_providers_add(providers, cm_tl) != UCS_OK)) {
+            return 0;
+        }
+    }
+
+    for (i = 0; i < tls->count; ++i) {
+        tl = tls->names[i];
+        if (ucp_tl_providers_add(providers, tl) != UCS_OK) {
+            return 0;
+        }
+
+        if (tl[0] == '\\') {
+            /* Aliasing is disabled */
+            continue;
+        }
+
+        tl_len = strcspn(tl, ":");
+        for (alias = ucp_tl_aliases; alias->alias != NULL; ++alias) {
+            if ((strlen(alias->alias) != tl_len) ||
+                strncmp(tl, alias->alias, tl_len)) {
+                continue;
+            }
+
+            for (alias_tl = alias->tls; *alias_tl != NULL; ++alias_tl) {
+                if (ucp_tl_providers_add(providers, *alias_tl) != UCS_OK) {
+                    return 0;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+static ucs_status_t ucp_query_uct_components(const ucp_config_t *config,
+                                             uct_component_h **components_p,
+                                             unsigned *num_components_p)
+{
+    uct_component_query_params_t params = {.field_mask = 0};
+    const char **names                  = NULL;
+    ucs_string_set_t providers;
+    const char *provider;
+    ucs_status_t status;
+    unsigned count;
+
+    ucs_string_set_init(&providers);
+    if (ucp_config_get_tl_providers(config, &providers)) {
+        names = ucs_calloc(kh_size(&providers) + 1, sizeof(*names),
+                           "ucp_tl_providers");
+        if (names != NULL) {
+            count = 0;
+            kh_foreach_key(&providers, provider, {
+                names[count++] = provider;
+            })
+
+            params.field_mask = UCT_COMPONENT_QUERY_PARAM_FIELD_PROVIDES;
+            params.provides   = names;
+        }
+    }
+
+    status = uct_query_components_v2(&params, components_p, num_components_p);
+
+    ucs_free(names);
+    ucs_string_set_cleanup(&providers);
+    return status;
+}
+
+static void ucp_load_uct_components(const ucp_config_t *config)
 {
-    static ucs_init_once_t init_once = UCS_INIT_ONCE_INITIALIZER;
     uct_component_h *components;
     unsigned num_components;
     ucs_status_t status;
 
-    UCS_INIT_ONCE(&init_once) {
-        status = uct_query_components(&components, &num_components);
-        if (status == UCS_OK) {
-            uct_release_component_list(components);
-        } else {
-            ucs_warn("failed to query UCT components: %s",
-                     ucs_status_string(status));
-        }
+    status = ucp_query_uct_components(config, &components, &num_components);
+    if (status == UCS_OK) {
+        uct_release_component_list(components);
+    } else {
+        ucs_warn("failed to query UCT components: %s",
+                 ucs_status_string(status));
     }
 }
 
@@ -866,7 +1096,7 @@ ucs_status_t ucp_config_read(const char *env_prefix, const char *filename,
     ucs_list_head_init(&config->cached_key_list);
     /* Load UCT components to populate ucs_config_global_list with UCT
      * configuration options */
-    ucp_load_uct_components();
+    ucp_load_uct_components(config);
 
     *config_p = config;
     return UCS_OK;
@@ -2212,7 +2442,8 @@ ucp_fill_resources(ucp_context_h context, const ucp_config_t *config)
         goto out_cleanup_avail_devices;
     }
 
-    status = uct_query_components(&uct_components, &num_uct_components);
+    status = ucp_query_uct_components(config, &uct_components,
+                                      &num_uct_components);
     if (status != UCS_OK) {
         goto out_cleanup_avail_devices;
     }
@@ -2445,6 +2676,7 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
                                     const ucp_config_t *config)
 {
     unsigned i, num_alloc_methods, method;
+    ucs_memory_type_t mem_type;
     const char *method_name;
     ucp_proto_id_t proto_id;
     ucs_status_t status;
@@ -2524,6 +2756,11 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if (context->config.ext.rndv_ppln_max_inflight == 0) {
+        ucs_error("UCX_RNDV_PIPELINE_MAX_INFLIGHT must be > 0");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
     /* Save environment prefix to later notify user for unused variables */
     context->config.env_prefix = ucs_strdup(config->env_prefix, "ucp config");
     if (context->config.env_prefix == NULL) {
@@ -2598,6 +2835,15 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
         goto err_free_alloc_methods;
     }
 
+    context->config.rndv_ppln_pool_depth = SIZE_MAX;
+    ucs_memory_type_for_each(mem_type) {
+        if (context->config.ext.rndv_frag_mem_types & UCS_BIT(mem_type)) {
+            context->config.rndv_ppln_pool_depth =
+                    ucs_min(context->config.rndv_ppln_pool_depth,
+                            context->config.ext.rndv_num_frags[mem_type]);
+        }
+    }
+
     /* Need to check TM_SEG_SIZE value if it is enabled only */
     if (context->config.ext.tm_max_bb_size > context->config.ext.tm_thresh) {
         if (context->config.ext.tm_max_bb_size < sizeof(ucp_request_hdr_t)) {
@@ -2675,6 +2921,12 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
         context->config.worker_fence_mode = context->config.ext.fence_mode;
     }
 
+    if (context->config.ext.proto_tune && !context->config.ext.proto_enable) {
+        /* Only protocols v2 have performance estimations to correct */
+        ucs_diag("UCX_PROTO_TUNE requires UCX_PROTO_ENABLE=y, disabling it");
+        context->config.ext.proto_tune = 0;
+    }
+
     context->config.progress_wrapper_enabled =
             ucs_log_is_enabled(UCS_LOG_LEVEL_TRACE_REQ) ||
             ucp_context_usage_tracker_enabled(context);
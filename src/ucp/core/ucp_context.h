@@ -102,6 +102,8 @@ typedef struct ucp_context_config {
     /** Maximal allowed ratio between slowest and fastest lane in a multi-lane
      *  protocol. Lanes slower than the specified ratio will not be used */
     double                                 multi_lane_max_ratio;
+    /** Distribution of fragments between the lanes of multi-lane protocols */
+    ucp_multi_lane_striping_t              multi_lane_striping;
     /* Bandwidth efficiency ratio */
     double                                 multi_path_ratio;
     /** Threshold for switching UCP to zero copy protocol */
@@ -128,8 +130,18 @@ typedef struct ucp_context_config {
     int                                    rndv_shm_ppln_enable;
     /** Force intra-node CUDA staging when rendezvous scheme is automatic */
     int                                    rndv_shm_cuda_staging_force;
+    /** Adapt rndv pipeline fragment size */
+    int                                    rndv_ppln_adaptive;
+    /** Maximal number of rndv pipeline fragments in flight per message */
+    size_t                                 rndv_ppln_max_inflight;
     /** Enable error handling for rndv pipeline protocol */
     int                                    rndv_errh_ppln_enable;
+    /** Enable compressed rendezvous protocol */
+    int                                    rndv_compress;
+    /** Expected compression ratio of rendezvous payload */
+    double                                 rndv_compress_ratio;
+    /** Estimation of payload compression bandwidth */
+    double                                 rndv_compress_bw;
     /** Force-enable the RMA rendezvous put/get protocols */
     int                                    rma_ppln_enable;
     /** Threshold for using tag matching offload capabilities. Smaller buffers
@@ -158,6 +170,14 @@ typedef struct ucp_context_config {
     unsigned                               max_rndv_lanes;
     /** RMA multi-lane support */
     unsigned                               max_rma_lanes;
+    /** Coalesce small active messages to the same endpoint */
+    int                                    am_coalesce;
+    /** Maximal size of user header and data of a coalesced active message */
+    size_t                                 am_coalesce_thresh;
+    /** Maximal size of a coalesced active messages frame */
+    size_t                                 am_coalesce_frame_size;
+    /** Maximal time to hold a coalesced active message */
+    ucs_time_t                             am_coalesce_timeout;
     /** Minimum allowed chunk size when splitting rndv message over multiple
      *  lanes */
     size_t                                 min_rndv_chunk_size;
@@ -224,6 +244,14 @@ typedef struct ucp_context_config {
     char                                   *select_distance_md;
     /** Directory to write protocol selection information */
     char                                   *proto_info_dir;
+    /** Tune protocol selection thresholds according to completion times */
+    int                                    proto_tune;
+    /** Number of samples to correct protocol performance estimation */
+    unsigned                               proto_tune_samples;
+    /** File to load and save learned protocol performance corrections */
+    char                                   *proto_tune_file;
+    /** File to load and save protocol selection keys to precompute */
+    char                                   *proto_cache_file;
     /** Memory types that perform non-blocking registration by default */
     uint64_t                               reg_nb_mem_types;
     /** Enable fallback to blocking registration if no MDs support nonblocking */
@@ -257,6 +285,8 @@ typedef struct ucp_context_config {
     /** Extend endpoint lanes connections of each local device to all remote
      *  devices */
     int                                    connect_all_to_all;
+    /** Cache lanes selection results by remote address signature */
+    int                                    wireup_select_cache;
     /** Restrict lanes to one network device per protocol */
     int                                    proto_use_single_net_device;
     /** Max HCAs for GPU memory registration: auto=closest, N=limit, inf=all */
@@ -279,6 +309,8 @@ struct ucp_config {
     ucs_config_allow_list_t                devices[UCT_DEVICE_TYPE_LAST];
     /** Array of transport names to use */
     ucs_config_allow_list_t                tls;
+    /** Load only the transport modules which provide the selected transports */
+    int                                    lazy_tl_modules;
     /** Array of protocol names to use */
     ucs_config_allow_list_t                protos;
     /** Array of memory allocation methods */
@@ -514,6 +546,10 @@ typedef struct ucp_context {
            unsigned               count;
            size_t                 *sizes;
         } am_mpools;
+
+        /* Number of rndv pipeline fragments which can be in flight on a worker
+         * without growing the staging memory pools */
+        size_t                    rndv_ppln_pool_depth;
     } config;
 
     /* Configuration of multi-threading support */
@@ -16,6 +16,7 @@
 #include "ucp_ep.inl"
 #include "ucp_request.inl"
 
+#include <ucp/wireup/lazy_ep.h>
 #include <ucp/wireup/wireup_ep.h>
 #include <ucp/wireup/wireup.h>
 #include <ucp/wireup/wireup_cm.h>
@@ -87,11 +88,21 @@ extern const ucp_request_send_proto_t ucp_am_proto;
 extern const ucp_request_send_proto_t ucp_am_reply_proto;
 
 #ifdef ENABLE_STATS
+static const char *ucp_ep_stats_histogram_names[] = {
+    [UCP_EP_STAT_LAT_TAG]    = "lat_tag",
+    [UCP_EP_STAT_LAT_AM]     = "lat_am",
+    [UCP_EP_STAT_LAT_RMA]    = "lat_rma",
+    [UCP_EP_STAT_LAT_STREAM] = "lat_stream",
+    [UCP_EP_STAT_LAT_RNDV]   = "lat_rndv"
+};
+
 static ucs_stats_class_t ucp_ep_stats_class = {
-    .name           = "ucp_ep",
-    .num_counters   = UCP_EP_STAT_LAST,
-    .class_id       = UCS_STATS_CLASS_ID_INVALID,
-    .counter_names  = {
+    .name            = "ucp_ep",
+    .num_counters    = UCP_EP_STAT_LAST,
+    .class_id        = UCS_STATS_CLASS_ID_INVALID,
+    .num_histograms  = UCP_EP_STAT_LAT_LAST,
+    .histogram_names = ucp_ep_stats_histogram_names,
+    .counter_names   = {
         [UCP_EP_STAT_TAG_TX_EAGER]      = "tx_eager",
         [UCP_EP_STAT_TAG_TX_EAGER_SYNC] = "tx_eager_sync",
         [UCP_EP_STAT_TAG_TX_RNDV]       = "tx_rndv"
@@ -150,7 +161,8 @@ static void ucp_failed_tl_iface_init(void)
     ucs_status_t status;
 
     UCS_INIT_ONCE(&ucp_failed_tl_iface_once) {
-        status = ucp_stub_iface_open(UCS_ERR_CANCELED, &ucp_failed_tl_iface);
+        status = ucp_stub_iface_open(UCS_ERR_CANCELED, NULL,
+                                     &ucp_failed_tl_iface);
         if (status != UCS_OK) {
             ucs_fatal("failed to create failed tl iface stub");
         }
@@ -277,6 +289,11 @@ static ucp_ep_h ucp_ep_allocate(ucp_worker_h worker, const char *peer_name)
 
     UCS_STATIC_ASSERT(sizeof(ep->ext->ep_match) >=
                       sizeof(ep->ext->flush_state));
+#if !(ENABLE_DEBUG_DATA || UCS_ENABLE_ASSERT || ENABLE_STATS)
+    /* Fields used by the send fast path must fit in one cache line, the rest
+     * of the endpoint state lives in the extension */
+    UCS_STATIC_ASSERT(sizeof(*ep) <= UCS_SYS_CACHE_LINE_SIZE);
+#endif
     memset(&ep->ext->ep_match, 0, sizeof(ep->ext->ep_match));
 
     ucs_hlist_head_init(&ep->ext->proto_reqs);
@@ -1112,6 +1129,26 @@ ucp_ep_create_api_conn_request(ucp_worker_h worker,
     return status;
 }
 
+ucs_status_t
+ucp_ep_resolve_remote_id_on_create(ucp_ep_h ep, unsigned ep_init_flags)
+{
+    ucp_worker_h worker   = ep->worker;
+    ucp_context_h context = worker->context;
+
+    if ((context->config.ext.resolve_remote_ep_id == UCS_CONFIG_ON) ||
+        ((context->config.ext.resolve_remote_ep_id == UCS_CONFIG_AUTO) &&
+         (ep_init_flags & UCP_EP_INIT_ERR_MODE_FAILOVER_MASK) &&
+         ucp_worker_keepalive_is_enabled(worker))) {
+        /* If resolving remote ID forced by configuration or PEER_FAILURE
+         * and keepalive were requested, resolve remote endpoint ID prior to
+         * communicating with a peer to make sure that remote peer's endpoint
+         * won't be changed during runtime */
+        return ucp_ep_resolve_remote_id(ep, ep->am_lane);
+    }
+
+    return UCS_OK;
+}
+
 static ucs_status_t
 ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
                                  const ucp_ep_params_t *params, ucp_ep_h *ep_p)
@@ -1166,9 +1203,17 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
         goto out_resolve_remote_id;
     }
 
-    status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
-                                          &remote_address, ep_init_flags,
-                                          "from api call", addr_indices, &ep);
+    flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
+    if ((flags & UCP_EP_PARAMS_FLAGS_LAZY_CONNECT) &&
+        context->config.ext.proto_enable) {
+        status = ucp_lazy_ep_create(worker, params->address, &remote_address,
+                                    ep_init_flags, &ep);
+    } else {
+        status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
+                                              &remote_address, ep_init_flags,
+                                              "from api call", addr_indices,
+                                              &ep);
+    }
     if (status != UCS_OK) {
         goto out_free_address;
     }
@@ -1186,7 +1231,6 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
      * Otherwise, add the new ep to the matching context as an expected endpoint,
      * waiting for connection request from the peer endpoint
      */
-    flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
     if ((remote_address.uuid == worker->uuid) &&
         !(flags & UCP_EP_PARAMS_FLAGS_NO_LOOPBACK)) {
         ucp_ep_update_remote_id(ep, ucp_ep_local_id(ep));
@@ -1200,6 +1244,12 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
         }
     }
 
+    if (ep->flags & UCP_EP_FLAG_LAZY) {
+        /* Wireup and remote ID resolution are done on the first operation */
+        status = UCS_OK;
+        goto out_free_address;
+    }
+
     /* if needed, send initial wireup message */
     if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
         ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
@@ -1212,19 +1262,7 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
     status = UCS_OK;
 
 out_resolve_remote_id:
-    if ((context->config.ext.resolve_remote_ep_id == UCS_CONFIG_ON) ||
-        ((context->config.ext.resolve_remote_ep_id == UCS_CONFIG_AUTO) &&
-         (ep_init_flags & UCP_EP_INIT_ERR_MODE_FAILOVER_MASK) &&
-         ucp_worker_keepalive_is_enabled(worker))) {
-        /* If resolving remote ID forced by configuration or PEER_FAILURE
-         * and keepalive were requested, resolve remote endpoint ID prior to
-         * communicating with a peer to make sure that remote peer's endpoint
-         * won't be changed during runtime */
-        status = ucp_ep_resolve_remote_id(ep, ep->am_lane);
-        if (ucs_unlikely(status != UCS_OK)) {
-            goto out_free_address;
-        }
-    }
+    status = ucp_ep_resolve_remote_id_on_create(ep, ep_init_flags);
 out_free_address:
     ucs_free(remote_address.address_list);
 out:
@@ -1254,15 +1292,14 @@ static void ucp_ep_params_check_err_handling(ucp_ep_h ep,
              "keepalive and indirect id", ep);
 }
 
-ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
-                           ucp_ep_h *ep_p)
+static ucs_status_t ucp_ep_create_api(ucp_worker_h worker,
+                                      const ucp_ep_params_t *params,
+                                      ucp_ep_h *ep_p)
 {
     ucp_ep_h ep    = NULL;
     unsigned flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
     ucs_status_t status;
 
-    UCS_ASYNC_BLOCK(&worker->async);
-
     if (flags & UCP_EP_PARAMS_FLAGS_CLIENT_SERVER) {
         status = ucp_ep_create_to_sock_addr(worker, params, &ep);
     } else if (params->field_mask & UCP_EP_PARAM_FIELD_CONN_REQUEST) {
@@ -1292,10 +1329,139 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
     }
     ++worker->counters.ep_creations;
 
+    return status;
+}
+
+ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
+                           ucp_ep_h *ep_p)
+{
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    status = ucp_ep_create_api(worker, params, ep_p);
     UCS_ASYNC_UNBLOCK(&worker->async);
+
+    return status;
+}
+
+static void
+ucp_ep_create_bulk_complete_one(ucp_request_t *req, ucs_status_t status)
+{
+    if (status != UCS_OK) {
+        req->status = status;
+    }
+
+    if (--req->ep_bulk.comp_count == 0) {
+        ucp_request_complete(req, ep_bulk.cb, req->status, req->user_data);
+    }
+}
+
+static void ucp_ep_create_bulk_flushed_cb(ucp_request_t *req)
+{
+    ucp_ep_create_bulk_complete_one(ucp_request_get_super(req), req->status);
+    ucp_request_put(req);
+}
+
+static ucs_status_t
+ucp_ep_create_bulk_eps(ucp_worker_h worker, const ucp_ep_params_t *params,
+                       unsigned count, ucp_ep_h *eps)
+{
+    ucs_status_t status;
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        status = ucp_ep_create_api(worker, &params[i], &eps[i]);
+        if (status != UCS_OK) {
+            goto err_close_eps;
+        }
+    }
+
+    return UCS_OK;
+
+err_close_eps:
+    while (i-- > 0) {
+        ucp_ep_update_flags(eps[i], UCP_EP_FLAG_CLOSED, 0);
+        ucp_ep_disconnected(eps[i], 0);
+    }
     return status;
 }
 
+ucs_status_ptr_t ucp_ep_create_bulk_nbx(ucp_worker_h worker,
+                                        const ucp_ep_params_t *params,
+                                        unsigned count, ucp_ep_h *eps,
+                                        const ucp_request_param_t *param)
+{
+    ucs_status_ptr_t ret, flush_req;
+    ucs_status_t status;
+    ucp_request_t *req;
+    unsigned i;
+
+    for (i = 0; i < count; ++i) {
+        if (!(params[i].field_mask & UCP_EP_PARAM_FIELD_REMOTE_ADDRESS) ||
+            (params[i].field_mask & UCP_EP_PARAM_FIELD_CONN_REQUEST) ||
+            (UCP_PARAM_VALUE(EP, &params[i], flags, FLAGS, 0) &
+             UCP_EP_PARAMS_FLAGS_CLIENT_SERVER)) {
+            ucs_error("endpoint %u: only worker address is supported by bulk "
+                      "endpoint creation", i);
+            return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
+        }
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    req = ucp_request_get_param(worker, param, {
+        ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
+        goto out;
+    });
+
+    status = ucp_ep_create_bulk_eps(worker, params, count, eps);
+    if (status != UCS_OK) {
+        ucp_request_put_param(param, req);
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
+    req->flags              = 0;
+    req->status             = UCS_OK;
+    req->ep_bulk.comp_count = 1; /* counting starts from 1, and decremented
+                                    when all the flush operations are started */
+
+    /* Wireup messages were sent to all the peers, now wait for all the
+     * endpoints to be connected. Endpoint flush is completed when all of its
+     * lanes are connected. */
+    for (i = 0; i < count; ++i) {
+        if (eps[i]->flags & UCP_EP_FLAG_LAZY) {
+            continue;
+        }
+
+        flush_req = ucp_ep_flush_internal(eps[i], UCP_REQUEST_FLAG_RELEASED,
+                                          &ucp_request_null_param, req,
+                                          ucp_ep_create_bulk_flushed_cb,
+                                          "ep_create_bulk",
+                                          UCT_FLUSH_FLAG_LOCAL);
+        if (UCS_PTR_IS_PTR(flush_req)) {
+            ++req->ep_bulk.comp_count;
+        } else if (UCS_PTR_IS_ERR(flush_req)) {
+            req->status = UCS_PTR_STATUS(flush_req);
+        }
+    }
+
+    if (req->ep_bulk.comp_count == 1) {
+        /* All the endpoints are already connected */
+        req->flags |= UCP_REQUEST_FLAG_COMPLETED;
+        UCS_ASYNC_UNBLOCK(&worker->async);
+        ucp_request_imm_cmpl_param(param, req, send);
+    }
+
+    ucp_request_set_send_callback_param(param, req, ep_bulk);
+    ucp_ep_create_bulk_complete_one(req, UCS_OK);
+    ret = req + 1;
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return ret;
+}
+
 ucs_status_ptr_t ucp_ep_modify_nb(ucp_ep_h ep, const ucp_ep_params_t *params)
 {
     ucp_worker_h worker = ep->worker;
@@ -3891,6 +4057,7 @@ err:
 void ucp_ep_config_cleanup(ucp_worker_h worker, ucp_ep_config_t *config)
 {
     ucp_proto_select_cleanup(&config->proto_select);
+    ucs_free(config->cm_server_addr.buffer);
     ucs_free(config->key.dst_md_cmpts);
 }
 
@@ -4174,6 +4341,8 @@ static void ucp_ep_print_info_internal(ucp_ep_h ep, const char *name,
     fprintf(stream, "# UCP endpoint %s\n", name);
     fprintf(stream, "#\n");
     fprintf(stream, "#               peer: %s\n", ucp_ep_peer_name(ep));
+    fprintf(stream, "#             memory: %zu bytes\n",
+            ucp_ep_memory_usage(ep));
 
     /* if there is a wireup lane, set aux_rsc_index to the stub ep resource */
     aux_rsc_index   = UCP_NULL_RESOURCE;
@@ -4740,8 +4909,8 @@ ucp_ep_select_short_init(ucp_worker_h worker, ucp_worker_cfg_index_t cfg_index,
     max_eager_short->memtype_on  = proto_short.max_length_host_mem;
 }
 
-static void ucp_ep_config_proto_init(ucp_worker_h worker,
-                                     ucp_worker_cfg_index_t cfg_index)
+void ucp_ep_config_proto_short_init(ucp_worker_h worker,
+                                    ucp_worker_cfg_index_t cfg_index)
 {
     ucp_ep_config_t *ep_config = ucp_worker_ep_config(worker, cfg_index);
     ucp_ep_config_key_t *key   = &ep_config->key;
@@ -4749,14 +4918,6 @@ static void ucp_ep_config_proto_init(ucp_worker_h worker,
     ucp_lane_index_t tag_exp_lane;
     unsigned tag_proto_flags;
 
-    /* Do protocol init once per EP config and only for protov2 */
-    if ((!worker->context->config.ext.proto_enable) ||
-        (ep_config->proto_init_flags & UCP_EP_PROTO_INITIALIZED)) {
-        return;
-    }
-
-    ep_config->proto_init_flags |= UCP_EP_PROTO_INITIALIZED;
-
     if (ucp_ep_config_key_has_tag_lane(key)) {
         tag_proto_flags = UCP_PROTO_FLAG_TAG_SHORT;
         tag_max_short   = &ep_config->tag.offload.max_eager_short;
@@ -4782,6 +4943,21 @@ static void ucp_ep_config_proto_init(ucp_worker_h worker,
                              &ep_config->am_u.max_reply_eager_short);
 }
 
+static void ucp_ep_config_proto_init(ucp_worker_h worker,
+                                     ucp_worker_cfg_index_t cfg_index)
+{
+    ucp_ep_config_t *ep_config = ucp_worker_ep_config(worker, cfg_index);
+
+    /* Do protocol init once per EP config and only for protov2 */
+    if ((!worker->context->config.ext.proto_enable) ||
+        (ep_config->proto_init_flags & UCP_EP_PROTO_INITIALIZED)) {
+        return;
+    }
+
+    ep_config->proto_init_flags |= UCP_EP_PROTO_INITIALIZED;
+    ucp_ep_config_proto_short_init(worker, cfg_index);
+}
+
 void ucp_ep_set_cfg_index(ucp_ep_h ep, ucp_worker_cfg_index_t cfg_index,
                           int reactivate)
 {
@@ -4796,6 +4972,38 @@ void ucp_ep_set_cfg_index(ucp_ep_h ep, ucp_worker_cfg_index_t cfg_index,
     ucp_ep_config_proto_init(ep->worker, cfg_index);
 }
 
+void ucp_ep_release_cfg_index(ucp_ep_h ep)
+{
+    ucs_trace("ep %p: release cfg_index %u", ep, ep->cfg_index);
+    ucp_ep_config_deactivate_worker_ifaces(ep->worker, ep->cfg_index);
+    ep->cfg_index = UCP_WORKER_CFG_INDEX_NULL;
+    ep->am_lane   = UCP_NULL_LANE;
+}
+
+size_t ucp_ep_memory_usage(ucp_ep_h ep)
+{
+    ucp_ep_ext_t *ep_ext = ep->ext;
+    size_t usage         = sizeof(*ep) + sizeof(*ep_ext);
+
+    if ((ep_ext->uct_eps != NULL) &&
+        (ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL)) {
+        usage += (ucp_ep_num_lanes(ep) - UCP_MAX_FAST_PATH_LANES) *
+                 sizeof(*ep_ext->uct_eps);
+    }
+
+    if (ep_ext->peer_mem != NULL) {
+        usage += sizeof(*ep_ext->peer_mem) +
+                 (kh_n_buckets(ep_ext->peer_mem) *
+                  (sizeof(uint64_t) + sizeof(ucp_ep_peer_mem_data_t)));
+    }
+
+    if (!ucp_ep_has_cm_lane(ep) && (ep_ext->recovery_arg != NULL)) {
+        usage += sizeof(*ep_ext->recovery_arg);
+    }
+
+    return usage + ucp_am_ep_memory_usage(ep);
+}
+
 unsigned ucp_ep_err_mode_init_flags(ucp_err_handling_mode_t err_mode)
 {
     switch (err_mode) {
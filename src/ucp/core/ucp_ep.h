@@ -104,7 +104,8 @@ enum {
                                                         while merging pending queues */
     UCP_EP_FLAG_CONNECT_PRE_REQ_QUEUED = UCS_BIT(9), /* Pre-Connection request was queued */
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
-    /* 11 bit is vacant for a flag */
+    UCP_EP_FLAG_LAZY                   = UCS_BIT(11),/* EP is not connected yet, and its
+                                                        only lane is a lazy endpoint */
     UCP_EP_FLAG_ERR_HANDLER_INVOKED    = UCS_BIT(12),/* error handler was called */
     UCP_EP_FLAG_INTERNAL               = UCS_BIT(13),/* the internal EP which holds
                                                         temporary wireup configuration or
@@ -143,6 +144,19 @@ enum {
 };
 
 
+/**
+ * UCP endpoint request completion latency histograms
+ */
+enum {
+    UCP_EP_STAT_LAT_TAG,
+    UCP_EP_STAT_LAT_AM,
+    UCP_EP_STAT_LAT_RMA,
+    UCP_EP_STAT_LAT_STREAM,
+    UCP_EP_STAT_LAT_RNDV,
+    UCP_EP_STAT_LAT_LAST
+};
+
+
 /**
  * Endpoint init flags
  */
@@ -170,6 +184,9 @@ enum {
     UCP_EP_INIT_ERR_MODE_FAILOVER      = UCS_BIT(11), /**< Endpoint requires an
                                                            @ref UCP_ERR_HANDLING_MODE_FAILOVER */
     UCP_EP_INIT_RECOVERY               = UCS_BIT(12),
+    UCP_EP_INIT_LAZY_LANES             = UCS_BIT(13), /**< Defer connecting RMA lanes to
+                                                           remote interfaces until their
+                                                           first use */
 
     /**
      * For consistency with @ref UCP_SA_DATA_MASK_ERR_MODE_FAILOVER
@@ -476,6 +493,18 @@ struct ucp_ep_config {
     /* EP initialization flags from @ref ucp_ep_init_flags_t */
     unsigned                      proto_init_flags;
 
+    /* Worker address sent by server side CM endpoints with this configuration.
+     * Valid only if there are no p2p lanes, since otherwise the address
+     * contains the endpoint addresses. */
+    struct {
+        void                      *buffer;
+        size_t                    length;
+        ucp_tl_bitmap_t           tl_bitmap;
+        unsigned                  pack_flags;
+        unsigned                  max_num_paths;
+        uint64_t                  epoch; /* Worker epoch of the address */
+    } cm_server_addr;
+
     /* Number of endpoints using this configuration */
     unsigned                      ep_count;
 };
@@ -559,10 +588,11 @@ typedef struct ucp_ep_ext {
     } stream;
 
     struct {
-        ucs_list_link_t           started_ams;
-        ucs_queue_head_t          mid_rdesc_q;    /* Queue of middle fragments, which
-                                                     arrived before the first one */
+        ucp_am_ep_frags_t         *frags;         /* Reassembly state of
+                                                     fragmented messages */
         uint64_t                  psn;
+        ucp_am_coalesce_frame_t   *coalesce;      /* Frame of coalesced
+                                                     messages to send */
     } am;
 
     ucp_lane_map_t                unflushed_lanes; /* Bitmap of lanes which have
@@ -750,6 +780,9 @@ ucp_ep_create_to_worker_addr(ucp_worker_h worker,
                              unsigned ep_init_flags, const char *message,
                              unsigned *addr_indices, ucp_ep_h *ep_p);
 
+ucs_status_t ucp_ep_resolve_remote_id_on_create(ucp_ep_h ep,
+                                                unsigned ep_init_flags);
+
 ucs_status_t ucp_ep_create_server_accept(ucp_worker_h worker,
                                          const ucp_conn_request_h conn_request,
                                          ucp_ep_h *ep_p);
@@ -767,6 +800,9 @@ void ucp_ep_config_key_set_err_mode(ucp_ep_config_key_t *key,
 void ucp_ep_config_key_init_flags(ucp_ep_config_key_t *key,
                                   unsigned ep_init_flags);
 
+void ucp_ep_config_proto_short_init(ucp_worker_h worker,
+                                    ucp_worker_cfg_index_t cfg_index);
+
 void ucp_ep_err_pending_purge(uct_pending_req_t *self, void *arg);
 
 void ucp_destroyed_ep_pending_purge(uct_pending_req_t *self, void *arg);
@@ -981,6 +1017,31 @@ void ucp_ep_set_cfg_index(ucp_ep_h ep, ucp_worker_cfg_index_t cfg_index,
                           int reactivate);
 
 
+/**
+ * @brief Reset the configuration index of the endpoint.
+ *
+ * Deactivates UCP worker interfaces of the current endpoint configuration, and
+ * leaves the endpoint without configuration, so that its lanes can be
+ * initialized from scratch.
+ *
+ * @param [in] ep         Endpoint object.
+ */
+void ucp_ep_release_cfg_index(ucp_ep_h ep);
+
+
+/**
+ * @brief Get the memory used by the endpoint.
+ *
+ * Sums the endpoint object, its extension and the state which is allocated on
+ * demand, such as slow-path lanes, peer memory hash and AM reassembly state.
+ *
+ * @param [in] ep         Endpoint object.
+ *
+ * @return Number of bytes allocated for the endpoint.
+ */
+size_t ucp_ep_memory_usage(ucp_ep_h ep);
+
+
 /**
  * @brief Progress function for memory specific remote flushing.
  *
@@ -1069,6 +1130,7 @@ ucs_status_t ucp_ep_failover_reconfig(ucp_ep_h ucp_ep,
  */
 ucs_status_t ucp_ep_update_rkey_config(ucp_ep_h ep, ucp_rkey_h rkey);
 
-ucs_status_t ucp_stub_iface_open(ucs_status_t status, uct_iface_h *iface_p);
+ucs_status_t ucp_stub_iface_open(ucs_status_t status, const uct_iface_ops_t *ops,
+                                uct_iface_h *iface_p);
 
 #endif
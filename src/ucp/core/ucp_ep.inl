@@ -331,4 +331,31 @@ static UCS_F_ALWAYS_INLINE ucp_lane_map_t ucp_ep_get_live_lanes(ucp_ep_h ep)
     return lane_map;
 }
 
+/**
+ * Start time of an operation which is sent inline, without a request, or 0
+ * if the endpoint does not collect statistics.
+ */
+static UCS_F_ALWAYS_INLINE ucs_time_t ucp_ep_stats_lat_start(ucp_ep_h ep)
+{
+#ifdef ENABLE_STATS
+    if (UCS_STATS_NODE_VALID(ep->stats)) {
+        return ucs_get_time();
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Account the latency of an operation which was sent inline, if it was
+ * completed.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_ep_stats_lat_inline(ucp_ep_h ep, unsigned lat_index, ucs_time_t start_time,
+                        ucs_status_t status)
+{
+    if (status == UCS_OK) {
+        UCS_STATS_UPDATE_HISTOGRAM_TIME(ep->stats, lat_index, start_time);
+    }
+}
+
 #endif
@@ -47,6 +47,14 @@ static void ucp_ep_vfs_read_peer_name(void *obj, ucs_string_buffer_t *strb,
     ucs_string_buffer_appendf(strb, "%s\n", ucp_ep_peer_name(ep));
 }
 
+static void ucp_ep_vfs_read_memory_usage(void *obj, ucs_string_buffer_t *strb,
+                                         void *arg_ptr, uint64_t arg_u64)
+{
+    ucp_ep_h ep = obj;
+
+    ucs_string_buffer_appendf(strb, "%zu\n", ucp_ep_memory_usage(ep));
+}
+
 static ucs_status_t ucp_ep_vfs_query_sockaddr(ucp_ep_h ep, ucp_ep_attr_t *attr,
                                               uint64_t field_mask,
                                               ucs_string_buffer_t *strb)
@@ -124,6 +132,8 @@ void ucp_ep_vfs_init(ucp_ep_h ep)
 
     ucs_vfs_obj_add_ro_file(ep, ucp_ep_vfs_read_peer_name, NULL, 0,
                             "peer_name");
+    ucs_vfs_obj_add_ro_file(ep, ucp_ep_vfs_read_memory_usage, NULL, 0,
+                            "memory_usage");
 
     err_mode = ucp_ep_config(ep)->key.err_mode;
     ucs_vfs_obj_add_ro_file(ep, ucs_vfs_show_primitive,
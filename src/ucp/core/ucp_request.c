@@ -338,6 +338,12 @@ int ucp_request_pending_add(ucp_request_t *req)
         ucs_trace_data("ep %p: added pending uct request %p to lane[%d]=%p",
                        req->send.ep, req, req->send.lane, uct_ep);
         req->send.pending_lane = req->send.lane;
+        if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TUNE) &&
+            (req->send.state.dt_iter.offset == 0)) {
+            /* The request waits for resources before it sends any data, so
+             * its completion time does not reflect the protocol performance */
+            ucp_proto_tune_cancel(req);
+        }
         return 1;
     } else if (status == UCS_ERR_BUSY) {
         /* Could not add, try to send again */
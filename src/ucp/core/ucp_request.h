@@ -69,7 +69,8 @@ enum {
     UCP_REQUEST_FLAG_RNDV_SEND_INTERNAL    = UCS_BIT(26),
     UCP_REQUEST_FLAG_RNDV_GET_REQ          = UCS_BIT(27),
     UCP_REQUEST_FLAG_RNDV_FLUSH            = UCS_BIT(28),
-    UCP_REQUEST_FLAG_RNDV_START_FLUSH      = UCS_BIT(29)
+    UCP_REQUEST_FLAG_RNDV_START_FLUSH      = UCS_BIT(29),
+    UCP_REQUEST_FLAG_PROTO_TUNE            = UCS_BIT(30)
 };
 
 
@@ -112,8 +113,13 @@ enum {
                                                          because UCT AM callback is still in
                                                          the call stack and descriptor is not
                                                          initialized yet. */
-    UCP_RECV_DESC_FLAG_RELEASED         = UCS_BIT(10) /* Indicates that the descriptor was
-                                                         released and cannot be used. */
+    UCP_RECV_DESC_FLAG_RELEASED         = UCS_BIT(10), /* Indicates that the descriptor was
+                                                          released and cannot be used. */
+    UCP_RECV_DESC_FLAG_AM_USER_BUFFER   = UCS_BIT(11), /* Multi-fragment AM is assembled in
+                                                          a buffer provided by the user. */
+    UCP_RECV_DESC_FLAG_AM_USER_POOL     = UCS_BIT(12) /* Multi-fragment AM is assembled in
+                                                         a buffer from the user AM buffer
+                                                         pool. */
 };
 
 
@@ -326,7 +332,13 @@ struct ucp_request {
                                 /* Used by rndv/send/ppln and rndv/recv/ppln */
                                 struct {
                                     /* Size to send in ack message */
-                                    ssize_t ack_data_size;
+                                    ssize_t  ack_data_size;
+
+                                    /* Number of fragments in flight */
+                                    uint32_t num_inflight;
+
+                                    /* Pipeline state flags */
+                                    uint8_t  flags;
                                 } ppln;
 
                                 /* Used by rndv/rkey_ptr */
@@ -425,6 +437,13 @@ struct ucp_request {
             ucp_lane_index_t      lane;            /* Lane on which this request is being sent */
             uint8_t               proto_stage;     /* Protocol current stage */
             uct_pending_req_t     uct;             /* UCT pending request */
+#ifdef ENABLE_STATS
+            struct {
+                ucs_time_t        start_time;      /* Request start time */
+                uint8_t           lat_index;       /* Latency histogram index,
+                                                    * or UCP_EP_STAT_LAT_LAST */
+            } stats;
+#endif
         } send;
 
         /* "receive" part - used for tag_recv, am_recv and stream_recv operations */
@@ -507,6 +526,11 @@ struct ucp_request {
             int                     comp_count;   /* Countdown to request completion */
             unsigned                uct_flags;    /* Flags to pass to @ref uct_ep_flush */
         } flush_worker;
+
+        struct {
+            ucp_send_nbx_callback_t cb;           /* Completion callback */
+            int                     comp_count;   /* Countdown to request completion */
+        } ep_bulk;
     };
 };
 
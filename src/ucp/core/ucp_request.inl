@@ -13,6 +13,7 @@
 #include "ucp_mm.inl"
 
 #include <ucp/dt/dt.h>
+#include <ucp/proto/proto_tune.h>
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/mpool_set.inl>
@@ -285,6 +286,19 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+#ifdef ENABLE_STATS
+    if ((req->flags & UCP_REQUEST_FLAG_PROTO_SEND) &&
+        (req->send.stats.lat_index != UCP_EP_STAT_LAT_LAST) &&
+        (status == UCS_OK)) {
+        UCS_STATS_UPDATE_HISTOGRAM_TIME(req->send.ep->stats,
+                                        req->send.stats.lat_index,
+                                        req->send.stats.start_time);
+    }
+#endif
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_PROTO_TUNE) &&
+        (status == UCS_OK)) {
+        ucp_proto_tune_sample(req);
+    }
     /* Coverity wrongly resolves completion callback function to
      * 'ucp_cm_client_connect_progress'/'ucp_cm_server_conn_request_progress'
      */
@@ -77,6 +77,8 @@ typedef struct ucp_ep_config_key      ucp_ep_config_key_t;
 typedef struct ucp_rkey_config_key    ucp_rkey_config_key_t;
 typedef struct ucp_proto              ucp_proto_t;
 typedef struct ucp_mem_desc           ucp_mem_desc_t;
+typedef struct ucp_am_coalesce_frame  ucp_am_coalesce_frame_t;
+typedef struct ucp_am_ep_frags        ucp_am_ep_frags_t;
 
 
 /**
@@ -204,6 +206,10 @@ typedef enum {
                                           carrying remote ep and PSN for
                                           tracking */
     UCP_AM_ID_AM_MIDDLE_PSN     =  28,
+    UCP_AM_ID_AM_COALESCED      =  29, /* Frame of several coalesced single
+                                          fragment user defined AMs */
+    UCP_AM_ID_RNDV_DATA_COMPRESSED = 30, /* Rndv data fragment, compressed
+                                            by the sender */
     UCP_AM_ID_LAST
 } ucp_am_id_t;
 
@@ -247,6 +253,16 @@ typedef enum {
 } ucp_rndv_mode_t;
 
 
+/**
+ * Distribution of message fragments between the lanes of a multi-lane protocol.
+ */
+typedef enum {
+    UCP_MULTI_LANE_STRIPING_STATIC,  /* By configured lane bandwidth ratios */
+    UCP_MULTI_LANE_STRIPING_DYNAMIC, /* By observed lane congestion */
+    UCP_MULTI_LANE_STRIPING_LAST
+} ucp_multi_lane_striping_t;
+
+
 /* Versions enumeration used for various UCP objects (e.g. ucp worker address,
  * sockaddr data structure, etc).
  */
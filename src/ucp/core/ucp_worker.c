@@ -18,6 +18,7 @@
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_common.inl>
 #include <ucp/wireup/address.h>
+#include <ucp/wireup/lazy_ep.h>
 #include <ucp/wireup/wireup_cm.h>
 #include <ucp/wireup/wireup_ep.h>
 #include <ucp/wireup/wireup_lane_info.h>
@@ -1420,6 +1421,8 @@ ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
     wiface->proxy_recv_count = 0;
     wiface->post_count       = 0;
     wiface->flags            = 0;
+    wiface->stripe_factor    = 1.0;
+    wiface->stripe_bytes     = 0;
 
     /* Read interface or md configuration */
     status = uct_md_iface_config_read(md, resource->tl_rsc.tl_name, NULL, NULL,
@@ -2018,6 +2021,7 @@ static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
 
     /* Create a hashtable of memory pools for mem_type devices */
     kh_init_inplace(ucp_worker_mpool_hash, &worker->mpool_hash);
+    worker->rndv_ppln_inflight = 0;
 
     ucs_mpool_params_reset(&mp_params);
     mp_params.elem_size       = sizeof(ucp_request_t) +
@@ -2256,6 +2260,24 @@ ucp_worker_dump_rkey_config_key(ucs_string_buffer_t *log_strb,
             ucs_memory_type_names[key->mem_type], key->unreachable_md_map);
 }
 
+void ucp_worker_rkey_config_short_init(ucp_worker_h worker,
+                                       ucp_worker_cfg_index_t rkey_cfg_index)
+{
+    ucp_rkey_config_t *rkey_config = &ucs_array_elem(&worker->rkey_config,
+                                                     rkey_cfg_index);
+
+    /* Set threshold for short put */
+    if (worker->context->config.features & UCP_FEATURE_RMA) {
+        ucp_proto_select_short_init(worker, &rkey_config->proto_select,
+                                    rkey_config->key.ep_cfg_index,
+                                    rkey_cfg_index, UCP_OP_ID_PUT,
+                                    UCP_PROTO_FLAG_PUT_SHORT,
+                                    &rkey_config->put_short);
+    } else {
+        ucp_proto_select_short_disable(&rkey_config->put_short);
+    }
+}
+
 ucs_status_t
 ucp_worker_add_rkey_config(ucp_worker_h worker,
                            const ucp_rkey_config_key_t *key,
@@ -2344,16 +2366,7 @@ ucp_worker_add_rkey_config(ucp_worker_h worker,
 
     *cfg_index_p = rkey_cfg_index;
 
-    /* Set threshold for short put */
-    if (worker->context->config.features & UCP_FEATURE_RMA) {
-        ucp_proto_select_short_init(worker, &rkey_config->proto_select,
-                                    key->ep_cfg_index, rkey_cfg_index,
-                                    UCP_OP_ID_PUT, UCP_PROTO_FLAG_PUT_SHORT,
-                                    &rkey_config->put_short);
-    } else {
-        ucp_proto_select_short_disable(&rkey_config->put_short);
-    }
-
+    ucp_worker_rkey_config_short_init(worker, rkey_cfg_index);
     return UCS_OK;
 
 err_kh_del:
@@ -2490,6 +2503,18 @@ void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
     ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
                             &worker->counters.ep_failures, UCS_VFS_TYPE_ULONG,
                             "counters/ep_failures");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.lanes_select_cache_hits,
+                            UCS_VFS_TYPE_ULONG,
+                            "counters/lanes_select_cache_hits");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.cm_server_addr_reuses,
+                            UCS_VFS_TYPE_ULONG,
+                            "counters/cm_server_addr_reuses");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.rndv_ppln_max_inflight,
+                            UCS_VFS_TYPE_ULONG,
+                            "counters/rndv_ppln_max_inflight");
 }
 
 static void ucp_worker_set_max_am_header(ucp_worker_h worker)
@@ -2634,10 +2659,13 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     kh_init_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     kh_init_inplace(ucp_worker_discard_uct_ep_hash, &worker->discard_uct_ep_hash);
     kh_init_inplace(ucp_worker_remote_flush, &worker->remote_flush_hash);
-    worker->counters.ep_creations         = 0;
-    worker->counters.ep_creation_failures = 0;
-    worker->counters.ep_closures          = 0;
-    worker->counters.ep_failures          = 0;
+    worker->counters.ep_creations            = 0;
+    worker->counters.ep_creation_failures    = 0;
+    worker->counters.ep_closures             = 0;
+    worker->counters.ep_failures             = 0;
+    worker->counters.lanes_select_cache_hits = 0;
+    worker->counters.cm_server_addr_reuses   = 0;
+    worker->counters.rndv_ppln_max_inflight  = 0;
 
     /* Copy user flags, and mask-out unsupported flags for compatibility */
     worker->flags = UCP_PARAM_VALUE(WORKER, params, flags, FLAGS, 0) &
@@ -2759,6 +2787,9 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     ucs_conn_match_init(&worker->conn_match_ctx, sizeof(uint64_t),
                         UCP_EP_MATCH_CONN_SN_MAX, &ucp_ep_match_ops);
 
+    /* Initialize lanes selection cache, used also by memory type endpoints */
+    ucp_wireup_select_cache_init(worker);
+
     /* Open all resources as interfaces on this worker */
     status = ucp_worker_add_resource_ifaces(worker);
     if (status != UCS_OK) {
@@ -2817,6 +2848,9 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_am_cleanup;
     }
 
+    ucp_proto_tune_init(worker);
+    ucp_proto_cache_init(worker);
+
     *worker_p = worker;
     return UCS_OK;
 
@@ -2833,6 +2867,7 @@ err_close_cms:
 err_close_ifaces:
     ucp_worker_close_ifaces(worker);
 err_conn_match_cleanup:
+    ucp_wireup_select_cache_cleanup(worker);
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
     ucp_worker_wakeup_cleanup(worker);
 err_destroy_uct_worker:
@@ -3092,6 +3127,10 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_vfs_obj_remove(worker);
     ucp_tag_match_cleanup(&worker->tm);
     ucp_worker_destroy_mpools(worker);
+    /* The endpoint fingerprints of the saved protocol selections use the
+     * interface attributes */
+    ucp_proto_cache_cleanup(worker);
+    ucp_proto_tune_cleanup(worker);
     ucp_worker_close_cms(worker);
     ucp_worker_close_ifaces(worker);
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
@@ -3107,7 +3146,9 @@ void ucp_worker_destroy(ucp_worker_h worker)
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_remote_flush, &worker->remote_flush_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
+    ucp_wireup_select_cache_cleanup(worker);
     ucp_worker_destroy_configs(worker);
+    ucs_free(worker->address_template.buffer);
     ucs_free(worker);
 }
 
@@ -3121,6 +3162,9 @@ static ucs_status_t ucp_worker_address_pack(ucp_worker_h worker,
     ucp_tl_bitmap_t tl_bitmap;
     ucp_rsc_index_t tl_id;
     const uct_iface_attr_t *iface_attr;
+    ucs_status_t status;
+    size_t length;
+    void *address;
 
     /* Make sure that UUID is packed to the address intended for the user,
      * because ucp_worker_address_query routine assumes that uuid is always
@@ -3140,9 +3184,20 @@ static ucs_status_t ucp_worker_address_pack(ucp_worker_h worker,
         UCS_STATIC_BITMAP_SET_ALL(&tl_bitmap);
     }
 
-    return ucp_address_pack(worker, NULL, &tl_bitmap, flags,
-                            context->config.ext.worker_addr_version, NULL,
-                            UINT_MAX, address_length_p, (void**)address_p);
+    status = ucp_address_pack(worker, NULL, &tl_bitmap, flags,
+                              context->config.ext.worker_addr_version, NULL,
+                              UINT_MAX, &length, &address);
+    if ((status != UCS_OK) ||
+        !(address_flags & UCP_WORKER_ADDRESS_FLAG_COMPACT)) {
+        *address_length_p = length;
+        *address_p        = address;
+        return status;
+    }
+
+    status = ucp_address_compact(worker, address, length, address_length_p,
+                                 address_p);
+    ucs_free(address);
+    return status;
 }
 
 ucs_status_t ucp_worker_query(ucp_worker_h worker,
@@ -3178,6 +3233,19 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
     return status;
 }
 
+ucs_status_t ucp_worker_set_address_template(ucp_worker_h worker,
+                                             const ucp_address_t *address,
+                                             size_t address_length)
+{
+    ucs_status_t status;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    status = ucp_address_set_template(worker, address, address_length);
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    return status;
+}
+
 ucs_status_t ucp_worker_address_query(ucp_address_t *address,
                                       ucp_worker_address_attr_t *attr)
 {
@@ -3856,6 +3924,12 @@ ucs_status_t ucp_worker_discard_uct_ep(ucp_ep_h ucp_ep, uct_ep_h uct_ep,
 
     uct_ep_pending_purge(uct_ep, purge_cb, purge_arg);
 
+    if (ucp_lazy_ep_test(uct_ep)) {
+        /* Lazy endpoint has no transport resources to flush */
+        uct_ep_destroy(uct_ep);
+        return UCS_OK;
+    }
+
     if (ucp_wireup_ep_test(uct_ep)) {
         uct_ep = ucp_worker_discard_wireup_ep(ucp_ep, ucp_wireup_ep(uct_ep),
                                               ep_flush_flags);
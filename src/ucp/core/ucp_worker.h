@@ -14,7 +14,9 @@
 #include "ucp_rkey.h"
 
 #include <ucp/core/ucp_am.h>
+#include <ucp/proto/proto_cache.h>
 #include <ucp/tag/tag_match.h>
+#include <ucp/wireup/select_cache.h>
 #include <ucs/datastruct/mpool.h>
 #include <ucs/datastruct/mpool_set.h>
 #include <ucs/datastruct/queue_types.h>
@@ -275,6 +277,12 @@ struct ucp_worker_iface {
                                                     offloaded to the transport */
     uint8_t                       flags;         /* Interface flags */
     uint8_t                       port_speed;    /* Quantized port speed */
+    double                        stripe_factor; /* Fragment size factor for
+                                                    dynamic multi-lane striping,
+                                                    decreased by congestion */
+    uint64_t                      stripe_bytes;  /* Bytes sent on this
+                                                    interface by dynamic
+                                                    multi-lane striping */
 };
 
 
@@ -344,6 +352,8 @@ typedef struct ucp_worker {
     ucs_mpool_set_t                  am_mps;              /* Memory pool set for AM receives */
     ucs_mpool_t                      reg_mp;              /* Registered memory pool */
     ucp_worker_mpool_hash_t          mpool_hash;          /* Hash table of memory pools */
+    size_t                           rndv_ppln_inflight;  /* Number of rndv pipeline
+                                                             fragments in flight */
     ucs_queue_head_t                 rkey_ptr_reqs;       /* Queue of submitted RKEY PTR requests that
                                                            * are in-progress */
     uct_worker_cb_id_t               rkey_ptr_cb_id;      /* RKEY PTR worker callback queue ID */
@@ -394,6 +404,13 @@ typedef struct ucp_worker {
         uint64_t                     ep_closures;
         /* Number of failed endpoints */
         uint64_t                     ep_failures;
+        /* Number of lanes selections found in the cache */
+        uint64_t                     lanes_select_cache_hits;
+        /* Number of server CM endpoints which reused a packed address */
+        uint64_t                     cm_server_addr_reuses;
+        /* Maximal number of rndv pipeline fragments of a single message
+         * which were in flight at the same time */
+        uint64_t                     rndv_ppln_max_inflight;
     } counters;
 
     struct {
@@ -413,6 +430,22 @@ typedef struct ucp_worker {
      * speed change). A matching epoch is stored in @ref ucp_proto_select_t.
      * If epochs differ, the cached config is stale and must be updated. */
     uint64_t                         epoch;
+
+    /* Online protocol threshold tuning, see UCX_PROTO_TUNE */
+    ucp_proto_tune_ctx_t             proto_tune;
+
+    /* Protocol selections to precompute, see UCX_PROTO_CACHE_FILE */
+    ucp_proto_cache_t                proto_cache;
+
+    /* Lanes selections by remote address signature, see UCX_WIREUP_SELECT_CACHE */
+    ucp_wireup_select_cache_t        select_cache;
+
+    /* Template for compact worker addresses */
+    struct {
+        void                         *buffer;   /* Full template address */
+        size_t                       length;    /* Template address length */
+        uint32_t                     id;        /* Template checksum */
+    } address_template;
 } ucp_worker_t;
 
 
@@ -427,6 +460,9 @@ ucp_worker_add_rkey_config(ucp_worker_h worker,
                            const ucs_sys_dev_distance_t *lanes_distance,
                            ucp_worker_cfg_index_t *cfg_index_p);
 
+void ucp_worker_rkey_config_short_init(ucp_worker_h worker,
+                                       ucp_worker_cfg_index_t rkey_cfg_index);
+
 ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
                                    ucp_worker_iface_t **wiface);
 
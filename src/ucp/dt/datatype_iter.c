@@ -283,6 +283,60 @@ size_t ucp_datatype_iter_iov_next_iov(const ucp_datatype_iter_t *dt_iter,
     return dst_iov_index;
 }
 
+size_t ucp_datatype_iter_strided_next_iov(const ucp_datatype_iter_t *dt_iter,
+                                          size_t max_length,
+                                          ucp_rsc_index_t memh_index,
+                                          ucp_datatype_iter_t *next_iter,
+                                          uct_iov_t *iov, size_t max_iov)
+{
+    const ucp_dt_strided_t *dt_strided = dt_iter->type.strided.dt;
+    ucp_mem_h memh                     = dt_iter->type.strided.memh;
+    size_t block_size                  = dt_strided->block_size;
+    size_t offset                      = dt_iter->offset;
+    size_t end_offset, block_offset, length;
+    size_t dst_iov_index;
+    uct_mem_h uct_memh;
+    void *buffer;
+
+    ucs_assert(dt_iter->offset <= dt_iter->length);
+    end_offset = offset + ucs_min(max_length, dt_iter->length - offset);
+    uct_memh   = (memh == NULL) ? UCT_MEM_HANDLE_NULL :
+                 ucp_datatype_iter_uct_memh(memh, memh_index);
+
+    dst_iov_index = 0;
+    while (offset < end_offset) {
+        block_offset = offset % block_size;
+        buffer       = UCS_PTR_BYTE_OFFSET(
+                ucp_dt_strided_block_ptr(dt_strided,
+                                         dt_iter->type.strided.buffer,
+                                         offset / block_size),
+                block_offset);
+        length       = ucs_min(block_size - block_offset, end_offset - offset);
+
+        /* UCT does not support strides, so every block needs its own iov
+         * entry, unless it is adjacent to the previous one */
+        if ((dst_iov_index > 0) &&
+            (UCS_PTR_BYTE_OFFSET(iov[dst_iov_index - 1].buffer,
+                                 iov[dst_iov_index - 1].length) == buffer)) {
+            iov[dst_iov_index - 1].length += length;
+        } else if (dst_iov_index < max_iov) {
+            iov[dst_iov_index].buffer = buffer;
+            iov[dst_iov_index].length = length;
+            iov[dst_iov_index].memh   = uct_memh;
+            iov[dst_iov_index].stride = 0;
+            iov[dst_iov_index].count  = 1;
+            ++dst_iov_index;
+        } else {
+            break;
+        }
+
+        offset += length;
+    }
+
+    next_iter->offset = offset;
+    return dst_iov_index;
+}
+
 ucs_status_t ucp_datatype_iter_sgl_init(ucp_context_h context,
                                         ucp_datatype_iter_t *dt_iter,
                                         const ucp_dt_local_sgl_t *local,
@@ -442,6 +496,12 @@ void ucp_datatype_iter_str(const ucp_datatype_iter_t *dt_iter,
         ucs_string_buffer_appendf(strb, " buffer:%p",
                                   dt_iter->type.contig.buffer);
         break;
+    case UCP_DATATYPE_STRIDED:
+        ucs_string_buffer_appendf(strb, " buffer:%p block:%zu dims:%u",
+                                  dt_iter->type.strided.buffer,
+                                  dt_iter->type.strided.dt->block_size,
+                                  dt_iter->type.strided.dt->num_dims);
+        break;
     case UCP_DATATYPE_IOV:
         iov_index = 0;
         offset    = 0;
@@ -496,6 +556,16 @@ int ucp_datatype_iter_is_user_memh_valid(const ucp_datatype_iter_t *dt_iter,
             goto err_memh_mismatch;
         }
         break;
+    case UCP_DATATYPE_STRIDED:
+        if (!ucp_memh_is_buffer_in_range(
+                    memh, dt_iter->type.strided.buffer,
+                    ucp_datatype_iter_strided_span(dt_iter))) {
+            ucs_string_buffer_appendf(&err_msg, "[strided buffer %p span %zu]",
+                                      dt_iter->type.strided.buffer,
+                                      ucp_datatype_iter_strided_span(dt_iter));
+            goto err_memh_mismatch;
+        }
+        break;
     case UCP_DATATYPE_IOV:
         iov_count = ucp_datatype_iter_iov_count(dt_iter);
         if (!ucp_memh_is_iov_buffer_in_range(memh, dt_iter->type.iov.iov,
@@ -9,6 +9,7 @@
 
 #include "dt.h"
 #include "dt_generic.h"
+#include "dt_strided.h"
 
 #include <ucp/api/ucp.h>
 #include <ucp/core/ucp_mm.h>
@@ -28,11 +29,19 @@
     (UCS_BIT(UCP_DATATYPE_CONTIG) | UCS_BIT(UCP_DATATYPE_IOV))
 
 /*
- * dt_mask argument which contains contiguous, iov and generic datatypes
+ * dt_mask argument which contains datatypes that can be sent with zero-copy
+ */
+#define UCP_DT_MASK_ZCOPY \
+    (UCP_DT_MASK_CONTIG_IOV | UCS_BIT(UCP_DATATYPE_STRIDED))
+
+/*
+ * dt_mask argument which contains contiguous, strided, iov and generic
+ * datatypes
  */
 #define UCP_PROTO_DT_MASK_DEFAULT \
-    (UCS_BIT(UCP_DATATYPE_CONTIG) | \
-     UCS_BIT(UCP_DATATYPE_IOV)    | \
+    (UCS_BIT(UCP_DATATYPE_CONTIG)  | \
+     UCS_BIT(UCP_DATATYPE_STRIDED) | \
+     UCS_BIT(UCP_DATATYPE_IOV)     | \
      UCS_BIT(UCP_DATATYPE_GENERIC))
 
 
@@ -51,6 +60,12 @@ typedef struct {
             void                  *buffer;    /* Contiguous buffer pointer */
             ucp_mem_h             memh;       /* Memory registration handle */
         } contig;
+        struct {
+            void                  *buffer;    /* Strided buffer pointer */
+            const ucp_dt_strided_t *dt;       /* Strided datatype handle */
+            ucp_mem_h             memh;       /* Registration of the span */
+            /* length = packed length, offset = packed offset */
+        } strided;
         struct {
             void                  *buffer;    /* Buffer pointer, needed for restart */
             size_t                count;      /* Count, needed for restart */
@@ -109,6 +124,12 @@ size_t ucp_datatype_iter_iov_next_iov(const ucp_datatype_iter_t *dt_iter,
 
 size_t ucp_datatype_iter_iov_count(const ucp_datatype_iter_t *dt_iter);
 
+size_t ucp_datatype_iter_strided_next_iov(const ucp_datatype_iter_t *dt_iter,
+                                          size_t max_length,
+                                          ucp_rsc_index_t memh_index,
+                                          ucp_datatype_iter_t *next_iter,
+                                          uct_iov_t *iov, size_t max_iov);
+
 void ucp_datatype_iter_str(const ucp_datatype_iter_t *dt_iter,
                            ucs_string_buffer_t *strb);
 
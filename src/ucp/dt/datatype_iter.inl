@@ -102,6 +102,58 @@ ucp_datatype_contig_iter_init(ucp_context_h context, void *buffer,
     return UCS_OK;
 }
 
+static UCS_F_ALWAYS_INLINE size_t
+ucp_datatype_iter_strided_span(const ucp_datatype_iter_t *dt_iter)
+{
+    const ucp_dt_strided_t *dt_strided = dt_iter->type.strided.dt;
+    size_t num_blocks = ucs_div_round_up(dt_iter->length,
+                                         dt_strided->block_size);
+    void *last_block;
+
+    if (num_blocks == 0) {
+        return 0;
+    }
+
+    /* Blocks are laid out in increasing addresses, and the length may end in
+     * the middle of an element after the iterator was moved */
+    last_block = ucp_dt_strided_block_ptr(dt_strided,
+                                          dt_iter->type.strided.buffer,
+                                          num_blocks - 1);
+    return UCS_PTR_BYTE_DIFF(dt_iter->type.strided.buffer, last_block) +
+           dt_strided->block_size;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_datatype_strided_iter_init(ucp_context_h context, void *buffer,
+                               size_t count, ucp_datatype_t datatype,
+                               ucp_datatype_iter_t *dt_iter,
+                               const ucp_request_param_t *param)
+{
+    const ucp_dt_strided_t *dt_strided = ucp_dt_to_strided(datatype);
+    ucs_status_t status;
+
+    dt_iter->length              = ucp_dt_strided_length(dt_strided, count);
+    dt_iter->type.strided.buffer = buffer;
+    dt_iter->type.strided.dt     = dt_strided;
+
+    if (param->op_attr_mask & UCP_OP_ATTR_FIELD_MEMH) {
+        status = ucp_datatype_iter_init_mem_info_from_user_memh(dt_iter,
+                                                                param->memh);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        dt_iter->type.strided.memh = param->memh;
+    } else {
+        dt_iter->type.strided.memh = NULL;
+        ucp_datatype_iter_detect_mem_info(
+                context, buffer, ucp_dt_strided_span(dt_strided, count),
+                dt_iter, param);
+    }
+
+    return UCS_OK;
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_datatype_generic_iter_init(ucp_context_h context, void *buffer,
                                size_t count, ucp_datatype_t datatype,
@@ -154,6 +206,11 @@ ucp_datatype_iter_init(ucp_context_h context, void *buffer, size_t count,
         length = ucp_dt_iov_length((const ucp_dt_iov_t*)buffer, count);
         return ucp_datatype_iov_iter_init(context, buffer, count, length,
                                           dt_iter, param);
+    } else if (dt_iter->dt_class == UCP_DATATYPE_STRIDED) {
+        ucp_datatype_iter_iov_set_sg_count(
+                sg_count, ucp_dt_to_strided(datatype)->num_blocks * count);
+        return ucp_datatype_strided_iter_init(context, buffer, count, datatype,
+                                              dt_iter, param);
     } else if (dt_iter->dt_class == UCP_DATATYPE_SGL) {
         *sg_count = 0;
         return ucp_datatype_iter_sgl_init(context, dt_iter,
@@ -198,6 +255,9 @@ static UCS_F_ALWAYS_INLINE ucs_status_t ucp_datatype_iter_init_unpack(
         length = ucp_dt_iov_length((const ucp_dt_iov_t*)buffer, count);
         return ucp_datatype_iov_iter_init(context, buffer, count, length,
                                           dt_iter, param);
+    } else if (dt_iter->dt_class == UCP_DATATYPE_STRIDED) {
+        return ucp_datatype_strided_iter_init(context, buffer, count, datatype,
+                                              dt_iter, param);
     } else if (!ENABLE_PARAMS_CHECK ||
                (dt_iter->dt_class == UCP_DATATYPE_GENERIC)) {
         ucp_datatype_generic_iter_init(context, buffer, count, datatype, 0,
@@ -242,6 +302,12 @@ ucp_datatype_iter_move(ucp_datatype_iter_t *dst_iter,
     } else if (src_iter->dt_class == UCP_DATATYPE_IOV) {
         iov_count = ucp_datatype_iter_iov_count(src_iter);
         ucp_datatype_iter_iov_set_sg_count(sg_count, iov_count);
+    } else if (src_iter->dt_class == UCP_DATATYPE_STRIDED) {
+        /* A partial last block still takes an iov entry */
+        ucp_datatype_iter_iov_set_sg_count(
+                sg_count,
+                ucs_div_round_up(length,
+                                 src_iter->type.strided.dt->block_size));
     } else {
         *sg_count = 0;
     }
@@ -349,6 +415,12 @@ ucp_datatype_iter_cleanup(ucp_datatype_iter_t *dt_iter, int dereg,
             ucp_datatype_iter_mem_dereg_single(&dt_iter->type.contig.memh);
         }
         ucp_datatatype_iter_memh_cleanup_check(dt_iter->type.contig.memh);
+    } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_STRIDED,
+                                          dt_mask)) {
+        if (dereg) {
+            ucp_datatype_iter_mem_dereg_single(&dt_iter->type.strided.memh);
+        }
+        ucp_datatatype_iter_memh_cleanup_check(dt_iter->type.strided.memh);
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_IOV, dt_mask)) {
         ucp_datatype_iter_iov_cleanup(dt_iter, dereg);
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_SGL, dt_mask)) {
@@ -399,6 +471,13 @@ ucp_datatype_iter_next_pack(const ucp_datatype_iter_t *dt_iter,
                            (ucs_memory_type_t)dt_iter->mem_info.type,
                            dt_iter->length);
         break;
+    case UCP_DATATYPE_STRIDED:
+        length = ucs_min(dt_iter->length - dt_iter->offset, max_length);
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_pack, worker, dest,
+                              dt_iter->type.strided.buffer,
+                              dt_iter->type.strided.dt, dt_iter->offset, length,
+                              (ucs_memory_type_t)dt_iter->mem_info.type);
+        break;
     case UCP_DATATYPE_IOV:
         ucp_datatype_iter_iov_check(dt_iter);
         length = ucs_min(dt_iter->length - dt_iter->offset, max_length);
@@ -467,6 +546,13 @@ ucp_datatype_iter_unpack(ucp_datatype_iter_t *dt_iter, ucp_worker_h worker,
                              dt_iter->length);
         status = UCS_OK;
         break;
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack, worker,
+                              dt_iter->type.strided.buffer, src,
+                              dt_iter->type.strided.dt, offset, length,
+                              (ucs_memory_type_t)dt_iter->mem_info.type);
+        status = UCS_OK;
+        break;
     case UCP_DATATYPE_IOV:
         ucp_datatype_iter_iov_seek(dt_iter, offset);
         unpacked_length = UCS_PROFILE_CALL(ucp_dt_iov_scatter,
@@ -606,6 +692,11 @@ ucp_datatype_iter_next_iov(const ucp_datatype_iter_t *dt_iter,
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_IOV, dt_mask)) {
         return ucp_datatype_iter_iov_next_iov(dt_iter, max_length, memh_index,
                                               next_iter, iov, max_iov);
+    } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_STRIDED,
+                                          dt_mask)) {
+        return ucp_datatype_iter_strided_next_iov(dt_iter, max_length,
+                                                  memh_index, next_iter, iov,
+                                                  max_iov);
     } else {
         /* Silence compiler warning */
         next_iter->offset = dt_iter->offset;
@@ -694,6 +785,13 @@ static UCS_F_ALWAYS_INLINE ucs_status_t ucp_datatype_iter_mem_reg(
                 context, dt_iter->type.contig.buffer, dt_iter->length,
                 (ucs_memory_type_t)dt_iter->mem_info.type, md_map, uct_flags,
                 &dt_iter->type.contig.memh);
+    } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_STRIDED,
+                                          dt_mask)) {
+        return ucp_datatype_iter_mem_reg_single(
+                context, dt_iter->type.strided.buffer,
+                ucp_datatype_iter_strided_span(dt_iter),
+                (ucs_memory_type_t)dt_iter->mem_info.type, md_map, uct_flags,
+                &dt_iter->type.strided.memh);
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_IOV, dt_mask)) {
         return ucp_datatype_iter_iov_mem_reg(context, dt_iter, md_map,
                                              uct_flags);
@@ -725,6 +823,9 @@ ucp_datatype_iter_mem_dereg(ucp_datatype_iter_t *dt_iter, unsigned dt_mask)
 {
     if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_CONTIG, dt_mask)) {
         ucp_datatype_iter_mem_dereg_single(&dt_iter->type.contig.memh);
+    } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_STRIDED,
+                                          dt_mask)) {
+        ucp_datatype_iter_mem_dereg_single(&dt_iter->type.strided.memh);
     } else if (ucp_datatype_iter_is_class(dt_iter, UCP_DATATYPE_IOV, dt_mask)) {
         if (dt_iter->type.iov.memh != NULL) {
             ucp_datatype_iter_iov_mem_dereg(dt_iter);
@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "dt_strided.h"
+#include "dt_contig.h"
+
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/math.h>
+#include <string.h>
+
+
+ucs_status_t ucp_dt_create_strided(const ucp_dt_strided_params_t *params,
+                                   ucp_datatype_t *datatype_p)
+{
+    ucp_dt_strided_t *dt_strided;
+    size_t inner_span;
+    unsigned dim;
+    int ret;
+
+    if (!ucs_test_all_flags(params->field_mask,
+                            UCP_DT_STRIDED_PARAM_FIELD_BLOCK_SIZE |
+                            UCP_DT_STRIDED_PARAM_FIELD_DIMS)) {
+        ucs_error("strided datatype requires block size and dimensions");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((params->block_size == 0) || (params->num_dims == 0) ||
+        (params->num_dims > UCP_DT_STRIDED_MAX_DIMS)) {
+        ucs_error("invalid strided datatype: block_size %zu num_dims %u",
+                  params->block_size, params->num_dims);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* Every dimension must place its items apart enough to contain the inner
+     * dimension, so that the blocks do not overlap */
+    inner_span = params->block_size;
+    for (dim = 0; dim < params->num_dims; ++dim) {
+        if ((params->dims[dim].count == 0) ||
+            (params->dims[dim].stride < inner_span) ||
+            (params->dims[dim].count > (SIZE_MAX / params->dims[dim].stride))) {
+            ucs_error("invalid strided datatype dimension %u: count %zu "
+                      "stride %zu inner span %zu", dim,
+                      params->dims[dim].count, params->dims[dim].stride,
+                      inner_span);
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        inner_span = params->dims[dim].count * params->dims[dim].stride;
+    }
+
+    ret = ucs_posix_memalign((void**)&dt_strided,
+                             ucs_max(sizeof(void*),
+                                     UCS_BIT(UCP_DATATYPE_SHIFT)),
+                             sizeof(*dt_strided), "strided_dt");
+    if (ret != 0) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    dt_strided->block_size = params->block_size;
+    dt_strided->num_dims   = params->num_dims;
+    dt_strided->num_blocks = 1;
+    for (dim = 0; dim < params->num_dims; ++dim) {
+        dt_strided->counts[dim]  = params->dims[dim].count;
+        dt_strided->strides[dim] = params->dims[dim].stride;
+        dt_strided->num_blocks  *= params->dims[dim].count;
+    }
+
+    dt_strided->elem_size = dt_strided->num_blocks * params->block_size;
+    dt_strided->extent    = inner_span;
+    *datatype_p           = ucp_dt_from_strided(dt_strided);
+    return UCS_OK;
+}
+
+/*
+ * Copy a row of equally spaced blocks to or from a packed buffer. With a
+ * constant block size, the compiler replaces memcpy by vector moves.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_row(void *packed, void *block, size_t stride,
+                        size_t block_size, size_t num_blocks, int is_pack)
+{
+    size_t i;
+
+    for (i = 0; i < num_blocks; ++i) {
+        if (is_pack) {
+            memcpy(packed, block, block_size);
+        } else {
+            memcpy(block, packed, block_size);
+        }
+
+        packed = UCS_PTR_BYTE_OFFSET(packed, block_size);
+        block  = UCS_PTR_BYTE_OFFSET(block, stride);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_row_dispatch(void *packed, void *block, size_t stride,
+                                 size_t block_size, size_t num_blocks,
+                                 int is_pack)
+{
+    switch (block_size) {
+    case 4:
+        ucp_dt_strided_copy_row(packed, block, stride, 4, num_blocks, is_pack);
+        break;
+    case 8:
+        ucp_dt_strided_copy_row(packed, block, stride, 8, num_blocks, is_pack);
+        break;
+    case 16:
+        ucp_dt_strided_copy_row(packed, block, stride, 16, num_blocks,
+                                is_pack);
+        break;
+    case 32:
+        ucp_dt_strided_copy_row(packed, block, stride, 32, num_blocks,
+                                is_pack);
+        break;
+    default:
+        ucp_dt_strided_copy_row(packed, block, stride, block_size, num_blocks,
+                                is_pack);
+        break;
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy(ucp_worker_h worker, void *packed, void *buffer,
+                    const ucp_dt_strided_t *dt_strided, size_t offset,
+                    size_t length, ucs_memory_type_t mem_type, int is_pack)
+{
+    size_t block_size   = dt_strided->block_size;
+    size_t block_index  = offset / block_size;
+    size_t block_offset = offset % block_size;
+    size_t row_blocks, frag_length;
+    void *block;
+
+    while (length > 0) {
+        block = ucp_dt_strided_block_ptr(dt_strided, buffer, block_index);
+
+        if ((block_offset != 0) || (length < block_size) ||
+            !UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type)) {
+            /* Partial block, or memory which is not accessible by the CPU */
+            block       = UCS_PTR_BYTE_OFFSET(block, block_offset);
+            frag_length = ucs_min(block_size - block_offset, length);
+            if (is_pack) {
+                ucp_dt_contig_pack(worker, packed, block, frag_length,
+                                   mem_type, frag_length);
+            } else {
+                ucp_dt_contig_unpack(worker, block, packed, frag_length,
+                                     mem_type, frag_length);
+            }
+
+            block_offset = (block_offset + frag_length) % block_size;
+            block_index += (block_offset == 0);
+        } else {
+            /* Full blocks until the end of the innermost dimension */
+            row_blocks  = ucs_min(dt_strided->counts[0] -
+                                  (block_index % dt_strided->counts[0]),
+                                  length / block_size);
+            frag_length = row_blocks * block_size;
+            ucp_dt_strided_copy_row_dispatch(packed, block,
+                                             dt_strided->strides[0],
+                                             block_size, row_blocks, is_pack);
+            block_index += row_blocks;
+        }
+
+        packed  = UCS_PTR_BYTE_OFFSET(packed, frag_length);
+        length -= frag_length;
+    }
+}
+
+void ucp_dt_strided_pack(ucp_worker_h worker, void *dest, const void *buffer,
+                         const ucp_dt_strided_t *dt_strided, size_t offset,
+                         size_t length, ucs_memory_type_t mem_type)
+{
+    ucp_dt_strided_copy(worker, dest, (void*)buffer, dt_strided, offset,
+                        length, mem_type, 1);
+}
+
+void ucp_dt_strided_unpack(ucp_worker_h worker, void *buffer, const void *src,
+                           const ucp_dt_strided_t *dt_strided, size_t offset,
+                           size_t length, ucs_memory_type_t mem_type)
+{
+    ucp_dt_strided_copy(worker, (void*)src, buffer, dt_strided, offset, length,
+                        mem_type, 0);
+}
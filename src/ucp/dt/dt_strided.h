@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+
+#ifndef UCP_DT_STRIDED_H_
+#define UCP_DT_STRIDED_H_
+
+#include <ucp/api/ucp.h>
+#include <ucp/dt/dt.h>
+#include <ucs/sys/compiler_def.h>
+
+
+/**
+ * Strided datatype structure.
+ */
+typedef struct ucp_dt_strided {
+    size_t   block_size;                          /* Contiguous block size */
+    unsigned num_dims;                            /* Number of dimensions */
+    size_t   counts[UCP_DT_STRIDED_MAX_DIMS];     /* Items per dimension */
+    size_t   strides[UCP_DT_STRIDED_MAX_DIMS];    /* Byte stride per dimension */
+    size_t   num_blocks;                          /* Blocks in one element */
+    size_t   elem_size;                           /* Packed size of one element */
+    size_t   extent;                              /* Span of one element */
+} ucp_dt_strided_t;
+
+
+#define UCP_DT_IS_STRIDED(_datatype) \
+    (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_STRIDED)
+
+
+static UCS_F_ALWAYS_INLINE
+ucp_dt_strided_t* ucp_dt_to_strided(ucp_datatype_t datatype)
+{
+    return (ucp_dt_strided_t*)(void*)(datatype & ~UCP_DATATYPE_CLASS_MASK);
+}
+
+
+static UCS_F_ALWAYS_INLINE
+ucp_datatype_t ucp_dt_from_strided(ucp_dt_strided_t *dt_strided)
+{
+    return ((uintptr_t)dt_strided) | UCP_DATATYPE_STRIDED;
+}
+
+
+/**
+ * Get the total packed length of @a count elements of a strided datatype.
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_length(const ucp_dt_strided_t *dt_strided, size_t count)
+{
+    return dt_strided->elem_size * count;
+}
+
+
+/**
+ * Get the number of bytes spanned by @a count elements of a strided datatype,
+ * starting from the first byte of the first block.
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_span(const ucp_dt_strided_t *dt_strided, size_t count)
+{
+    size_t span;
+    unsigned dim;
+
+    if (count == 0) {
+        return 0;
+    }
+
+    span = dt_strided->block_size + ((count - 1) * dt_strided->extent);
+    for (dim = 0; dim < dt_strided->num_dims; ++dim) {
+        span += (dt_strided->counts[dim] - 1) * dt_strided->strides[dim];
+    }
+
+    return span;
+}
+
+
+/**
+ * Get the address of a block, given its index in the packed stream.
+ */
+static UCS_F_ALWAYS_INLINE void*
+ucp_dt_strided_block_ptr(const ucp_dt_strided_t *dt_strided, void *buffer,
+                         size_t block_index)
+{
+    size_t offset = 0;
+    unsigned dim;
+
+    for (dim = 0; dim < dt_strided->num_dims; ++dim) {
+        offset      += (block_index % dt_strided->counts[dim]) *
+                       dt_strided->strides[dim];
+        block_index /= dt_strided->counts[dim];
+    }
+
+    return UCS_PTR_BYTE_OFFSET(buffer,
+                               offset + (block_index * dt_strided->extent));
+}
+
+
+/**
+ * Gather a range of the packed stream of a strided buffer into @a dest.
+ *
+ * @param [in]  worker      Worker, used to copy non-host memory.
+ * @param [in]  dest        Destination contiguous buffer.
+ * @param [in]  buffer      Strided source buffer.
+ * @param [in]  dt_strided  Strided datatype.
+ * @param [in]  offset      Offset in the packed stream to start from.
+ * @param [in]  length      Number of bytes to gather.
+ * @param [in]  mem_type    Memory type of @a buffer.
+ */
+void ucp_dt_strided_pack(ucp_worker_h worker, void *dest, const void *buffer,
+                         const ucp_dt_strided_t *dt_strided, size_t offset,
+                         size_t length, ucs_memory_type_t mem_type);
+
+
+/**
+ * Scatter contiguous data from @a src to a range of the packed stream of a
+ * strided buffer.
+ *
+ * @param [in]  worker      Worker, used to copy non-host memory.
+ * @param [in]  buffer      Strided destination buffer.
+ * @param [in]  src         Source contiguous buffer.
+ * @param [in]  dt_strided  Strided datatype.
+ * @param [in]  offset      Offset in the packed stream to start from.
+ * @param [in]  length      Number of bytes to scatter.
+ * @param [in]  mem_type    Memory type of @a buffer.
+ */
+void ucp_dt_strided_unpack(ucp_worker_h worker, void *buffer, const void *src,
+                           const ucp_dt_strided_t *dt_strided, size_t offset,
+                           size_t length, ucs_memory_type_t mem_type);
+
+#endif
@@ -46,6 +46,7 @@
     _macro(ucp_eager_sync_zcopy_single_proto) \
     _macro(ucp_rndv_am_bcopy_proto) \
     _macro(ucp_rndv_am_zcopy_proto) \
+    _macro(ucp_rndv_am_lz4_proto) \
     _macro(ucp_rndv_get_zcopy_proto) \
     _macro(ucp_rndv_get_mtype_proto) \
     _macro(ucp_rndv_ats_proto) \
@@ -63,6 +63,10 @@ typedef struct ucp_proto_select_param ucp_proto_select_param_t;
 typedef struct ucp_proto_probe_ctx ucp_proto_probe_ctx_t;
 
 
+/* Protocol selected for a range of message sizes */
+typedef struct ucp_proto_config ucp_proto_config_t;
+
+
 /* Protocol stage ID */
 enum {
     /* Initial stage. All protocols start from this stage. */
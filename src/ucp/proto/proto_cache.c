@@ -0,0 +1,447 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_cache.h"
+#include "proto_select.inl"
+
+#include <ucp/core/ucp_worker.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ucp/core/ucp_worker.inl>
+
+
+/* Maximal length of a line in the cache file */
+#define UCP_PROTO_CACHE_LINE_MAX 1024
+
+/* Prefix of the line with the host fingerprint */
+#define UCP_PROTO_CACHE_HOST     "host "
+
+
+KHASH_IMPL(ucp_proto_cache_hash, kh_cstr_t, ucp_proto_cache_table_t, 1,
+           kh_str_hash_func, kh_str_hash_equal)
+
+
+/*
+ * Host fingerprint, which is written at the beginning of the cache file. The
+ * whole file is ignored if the fingerprint does not match, since the selection
+ * tables depend on the hardware and on the protocol implementations.
+ */
+static void ucp_proto_cache_host_fingerprint(ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%s %s %s ucx-%s", ucs_get_host_name(),
+                              ucs_cpu_vendor_name(), ucs_cpu_model_name(),
+                              ucp_get_version_string());
+}
+
+void ucp_proto_cache_ep_fingerprint(ucp_worker_h worker,
+                                    ucp_worker_cfg_index_t ep_cfg_index,
+                                    ucs_string_buffer_t *strb)
+{
+    ucp_context_h context          = worker->context;
+    const ucp_ep_config_key_t *key = &ucs_array_elem(&worker->ep_config,
+                                                     ep_cfg_index).key;
+    const uct_tl_resource_desc_t *tl_rsc;
+    const uct_iface_attr_t *iface_attr;
+    ucp_rsc_index_t rsc_index;
+    ucp_lane_index_t lane;
+
+    for (lane = 0; lane < key->num_lanes; ++lane) {
+        rsc_index  = key->lanes[lane].rsc_index;
+        tl_rsc     = &context->tl_rscs[rsc_index].tl_rsc;
+        iface_attr = ucp_worker_iface_get_attr(worker, rsc_index);
+        ucs_string_buffer_appendf(strb, " " UCT_TL_RESOURCE_DESC_FMT
+                                  "/%.0fMBs/%.0fns",
+                                  UCT_TL_RESOURCE_DESC_ARG(tl_rsc),
+                                  ucp_worker_iface_bandwidth(worker,
+                                                             rsc_index) /
+                                          UCS_MBYTE,
+                                  iface_attr->latency.c * 1e9);
+    }
+}
+
+/* Cache entry name: selection key followed by the endpoint fingerprint */
+static void ucp_proto_cache_name(ucp_worker_h worker,
+                                 ucp_worker_cfg_index_t ep_cfg_index,
+                                 uint64_t key, ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%016" PRIx64, key);
+    ucp_proto_cache_ep_fingerprint(worker, ep_cfg_index, strb);
+}
+
+static ucp_proto_cache_table_t *
+ucp_proto_cache_table_get(ucp_worker_h worker, const char *name)
+{
+    khash_t(ucp_proto_cache_hash) *hash = &worker->proto_cache.tables;
+    ucp_proto_cache_table_t *table;
+    char *name_copy;
+    khiter_t khiter;
+    int khret;
+
+    khiter = kh_get(ucp_proto_cache_hash, hash, name);
+    if (khiter != kh_end(hash)) {
+        table = &kh_value(hash, khiter);
+        ucs_array_clear(table);
+        return table;
+    }
+
+    name_copy = ucs_strdup(name, "proto_cache_name");
+    if (name_copy == NULL) {
+        ucs_error("failed to allocate protocol cache entry name");
+        return NULL;
+    }
+
+    khiter = kh_put(ucp_proto_cache_hash, hash, name_copy, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucs_error("failed to add protocol cache entry '%s'", name);
+        ucs_free(name_copy);
+        return NULL;
+    }
+
+    table = &kh_value(hash, khiter);
+    ucs_array_init_dynamic(table);
+    return table;
+}
+
+static ucp_proto_id_t ucp_proto_cache_proto_id(const char *proto_name)
+{
+    ucp_proto_id_t proto_id;
+
+    for (proto_id = 0; proto_id < ucp_protocols_count(); ++proto_id) {
+        if (!strcmp(ucp_protocols[proto_id]->name, proto_name)) {
+            return proto_id;
+        }
+    }
+
+    return UCP_PROTO_MAX_COUNT;
+}
+
+/*
+ * Parse a selection table in the format
+ * "<max length>:<protocol>,...,<max length>:<protocol>", and check that the
+ * ranges are increasing and cover all message sizes.
+ */
+static int ucp_proto_cache_parse_table(char *str,
+                                       ucp_proto_cache_table_t *table)
+{
+    ucp_proto_cache_range_t *range;
+    unsigned long long max_length;
+    char *saveptr, *token, *end;
+    size_t prev_max_length;
+
+    prev_max_length = 0;
+    for (token = strtok_r(str, ",", &saveptr); token != NULL;
+         token = strtok_r(NULL, ",", &saveptr)) {
+        errno      = 0;
+        max_length = strtoull(token, &end, 10);
+        if ((errno != 0) || (*end != ':') || (max_length > SIZE_MAX) ||
+            (!ucs_array_is_empty(table) && (max_length <= prev_max_length))) {
+            return 0;
+        }
+
+        range = ucs_array_append(table, return 0);
+        range->max_msg_length = max_length;
+        range->proto_id       = ucp_proto_cache_proto_id(end + 1);
+        if (range->proto_id == UCP_PROTO_MAX_COUNT) {
+            return 0;
+        }
+
+        prev_max_length = max_length;
+    }
+
+    return !ucs_array_is_empty(table) &&
+           (ucs_array_last(table)->max_msg_length == SIZE_MAX);
+}
+
+static void ucp_proto_cache_load(ucp_worker_h worker, const char *filename)
+{
+    UCS_STRING_BUFFER_ONSTACK(host_strb, UCP_PROTO_CACHE_LINE_MAX);
+    UCS_STRING_BUFFER_ONSTACK(name_strb, UCP_PROTO_CACHE_LINE_MAX);
+    char line[UCP_PROTO_CACHE_LINE_MAX];
+    ucp_proto_cache_table_t *table;
+    char *table_str, *fingerprint;
+    int host_valid;
+    unsigned count;
+    FILE *stream;
+
+    stream = fopen(filename, "r");
+    if (stream == NULL) {
+        /* The file does not exist before the first run */
+        if (errno != ENOENT) {
+            ucs_warn("failed to open protocol cache file '%s': %m", filename);
+        }
+        return;
+    }
+
+    ucp_proto_cache_host_fingerprint(&host_strb);
+
+    count      = 0;
+    host_valid = 0;
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        line[strcspn(line, "\n")] = '\0';
+        if ((line[0] == '#') || (line[0] == '\0')) {
+            continue;
+        }
+
+        if (!host_valid) {
+            /* The host fingerprint is the first line */
+            if (strncmp(line, UCP_PROTO_CACHE_HOST,
+                        strlen(UCP_PROTO_CACHE_HOST)) ||
+                strcmp(line + strlen(UCP_PROTO_CACHE_HOST),
+                       ucs_string_buffer_cstr(&host_strb))) {
+                ucs_debug("%s: ignoring protocol cache of '%s', expected "
+                          "'%s'", filename, line,
+                          ucs_string_buffer_cstr(&host_strb));
+                break;
+            }
+
+            host_valid = 1;
+            continue;
+        }
+
+        /* "<selection key> <table> <endpoint fingerprint>", the endpoint
+         * fingerprint starts with a space */
+        table_str = strchr(line, ' ');
+        if ((table_str == NULL) || (table_str - line != 16) ||
+            (strspn(line, "0123456789abcdef") != 16)) {
+            goto err_malformed;
+        }
+
+        *(table_str++) = '\0';
+        fingerprint    = strchr(table_str, ' ');
+        if (fingerprint == NULL) {
+            goto err_malformed;
+        }
+
+        /* The entry name is the selection key and the endpoint fingerprint */
+        ucs_string_buffer_reset(&name_strb);
+        ucs_string_buffer_appendf(&name_strb, "%s%s", line, fingerprint);
+        *fingerprint = '\0';
+
+        table = ucp_proto_cache_table_get(worker,
+                                          ucs_string_buffer_cstr(&name_strb));
+        if (table == NULL) {
+            continue;
+        }
+
+        if (!ucp_proto_cache_parse_table(table_str, table)) {
+            ucs_array_clear(table);
+            goto err_malformed;
+        }
+
+        ++count;
+        continue;
+
+err_malformed:
+        ucs_warn("%s: ignoring malformed line", filename);
+    }
+
+    fclose(stream);
+    ucs_debug("worker %p: loaded %u protocol selection tables from '%s'",
+              worker, count, filename);
+}
+
+static void ucp_proto_cache_load_once(ucp_worker_h worker)
+{
+    const char *filename = worker->context->config.ext.proto_cache_file;
+
+    if (worker->proto_cache.loaded) {
+        return;
+    }
+
+    worker->proto_cache.loaded = 1;
+    if (!ucs_string_is_empty(filename)) {
+        ucp_proto_cache_load(worker, filename);
+    }
+}
+
+static void
+ucp_proto_cache_collect(ucp_worker_h worker,
+                        ucp_worker_cfg_index_t ep_cfg_index,
+                        uint64_t key, const ucp_proto_select_elem_t *select_elem)
+{
+    UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_CACHE_LINE_MAX);
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    ucp_proto_cache_table_t *table;
+    ucp_proto_cache_range_t *range;
+
+    ucp_proto_cache_name(worker, ep_cfg_index, key, &strb);
+    table = ucp_proto_cache_table_get(worker, ucs_string_buffer_cstr(&strb));
+    if (table == NULL) {
+        return;
+    }
+
+    thresh_elem = select_elem->thresholds;
+    do {
+        range = ucs_array_append(table,
+                                 ucs_error("failed to add protocol cache range");
+                                 ucs_array_clear(table);
+                                 return);
+        range->max_msg_length = thresh_elem->max_msg_length;
+        range->proto_id       = thresh_elem->proto_config.init_elem->proto_id;
+    } while ((thresh_elem++)->max_msg_length != SIZE_MAX);
+}
+
+static void ucp_proto_cache_save(ucp_worker_h worker, const char *filename)
+{
+    UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_CACHE_LINE_MAX);
+    khash_t(ucp_proto_cache_hash) *hash = &worker->proto_cache.tables;
+    ucp_proto_select_elem_t select_elem;
+    const ucp_proto_cache_range_t *range;
+    ucp_proto_cache_table_t table;
+    ucp_ep_config_t *ep_config;
+    const char *name;
+    uint64_t key;
+    ucs_status_t status;
+    char *tmp_filename;
+    FILE *stream;
+    int fd;
+
+    /* Keep the tables of other endpoint configurations from the file */
+    ucp_proto_cache_load_once(worker);
+
+    ucs_array_for_each(ep_config, &worker->ep_config) {
+        kh_foreach(ep_config->proto_select.hash, key, select_elem,
+            ucp_proto_cache_collect(worker,
+                                    ep_config - worker->ep_config.buffer,
+                                    key, &select_elem);
+        )
+    }
+
+    if (kh_size(hash) == 0) {
+        return;
+    }
+
+    /* Write to a private file and rename it, so other workers never read a
+     * partially written file */
+    status = ucs_string_alloc_formatted_path(&tmp_filename, "tmp_filename",
+                                             "%s.%d.%p.tmp", filename,
+                                             getpid(), worker);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    fd = open(tmp_filename, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        ucs_warn("failed to create protocol cache file '%s': %m",
+                 tmp_filename);
+        goto out_free;
+    }
+
+    stream = fdopen(fd, "w");
+    if (stream == NULL) {
+        ucs_warn("failed to open protocol cache file '%s': %m", tmp_filename);
+        close(fd);
+        goto err_unlink;
+    }
+
+    ucp_proto_cache_host_fingerprint(&strb);
+    fprintf(stream, "# UCX protocol selection cache\n");
+    fprintf(stream, UCP_PROTO_CACHE_HOST "%s\n", ucs_string_buffer_cstr(&strb));
+    fprintf(stream, "# <selection key> <max length>:<protocol>,... "
+                    "<lane resources>\n");
+    kh_foreach(hash, name, table,
+        if (ucs_array_is_empty(&table)) {
+            continue;
+        }
+
+        /* The name is the selection key and the endpoint fingerprint */
+        fprintf(stream, "%.16s ", name);
+        ucs_array_for_each(range, &table) {
+            fprintf(stream, "%s%zu:%s",
+                    (range == ucs_array_begin(&table)) ? "" : ",",
+                    range->max_msg_length,
+                    ucp_proto_id_field(range->proto_id, name));
+        }
+        fprintf(stream, "%s\n", name + 16);
+    )
+
+    if (fclose(stream) != 0) {
+        ucs_warn("failed to write protocol cache file '%s': %m",
+                 tmp_filename);
+        goto err_unlink;
+    }
+
+    if (rename(tmp_filename, filename) != 0) {
+        ucs_warn("failed to rename '%s' to '%s': %m", tmp_filename, filename);
+        goto err_unlink;
+    }
+
+    ucs_debug("worker %p: saved protocol selection tables to '%s'", worker,
+              filename);
+    goto out_free;
+
+err_unlink:
+    unlink(tmp_filename);
+out_free:
+    ucs_free(tmp_filename);
+}
+
+void ucp_proto_cache_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_proto_cache_hash, &worker->proto_cache.tables);
+    worker->proto_cache.loaded = 0;
+}
+
+void ucp_proto_cache_cleanup(ucp_worker_h worker)
+{
+    const char *filename = worker->context->config.ext.proto_cache_file;
+    ucp_proto_cache_table_t table;
+    const char *name;
+
+    if (!ucs_string_is_empty(filename)) {
+        ucp_proto_cache_save(worker, filename);
+    }
+
+    kh_foreach(&worker->proto_cache.tables, name, table,
+        ucs_free((void*)name);
+        ucs_array_cleanup_dynamic(&table);
+    )
+    kh_destroy_inplace(ucp_proto_cache_hash, &worker->proto_cache.tables);
+}
+
+const ucp_proto_cache_table_t *
+ucp_proto_cache_lookup(ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index,
+                       const ucp_proto_select_param_t *select_param)
+{
+    UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_CACHE_LINE_MAX);
+    khash_t(ucp_proto_cache_hash) *hash = &worker->proto_cache.tables;
+    ucp_proto_select_key_t key;
+    khiter_t khiter;
+
+    if (ucs_string_is_empty(worker->context->config.ext.proto_cache_file)) {
+        return NULL;
+    }
+
+    ucp_proto_cache_load_once(worker);
+    if (kh_size(hash) == 0) {
+        return NULL;
+    }
+
+    key.param = *select_param;
+    ucp_proto_cache_name(worker, ep_cfg_index, key.u64, &strb);
+    khiter = kh_get(ucp_proto_cache_hash, hash, ucs_string_buffer_cstr(&strb));
+    if ((khiter == kh_end(hash)) ||
+        ucs_array_is_empty(&kh_value(hash, khiter))) {
+        return NULL;
+    }
+
+    return &kh_value(hash, khiter);
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_CACHE_H_
+#define UCP_PROTO_CACHE_H_
+
+#include "proto.h"
+
+#include <ucs/datastruct/array.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/string_buffer.h>
+
+
+/**
+ * Range of message sizes in a cached protocol selection table
+ */
+typedef struct {
+    size_t         max_msg_length; /* Maximal message length of the range */
+    ucp_proto_id_t proto_id;       /* Protocol selected for the range */
+} ucp_proto_cache_range_t;
+
+
+/* Cached protocol selection table, the last range ends at SIZE_MAX */
+UCS_ARRAY_DECLARE_TYPE(ucp_proto_cache_table_t, unsigned,
+                       ucp_proto_cache_range_t);
+
+
+/* Protocol selection tables by selection key and endpoint fingerprint */
+KHASH_TYPE(ucp_proto_cache_hash, kh_cstr_t, ucp_proto_cache_table_t)
+
+
+/**
+ * Per-worker cache of protocol selection tables
+ */
+typedef struct {
+    khash_t(ucp_proto_cache_hash) tables;
+    int                           loaded; /* Whether the file was loaded */
+} ucp_proto_cache_t;
+
+
+/**
+ * Initialize the protocol selection cache of a worker. The cache file
+ * UCX_PROTO_CACHE_FILE is loaded on the first lookup.
+ */
+void ucp_proto_cache_init(ucp_worker_h worker);
+
+
+/**
+ * Save the protocol selection tables of all endpoint configurations to
+ * UCX_PROTO_CACHE_FILE, and release the cache. Must be called before the
+ * worker configurations are destroyed.
+ */
+void ucp_proto_cache_cleanup(ucp_worker_h worker);
+
+
+/**
+ * Find the cached protocol selection table for a selection key.
+ *
+ * The table was saved by a previous run on the same host, with the same UCX
+ * version and the same lane resources. The caller probes only the protocols
+ * of the table, and must fall back to a full protocol selection if any of them
+ * is not available.
+ *
+ * @param [in] worker        UCP worker.
+ * @param [in] ep_cfg_index  Endpoint configuration index.
+ * @param [in] select_param  Protocol selection parameters.
+ *
+ * @return Cached selection table, or NULL if not found.
+ */
+const ucp_proto_cache_table_t *
+ucp_proto_cache_lookup(ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index,
+                       const ucp_proto_select_param_t *select_param);
+
+
+/**
+ * Append the fingerprint of an endpoint configuration to a string buffer. The
+ * fingerprint consists of the transport resources of the lanes and their
+ * performance attributes, so it is the same for similar endpoints in different
+ * runs on the same hardware.
+ *
+ * @param [in]    worker        UCP worker.
+ * @param [in]    ep_cfg_index  Endpoint configuration index.
+ * @param [inout] strb          String buffer to append the fingerprint to.
+ */
+void ucp_proto_cache_ep_fingerprint(ucp_worker_h worker,
+                                    ucp_worker_cfg_index_t ep_cfg_index,
+                                    ucs_string_buffer_t *strb);
+
+#endif
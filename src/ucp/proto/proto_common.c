@@ -272,6 +272,24 @@ static void ucp_proto_common_update_lane_perf_by_distance(
     ucp_proto_perf_node_own_child(perf->node, &sys_perf_node);
 }
 
+/* Compressed data takes less time on the wire, but the compression speed
+ * limits the bandwidth */
+static void
+ucp_proto_common_update_lane_perf_by_compress(ucp_context_h context,
+                                              ucp_proto_common_tl_perf_t *perf)
+{
+    double ratio       = context->config.ext.rndv_compress_ratio;
+    double compress_bw = context->config.ext.rndv_compress_bw;
+    ucp_proto_perf_node_t *compress_perf_node;
+
+    perf->bandwidth = ucs_min(perf->bandwidth * ratio, compress_bw);
+
+    compress_perf_node = ucp_proto_perf_node_new_data("compress", "ratio %.2f",
+                                                      ratio);
+    ucp_proto_perf_node_add_bandwidth(compress_perf_node, "bw", compress_bw);
+    ucp_proto_perf_node_own_child(perf->node, &compress_perf_node);
+}
+
 void ucp_proto_common_lane_perf_node(ucp_context_h context,
                                      ucp_rsc_index_t rsc_index,
                                      const uct_perf_attr_t *perf_attr,
@@ -447,6 +465,10 @@ ucp_proto_common_get_lane_perf(const ucp_proto_common_init_params_t *params,
                 ucs_memory_type_names[rkey_config->key.mem_type]);
     }
 
+    if (params->flags & UCP_PROTO_COMMON_INIT_FLAG_COMPRESS) {
+        ucp_proto_common_update_lane_perf_by_compress(context, tl_perf);
+    }
+
     ucs_assert(tl_perf->bandwidth > 1.0);
     ucs_assert(tl_perf->send_pre_overhead >= 0);
     ucs_assert(tl_perf->send_post_overhead >= 0);
@@ -543,6 +565,16 @@ ucp_proto_common_filter_min_frag(const ucp_proto_init_params_t *params,
         return 0;
     }
 
+    /* Every block of a strided datatype takes an iov entry, so zero-copy is
+     * efficient only if all blocks of a message fit in one operation */
+    if ((flags & UCP_PROTO_COMMON_INIT_FLAG_SEND_ZCOPY) &&
+        (params->select_param->dt_class == UCP_DATATYPE_STRIDED) &&
+        (params->select_param->sg_count > ucs_min(max_iov, UCP_MAX_IOV))) {
+        ucs_trace("%s: %u strided blocks exceed max iov %zu", lane_desc,
+                  params->select_param->sg_count, max_iov);
+        return 0;
+    }
+
     ucp_proto_common_get_frag_size(common_params, iface_attr, lane,
                                    &tl_min_frag, &tl_max_frag);
 
@@ -79,7 +79,10 @@ typedef enum {
     UCP_PROTO_COMMON_KEEP_MD_MAP             = UCS_BIT(11),
 
     /* Supports failover error handling mode */
-    UCP_PROTO_COMMON_INIT_FLAG_FAILOVER      = UCS_BIT(12)
+    UCP_PROTO_COMMON_INIT_FLAG_FAILOVER      = UCS_BIT(12),
+
+    /* Payload is compressed before sending it */
+    UCP_PROTO_COMMON_INIT_FLAG_COMPRESS      = UCS_BIT(13)
 } ucp_proto_common_init_flags_t;
 
 
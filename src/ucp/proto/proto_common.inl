@@ -98,7 +98,7 @@ ucp_proto_request_zcopy_complete_cb(ucp_request_t *req, ucs_status_t status,
                                     ucp_request_callback_t complete_cb)
 {
     ucp_datatype_iter_cleanup(&req->send.state.dt_iter, 1,
-                              UCP_DT_MASK_CONTIG_IOV |
+                              UCP_DT_MASK_ZCOPY |
                               UCS_BIT(UCP_DATATYPE_SGL));
     if (ucp_proto_select_op_id(&req->send.proto_config->select_param) ==
         UCP_OP_ID_TAG_SEND) {
@@ -247,6 +247,86 @@ ucp_proto_request_send_init(ucp_request_t *req, ucp_ep_h ep, uint32_t flags)
 {
     req->flags   = UCP_REQUEST_FLAG_PROTO_SEND | flags;
     req->send.ep = ep;
+#ifdef ENABLE_STATS
+    req->send.stats.lat_index = UCP_EP_STAT_LAT_LAST;
+#endif
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_request_stats_start(ucp_request_t *req, ucp_operation_id_t op_id)
+{
+#ifdef ENABLE_STATS
+    if (!UCS_STATS_NODE_VALID(req->send.ep->stats)) {
+        return;
+    }
+
+    switch (op_id) {
+    case UCP_OP_ID_TAG_SEND:
+    case UCP_OP_ID_TAG_SEND_SYNC:
+        req->send.stats.lat_index = UCP_EP_STAT_LAT_TAG;
+        break;
+    case UCP_OP_ID_AM_SEND:
+    case UCP_OP_ID_AM_SEND_REPLY:
+        req->send.stats.lat_index = UCP_EP_STAT_LAT_AM;
+        break;
+    case UCP_OP_ID_STREAM_SEND:
+        req->send.stats.lat_index = UCP_EP_STAT_LAT_STREAM;
+        break;
+    default:
+        req->send.stats.lat_index = UCP_EP_STAT_LAT_RMA;
+        break;
+    }
+
+    req->send.stats.start_time = ucs_get_time();
+#endif
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_request_tune_start(ucp_worker_h worker, ucp_request_t *req)
+{
+    ucp_proto_tune_slot_t *slot;
+
+    if (ucs_likely(!worker->context->config.ext.proto_tune)) {
+        return;
+    }
+
+    slot               = ucp_proto_tune_slot(&worker->proto_tune, req);
+    slot->req          = req;
+    slot->proto_config = req->send.proto_config;
+    slot->start_time   = ucs_get_time();
+    req->flags        |= UCP_REQUEST_FLAG_PROTO_TUNE;
+}
+
+/**
+ * @return Start time of a fast-path short send, if it is measured by online
+ *         protocol tuning, or 0 otherwise.
+ */
+static UCS_F_ALWAYS_INLINE ucs_time_t
+ucp_proto_tune_short_start(ucp_worker_h worker)
+{
+    if (ucs_likely(!worker->context->config.ext.proto_tune)) {
+        return 0;
+    }
+
+    return ucs_get_time();
+}
+
+/**
+ * Account a fast-path short send started by @ref ucp_proto_tune_short_start,
+ * if it was completed inline.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_tune_short_end(ucp_ep_h ep, ucp_worker_cfg_index_t rkey_cfg_index,
+                         ucp_operation_id_t op_id,
+                         const ucp_request_param_t *param, uint8_t op_flags,
+                         size_t length, ucs_time_t start_time,
+                         ucs_status_t status)
+{
+    if (ucs_unlikely(start_time != 0) && (status == UCS_OK)) {
+        ucp_proto_tune_sample_short(ep, rkey_cfg_index, op_id,
+                                    param->op_attr_mask, op_flags, length,
+                                    start_time);
+    }
 }
 
 
@@ -267,6 +347,8 @@ static UCS_F_ALWAYS_INLINE ucs_status_ptr_t ucp_proto_request_send_op_common(
         return UCS_STATUS_PTR(status);
     }
 
+    ucp_proto_request_stats_start(req, ucp_proto_select_op_id(select_param));
+    ucp_proto_request_tune_start(worker, req);
     UCS_PROFILE_CALL_VOID(ucp_request_send, req);
     if (req->flags & UCP_REQUEST_FLAG_COMPLETED) {
         /* coverity[offset_free] */
@@ -616,6 +616,7 @@ ucp_proto_multi_init_priv(const ucp_proto_multi_init_params_t *params,
                           ucp_proto_multi_priv_t *mpriv,
                           ucp_md_map_t *reg_md_map_p)
 {
+    ucp_context_h context = params->super.super.worker->context;
     const ucp_proto_common_tl_perf_t *lane_perf;
     ucp_proto_multi_lane_priv_t *lpriv;
     uct_iface_attr_v2_t iface_attr_v2;
@@ -725,6 +726,9 @@ ucp_proto_multi_init_priv(const ucp_proto_multi_init_params_t *params,
         mpriv->align_thresh   = ucs_max(mpriv->align_thresh, lpriv->opt_align);
         lpriv->flush_sys_dev_mask =
                 ucp_proto_multi_init_flush_sys_dev_mask(params, lane);
+        lpriv->dynamic_striping   =
+                (context->config.ext.multi_lane_striping ==
+                 UCP_MULTI_LANE_STRIPING_DYNAMIC);
 
         if (v2_cap_flags & (UCT_IFACE_FLAG_V2_PUT_SGL_ZCOPY |
                             UCT_IFACE_FLAG_V2_GET_SGL_ZCOPY)) {
@@ -983,3 +987,44 @@ void ucp_proto_multi_query(const ucp_proto_query_params_t *params,
     ucp_proto_default_query(params, attr);
     ucp_proto_multi_query_config(params, attr);
 }
+
+ucs_status_t
+ucp_proto_multi_stripe_send(ucp_request_t *req,
+                            const ucp_proto_multi_priv_t *mpriv,
+                            ucp_proto_send_multi_cb_t send_func,
+                            const ucp_proto_multi_lane_priv_t **lpriv_p,
+                            ucp_datatype_iter_t *next_iter,
+                            ucp_lane_index_t *lane_shift, ucs_status_t status)
+{
+    ucp_lane_index_t lane_idx = req->send.multi_lane_idx;
+    ucp_lane_map_t tried_map  = 0;
+
+    ucp_proto_multi_stripe_update(req, *lpriv_p, status);
+
+    /* The first fragment may require the capabilities of the first lane */
+    while ((status == UCS_ERR_NO_RESOURCE) &&
+           (req->send.state.dt_iter.offset > 0)) {
+        tried_map |= UCS_BIT(lane_idx);
+        lane_idx   = (lane_idx + 1) % mpriv->num_lanes;
+        if (tried_map & UCS_BIT(lane_idx)) {
+            break;
+        }
+
+        ucp_trace_req(req, "lane[%d] is busy, trying lane[%d]",
+                      (*lpriv_p)->super.lane,
+                      mpriv->lanes[lane_idx].super.lane);
+
+        req->send.multi_lane_idx = lane_idx;
+        *lpriv_p                 = &mpriv->lanes[lane_idx];
+        *lane_shift              = 1;
+        status = send_func(req, *lpriv_p, next_iter, lane_shift);
+        ucp_proto_multi_stripe_update(req, *lpriv_p, status);
+    }
+
+    if (!UCS_STATUS_IS_ERR(status)) {
+        ucp_proto_multi_lane_wiface(req, *lpriv_p)->stripe_bytes +=
+                next_iter->offset - req->send.state.dt_iter.offset;
+    }
+
+    return status;
+}
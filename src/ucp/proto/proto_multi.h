@@ -18,6 +18,14 @@
 #define UCP_PROTO_MULTI_WEIGHT_MAX   UCS_BIT(UCP_PROTO_MULTI_WEIGHT_SHIFT)
 
 
+/* Dynamic striping: minimal fragment size factor of a congested lane */
+#define UCP_PROTO_MULTI_STRIPE_FACTOR_MIN 0.0625
+
+/* Dynamic striping: part of the way back to the full fragment size which a
+ * lane recovers on every successful send */
+#define UCP_PROTO_MULTI_STRIPE_RECOVERY   0.0625
+
+
 /**
  * Helper macro to calculate the size of a protocol private data structure that
  * extends ucp_proto_multi_priv_t, according to the actual number of lanes.
@@ -89,6 +97,10 @@ typedef struct {
      * uct_ep_get_sgl_zcopy on this lane, cached from uct_iface_attr_v2 at
      * protocol init when SGL zcopy is selected, otherwise zero */
      size_t                      max_sgl_zcopy_count;
+
+    /* Scale fragments by the lane congestion, cached from the context
+     * configuration to avoid dereferencing it on every fragment */
+    int                          dynamic_striping;
 } ucp_proto_multi_lane_priv_t;
 
 
@@ -196,4 +208,30 @@ void ucp_proto_multi_query_config(const ucp_proto_query_params_t *params,
 void ucp_proto_multi_query(const ucp_proto_query_params_t *params,
                            ucp_proto_query_attr_t *attr);
 
+
+/**
+ * Dynamic multi-lane striping: if sending a fragment failed because the lane is
+ * out of resources, try the next lanes, until one of them succeeds or all lanes
+ * were tried. Updates the congestion state of every tried lane.
+ *
+ * @param [in]    req         Request to send.
+ * @param [in]    mpriv       Multi-lane protocol configuration.
+ * @param [in]    send_func   Function to send a fragment on a lane.
+ * @param [inout] lpriv_p     Lane which was tried first, set to the last tried
+ *                            lane. @a req->send.multi_lane_idx is updated
+ *                            accordingly.
+ * @param [out]   next_iter   Datatype iterator to advance to.
+ * @param [inout] lane_shift  How many lanes to advance after sending.
+ * @param [in]    status      Status of sending on the first lane.
+ *
+ * @return Status of sending on the last tried lane.
+ */
+ucs_status_t
+ucp_proto_multi_stripe_send(ucp_request_t *req,
+                            const ucp_proto_multi_priv_t *mpriv,
+                            ucp_proto_send_multi_cb_t send_func,
+                            const ucp_proto_multi_lane_priv_t **lpriv_p,
+                            ucp_datatype_iter_t *next_iter,
+                            ucp_lane_index_t *lane_shift, ucs_status_t status);
+
 #endif
@@ -58,6 +58,44 @@ ucp_proto_multi_scaled_length(uint32_t weight, size_t length)
            UCP_PROTO_MULTI_WEIGHT_SHIFT;
 }
 
+static UCS_F_ALWAYS_INLINE ucp_worker_iface_t *
+ucp_proto_multi_lane_wiface(ucp_request_t *req,
+                            const ucp_proto_multi_lane_priv_t *lpriv)
+{
+    ucp_ep_h ep = req->send.ep;
+
+    return ucp_worker_iface(ep->worker,
+                            ucp_ep_get_rsc_index(ep, lpriv->super.lane));
+}
+
+/* Scale the fragment size of a lane according to its congestion */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_proto_multi_stripe_length(ucp_request_t *req,
+                              const ucp_proto_multi_lane_priv_t *lpriv,
+                              size_t length)
+{
+    double factor = ucp_proto_multi_lane_wiface(req, lpriv)->stripe_factor;
+
+    return ucs_max((size_t)(length * factor), 1);
+}
+
+/* Update the congestion of a lane according to a send operation status */
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_multi_stripe_update(ucp_request_t *req,
+                              const ucp_proto_multi_lane_priv_t *lpriv,
+                              ucs_status_t status)
+{
+    ucp_worker_iface_t *wiface = ucp_proto_multi_lane_wiface(req, lpriv);
+
+    if (status == UCS_ERR_NO_RESOURCE) {
+        wiface->stripe_factor = ucs_max(wiface->stripe_factor / 2,
+                                        UCP_PROTO_MULTI_STRIPE_FACTOR_MIN);
+    } else if (!UCS_STATUS_IS_ERR(status)) {
+        wiface->stripe_factor += (1.0 - wiface->stripe_factor) *
+                                 UCP_PROTO_MULTI_STRIPE_RECOVERY;
+    }
+}
+
 static UCS_F_ALWAYS_INLINE size_t
 ucp_proto_multi_max_payload(ucp_request_t *req,
                             const ucp_proto_multi_lane_priv_t *lpriv,
@@ -88,6 +126,11 @@ ucp_proto_multi_max_payload(ucp_request_t *req,
                 "length=%zu weight=%zu%% lpriv->max_frag=%zu hdr_size=%zu",
                 length, ucp_proto_multi_scaled_length(lpriv->weight, 100),
                 lpriv->max_frag, hdr_size);
+
+    if (ucs_unlikely(lpriv->dynamic_striping)) {
+        return ucp_proto_multi_stripe_length(req, lpriv, max_payload);
+    }
+
     return max_payload;
 }
 
@@ -181,6 +224,11 @@ ucp_proto_multi_progress(ucp_request_t *req,
 
     /* send the next fragment */
     status = send_func(req, lpriv, &next_iter, &lane_shift);
+    if (ucs_unlikely(lpriv->dynamic_striping)) {
+        status = ucp_proto_multi_stripe_send(req, mpriv, send_func, &lpriv,
+                                             &next_iter, &lane_shift, status);
+    }
+
     if (ucs_likely(status == UCS_OK)) {
         /* fast path is OK */
     } else if (status == UCS_INPROGRESS) {
@@ -361,7 +409,7 @@ ucp_proto_am_zcopy_multi_common_send_func(
     max_payload = ucp_proto_multi_max_payload(req, lpriv, hdr_size);
     iov_count   = ucp_datatype_iter_next_iov(&req->send.state.dt_iter,
                                              max_payload, lpriv->super.md_index,
-                                             UCP_DT_MASK_CONTIG_IOV, next_iter,
+                                             UCP_DT_MASK_ZCOPY, next_iter,
                                              iov, lpriv->super.max_iov);
     return uct_ep_am_zcopy(ucp_ep_get_lane(req->send.ep, lpriv->super.lane),
                            am_id, hdr, hdr_size, iov, iov_count, 0,
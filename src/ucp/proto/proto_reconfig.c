@@ -84,10 +84,12 @@ static ucs_status_t ucp_proto_reconfig_progress(uct_pending_req_t *self)
     ucs_status_t status;
 
     /* EP is in final state when the remote is connected, or there is no
-     * p2p lane and the configuration index is already the latest.
+     * p2p lane and the configuration index is already the latest. A lazy EP
+     * is connected when the request is queued on its stub lane.
      */
     if ((ep->flags & UCP_EP_FLAG_REMOTE_CONNECTED) ||
         (!ucp_ep_config(ep)->p2p_lanes && !ucp_ep_has_cm_lane(ep) &&
+         !(ep->flags & UCP_EP_FLAG_LAZY) &&
          (ep->cfg_index == req->send.proto_config->ep_cfg_index))) {
         if (ucp_proto_reconfig_report_no_rma_emulation_no_proto(req, ep)) {
             ucp_proto_request_abort(req, UCS_ERR_CANCELED);
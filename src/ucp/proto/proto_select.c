@@ -60,6 +60,7 @@ static ucs_status_t ucp_proto_thresholds_next_range(
     const ucp_proto_init_elem_t *proto;
     const char *max_prio_proto_name;
     unsigned max_cfg_priority;
+    ucs_linear_func_t perf;
     ucs_status_t status;
     unsigned proto_idx;
     size_t max_length;
@@ -166,11 +167,12 @@ static ucs_status_t ucp_proto_thresholds_next_range(
             goto out_unindent;
         }
 
+        perf = ucp_proto_tune_apply(&proto->tune, range->value);
         *ucs_array_append(perf_list, status = UCS_ERR_NO_MEMORY;
-                          goto out_unindent) = range->value;
+                          goto out_unindent) = perf;
 
-        ucp_proto_select_perf_str(&range->value, time_str, sizeof(time_str),
-                                  bw_str, sizeof(bw_str));
+        ucp_proto_select_perf_str(&perf, time_str, sizeof(time_str), bw_str,
+                                  sizeof(bw_str));
         ucs_trace("  %-20s %-20s %-18s",
                   ucp_proto_id_field(proto->proto_id, name), time_str, bw_str);
     }
@@ -190,6 +192,7 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
                                 ucp_worker_cfg_index_t ep_cfg_index,
                                 ucp_worker_cfg_index_t rkey_cfg_index,
                                 const ucp_proto_select_param_t *select_param,
+                                const ucp_proto_id_mask_t *proto_mask,
                                 ucp_proto_select_init_protocols_t *proto_init)
 {
     UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_CONFIG_STR_MAX);
@@ -221,8 +224,7 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
     ucs_array_init_dynamic(&proto_init->protocols);
     ucs_array_init_dynamic(&proto_init->priv_buf);
 
-    UCS_STATIC_BITMAP_FOR_EACH_BIT(init_params.proto_id,
-                                   &worker->context->proto_bitmap) {
+    UCS_STATIC_BITMAP_FOR_EACH_BIT(init_params.proto_id, proto_mask) {
         const ucp_proto_t *proto;
 
         ucs_assert(init_params.proto_id < ucp_protocols_count()); /* Coverity */
@@ -263,6 +265,29 @@ ucp_proto_select_cleanup_protocols(ucp_proto_select_init_protocols_t *proto_init
     ucs_array_cleanup_dynamic(&proto_init->protocols);
 }
 
+static void
+ucp_proto_select_config_init(ucp_worker_h worker,
+                             const ucp_proto_select_init_protocols_t *proto_init,
+                             unsigned proto_idx,
+                             ucp_worker_cfg_index_t ep_cfg_index,
+                             ucp_worker_cfg_index_t rkey_cfg_index,
+                             const ucp_proto_select_param_t *select_param,
+                             ucp_proto_config_t *proto_config)
+{
+    const ucp_proto_init_elem_t *proto = &ucs_array_elem(&proto_init->protocols,
+                                                         proto_idx);
+
+    proto_config->proto          = ucp_protocols[proto->proto_id];
+    proto_config->priv           = ucp_proto_select_init_priv_buf(proto_init,
+                                                                  proto_idx);
+    proto_config->ep_cfg_index   = ep_cfg_index;
+    proto_config->rkey_cfg_index = rkey_cfg_index;
+    proto_config->select_param   = *select_param;
+    proto_config->init_elem      = proto;
+    proto_config->selections     = 0;
+    ucp_request_progress_wrapper_init(worker, proto_config);
+}
+
 static ucs_status_t ucp_proto_select_elem_add_envelope(
         const ucp_proto_select_init_protocols_t *proto_init,
         ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index,
@@ -276,7 +301,6 @@ static ucs_status_t ucp_proto_select_elem_add_envelope(
     ucp_proto_perf_envelope_elem_t *envelope_elem;
     ucp_proto_threshold_elem_t *thresh_elem;
     const ucp_proto_init_elem_t *proto;
-    ucp_proto_config_t *proto_config;
     const void *proto_priv;
     unsigned proto_idx;
     size_t UCS_V_UNUSED range_start;
@@ -307,17 +331,12 @@ static ucs_status_t ucp_proto_select_elem_add_envelope(
                                            return UCS_ERR_NO_MEMORY);
 
             ucs_assert(proto_idx < UINT16_MAX);
-            thresh_elem->max_msg_length  = envelope_elem->max_length;
-            proto_config                 = &thresh_elem->proto_config;
-            proto_config->proto          = ucp_protocols[proto->proto_id];
-            proto_config->priv           = proto_priv;
-            proto_config->ep_cfg_index   = ep_cfg_index;
-            proto_config->rkey_cfg_index = rkey_cfg_index;
-            proto_config->select_param   = *select_param;
-            proto_config->init_elem      = proto;
-            proto_config->selections     = 0;
-            *last_proto_idx              = proto_idx;
-            ucp_request_progress_wrapper_init(worker, proto_config);
+            thresh_elem->max_msg_length = envelope_elem->max_length;
+            ucp_proto_select_config_init(worker, proto_init, proto_idx,
+                                         ep_cfg_index, rkey_cfg_index,
+                                         select_param,
+                                         &thresh_elem->proto_config);
+            *last_proto_idx             = proto_idx;
         }
 
         /* Print detailed protocol selection data to a user-configured path */
@@ -336,14 +355,13 @@ static ucs_status_t ucp_proto_select_elem_add_envelope(
     return UCS_OK;
 }
 
-static ucs_status_t
-ucp_proto_select_elem_init_thresh(ucp_worker_h worker,
-                                  ucp_proto_select_elem_t *select_elem,
-                                  ucp_proto_select_init_protocols_t *proto_init,
-                                  ucp_worker_cfg_index_t ep_cfg_index,
-                                  ucp_worker_cfg_index_t rkey_cfg_index,
-                                  const ucp_proto_select_param_t *select_param,
-                                  int internal)
+static ucs_status_t ucp_proto_select_thresholds_build(
+        ucp_worker_h worker,
+        const ucp_proto_select_init_protocols_t *proto_init,
+        ucp_worker_cfg_index_t ep_cfg_index,
+        ucp_worker_cfg_index_t rkey_cfg_index,
+        const ucp_proto_select_param_t *select_param, int internal,
+        const ucp_proto_threshold_elem_t **thresholds_p)
 {
     ucp_proto_thresh_t thresholds  = UCS_ARRAY_DYNAMIC_INITIALIZER;
     unsigned last_proto_idx        = UINT_MAX;
@@ -406,12 +424,7 @@ ucp_proto_select_elem_init_thresh(ucp_worker_h worker,
 
     ucs_assert_always(!ucs_array_is_empty(&thresholds));
 
-    /* Set pointer to priv buffer (to release it during cleanup) */
-    select_elem->thresholds  = ucs_array_extract_buffer(&thresholds);
-    select_elem->proto_init  = *proto_init;
-    ucs_array_init_dynamic(&proto_init->priv_buf);
-    ucs_array_init_dynamic(&proto_init->protocols);
-
+    *thresholds_p = ucs_array_extract_buffer(&thresholds);
     return UCS_OK;
 
 err_cleanup_envelope:
@@ -424,6 +437,130 @@ err:
     return status;
 }
 
+/* Check that a protocol supports all message sizes from 'start' to 'end' */
+static int ucp_proto_select_init_elem_covers(const ucp_proto_init_elem_t *proto,
+                                             size_t start, size_t end)
+{
+    const ucp_proto_flat_perf_range_t *range;
+
+    for (;;) {
+        range = ucp_proto_flat_perf_find_lb(proto->flat_perf, start);
+        if ((range == NULL) || (start < range->start)) {
+            return 0;
+        }
+
+        if (range->end >= end) {
+            return 1;
+        }
+
+        start = range->end + 1;
+    }
+}
+
+/*
+ * Build the thresholds from a selection table saved by a previous run, instead
+ * of comparing the performance of the protocols. Fails if a protocol of the
+ * table does not support its range anymore, or if any protocol has a
+ * user-configured threshold.
+ */
+static ucs_status_t ucp_proto_select_thresholds_from_cache(
+        ucp_worker_h worker,
+        const ucp_proto_select_init_protocols_t *proto_init,
+        ucp_worker_cfg_index_t ep_cfg_index,
+        ucp_worker_cfg_index_t rkey_cfg_index,
+        const ucp_proto_select_param_t *select_param,
+        const ucp_proto_cache_table_t *table,
+        const ucp_proto_threshold_elem_t **thresholds_p)
+{
+    ucp_proto_thresh_t thresholds = UCS_ARRAY_DYNAMIC_INITIALIZER;
+    size_t range_start            = 0;
+    ucp_proto_threshold_elem_t *thresh_elem;
+    const ucp_proto_cache_range_t *range;
+    const ucp_proto_init_elem_t *proto;
+    ucs_status_t status;
+    unsigned proto_idx;
+
+    ucs_array_for_each(proto, &proto_init->protocols) {
+        if (proto->cfg_thresh != UCS_MEMUNITS_AUTO) {
+            ucs_trace("%s has a configured threshold, ignoring cached "
+                      "selection", ucp_proto_id_field(proto->proto_id, name));
+            status = UCS_ERR_UNSUPPORTED;
+            goto err;
+        }
+    }
+
+    ucs_array_for_each(range, table) {
+        for (proto_idx = 0;
+             proto_idx < ucs_array_length(&proto_init->protocols);
+             ++proto_idx) {
+            proto = &ucs_array_elem(&proto_init->protocols, proto_idx);
+            if ((proto->proto_id == range->proto_id) &&
+                ucp_proto_select_init_elem_covers(proto, range_start,
+                                                  range->max_msg_length)) {
+                break;
+            }
+        }
+
+        if (proto_idx == ucs_array_length(&proto_init->protocols)) {
+            ucs_trace("cached protocol %s is not available for %zu..%zu",
+                      ucp_proto_id_field(range->proto_id, name), range_start,
+                      range->max_msg_length);
+            status = UCS_ERR_UNSUPPORTED;
+            goto err;
+        }
+
+        thresh_elem = ucs_array_append(&thresholds,
+                                       status = UCS_ERR_NO_MEMORY;
+                                       goto err);
+        thresh_elem->max_msg_length = range->max_msg_length;
+        ucp_proto_select_config_init(worker, proto_init, proto_idx,
+                                     ep_cfg_index, rkey_cfg_index, select_param,
+                                     &thresh_elem->proto_config);
+        range_start = range->max_msg_length + 1;
+    }
+
+    *thresholds_p = ucs_array_extract_buffer(&thresholds);
+    return UCS_OK;
+
+err:
+    ucs_array_cleanup_dynamic(&thresholds);
+    return status;
+}
+
+static ucs_status_t
+ucp_proto_select_elem_init_thresh(ucp_worker_h worker,
+                                  ucp_proto_select_elem_t *select_elem,
+                                  ucp_proto_select_init_protocols_t *proto_init,
+                                  ucp_worker_cfg_index_t ep_cfg_index,
+                                  ucp_worker_cfg_index_t rkey_cfg_index,
+                                  const ucp_proto_select_param_t *select_param,
+                                  const ucp_proto_cache_table_t *cache_table,
+                                  int internal)
+{
+    ucs_status_t status;
+
+    if (cache_table != NULL) {
+        status = ucp_proto_select_thresholds_from_cache(
+                worker, proto_init, ep_cfg_index, rkey_cfg_index, select_param,
+                cache_table, &select_elem->thresholds);
+    } else {
+        status = ucp_proto_select_thresholds_build(worker, proto_init,
+                                                   ep_cfg_index, rkey_cfg_index,
+                                                   select_param, internal,
+                                                   &select_elem->thresholds);
+    }
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* Set pointer to priv buffer (to release it during cleanup) */
+    select_elem->proto_init = *proto_init;
+    ucs_array_init_dynamic(&proto_init->priv_buf);
+    ucs_array_init_dynamic(&proto_init->protocols);
+
+    return UCS_OK;
+}
+
 /**
  * Get map of lanes used in the selected protocols.
  */
@@ -470,6 +607,38 @@ ucp_proto_select_wiface_activate(ucp_worker_h worker,
     ep_config->proto_lane_map |= lane_map;
 }
 
+static ucs_status_t
+ucp_proto_select_elem_init_protocols(ucp_worker_h worker, int internal,
+                                     ucp_worker_cfg_index_t ep_cfg_index,
+                                     ucp_worker_cfg_index_t rkey_cfg_index,
+                                     const ucp_proto_select_param_t *select_param,
+                                     const ucp_proto_id_mask_t *proto_mask,
+                                     const ucp_proto_cache_table_t *cache_table,
+                                     ucp_proto_select_elem_t *select_elem)
+{
+    ucp_proto_select_init_protocols_t proto_init;
+    ucs_status_t status;
+
+    status = ucp_proto_select_init_protocols(worker, ep_cfg_index,
+                                             rkey_cfg_index, select_param,
+                                             proto_mask, &proto_init);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (worker->context->config.ext.proto_tune) {
+        ucp_proto_tune_load_elems(worker, ep_cfg_index, select_param,
+                                  &proto_init);
+    }
+
+    status = ucp_proto_select_elem_init_thresh(worker, select_elem, &proto_init,
+                                               ep_cfg_index, rkey_cfg_index,
+                                               select_param, cache_table,
+                                               internal);
+    ucp_proto_select_cleanup_protocols(&proto_init);
+    return status;
+}
+
 static ucs_status_t
 ucp_proto_select_elem_init(ucp_worker_h worker, int internal,
                            ucp_worker_cfg_index_t ep_cfg_index,
@@ -480,7 +649,9 @@ ucp_proto_select_elem_init(ucp_worker_h worker, int internal,
     ucp_proto_select_param_t select_param_copy = *select_param;
     UCS_STRING_BUFFER_ONSTACK(sel_param_strb, UCP_PROTO_SELECT_PARAM_STR_MAX);
     UCS_STRING_BUFFER_ONSTACK(config_name_strb, UCP_PROTO_SELECT_PARAM_STR_MAX);
-    ucp_proto_select_init_protocols_t proto_init;
+    const ucp_proto_cache_table_t *cache_table;
+    const ucp_proto_cache_range_t *cache_range;
+    ucp_proto_id_mask_t cache_proto_mask;
     ucs_status_t status;
 
     select_param_copy.op_attr |= worker->context->config.ext.extra_op_attr_flags;
@@ -495,35 +666,82 @@ ucp_proto_select_elem_init(ucp_worker_h worker, int internal,
 
     ucs_log_indent(1);
 
-    status = ucp_proto_select_init_protocols(worker, ep_cfg_index,
-                                             rkey_cfg_index, &select_param_copy,
-                                             &proto_init);
-    if (status != UCS_OK) {
-        goto out;
+    /* Selections with a remote key are not cached, since the key does not
+     * identify the remote memory */
+    cache_table = (rkey_cfg_index == UCP_WORKER_CFG_INDEX_NULL) ?
+                  ucp_proto_cache_lookup(worker, ep_cfg_index, select_param) :
+                  NULL;
+    if (cache_table != NULL) {
+        /* Probe only the protocols of the cached selection */
+        UCS_STATIC_BITMAP_RESET_ALL(&cache_proto_mask);
+        ucs_array_for_each(cache_range, cache_table) {
+            if (UCS_STATIC_BITMAP_GET(worker->context->proto_bitmap,
+                                      cache_range->proto_id)) {
+                UCS_STATIC_BITMAP_SET(&cache_proto_mask,
+                                      cache_range->proto_id);
+            }
+        }
+
+        status = ucp_proto_select_elem_init_protocols(
+                worker, internal, ep_cfg_index, rkey_cfg_index,
+                &select_param_copy, &cache_proto_mask, cache_table,
+                select_elem);
+        if (status == UCS_OK) {
+            goto out_activate;
+        }
+
+        ucs_debug("worker %p: cached protocol selection for %s is not valid",
+                  worker, ucs_string_buffer_cstr(&sel_param_strb));
     }
 
-    status = ucp_proto_select_elem_init_thresh(worker, select_elem, &proto_init,
-                                               ep_cfg_index, rkey_cfg_index,
-                                               &select_param_copy, internal);
+    status = ucp_proto_select_elem_init_protocols(
+            worker, internal, ep_cfg_index, rkey_cfg_index, &select_param_copy,
+            &worker->context->proto_bitmap, NULL, select_elem);
     if (status != UCS_OK) {
-        goto out_cleanup_proto_init;
+        goto out;
     }
 
+out_activate:
     ucp_proto_select_wiface_activate(worker, select_elem, ep_cfg_index);
 
     if (!internal) {
         ucp_proto_select_elem_trace(worker, &select_param_copy, select_elem, 0);
     }
 
-    status = UCS_OK;
-
-out_cleanup_proto_init:
-    ucp_proto_select_cleanup_protocols(&proto_init);
 out:
     ucs_log_indent(-1);
     return status;
 }
 
+ucs_status_t ucp_proto_select_elem_update_thresh(
+        ucp_worker_h worker, ucp_proto_select_elem_t *select_elem,
+        const ucp_proto_threshold_elem_t **old_thresholds_p)
+{
+    const ucp_proto_config_t *proto_config = &select_elem->thresholds[0]
+                                                      .proto_config;
+    const ucp_proto_threshold_elem_t *thresholds;
+    ucs_status_t status;
+
+    /* Protocols are not probed again, so the private configurations and the
+     * initialization elements remain valid for requests which already use
+     * the previous thresholds */
+    status = ucp_proto_select_thresholds_build(worker,
+                                               &select_elem->proto_init,
+                                               proto_config->ep_cfg_index,
+                                               proto_config->rkey_cfg_index,
+                                               &proto_config->select_param, 1,
+                                               &thresholds);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    *old_thresholds_p       = select_elem->thresholds;
+    select_elem->thresholds = thresholds;
+    ucp_proto_select_wiface_activate(worker, select_elem,
+                                     proto_config->ep_cfg_index);
+    return UCS_OK;
+}
+
 static void
 ucp_proto_select_elem_cleanup(ucp_proto_select_elem_t *select_elem)
 {
@@ -545,6 +763,7 @@ ucp_proto_select_lookup_slow(ucp_worker_h worker,
                              const ucp_proto_select_param_t *select_param)
 {
     ucp_proto_select_elem_t *select_elem, tmp_select_elem;
+    ucp_proto_init_elem_t *init_elem;
     ucp_proto_select_key_t key;
     ucs_status_t status;
     khiter_t khiter;
@@ -585,6 +804,11 @@ ucp_proto_select_lookup_slow(ucp_worker_h worker,
     select_elem  = &kh_value(proto_select->hash, khiter);
     *select_elem = tmp_select_elem;
 
+    /* Let online tuning find the element of a protocol by its key */
+    ucs_array_for_each(init_elem, &select_elem->proto_init.protocols) {
+        init_elem->tune.select_key = key.u64;
+    }
+
     /* Adding hash values may reallocate the array, so the cached pointer to
      * select_elem may not be valid anymore.
      */
@@ -9,6 +9,7 @@
 
 #include "proto.h"
 #include "proto_perf.h"
+#include "proto_tune.h"
 
 #include <ucs/datastruct/khash.h>
 #include <ucs/datastruct/array.h>
@@ -61,6 +62,7 @@ typedef struct {
     unsigned              cfg_priority; /* Priority of configuration */
     ucp_proto_perf_t      *perf;
     ucp_proto_flat_perf_t *flat_perf; /* Flat performance considering all parts */
+    ucp_proto_tune_t      tune; /* Online tuning state */
 } ucp_proto_init_elem_t;
 
 
@@ -108,7 +110,7 @@ struct ucp_proto_select_param {
 /**
  * Protocol and its private configuration
  */
-typedef struct {
+struct ucp_proto_config {
     /* Protocol definition */
     const ucp_proto_t        *proto;
 
@@ -136,7 +138,7 @@ typedef struct {
 
     /* Progress wrapper callbacks */
     uct_pending_callback_t      progress_wrapper[UCP_PROTO_STAGE_LAST];
-} ucp_proto_config_t;
+};
 
 
 /**
@@ -241,6 +243,21 @@ int ucp_proto_select_get_valid_range(
         size_t *max_length_p);
 
 
+/**
+ * Recalculate the thresholds of a protocol selection element after the
+ * estimated performance of its protocols has changed.
+ *
+ * @param [in]  worker            UCP worker.
+ * @param [in]  select_elem       Protocol selection element to update.
+ * @param [out] old_thresholds_p  Filled with the previous thresholds array,
+ *                                which may still be used by in-flight
+ *                                requests and must be released by the caller.
+ */
+ucs_status_t ucp_proto_select_elem_update_thresh(
+        ucp_worker_h worker, ucp_proto_select_elem_t *select_elem,
+        const ucp_proto_threshold_elem_t **old_thresholds_p);
+
+
 /* Get the protocol selection hash for the endpoint or remote key config */
 ucp_proto_select_t *
 ucp_proto_select_get(ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index,
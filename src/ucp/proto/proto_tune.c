@@ -0,0 +1,546 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_tune.h"
+#include "proto_cache.h"
+#include "proto_debug.h"
+#include "proto_select.h"
+#include "proto_select.inl"
+
+#include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <ucs/time/time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* Minimal relative change of the corrected time at the average sample, which
+ * causes recalculation of the thresholds */
+#define UCP_PROTO_TUNE_MIN_CHANGE 0.05
+
+/* Minimal standard deviation of the estimated times, relative to their
+ * average, to fit both the constant and the slope of the correction */
+#define UCP_PROTO_TUNE_MIN_SPREAD 0.1
+
+/* Maximal power of two, by which the number of samples for a correction is
+ * multiplied */
+#define UCP_PROTO_TUNE_MAX_WINDOW_SHIFT 10
+
+/* Maximal length of a line in the corrections file */
+#define UCP_PROTO_TUNE_LINE_MAX   1024
+
+/* Format string to display a correction of the estimated time */
+#define UCP_PROTO_TUNE_CORR_FMT   "%.2f ns + %.3f*T"
+#define UCP_PROTO_TUNE_CORR_ARG(_corr) ((_corr)->c * 1e9), (_corr)->m
+
+
+KHASH_IMPL(ucp_proto_tune_hash, kh_cstr_t, ucs_linear_func_t, 1,
+           kh_str_hash_func, kh_str_hash_equal)
+
+
+/*
+ * Protocol key, which is built from the protocol name, the selection parameters
+ * and the transport resources of the endpoint lanes, so it identifies the
+ * protocol across different runs on the same hardware.
+ */
+static void ucp_proto_tune_key_str(ucp_worker_h worker,
+                                   ucp_worker_cfg_index_t ep_cfg_index,
+                                   const ucp_proto_select_param_t *select_param,
+                                   ucp_proto_id_t proto_id,
+                                   ucs_string_buffer_t *strb)
+{
+    ucs_string_buffer_appendf(strb, "%s ",
+                              ucp_proto_id_field(proto_id, name));
+    ucp_proto_select_param_str(select_param, ucp_operation_names, strb);
+    ucp_proto_cache_ep_fingerprint(worker, ep_cfg_index, strb);
+}
+
+static void
+ucp_proto_tune_set(ucp_worker_h worker, const char *key, ucs_linear_func_t corr)
+{
+    khash_t(ucp_proto_tune_hash) *corrs = &worker->proto_tune.corrs;
+    khiter_t khiter;
+    char *key_copy;
+    int khret;
+
+    khiter = kh_get(ucp_proto_tune_hash, corrs, key);
+    if (khiter == kh_end(corrs)) {
+        key_copy = ucs_strdup(key, "proto_tune_key");
+        if (key_copy == NULL) {
+            ucs_error("failed to allocate protocol tuning key");
+            return;
+        }
+
+        khiter = kh_put(ucp_proto_tune_hash, corrs, key_copy, &khret);
+        if (khret == UCS_KH_PUT_FAILED) {
+            ucs_error("failed to add protocol tuning key '%s'", key);
+            ucs_free(key_copy);
+            return;
+        }
+    }
+
+    kh_value(corrs, khiter) = corr;
+}
+
+static void ucp_proto_tune_load(ucp_worker_h worker, const char *filename)
+{
+    char line[UCP_PROTO_TUNE_LINE_MAX];
+    ucs_linear_func_t corr;
+    unsigned count;
+    FILE *stream;
+    int key_offset;
+
+    stream = fopen(filename, "r");
+    if (stream == NULL) {
+        /* The file does not exist before the first run */
+        if (errno != ENOENT) {
+            ucs_warn("failed to open protocol tuning file '%s': %m",
+                     filename);
+        }
+        return;
+    }
+
+    count = 0;
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        line[strcspn(line, "\n")] = '\0';
+        if ((line[0] == '#') || (line[0] == '\0')) {
+            continue;
+        }
+
+        key_offset = 0;
+        if ((sscanf(line, "%lf %lf %n", &corr.c, &corr.m, &key_offset) < 2) ||
+            (key_offset == 0) || (corr.m <= 0) || (corr.c < 0)) {
+            ucs_warn("%s: ignoring malformed line '%s'", filename, line);
+            continue;
+        }
+
+        ucp_proto_tune_set(worker, line + key_offset, corr);
+        ++count;
+    }
+
+    fclose(stream);
+    ucs_debug("worker %p: loaded %u protocol corrections from '%s'", worker,
+              count, filename);
+}
+
+static void ucp_proto_tune_collect(ucp_worker_h worker,
+                                   const ucp_proto_select_t *proto_select)
+{
+    UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_TUNE_LINE_MAX);
+    const ucp_proto_select_elem_t *select_elem;
+    const ucp_proto_config_t *proto_config;
+    const ucp_proto_init_elem_t *init_elem;
+    khiter_t khiter;
+
+    for (khiter = kh_begin(proto_select->hash);
+         khiter != kh_end(proto_select->hash); ++khiter) {
+        if (!kh_exist(proto_select->hash, khiter)) {
+            continue;
+        }
+
+        select_elem  = &kh_value(proto_select->hash, khiter);
+        proto_config = &select_elem->thresholds[0].proto_config;
+        ucs_array_for_each(init_elem, &select_elem->proto_init.protocols) {
+            if (init_elem->tune.corr.m == 0) {
+                continue;
+            }
+
+            ucs_string_buffer_reset(&strb);
+            ucp_proto_tune_key_str(worker, proto_config->ep_cfg_index,
+                                   &proto_config->select_param,
+                                   init_elem->proto_id, &strb);
+            ucp_proto_tune_set(worker, ucs_string_buffer_cstr(&strb),
+                               init_elem->tune.corr);
+        }
+    }
+}
+
+static void ucp_proto_tune_save(ucp_worker_h worker, const char *filename)
+{
+    ucp_ep_config_t *ep_config;
+    ucp_rkey_config_t *rkey_config;
+    ucs_linear_func_t corr;
+    ucs_status_t status;
+    char *tmp_filename;
+    const char *key;
+    FILE *stream;
+    int fd;
+
+    ucs_array_for_each(ep_config, &worker->ep_config) {
+        ucp_proto_tune_collect(worker, &ep_config->proto_select);
+    }
+
+    ucs_array_for_each(rkey_config, &worker->rkey_config) {
+        ucp_proto_tune_collect(worker, &rkey_config->proto_select);
+    }
+
+    if (kh_size(&worker->proto_tune.corrs) == 0) {
+        return;
+    }
+
+    /* Write to a private file and rename it, so other workers never read a
+     * partially written file */
+    status = ucs_string_alloc_formatted_path(&tmp_filename, "tmp_filename",
+                                             "%s.%d.%p.tmp", filename,
+                                             getpid(), worker);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    fd = open(tmp_filename, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        ucs_warn("failed to create protocol tuning file '%s': %m",
+                 tmp_filename);
+        goto out_free;
+    }
+
+    stream = fdopen(fd, "w");
+    if (stream == NULL) {
+        ucs_warn("failed to open protocol tuning file '%s': %m", tmp_filename);
+        close(fd);
+        goto err_unlink;
+    }
+
+    fprintf(stream, "# UCX protocol performance corrections\n");
+    fprintf(stream, "# <constant [sec]> <factor> <protocol key>\n");
+    kh_foreach(&worker->proto_tune.corrs, key, corr,
+        fprintf(stream, "%.9e %.9e %s\n", corr.c, corr.m, key);
+    )
+
+    if (fclose(stream) != 0) {
+        ucs_warn("failed to write protocol tuning file '%s': %m",
+                 tmp_filename);
+        goto err_unlink;
+    }
+
+    if (rename(tmp_filename, filename) != 0) {
+        ucs_warn("failed to rename '%s' to '%s': %m", tmp_filename, filename);
+        goto err_unlink;
+    }
+
+    ucs_debug("worker %p: saved %u protocol corrections to '%s'", worker,
+              kh_size(&worker->proto_tune.corrs), filename);
+    goto out_free;
+
+err_unlink:
+    unlink(tmp_filename);
+out_free:
+    ucs_free(tmp_filename);
+}
+
+void ucp_proto_tune_init(ucp_worker_h worker)
+{
+    ucp_context_h context = worker->context;
+
+    kh_init_inplace(ucp_proto_tune_hash, &worker->proto_tune.corrs);
+    ucs_array_init_dynamic(&worker->proto_tune.retired);
+    memset(worker->proto_tune.slots, 0, sizeof(worker->proto_tune.slots));
+
+    if (context->config.ext.proto_tune &&
+        !ucs_string_is_empty(context->config.ext.proto_tune_file)) {
+        ucp_proto_tune_load(worker, context->config.ext.proto_tune_file);
+    }
+}
+
+void ucp_proto_tune_cleanup(ucp_worker_h worker)
+{
+    ucp_context_h context = worker->context;
+    const char *key;
+    void **thresholds;
+
+    if (context->config.ext.proto_tune &&
+        !ucs_string_is_empty(context->config.ext.proto_tune_file)) {
+        ucp_proto_tune_save(worker, context->config.ext.proto_tune_file);
+    }
+
+    ucs_array_for_each(thresholds, &worker->proto_tune.retired) {
+        ucs_free(*thresholds);
+    }
+    ucs_array_cleanup_dynamic(&worker->proto_tune.retired);
+
+    kh_foreach_key(&worker->proto_tune.corrs, key,
+        ucs_free((void*)key);
+    )
+    kh_destroy_inplace(ucp_proto_tune_hash, &worker->proto_tune.corrs);
+}
+
+void ucp_proto_tune_load_elems(ucp_worker_h worker,
+                               ucp_worker_cfg_index_t ep_cfg_index,
+                               const ucp_proto_select_param_t *select_param,
+                               ucp_proto_probe_ctx_t *proto_init)
+{
+    UCS_STRING_BUFFER_ONSTACK(strb, UCP_PROTO_TUNE_LINE_MAX);
+    khash_t(ucp_proto_tune_hash) *corrs = &worker->proto_tune.corrs;
+    ucp_proto_init_elem_t *init_elem;
+    khiter_t khiter;
+
+    if (kh_size(corrs) == 0) {
+        return;
+    }
+
+    ucs_array_for_each(init_elem, &proto_init->protocols) {
+        ucs_string_buffer_reset(&strb);
+        ucp_proto_tune_key_str(worker, ep_cfg_index, select_param,
+                               init_elem->proto_id, &strb);
+        khiter = kh_get(ucp_proto_tune_hash, corrs,
+                        ucs_string_buffer_cstr(&strb));
+        if (khiter != kh_end(corrs)) {
+            init_elem->tune.corr = kh_value(corrs, khiter);
+            ucs_trace("%s: loaded correction " UCP_PROTO_TUNE_CORR_FMT,
+                      ucs_string_buffer_cstr(&strb),
+                      UCP_PROTO_TUNE_CORR_ARG(&init_elem->tune.corr));
+        }
+    }
+}
+
+static ucp_proto_select_t *
+ucp_proto_tune_proto_select(ucp_worker_h worker,
+                            ucp_worker_cfg_index_t ep_cfg_index,
+                            ucp_worker_cfg_index_t rkey_cfg_index)
+{
+    if (rkey_cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
+        return &ucs_array_elem(&worker->ep_config, ep_cfg_index).proto_select;
+    }
+
+    return &ucs_array_elem(&worker->rkey_config, rkey_cfg_index).proto_select;
+}
+
+static ucp_proto_select_elem_t *
+ucp_proto_tune_find_elem(ucp_worker_h worker,
+                         const ucp_proto_config_t *proto_config)
+{
+    const ucp_proto_init_elem_t *init_elem = proto_config->init_elem;
+    ucp_proto_select_elem_t *select_elem;
+    ucp_proto_select_t *proto_select;
+    khiter_t khiter;
+
+    /* The selection key of the protocol configuration could be modified by
+     * UCX_EXTRA_OP_ATTR_FLAGS, so use the key of the hash element */
+    proto_select = ucp_proto_tune_proto_select(worker,
+                                               proto_config->ep_cfg_index,
+                                               proto_config->rkey_cfg_index);
+    khiter       = kh_get(ucp_proto_select_hash, proto_select->hash,
+                          init_elem->tune.select_key);
+    if (khiter == kh_end(proto_select->hash)) {
+        return NULL;
+    }
+
+    select_elem = &kh_value(proto_select->hash, khiter);
+    ucs_assert(init_elem >=
+               ucs_array_begin(&select_elem->proto_init.protocols));
+    ucs_assert(init_elem < ucs_array_end(&select_elem->proto_init.protocols));
+    return select_elem;
+}
+
+/* Fast-path short thresholds are derived from the selection thresholds */
+static void ucp_proto_tune_update_short(ucp_worker_h worker,
+                                        const ucp_proto_config_t *proto_config)
+{
+    if (proto_config->rkey_cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
+        ucp_ep_config_proto_short_init(worker, proto_config->ep_cfg_index);
+    } else {
+        ucp_worker_rkey_config_short_init(worker,
+                                          proto_config->rkey_cfg_index);
+    }
+}
+
+static void ucp_proto_tune_update(ucp_worker_h worker,
+                                  const ucp_proto_config_t *proto_config,
+                                  ucp_proto_tune_t *tune)
+{
+    const ucs_linear_func_t identity = ucs_linear_func_make(0, 1);
+    const ucp_proto_threshold_elem_t *old_thresholds;
+    ucp_proto_select_elem_t *select_elem;
+    double mean_x, mean_y, var_x, cov_xy, min_spread;
+    double prev_time, new_time;
+    ucs_linear_func_t corr;
+    ucs_status_t status;
+
+    mean_x = tune->sum_x / tune->count;
+    mean_y = tune->sum_y / tune->count;
+    var_x  = (tune->sum_xx / tune->count) - (mean_x * mean_x);
+    cov_xy = (tune->sum_xy / tune->count) - (mean_x * mean_y);
+    ++tune->num_fits;
+
+    tune->count  = 0;
+    tune->sum_x  = 0;
+    tune->sum_y  = 0;
+    tune->sum_xx = 0;
+    tune->sum_xy = 0;
+
+    if (mean_x <= 0) {
+        return;
+    }
+
+    min_spread = UCP_PROTO_TUNE_MIN_SPREAD * mean_x;
+    if (var_x > (min_spread * min_spread)) {
+        corr.m = cov_xy / var_x;
+        corr.c = mean_y - (corr.m * mean_x);
+    } else {
+        corr.m = 0;
+        corr.c = 0;
+    }
+
+    if ((corr.m <= 0) || (corr.c < 0)) {
+        /* Message sizes are too close to each other, or the linear fit does
+         * not make sense: correct only the ratio */
+        corr = ucs_linear_func_make(0, mean_y / mean_x);
+    }
+
+    prev_time = ucs_linear_func_apply((tune->corr.m == 0) ? identity :
+                                      tune->corr, mean_x);
+    new_time  = ucs_linear_func_apply(corr, mean_x);
+    if (fabs(new_time - prev_time) <= (prev_time * UCP_PROTO_TUNE_MIN_CHANGE)) {
+        return;
+    }
+
+    ucs_debug("worker %p: %s estimated %.2f us measured %.2f us, correction "
+              UCP_PROTO_TUNE_CORR_FMT, worker, proto_config->proto->name,
+              mean_x * 1e6, mean_y * 1e6, UCP_PROTO_TUNE_CORR_ARG(&corr));
+
+    /* The correction is saved and applied to new selection elements even if
+     * the thresholds of existing ones can't be recalculated anymore */
+    tune->corr = corr;
+    if (ucs_array_length(&worker->proto_tune.retired) >=
+        UCP_PROTO_TUNE_MAX_RETIRED) {
+        ucs_debug("worker %p: not updating %s thresholds, reached %u "
+                  "replaced threshold arrays", worker,
+                  proto_config->proto->name, UCP_PROTO_TUNE_MAX_RETIRED);
+        return;
+    }
+
+    select_elem = ucp_proto_tune_find_elem(worker, proto_config);
+    if (select_elem == NULL) {
+        return;
+    }
+
+    status     = ucp_proto_select_elem_update_thresh(worker, select_elem,
+                                                     &old_thresholds);
+    if (status != UCS_OK) {
+        ucs_diag("worker %p: failed to update %s thresholds: %s", worker,
+                 proto_config->proto->name, ucs_status_string(status));
+        return;
+    }
+
+    /* Requests which already use the previous thresholds keep their protocol
+     * configuration until completion */
+    *ucs_array_append(&worker->proto_tune.retired,
+                      ucs_free((void*)old_thresholds); return) =
+            (void*)old_thresholds;
+
+    ucp_proto_select_elem_trace(worker, &proto_config->select_param,
+                                select_elem, 0);
+    ucp_proto_tune_update_short(worker, proto_config);
+}
+
+static void ucp_proto_tune_account(ucp_worker_h worker,
+                                   const ucp_proto_config_t *proto_config,
+                                   size_t msg_length, ucs_time_t start_time)
+{
+    const ucp_proto_flat_perf_range_t *range;
+    ucp_proto_init_elem_t *init_elem;
+    double estimated, measured;
+    ucp_proto_tune_t *tune;
+    unsigned window_shift;
+
+    init_elem = ucs_const_cast(ucp_proto_init_elem_t*, proto_config->init_elem);
+    range     = ucp_proto_flat_perf_find_lb(init_elem->flat_perf, msg_length);
+    if ((range == NULL) || (msg_length < range->start)) {
+        return;
+    }
+
+    /* Compare to the estimation without correction, to avoid accumulating
+     * the error of previous corrections */
+    estimated = ucs_linear_func_apply(range->value, msg_length);
+    measured  = ucs_time_to_sec(ucs_get_time() - start_time);
+
+    tune          = &init_elem->tune;
+    tune->sum_x  += estimated;
+    tune->sum_y  += measured;
+    tune->sum_xx += estimated * estimated;
+    tune->sum_xy += estimated * measured;
+
+    window_shift = ucs_min(tune->num_fits, UCP_PROTO_TUNE_MAX_WINDOW_SHIFT);
+    if (++tune->count >= (worker->context->config.ext.proto_tune_samples <<
+                          window_shift)) {
+        ucp_proto_tune_update(worker, proto_config, tune);
+    }
+}
+
+void ucp_proto_tune_sample(ucp_request_t *req)
+{
+    ucp_worker_h worker = req->send.ep->worker;
+    const ucp_proto_config_t *proto_config;
+    ucp_proto_tune_slot_t *slot;
+    ucs_time_t start_time;
+
+    req->flags &= ~UCP_REQUEST_FLAG_PROTO_TUNE;
+
+    slot = ucp_proto_tune_slot(&worker->proto_tune, req);
+    if (slot->req != req) {
+        /* The slot was taken by a request which started later */
+        return;
+    }
+
+    proto_config = slot->proto_config;
+    start_time   = slot->start_time;
+    slot->req    = NULL;
+
+    ucp_proto_tune_account(worker, proto_config,
+                           req->send.state.dt_iter.length, start_time);
+}
+
+void ucp_proto_tune_cancel(ucp_request_t *req)
+{
+    ucp_proto_tune_slot_t *slot;
+
+    req->flags &= ~UCP_REQUEST_FLAG_PROTO_TUNE;
+
+    slot = ucp_proto_tune_slot(&req->send.ep->worker->proto_tune, req);
+    if (slot->req == req) {
+        slot->req = NULL;
+    }
+}
+
+void ucp_proto_tune_sample_short(ucp_ep_h ep,
+                                 ucp_worker_cfg_index_t rkey_cfg_index,
+                                 ucp_operation_id_t op_id,
+                                 uint32_t op_attr_mask, uint8_t op_flags,
+                                 size_t length, ucs_time_t start_time)
+{
+    ucp_worker_h worker = ep->worker;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    ucp_proto_select_param_t select_param;
+    ucp_memory_info_t mem_info;
+
+    /* Short sends are contiguous host memory buffers, as selected by
+     * ucp_proto_select_short_init() */
+    ucp_memory_info_set_host(&mem_info);
+    ucp_proto_select_param_init(&select_param, op_id, op_attr_mask, op_flags,
+                                UCP_DATATYPE_CONTIG, &mem_info, 1);
+    thresh_elem = ucp_proto_select_lookup(
+            worker,
+            ucp_proto_tune_proto_select(worker, ep->cfg_index, rkey_cfg_index),
+            ep->cfg_index, rkey_cfg_index, &select_param, length);
+    if (thresh_elem == NULL) {
+        return;
+    }
+
+    ucp_proto_tune_account(worker, &thresh_elem->proto_config, length,
+                           start_time);
+}
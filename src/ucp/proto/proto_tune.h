@@ -0,0 +1,191 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_TUNE_H_
+#define UCP_PROTO_TUNE_H_
+
+#include "proto.h"
+
+#include <ucs/datastruct/array.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/linear_func.h>
+
+
+/* Learned corrections of protocol performance, by protocol key string */
+KHASH_TYPE(ucp_proto_tune_hash, kh_cstr_t, ucs_linear_func_t)
+
+
+/* Threshold arrays replaced by tuning, which may still be used by requests */
+UCS_ARRAY_DECLARE_TYPE(ucp_proto_tune_retired_t, unsigned, void*);
+
+
+/* Number of send requests which can be measured at the same time */
+#define UCP_PROTO_TUNE_NUM_SLOTS   64
+
+
+/* Maximal number of replaced threshold arrays per worker. Since they can not
+ * be released while requests are in flight, thresholds are not recalculated
+ * anymore once this limit is reached. */
+#define UCP_PROTO_TUNE_MAX_RETIRED 256
+
+
+/**
+ * Measurement of an in-flight send request. The slot is selected by the
+ * request address, and a request which takes an occupied slot replaces the
+ * previous measurement, so the request itself does not hold any tuning state.
+ */
+typedef struct {
+    /* Measured request, or NULL if the slot is free */
+    ucp_request_t            *req;
+
+    /* Request start time */
+    ucs_time_t               start_time;
+
+    /* Protocol selected at request start */
+    const ucp_proto_config_t *proto_config;
+} ucp_proto_tune_slot_t;
+
+
+/**
+ * Online tuning state of a protocol in a protocol selection element
+ */
+typedef struct {
+    /* Correction applied to the estimated time of the protocol:
+     * corrected_time = corr(estimated_time). Zero slope means no correction. */
+    ucs_linear_func_t corr;
+
+    /* Key of the protocol selection element in its hash, since the element
+     * moves when the hash is resized */
+    uint64_t          select_key;
+
+    /* Number of samples collected since the last correction */
+    unsigned          count;
+
+    /* Number of corrections fitted so far. Every fit doubles the number of
+     * samples required for the next one, so the thresholds converge instead
+     * of following the noise of the measurements. */
+    unsigned          num_fits;
+
+    /* Sums of estimated (x) and measured (y) completion times, to fit the
+     * correction by linear least squares */
+    double            sum_x;
+    double            sum_y;
+    double            sum_xx;
+    double            sum_xy;
+} ucp_proto_tune_t;
+
+
+/**
+ * Per-worker tuning context
+ */
+typedef struct {
+    /* Corrections loaded from a file or learned by this worker */
+    khash_t(ucp_proto_tune_hash) corrs;
+
+    /* Threshold arrays replaced by recalculation */
+    ucp_proto_tune_retired_t     retired;
+
+    /* Send requests being measured */
+    ucp_proto_tune_slot_t        slots[UCP_PROTO_TUNE_NUM_SLOTS];
+} ucp_proto_tune_ctx_t;
+
+
+/**
+ * Initialize the tuning context of a worker, and load the learned corrections
+ * from UCX_PROTO_TUNE_FILE.
+ */
+void ucp_proto_tune_init(ucp_worker_h worker);
+
+
+/**
+ * Save the learned corrections to UCX_PROTO_TUNE_FILE, and release the tuning
+ * context of a worker. Must be called before the worker configurations are
+ * destroyed.
+ */
+void ucp_proto_tune_cleanup(ucp_worker_h worker);
+
+
+/**
+ * Account the completion time of a send request which was started with
+ * @ref ucp_proto_request_tune_start, if it is still being measured, and
+ * recalculate the protocol selection thresholds when the protocol performance
+ * estimation is corrected.
+ *
+ * @param [in] req     Completed send request.
+ */
+void ucp_proto_tune_sample(ucp_request_t *req);
+
+
+/**
+ * Stop measuring a send request which is queued before sending any data, so
+ * the time it waits for resources is not accounted to its protocol.
+ *
+ * @param [in] req     Send request added to a pending queue.
+ */
+void ucp_proto_tune_cancel(ucp_request_t *req);
+
+
+/**
+ * Account the completion time of a short send which was completed inline on
+ * the fast path, without a request.
+ *
+ * @param [in] ep              Endpoint the message was sent on.
+ * @param [in] rkey_cfg_index  Remote key configuration of an RMA operation,
+ *                             or UCP_WORKER_CFG_INDEX_NULL.
+ * @param [in] op_id           Operation type.
+ * @param [in] op_attr_mask    Operation attributes of the send call.
+ * @param [in] op_flags        Protocol selection flags of the operation.
+ * @param [in] length          Message length, including the user header.
+ * @param [in] start_time      Time when the send started.
+ */
+void ucp_proto_tune_sample_short(ucp_ep_h ep,
+                                 ucp_worker_cfg_index_t rkey_cfg_index,
+                                 ucp_operation_id_t op_id,
+                                 uint32_t op_attr_mask, uint8_t op_flags,
+                                 size_t length, ucs_time_t start_time);
+
+
+/**
+ * Set the learned corrections for a newly initialized set of protocols.
+ *
+ * @param [in]    worker        UCP worker.
+ * @param [in]    ep_cfg_index  Endpoint configuration of the protocols.
+ * @param [in]    select_param  Protocol selection parameters.
+ * @param [inout] proto_init    Protocols to update.
+ */
+void ucp_proto_tune_load_elems(ucp_worker_h worker,
+                               ucp_worker_cfg_index_t ep_cfg_index,
+                               const ucp_proto_select_param_t *select_param,
+                               ucp_proto_probe_ctx_t *proto_init);
+
+
+/**
+ * @return Measurement slot of a send request.
+ */
+static UCS_F_ALWAYS_INLINE ucp_proto_tune_slot_t *
+ucp_proto_tune_slot(ucp_proto_tune_ctx_t *tune_ctx, const ucp_request_t *req)
+{
+    uint64_t key = (uintptr_t)req;
+
+    return &tune_ctx->slots[kh_int64_hash_func(key) %
+                            UCP_PROTO_TUNE_NUM_SLOTS];
+}
+
+
+/**
+ * Apply the learned correction of a protocol to its estimated time function.
+ */
+static UCS_F_ALWAYS_INLINE ucs_linear_func_t
+ucp_proto_tune_apply(const ucp_proto_tune_t *tune, ucs_linear_func_t func)
+{
+    if (tune->corr.m == 0) {
+        return func;
+    }
+
+    return ucs_linear_func_compose(tune->corr, func);
+}
+
+#endif
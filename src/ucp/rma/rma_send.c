@@ -180,6 +180,8 @@ ucp_put_send_short(ucp_ep_h ep, const void *buffer, size_t length,
                    const ucp_request_param_t *param)
 {
     const ucp_rkey_config_t *rkey_config;
+    ucs_time_t UCS_V_UNUSED start_time;
+    ucs_time_t tune_start_time;
     uct_rkey_t tl_rkey;
     ucs_status_t status;
 
@@ -201,14 +203,20 @@ ucp_put_send_short(ucp_ep_h ep, const void *buffer, size_t length,
         return UCS_ERR_NO_RESOURCE;
     }
 
-    status = UCS_PROFILE_CALL(uct_ep_put_short,
-                              ucp_ep_get_fast_lane(ep,
-                                                   rkey_config->put_short.lane),
-                              buffer, length, remote_addr, tl_rkey);
+    start_time      = ucp_ep_stats_lat_start(ep);
+    tune_start_time = ucp_proto_tune_short_start(ep->worker);
+    status          = UCS_PROFILE_CALL(uct_ep_put_short,
+                                       ucp_ep_get_fast_lane(
+                                               ep, rkey_config->put_short.lane),
+                                       buffer, length, remote_addr, tl_rkey);
     if (status == UCS_OK) {
         ep->ext->unflushed_lanes |= UCS_BIT(rkey_config->put_short.lane);
     }
 
+    ucp_ep_stats_lat_inline(ep, UCP_EP_STAT_LAT_RMA, start_time, status);
+    ucp_proto_tune_short_end(ep, rkey->cfg_index, UCP_OP_ID_PUT, param, 0,
+                             length, tune_start_time, status);
+
     return status;
 }
 
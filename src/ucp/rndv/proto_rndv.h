@@ -243,6 +243,11 @@ ucs_status_t ucp_proto_rndv_handle_data(void *arg, void *data, size_t length,
                                         unsigned flags);
 
 
+ucs_status_t ucp_proto_rndv_handle_compressed_data(void *arg, void *data,
+                                                   size_t length,
+                                                   unsigned flags);
+
+
 /* Initialize req->send.multi_lane_idx according to req->rndv.offset */
 void ucp_proto_rndv_bulk_request_init_lane_idx(
         ucp_request_t *req, const ucp_proto_rndv_bulk_priv_t *rpriv);
@@ -210,6 +210,11 @@ ucp_proto_rndv_rts_request_init(ucp_request_t *req)
     ucp_send_request_id_alloc(req);
     req->flags                    |= UCP_REQUEST_FLAG_PROTO_INITIALIZED;
     req->send.state.completed_size = 0;
+#ifdef ENABLE_STATS
+    if (req->send.stats.lat_index != UCP_EP_STAT_LAT_LAST) {
+        req->send.stats.lat_index = UCP_EP_STAT_LAT_RNDV;
+    }
+#endif
 
     return UCS_OK;
 }
@@ -439,7 +444,16 @@ ucp_proto_rndv_bulk_max_payload(ucp_request_t *req,
     size_t max_frag_sum = rpriv->mpriv.max_frag_sum;
     size_t lane_offset, max_payload, weight_end_offset, end_offset;
 
-    if (ucs_likely(total_length < max_frag_sum)) {
+    if (ucs_unlikely(lpriv->dynamic_striping)) {
+        /* Lanes are chosen by their congestion rather than by the offset, so
+         * every fragment is scaled by the weight of its lane */
+        max_payload = ucp_proto_multi_scaled_length(lpriv->weight,
+                                                    total_length);
+        max_payload = ucp_proto_multi_stripe_length(
+                req, lpriv, ucs_min(max_payload, lpriv->max_frag));
+        max_payload = ucs_min(ucs_max(max_payload, rpriv->mpriv.min_frag),
+                              lpriv->max_frag);
+    } else if (ucs_likely(total_length < max_frag_sum)) {
         /**
          * Each lane sends less than its maximal fragment size but more than the
          * minimal chunk size
@@ -2448,6 +2448,7 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
     const ucp_rndv_rtr_req_hdr_t *rtr_req     = data;
     const ucp_request_data_hdr_t *rndv_data   = data;
     const ucp_rndv_ack_hdr_t *ack_hdr         = data;
+    const ucp_rndv_compressed_hdr_t *comp_hdr = data;
     const ucp_reply_hdr_t *rep_hdr            = data;
     const void *data_end                      = UCS_PTR_BYTE_OFFSET(data, length);
     const void *rkey_buf;
@@ -2526,6 +2527,14 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                                   rndv_data->req_id, rndv_data->offset,
                                   length - sizeof(*rndv_data));
         break;
+    case UCP_AM_ID_RNDV_DATA_COMPRESSED:
+        ucs_string_buffer_appendf(&strb,
+                                  "RNDV_DATA_COMPRESSED rreq_id 0x%" PRIx64
+                                  " offset %zu len %u comp_len %zu",
+                                  comp_hdr->super.req_id,
+                                  comp_hdr->super.offset, comp_hdr->length,
+                                  length - sizeof(*comp_hdr));
+        break;
     case UCP_AM_ID_RNDV_ATP:
         ucs_string_buffer_appendf(&strb,
                                   "RNDV_ATP sreq_id 0x%" PRIx64 " status '%s'",
@@ -2555,3 +2564,7 @@ UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_RMA,
 UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_RMA,
                          UCP_AM_ID_RNDV_DATA,
                          ucp_rndv_data_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_RMA,
+                         UCP_AM_ID_RNDV_DATA_COMPRESSED,
+                         ucp_proto_rndv_handle_compressed_data, ucp_rndv_dump,
+                         0);
@@ -95,6 +95,18 @@ typedef struct {
 } UCS_S_PACKED ucp_rndv_ack_hdr_t;
 
 
+/*
+ * RNDV_DATA_COMPRESSED, the payload is compressed unless its size is equal to
+ * the original size
+ */
+typedef struct {
+    ucp_request_data_hdr_t super;
+
+    /* Size of the data before compression */
+    uint32_t               length;
+} UCS_S_PACKED ucp_rndv_compressed_hdr_t;
+
+
 ucs_status_t ucp_rndv_send_rts(ucp_request_t *sreq, uct_pack_callback_t pack_cb,
                                size_t rts_body_size);
 
@@ -10,8 +10,11 @@
 
 #include "proto_rndv.inl"
 
+#include <ucs/algorithm/lz4.h>
 
-static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params)
+
+static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params,
+                                     size_t hdr_size)
 {
     ucp_context_h context = params->super.super.worker->context;
 
@@ -31,7 +34,7 @@ static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params)
     params->super.latency      = 0;
     params->first.lane_type    = UCP_LANE_TYPE_AM;
     params->middle.lane_type   = UCP_LANE_TYPE_AM_BW;
-    params->super.hdr_size     = sizeof(ucp_request_data_hdr_t);
+    params->super.hdr_size     = hdr_size;
     params->max_lanes          = context->config.ext.max_rndv_lanes;
     params->opt_align_offs     = UCP_PROTO_COMMON_OFFSET_INVALID;
 
@@ -122,7 +125,7 @@ static void ucp_rndv_am_bcopy_probe(const ucp_proto_init_params_t *init_params)
         .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_BCOPY
     };
 
-    ucp_rndv_am_probe_common(&params);
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_request_data_hdr_t));
 }
 
 static void
@@ -174,7 +177,7 @@ static ucs_status_t ucp_rndv_am_zcopy_proto_progress(uct_pending_req_t *uct_req)
     /* coverity[tainted_data_downcast] */
     return ucp_proto_multi_zcopy_progress(req, req->send.proto_config->priv,
                                           NULL, UCT_MD_MEM_ACCESS_LOCAL_READ,
-                                          UCP_DT_MASK_CONTIG_IOV,
+                                          UCP_DT_MASK_ZCOPY,
                                           ucp_rndv_am_zcopy_send_func,
                                           ucp_rndv_am_zcopy_complete,
                                           ucp_proto_rndv_request_zcopy_completion);
@@ -200,7 +203,7 @@ static void ucp_rndv_am_zcopy_probe(const ucp_proto_init_params_t *init_params)
         .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_ZCOPY
     };
 
-    ucp_rndv_am_probe_common(&params);
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_request_data_hdr_t));
 }
 
 static void
@@ -214,10 +217,109 @@ ucp_proto_t ucp_rndv_am_zcopy_proto = {
     .name     = "rndv/am/zcopy",
     .desc     = UCP_PROTO_ZCOPY_DESC,
     .flags    = 0,
-    .dt_mask  = UCP_DT_MASK_CONTIG_IOV,
+    .dt_mask  = UCP_DT_MASK_ZCOPY,
     .probe    = ucp_rndv_am_zcopy_probe,
     .query    = ucp_proto_multi_query,
     .progress = {ucp_rndv_am_zcopy_proto_progress},
     .abort    = ucp_rndv_am_zcopy_proto_abort,
     .reset    = ucp_proto_request_zcopy_reset
 };
+
+static size_t ucp_proto_rndv_am_lz4_pack(void *dest, void *arg)
+{
+    ucp_rndv_compressed_hdr_t *hdr       = dest;
+    ucp_proto_multi_pack_ctx_t *pack_ctx = arg;
+    ucp_request_t *req                   = pack_ctx->req;
+    size_t length, comp_length;
+    void *src;
+
+    ucp_rndv_am_fill_header(&hdr->super, req);
+
+    length = ucp_datatype_iter_next_ptr(&req->send.state.dt_iter,
+                                        pack_ctx->max_payload,
+                                        pack_ctx->next_iter, &src);
+    ucs_assert(length <= UINT32_MAX);
+    hdr->length = length;
+
+    /* Send the data as is if compression does not reduce its size */
+    comp_length = UCS_PROFILE_CALL(ucs_lz4_compress, src, length, hdr + 1,
+                                   length);
+    if ((comp_length == 0) || (comp_length >= length)) {
+        memcpy(hdr + 1, src, length);
+        comp_length = length;
+    }
+
+    return sizeof(*hdr) + comp_length;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t ucp_proto_rndv_am_lz4_send_func(
+        ucp_request_t *req, const ucp_proto_multi_lane_priv_t *lpriv,
+        ucp_datatype_iter_t *next_iter, ucp_lane_index_t *lane_shift)
+{
+    static const size_t hdr_size        = sizeof(ucp_rndv_compressed_hdr_t);
+    ucp_ep_t *ep                        = req->send.ep;
+    ucp_proto_multi_pack_ctx_t pack_ctx = {
+        .req       = req,
+        .next_iter = next_iter
+    };
+    ssize_t packed_size;
+
+    pack_ctx.max_payload = ucp_proto_multi_max_payload(req, lpriv, hdr_size);
+
+    packed_size = uct_ep_am_bcopy(ucp_ep_get_lane(ep, lpriv->super.lane),
+                                  UCP_AM_ID_RNDV_DATA_COMPRESSED,
+                                  ucp_proto_rndv_am_lz4_pack, &pack_ctx, 0);
+
+    return ucp_proto_bcopy_send_func_status(packed_size);
+}
+
+static ucs_status_t ucp_proto_rndv_am_lz4_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+
+    /* coverity[tainted_data_downcast] */
+    return ucp_proto_multi_bcopy_progress(req, req->send.proto_config->priv,
+                                          NULL,
+                                          ucp_proto_rndv_am_lz4_send_func,
+                                          ucp_proto_rndv_am_bcopy_complete);
+}
+
+static void ucp_rndv_am_lz4_probe(const ucp_proto_init_params_t *init_params)
+{
+    ucp_proto_multi_init_params_t params = {
+        .super.super         = *init_params,
+        .super.min_iov       = 0,
+        .super.min_frag_offs = UCP_PROTO_COMMON_OFFSET_INVALID,
+        .super.max_frag_offs = ucs_offsetof(uct_iface_attr_t, cap.am.max_bcopy),
+        .super.max_iov_offs  = UCP_PROTO_COMMON_OFFSET_INVALID,
+        .super.send_op       = UCT_EP_OP_AM_BCOPY,
+        .super.memtype_op    = UCT_EP_OP_LAST,
+        .super.flags         = UCP_PROTO_COMMON_INIT_FLAG_CAP_SEG_SIZE |
+                               UCP_PROTO_COMMON_INIT_FLAG_ERR_HANDLING |
+                               UCP_PROTO_COMMON_INIT_FLAG_RESUME |
+                               UCP_PROTO_COMMON_INIT_FLAG_COMPRESS,
+        .super.exclude_map   = 0,
+        .super.reg_mem_info  = ucp_mem_info_unknown,
+        .first.tl_cap_flags  = UCT_IFACE_FLAG_AM_BCOPY,
+        .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_BCOPY
+    };
+
+    if (!init_params->worker->context->config.ext.rndv_compress) {
+        return;
+    }
+
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_rndv_compressed_hdr_t));
+}
+
+ucp_proto_t ucp_rndv_am_lz4_proto = {
+    .name     = "rndv/am/lz4",
+    .desc     = "fragmented compressed " UCP_PROTO_COPY_IN_DESC " "
+                UCP_PROTO_COPY_OUT_DESC,
+    .flags    = 0,
+    .dt_mask  = UCS_BIT(UCP_DATATYPE_CONTIG),
+    .probe    = ucp_rndv_am_lz4_probe,
+    .query    = ucp_proto_multi_query,
+    .progress = {ucp_proto_rndv_am_lz4_progress},
+    .abort    = ucp_proto_rndv_am_bcopy_abort,
+    .reset    = ucp_proto_request_bcopy_reset
+};
@@ -24,10 +24,27 @@ enum {
 };
 
 
+enum {
+    /* Fragments are being sent, so a completed fragment should not send
+     * more fragments */
+    UCP_PROTO_RNDV_PPLN_FLAG_SENDING = UCS_BIT(0),
+
+    /* One of the fragments was aborted, so the rest of the message is not
+     * sent */
+    UCP_PROTO_RNDV_PPLN_FLAG_ABORTED = UCS_BIT(1),
+
+    /* All fragments were completed from the send loop, so the request is
+     * completed when the send loop exits */
+    UCP_PROTO_RNDV_PPLN_FLAG_COMPLETED = UCS_BIT(2)
+};
+
+
 /* Private data for pipeline protocol */
 typedef struct {
     ucp_proto_rndv_ack_priv_t ack;                   /* Ack configuration */
     size_t                    frag_size;             /* Fragment size */
+    size_t                    min_frag_size;         /* First fragment size */
+    size_t                    max_frag_size;         /* Max fragment size */
     ucp_proto_config_t        frag_proto_cfg;        /* Frag proto config */
     size_t                    frag_proto_min_length; /* Frag proto min length */
 } ucp_proto_rndv_ppln_priv_t;
@@ -49,6 +66,50 @@ ucp_proto_rndv_ppln_add_overhead(ucp_proto_perf_t *ppln_perf, size_t frag_size)
                                     node, NULL);
 }
 
+/*
+ * Find the range of fragment sizes to use, based on the performance of the
+ * slowest stage of sending one fragment: t(size) = c + m * size. Fragments
+ * start from the size on which the overhead equals the data transfer time,
+ * and grow while it improves the bandwidth by more than 5%.
+ */
+static void
+ucp_proto_rndv_ppln_init_frag_sizes(ucp_context_h context,
+                                    const ucp_proto_perf_segment_t *frag_seg,
+                                    ucp_proto_rndv_ppln_priv_t *rpriv)
+{
+    ucs_linear_func_t func, max_func = UCS_LINEAR_FUNC_ZERO;
+    ucp_proto_perf_factor_id_t factor_id;
+    double overhead_size;
+
+    rpriv->min_frag_size = rpriv->frag_size;
+    rpriv->max_frag_size = rpriv->frag_size;
+    if (!context->config.ext.rndv_ppln_adaptive) {
+        return;
+    }
+
+    for (factor_id = 0; factor_id < UCP_PROTO_PERF_FACTOR_LAST; ++factor_id) {
+        func = ucp_proto_perf_segment_func(frag_seg, factor_id);
+        if ((factor_id != UCP_PROTO_PERF_FACTOR_LATENCY) &&
+            (ucs_linear_func_apply(func, rpriv->frag_size) >
+             ucs_linear_func_apply(max_func, rpriv->frag_size))) {
+            max_func = func;
+        }
+    }
+
+    if ((max_func.m <= 0) || (max_func.c <= 0)) {
+        return;
+    }
+
+    overhead_size        = max_func.c / max_func.m;
+    rpriv->max_frag_size = ucs_min(ucs_roundup_pow2((size_t)(overhead_size *
+                                                             19) + 1),
+                                   rpriv->frag_size);
+    rpriv->min_frag_size = ucs_min(ucs_max(ucs_roundup_pow2(
+                                                   (size_t)overhead_size + 1),
+                                           rpriv->frag_proto_min_length),
+                                   rpriv->max_frag_size);
+}
+
 static void
 ucp_proto_rndv_ppln_probe(const ucp_proto_init_params_t *init_params)
 {
@@ -64,6 +125,7 @@ ucp_proto_rndv_ppln_probe(const ucp_proto_init_params_t *init_params)
     ucp_proto_rndv_ppln_priv_t rpriv;
     ucp_proto_select_t *proto_select;
     ucp_proto_init_elem_t *proto;
+    char min_frag_size_str[32];
     char frag_size_str[32];
     void *frag_proto_priv;
     ucs_status_t status;
@@ -133,6 +195,7 @@ ucp_proto_rndv_ppln_probe(const ucp_proto_init_params_t *init_params)
         ucs_assertv(rpriv.frag_size >= rpriv.frag_proto_min_length,
                     "rpriv.frag_size=%zu rpriv.frag_proto_min_length=%zu",
                     rpriv.frag_size, rpriv.frag_proto_min_length);
+        ucp_proto_rndv_ppln_init_frag_sizes(worker->context, frag_seg, &rpriv);
 
         frag_proto_priv = &ucs_array_elem(&select_elem->proto_init.priv_buf,
                                           proto->priv_offset);
@@ -141,8 +204,10 @@ ucp_proto_rndv_ppln_probe(const ucp_proto_init_params_t *init_params)
                                           &rpriv.frag_proto_cfg);
 
         ucp_proto_perf_segment_str(frag_seg, &seg_strb);
-        ucs_trace("rndv_ppln frag: %s proto: %s segment: %s",
-                  ucs_memunits_to_str(rpriv.frag_size, frag_size_str,
+        ucs_trace("rndv_ppln frag: %s..%s proto: %s segment: %s",
+                  ucs_memunits_to_str(rpriv.min_frag_size, min_frag_size_str,
+                                      sizeof(min_frag_size_str)),
+                  ucs_memunits_to_str(rpriv.max_frag_size, frag_size_str,
                                       sizeof(frag_size_str)),
                   ucp_proto_id_field(proto->proto_id, name),
                   ucs_string_buffer_cstr(&seg_strb));
@@ -183,6 +248,8 @@ static void ucp_proto_rndv_ppln_query(const ucp_proto_query_params_t *params,
 {
     const ucp_proto_rndv_ppln_priv_t *rpriv = params->priv;
     ucp_proto_query_attr_t frag_attr;
+    char min_frag_size_str[32];
+    char frag_size_str[32];
 
     if (params->msg_length <= rpriv->frag_size) {
         /* Message is smaller than fragment size */
@@ -190,21 +257,56 @@ static void ucp_proto_rndv_ppln_query(const ucp_proto_query_params_t *params,
                                params->msg_length, attr);
         attr->max_msg_length = rpriv->frag_size;
     } else {
-        /* Message is large and fragmented to frag_size */
+        /* Message is large and fragmented to min_frag_size..max_frag_size */
         ucp_proto_config_query(params->worker, &rpriv->frag_proto_cfg,
-                               rpriv->frag_size, &frag_attr);
+                               rpriv->max_frag_size, &frag_attr);
 
         attr->max_msg_length = SIZE_MAX;
         attr->is_estimation  = 0;
         attr->lane_map       = frag_attr.lane_map;
         ucs_snprintf_safe(attr->desc, sizeof(attr->desc), "pipeline %s",
                           frag_attr.desc);
-        ucs_strncpy_safe(attr->config, frag_attr.config, sizeof(attr->config));
+        if (rpriv->min_frag_size == rpriv->max_frag_size) {
+            ucs_strncpy_safe(attr->config, frag_attr.config,
+                             sizeof(attr->config));
+        } else {
+            /* Show the range of adaptive fragment sizes */
+            ucs_snprintf_safe(attr->config, sizeof(attr->config),
+                              "%s frag %s..%s", frag_attr.config,
+                              ucs_memunits_to_str(rpriv->min_frag_size,
+                                                  min_frag_size_str,
+                                                  sizeof(min_frag_size_str)),
+                              ucs_memunits_to_str(rpriv->max_frag_size,
+                                                  frag_size_str,
+                                                  sizeof(frag_size_str)));
+        }
     }
 
     attr->lane_map |= UCS_BIT(rpriv->ack.lane);
 }
 
+static void ucp_proto_rndv_ppln_send_frags(ucp_request_t *req);
+
+/* Returns the request if it should be completed by the caller */
+static ucp_request_t *ucp_proto_rndv_ppln_complete(ucp_request_t *req)
+{
+    int abort = req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_ABORTED;
+
+    if (req->send.rndv.rkey != NULL) {
+        ucp_proto_rndv_rkey_destroy(req);
+    }
+
+    ucp_datatype_iter_cleanup(&req->send.state.dt_iter, 1, UCP_DT_MASK_ALL);
+
+    if (!abort && (req->send.rndv.ppln.ack_data_size > 0)) {
+        ucp_proto_request_set_stage(req, UCP_PROTO_RNDV_PPLN_STAGE_ACK);
+        ucp_request_send(req);
+        return NULL;
+    } else {
+        return req;
+    }
+}
+
 static ucp_request_t *
 ucp_proto_rndv_ppln_frag_complete(ucp_request_t *freq, int send_ack, int abort,
                                   const char *title)
@@ -215,25 +317,52 @@ ucp_proto_rndv_ppln_frag_complete(ucp_request_t *freq, int send_ack, int abort,
         req->send.rndv.ppln.ack_data_size += freq->send.state.dt_iter.length;
     }
 
+    ucs_assert(req->send.rndv.ppln.num_inflight > 0);
+    --req->send.rndv.ppln.num_inflight;
+    --req->send.ep->worker->rndv_ppln_inflight;
+
+    if (abort) {
+        req->send.rndv.ppln.flags |= UCP_PROTO_RNDV_PPLN_FLAG_ABORTED;
+    }
+
+    /* The rest of an aborted message is not sent, so consider it completed
+     * when the last fragment in flight is completed */
+    if ((req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_ABORTED) &&
+        (req->send.rndv.ppln.num_inflight == 0)) {
+        req->send.state.completed_size += req->send.state.dt_iter.length -
+                                          req->send.state.dt_iter.offset;
+        req->send.state.dt_iter.offset  = req->send.state.dt_iter.length;
+    }
+
     /* In case of abort we don't destroy super request until all fragments are
      * completed */
     if (!ucp_proto_rndv_frag_complete(req, freq, title)) {
+        if (!(req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_SENDING)) {
+            /* Send the fragments which were held by the pipeline depth */
+            ucp_proto_rndv_ppln_send_frags(req);
+        }
         return NULL;
     }
 
-    if (req->send.rndv.rkey != NULL) {
-        ucp_proto_rndv_rkey_destroy(req);
+    if (req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_SENDING) {
+        /* The send loop still uses the request, so it completes it */
+        req->send.rndv.ppln.flags |= UCP_PROTO_RNDV_PPLN_FLAG_COMPLETED;
+        return NULL;
     }
 
-    ucp_datatype_iter_cleanup(&req->send.state.dt_iter, 1, UCP_DT_MASK_ALL);
+    return ucp_proto_rndv_ppln_complete(req);
+}
 
-    if (!abort && (req->send.rndv.ppln.ack_data_size > 0)) {
-        ucp_proto_request_set_stage(req, UCP_PROTO_RNDV_PPLN_STAGE_ACK);
-        ucp_request_send(req);
-        return NULL;
-    } else {
-        return req;
-    }
+static void ucp_proto_rndv_ppln_send_complete(ucp_request_t *req)
+{
+    ucp_request_rndv_flush_complete(req);
+    ucp_proto_request_complete_success(req);
+}
+
+static void ucp_proto_rndv_ppln_recv_complete(ucp_request_t *req)
+{
+    ucp_request_rndv_flush_complete(req);
+    ucp_proto_rndv_recv_complete(req);
 }
 
 void ucp_proto_rndv_ppln_send_frag_complete(ucp_request_t *freq, int send_ack)
@@ -242,8 +371,7 @@ void ucp_proto_rndv_ppln_send_frag_complete(ucp_request_t *freq, int send_ack)
 
     req = ucp_proto_rndv_ppln_frag_complete(freq, send_ack, 0, "ppln_send");
     if (req != NULL) {
-        ucp_request_rndv_flush_complete(req);
-        ucp_proto_request_complete_success(req);
+        ucp_proto_rndv_ppln_send_complete(req);
     }
 }
 
@@ -254,41 +382,62 @@ void ucp_proto_rndv_ppln_recv_frag_complete(ucp_request_t *freq, int send_ack,
 
     req = ucp_proto_rndv_ppln_frag_complete(freq, send_ack, abort, "ppln_recv");
     if (req != NULL) {
-        ucp_request_rndv_flush_complete(req);
-        ucp_proto_rndv_recv_complete(req);
+        ucp_proto_rndv_ppln_recv_complete(req);
     }
 }
 
-static ucs_status_t ucp_proto_rndv_ppln_progress(uct_pending_req_t *uct_req)
+static int ucp_proto_rndv_ppln_can_send_frag(ucp_request_t *req)
 {
-    ucp_request_t *req  = ucs_container_of(uct_req, ucp_request_t, send.uct);
-    ucp_worker_h worker = req->send.ep->worker;
-    const ucp_proto_rndv_ppln_priv_t *rpriv;
+    ucp_worker_h worker   = req->send.ep->worker;
+    ucp_context_h context = worker->context;
+    size_t max_inflight   = context->config.ext.rndv_ppln_max_inflight;
+
+    if (ucp_datatype_iter_is_end(&req->send.state.dt_iter) ||
+        (req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_ABORTED)) {
+        return 0;
+    }
+
+    if (max_inflight != UCS_ULUNITS_AUTO) {
+        /* Limit the staging memory used by a single message */
+        return req->send.rndv.ppln.num_inflight < max_inflight;
+    }
+
+    /* Do not grow the staging pools, but let every message progress */
+    return (req->send.rndv.ppln.num_inflight == 0) ||
+           (worker->rndv_ppln_inflight < context->config.rndv_ppln_pool_depth);
+}
+
+static void ucp_proto_rndv_ppln_send_frags(ucp_request_t *req)
+{
+    ucp_worker_h worker                     = req->send.ep->worker;
+    const ucp_proto_rndv_ppln_priv_t *rpriv = req->send.proto_config->priv;
     ucp_datatype_iter_t next_iter;
     ucs_status_t status;
     ucp_request_t *freq;
+    size_t frag_size;
     size_t overlap;
 
-    /* Nested pipeline is prevented during protocol selection */
-    ucs_assert(!(req->flags & UCP_REQUEST_FLAG_RNDV_FRAG));
-
-    /* Zero-length is not supported */
-    ucs_assert(req->send.state.dt_iter.length > 0);
+    /* Fragments which complete from the loop below do not complete the
+     * request, since it is still used by the loop */
+    req->send.rndv.ppln.flags |= UCP_PROTO_RNDV_PPLN_FLAG_SENDING;
 
-    req->send.state.completed_size    = 0;
-    req->send.rndv.ppln.ack_data_size = 0;
-    rpriv                             = req->send.proto_config->priv;
-
-    while (!ucp_datatype_iter_is_end(&req->send.state.dt_iter)) {
+    while (ucp_proto_rndv_ppln_can_send_frag(req)) {
         status = ucp_proto_rndv_frag_request_alloc(worker, req, &freq);
         if (status != UCS_OK) {
+            req->send.rndv.ppln.flags &= ~UCP_PROTO_RNDV_PPLN_FLAG_SENDING;
             ucp_proto_request_abort(req, status);
-            return UCS_OK;
+            return;
         }
 
+        /* Every fragment is as large as all the previous ones together, plus
+         * the first one, so the fragment size doubles until the maximum */
+        frag_size = ucs_min(req->send.state.dt_iter.offset +
+                                    rpriv->min_frag_size,
+                            rpriv->max_frag_size);
+
         /* Initialize datatype for the fragment */
         overlap = ucp_datatype_iter_next_slice_overlap(
-                &req->send.state.dt_iter, rpriv->frag_size,
+                &req->send.state.dt_iter, frag_size,
                 rpriv->frag_proto_min_length, &freq->send.state.dt_iter,
                 &next_iter);
         req->send.rndv.ppln.ack_data_size -= overlap;
@@ -310,12 +459,48 @@ static ucs_status_t ucp_proto_rndv_ppln_progress(uct_pending_req_t *uct_req)
 
         ucp_trace_req(req, "send freq %p offset %zu size %zu", freq,
                       freq->send.rndv.offset, freq->send.state.dt_iter.length);
-        UCS_PROFILE_CALL_VOID_ALWAYS(ucp_request_send, freq);
 
         ucp_datatype_iter_copy_position(&req->send.state.dt_iter, &next_iter,
                                         UCS_BIT(UCP_DATATYPE_CONTIG));
+        ++req->send.rndv.ppln.num_inflight;
+        ++worker->rndv_ppln_inflight;
+        worker->counters.rndv_ppln_max_inflight =
+                ucs_max(worker->counters.rndv_ppln_max_inflight,
+                        req->send.rndv.ppln.num_inflight);
+
+        UCS_PROFILE_CALL_VOID_ALWAYS(ucp_request_send, freq);
     }
 
+    req->send.rndv.ppln.flags &= ~UCP_PROTO_RNDV_PPLN_FLAG_SENDING;
+    if (!(req->send.rndv.ppln.flags & UCP_PROTO_RNDV_PPLN_FLAG_COMPLETED) ||
+        (ucp_proto_rndv_ppln_complete(req) == NULL)) {
+        return;
+    }
+
+    if (ucp_proto_select_op_id(&req->send.proto_config->select_param) ==
+        UCP_OP_ID_RNDV_SEND) {
+        ucp_proto_rndv_ppln_send_complete(req);
+    } else {
+        ucp_proto_rndv_ppln_recv_complete(req);
+    }
+}
+
+static ucs_status_t ucp_proto_rndv_ppln_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+
+    /* Nested pipeline is prevented during protocol selection */
+    ucs_assert(!(req->flags & UCP_REQUEST_FLAG_RNDV_FRAG));
+
+    /* Zero-length is not supported */
+    ucs_assert(req->send.state.dt_iter.length > 0);
+
+    req->send.state.completed_size    = 0;
+    req->send.rndv.ppln.ack_data_size = 0;
+    req->send.rndv.ppln.num_inflight  = 0;
+    req->send.rndv.ppln.flags         = 0;
+
+    ucp_proto_rndv_ppln_send_frags(req);
     return UCS_OK;
 }
 
@@ -15,6 +15,7 @@
 #include <ucp/proto/proto_init.h>
 #include <ucp/proto/proto_single.inl>
 #include <ucp/rma/rma_rndv.h>
+#include <ucs/algorithm/lz4.h>
 
 #include <string.h>
 
@@ -624,3 +625,87 @@ ucp_proto_rndv_handle_data(void *arg, void *data, size_t length, unsigned flags)
 
     return UCS_OK;
 }
+
+/* Decompress to the receive buffer directly if it is contiguous and accessible
+ * by the CPU, otherwise use a temporary buffer */
+static ucs_status_t
+ucp_proto_rndv_decompress(ucp_request_t *req, ucp_worker_h worker,
+                          const void *src, size_t comp_length, size_t offset,
+                          size_t length)
+{
+    ucp_datatype_iter_t *dt_iter = &req->send.state.dt_iter;
+    size_t decomp_length;
+    ucs_status_t status;
+    void *buffer;
+
+    if (ucs_unlikely(dt_iter->length - offset < length)) {
+        return UCS_ERR_MESSAGE_TRUNCATED;
+    }
+
+    if ((dt_iter->dt_class == UCP_DATATYPE_CONTIG) &&
+        UCP_MEM_IS_ACCESSIBLE_FROM_CPU(dt_iter->mem_info.type)) {
+        buffer = UCS_PTR_BYTE_OFFSET(dt_iter->type.contig.buffer, offset);
+        status = ucs_lz4_decompress(src, comp_length, buffer, length,
+                                    &decomp_length);
+    } else {
+        buffer = ucs_malloc(length, "rndv_decompress");
+        if (buffer == NULL) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        status = ucs_lz4_decompress(src, comp_length, buffer, length,
+                                    &decomp_length);
+        if ((status == UCS_OK) && (decomp_length == length)) {
+            status = ucp_datatype_iter_unpack(dt_iter, worker, length, offset,
+                                              buffer);
+        }
+
+        ucs_free(buffer);
+    }
+
+    if ((status == UCS_OK) && (decomp_length != length)) {
+        ucs_error("rndv data at offset %zu: decompressed %zu bytes instead "
+                  "of %zu", offset, decomp_length, length);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    return status;
+}
+
+ucs_status_t ucp_proto_rndv_handle_compressed_data(void *arg, void *data,
+                                                   size_t length,
+                                                   unsigned flags)
+{
+    ucp_worker_h worker            = arg;
+    ucp_rndv_compressed_hdr_t *hdr = data;
+    size_t comp_length             = length - sizeof(*hdr);
+    const ucp_proto_rndv_rtr_priv_t *rpriv;
+    ucs_status_t status;
+    ucp_request_t *req;
+
+    UCP_SEND_REQUEST_GET_BY_ID(&req, worker, hdr->super.req_id, 0,
+                               return UCS_OK, "RNDV_DATA_COMPRESSED %p", hdr);
+
+    if (comp_length == hdr->length) {
+        /* The sender could not compress this fragment */
+        status = ucp_datatype_iter_unpack(&req->send.state.dt_iter, worker,
+                                          comp_length, hdr->super.offset,
+                                          hdr + 1);
+    } else {
+        status = ucp_proto_rndv_decompress(req, worker, hdr + 1, comp_length,
+                                           hdr->super.offset, hdr->length);
+    }
+
+    if (status != UCS_OK) {
+        ucp_proto_request_abort(req, status);
+        return UCS_OK;
+    }
+
+    if (ucp_proto_common_frag_complete(req, hdr->length,
+                                       "rndv_data_compressed")) {
+        rpriv = req->send.proto_config->priv;
+        rpriv->data_received(req, 1);
+    }
+
+    return UCS_OK;
+}
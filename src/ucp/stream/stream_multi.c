@@ -138,7 +138,7 @@ static ucs_status_t ucp_stream_multi_zcopy_progress(uct_pending_req_t *uct_req)
     /* coverity[tainted_data_downcast] */
     return ucp_proto_multi_zcopy_progress(
             req, req->send.proto_config->priv, NULL,
-            UCT_MD_MEM_ACCESS_LOCAL_READ, UCP_DT_MASK_CONTIG_IOV,
+            UCT_MD_MEM_ACCESS_LOCAL_READ, UCP_DT_MASK_ZCOPY,
             ucp_stream_multi_zcopy_send_func,
             ucp_request_invoke_uct_completion_success,
             ucp_proto_request_zcopy_completion);
@@ -185,7 +185,7 @@ ucp_proto_t ucp_stream_multi_zcopy_proto = {
     .name     = "stream/multi/zcopy",
     .desc     = UCP_PROTO_MULTI_FRAG_DESC " " UCP_PROTO_STREAM_ZCOPY_DESC,
     .flags    = 0,
-    .dt_mask  = UCP_DT_MASK_CONTIG_IOV,
+    .dt_mask  = UCP_DT_MASK_ZCOPY,
     .probe    = ucp_stream_multi_zcopy_probe,
     .query    = ucp_proto_multi_query,
     .progress = {ucp_stream_multi_zcopy_progress},
@@ -111,8 +111,16 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_stream_send_nbx_am_short(ucp_ep_t *ep, const void *buffer, size_t length)
 {
+    ucs_time_t UCS_V_UNUSED start_time;
+    ucs_status_t status;
+
     if (ucs_likely((ssize_t)length <= ucp_ep_config(ep)->am.max_short)) {
-        return UCS_PROFILE_CALL(ucp_stream_send_am_short, ep, buffer, length);
+        start_time = ucp_ep_stats_lat_start(ep);
+        status     = UCS_PROFILE_CALL(ucp_stream_send_am_short, ep, buffer,
+                                      length);
+        ucp_ep_stats_lat_inline(ep, UCP_EP_STAT_LAT_STREAM, start_time,
+                                status);
+        return status;
     }
 
     return UCS_ERR_NO_RESOURCE;
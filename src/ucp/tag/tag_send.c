@@ -151,6 +151,8 @@ static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_tag_send_inline(ucp_ep_h ep, const void *buffer, size_t length,
                     ucp_tag_t tag, const ucp_request_param_t *param)
 {
+    ucs_time_t UCS_V_UNUSED start_time = ucp_ep_stats_lat_start(ep);
+    ucs_time_t tune_start_time         = ucp_proto_tune_short_start(ep->worker);
     ucs_status_t status;
 
     if (ucp_proto_is_inline(ep, &ucp_ep_config(ep)->tag.max_eager_short,
@@ -173,6 +175,9 @@ ucp_tag_send_inline(ucp_ep_h ep, const void *buffer, size_t length,
         UCP_EP_STAT_TAG_OP(ep, EAGER);
     }
 
+    ucp_ep_stats_lat_inline(ep, UCP_EP_STAT_LAT_TAG, start_time, status);
+    ucp_proto_tune_short_end(ep, UCP_WORKER_CFG_INDEX_NULL, UCP_OP_ID_TAG_SEND,
+                             param, 0, length, tune_start_time, status);
     return status;
 }
 
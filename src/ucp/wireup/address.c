@@ -13,6 +13,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucs/algorithm/crc.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/datastruct/array.h>
 #include <ucs/debug/log.h>
@@ -57,6 +58,20 @@
  *     UCP_ADDRESS_FLAG_LAST. For unified mode, there could not be more than one
  *     ep address.
  *   * For any mode, ep address is followed by a lane index.
+ *
+ * Compact address layout (version 2 only):
+ *
+ * [ header(16bit) | uuid(64bit) | client_id | worker_name(string) ]
+ * [ template_id(32bit) | length(varint) ]
+ *    [ skip(varint) | literal_length(varint) | literal(var) ]
+ *    ...
+ *
+ *   * The header, uuid, client id and worker name are the same as in the full
+ *     address, with the COMPACT flag set in the header.
+ *   * The rest of the full address, of the given length, is encoded relative
+ *     to the same part of the address template: every run copies 'skip' bytes
+ *     from the template at the current offset, followed by 'literal_length'
+ *     bytes from the compact address.
  */
 
 /* Address version 2 format:
@@ -225,9 +240,14 @@ enum {
     UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO  = UCS_BIT(0),  /* Address has debug info */
     UCP_ADDRESS_HEADER_FLAG_WORKER_UUID = UCS_BIT(1),  /* Worker unique id */
     UCP_ADDRESS_HEADER_FLAG_CLIENT_ID   = UCS_BIT(2),  /* Worker client id */
-    UCP_ADDRESS_HEADER_FLAG_AM_ONLY     = UCS_BIT(3)   /* Only AM lane info */
+    UCP_ADDRESS_HEADER_FLAG_AM_ONLY     = UCS_BIT(3),  /* Only AM lane info */
+    UCP_ADDRESS_HEADER_FLAG_COMPACT     = UCS_BIT(4)   /* Encoded relative to
+                                                          address template */
 };
 
+/* Shortest run of bytes equal to the template which is worth a new run */
+#define UCP_ADDRESS_COMPACT_MIN_MATCH  4
+
 static size_t ucp_address_iface_attr_size(ucp_worker_t *worker, uint64_t flags,
                                           ucp_object_version_t addr_version)
 {
@@ -1610,6 +1630,252 @@ out:
     return status;
 }
 
+/* Length of the address part which is kept as-is in a compact address */
+static size_t ucp_address_compact_prefix_length(const void *address)
+{
+    const void *ptr;
+    ucp_object_version_t addr_version;
+    unsigned dst_version;
+    uint8_t addr_flags;
+
+    ptr = ucp_address_unpack_header(address, &addr_version, &addr_flags,
+                                    &dst_version);
+    if (addr_flags & UCP_ADDRESS_HEADER_FLAG_WORKER_UUID) {
+        ptr = UCS_PTR_TYPE_OFFSET(ptr, uint64_t);
+    }
+
+    if (addr_flags & UCP_ADDRESS_HEADER_FLAG_CLIENT_ID) {
+        ptr = UCS_PTR_TYPE_OFFSET(ptr, uint64_t);
+    }
+
+    if (addr_flags & UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO) {
+        ptr = UCS_PTR_BYTE_OFFSET(UCS_PTR_TYPE_OFFSET(ptr, uint8_t),
+                                  *(const uint8_t*)ptr);
+    }
+
+    return UCS_PTR_BYTE_DIFF(address, ptr);
+}
+
+/* Pack a variable-length integer, 7 bits per byte. If buffer is NULL, only
+ * return the resulting offset. */
+static size_t
+ucp_address_compact_pack_varint(uint8_t *buffer, size_t offset, size_t value)
+{
+    do {
+        if (buffer != NULL) {
+            buffer[offset] = (value & UCS_MASK(7)) |
+                             ((value > UCS_MASK(7)) ? UCS_BIT(7) : 0);
+        }
+        ++offset;
+        value >>= 7;
+    } while (value != 0);
+
+    return offset;
+}
+
+/* Returns NULL if the value is too long */
+static const void *
+ucp_address_compact_unpack_varint(const void *ptr, size_t *value_p)
+{
+    const uint8_t *p = ptr;
+    unsigned shift   = 0;
+    uint8_t byte;
+
+    *value_p = 0;
+    do {
+        if (shift >= (sizeof(*value_p) * 8)) {
+            return NULL;
+        }
+
+        byte      = *(p++);
+        *value_p |= (size_t)(byte & UCS_MASK(7)) << shift;
+        shift    += 7;
+    } while (byte & UCS_BIT(7));
+
+    return p;
+}
+
+static size_t ucp_address_compact_match(const uint8_t *data,
+                                        const uint8_t *tmpl, size_t offset,
+                                        size_t limit)
+{
+    size_t length = 0;
+
+    while (((offset + length) < limit) &&
+           (data[offset + length] == tmpl[offset + length])) {
+        ++length;
+    }
+
+    return length;
+}
+
+/* Encode data relative to tmpl. If buffer is NULL, only return the resulting
+ * offset. */
+static size_t
+ucp_address_compact_pack_delta(uint8_t *buffer, size_t offset,
+                               const uint8_t *data, size_t length,
+                               const uint8_t *tmpl, size_t tmpl_length)
+{
+    size_t limit = ucs_min(length, tmpl_length);
+    size_t pos   = 0;
+    size_t skip, literal_end;
+
+    offset = ucp_address_compact_pack_varint(buffer, offset, length);
+    while (pos < length) {
+        skip = ucp_address_compact_match(data, tmpl, pos, limit);
+        pos += skip;
+
+        /* Short matches cost more than they save, keep them as literals */
+        for (literal_end = pos; literal_end < length; ++literal_end) {
+            if (ucp_address_compact_match(data, tmpl, literal_end, limit) >=
+                UCP_ADDRESS_COMPACT_MIN_MATCH) {
+                break;
+            }
+        }
+
+        offset = ucp_address_compact_pack_varint(buffer, offset, skip);
+        offset = ucp_address_compact_pack_varint(buffer, offset,
+                                                 literal_end - pos);
+        if (buffer != NULL) {
+            memcpy(buffer + offset, data + pos, literal_end - pos);
+        }
+
+        offset += literal_end - pos;
+        pos     = literal_end;
+    }
+
+    return offset;
+}
+
+static ucs_status_t
+ucp_address_compact_unpack_delta(const void **ptr_p, uint8_t *data,
+                                 size_t length, const uint8_t *tmpl,
+                                 size_t tmpl_length)
+{
+    size_t limit    = ucs_min(length, tmpl_length);
+    const void *ptr = *ptr_p;
+    size_t pos      = 0;
+    size_t skip, literal_length;
+
+    while (pos < length) {
+        ptr = ucp_address_compact_unpack_varint(ptr, &skip);
+        if ((ptr == NULL) || (skip > (limit - ucs_min(pos, limit)))) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        memcpy(data + pos, tmpl + pos, skip);
+        pos += skip;
+
+        ptr = ucp_address_compact_unpack_varint(ptr, &literal_length);
+        if ((ptr == NULL) || (literal_length > (length - pos)) ||
+            ((skip == 0) && (literal_length == 0))) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        memcpy(data + pos, ptr, literal_length);
+        ptr  = UCS_PTR_BYTE_OFFSET(ptr, literal_length);
+        pos += literal_length;
+    }
+
+    *ptr_p = ptr;
+    return UCS_OK;
+}
+
+static int ucp_address_is_compact_capable(const void *address, size_t length)
+{
+    uint8_t addr_flags;
+
+    if ((length < sizeof(uint16_t)) ||
+        ((*(const uint8_t*)address & UCP_ADDRESS_HEADER_VERSION_MASK) !=
+         UCP_OBJECT_VERSION_V2)) {
+        return 0;
+    }
+
+    addr_flags = ((const uint8_t*)address)[1];
+    return !(addr_flags & UCP_ADDRESS_HEADER_FLAG_COMPACT) &&
+           (length >= ucp_address_compact_prefix_length(address));
+}
+
+ucs_status_t ucp_address_set_template(ucp_worker_h worker, const void *address,
+                                      size_t length)
+{
+    void *buffer;
+
+    if (!ucp_address_is_compact_capable(address, length)) {
+        ucs_error("worker %p: address template must be a full address of "
+                  "version 2", worker);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    buffer = ucs_malloc(length, "ucp_address_template");
+    if (buffer == NULL) {
+        ucs_error("failed to allocate address template of %zu bytes", length);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memcpy(buffer, address, length);
+
+    ucs_free(worker->address_template.buffer);
+    worker->address_template.buffer = buffer;
+    worker->address_template.length = length;
+    worker->address_template.id     = ucs_crc32(0, address, length);
+    ucs_debug("worker %p: set address template 0x%x length %zu", worker,
+              worker->address_template.id, length);
+    return UCS_OK;
+}
+
+ucs_status_t ucp_address_compact(ucp_worker_h worker, const void *address,
+                                 size_t length, size_t *size_p,
+                                 void **buffer_p)
+{
+    const void *tmpl = worker->address_template.buffer;
+    size_t prefix_length, tmpl_prefix_length, size;
+    const uint8_t *data, *tmpl_data;
+    size_t data_length, tmpl_data_length;
+    uint8_t *buffer;
+
+    if (tmpl == NULL) {
+        ucs_error("worker %p: address template is not set", worker);
+        return UCS_ERR_NO_ELEM;
+    }
+
+    if (!ucp_address_is_compact_capable(address, length)) {
+        ucs_error("worker %p: compact address requires address version 2",
+                  worker);
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    prefix_length      = ucp_address_compact_prefix_length(address);
+    tmpl_prefix_length = ucp_address_compact_prefix_length(tmpl);
+    data               = UCS_PTR_BYTE_OFFSET(address, prefix_length);
+    data_length        = length - prefix_length;
+    tmpl_data          = UCS_PTR_BYTE_OFFSET(tmpl, tmpl_prefix_length);
+    tmpl_data_length   = worker->address_template.length - tmpl_prefix_length;
+
+    size   = ucp_address_compact_pack_delta(NULL,
+                                            prefix_length + sizeof(uint32_t),
+                                            data, data_length, tmpl_data,
+                                            tmpl_data_length);
+    buffer = ucs_malloc(size, "ucp_compact_address");
+    if (buffer == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memcpy(buffer, address, prefix_length);
+    buffer[1] |= UCP_ADDRESS_HEADER_FLAG_COMPACT;
+    memcpy(buffer + prefix_length, &worker->address_template.id,
+           sizeof(uint32_t));
+    ucp_address_compact_pack_delta(buffer, prefix_length + sizeof(uint32_t),
+                                   data, data_length, tmpl_data,
+                                   tmpl_data_length);
+
+    ucs_trace("worker %p: compacted address from %zu to %zu bytes", worker,
+              length, size);
+    *size_p   = size;
+    *buffer_p = buffer;
+    return UCS_OK;
+}
+
 static ucp_rsc_index_t ucp_address_get_remote_device_index(
         ucp_address_remote_device_array_t *device_array,
         ucp_rsc_index_t dev_index, ucs_sys_device_t sys_dev)
@@ -1655,6 +1921,117 @@ ucp_address_adjust_unpacked_md_index(ucp_unpacked_address_t *unpacked_address)
     }
 }
 
+static const void *ucp_address_rebase(const void *ptr, const void *old_base,
+                                      const void *new_base)
+{
+    if (ptr == NULL) {
+        return NULL;
+    }
+
+    return UCS_PTR_BYTE_OFFSET(new_base, UCS_PTR_BYTE_DIFF(old_base, ptr));
+}
+
+/* Expand a compact address and unpack it. The expanded address is stored after
+ * the address list, so it is released together with the list. */
+static ucs_status_t
+ucp_address_unpack_compact(ucp_worker_t *worker, const void *buffer,
+                           unsigned unpack_flags,
+                           ucp_unpacked_address_t *unpacked_address)
+{
+    const size_t list_size = UCP_MAX_RESOURCES *
+                             sizeof(*unpacked_address->address_list);
+    const void *tmpl       = worker->address_template.buffer;
+    size_t prefix_length, tmpl_prefix_length, data_length, address_length;
+    ucp_address_entry_t *address_list, *address;
+    ucp_address_entry_ep_addr_t *ep_addr;
+    uint8_t *expanded, *copy;
+    uint32_t tmpl_id;
+    ucs_status_t status;
+    const void *ptr;
+
+    prefix_length = ucp_address_compact_prefix_length(buffer);
+    ptr           = UCS_PTR_BYTE_OFFSET(buffer, prefix_length);
+    tmpl_id       = *ucs_serialize_next(&ptr, uint32_t);
+    if ((tmpl == NULL) || (tmpl_id != worker->address_template.id)) {
+        ucp_address_error(unpack_flags,
+                          "worker %p: compact address template 0x%x does not "
+                          "match local address template 0x%x", worker, tmpl_id,
+                          worker->address_template.id);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ptr = ucp_address_compact_unpack_varint(ptr, &data_length);
+    if (ptr == NULL) {
+        goto err_invalid;
+    }
+
+    address_length = prefix_length + data_length;
+    expanded       = ucs_malloc(address_length, "ucp_expanded_address");
+    if (expanded == NULL) {
+        ucs_error("failed to allocate expanded address of %zu bytes",
+                  address_length);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memcpy(expanded, buffer, prefix_length);
+    expanded[1]       &= ~UCP_ADDRESS_HEADER_FLAG_COMPACT;
+    tmpl_prefix_length = ucp_address_compact_prefix_length(tmpl);
+    status             = ucp_address_compact_unpack_delta(
+                            &ptr, expanded + prefix_length, data_length,
+                            UCS_PTR_BYTE_OFFSET(tmpl, tmpl_prefix_length),
+                            worker->address_template.length -
+                            tmpl_prefix_length);
+    if (status != UCS_OK) {
+        ucs_free(expanded);
+        goto err_invalid;
+    }
+
+    status = ucp_address_unpack(worker, expanded, unpack_flags,
+                                unpacked_address);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    unpacked_address->length = UCS_PTR_BYTE_DIFF(buffer, ptr);
+    if (unpacked_address->address_list == NULL) {
+        goto out;
+    }
+
+    address_list = ucs_realloc(unpacked_address->address_list,
+                               list_size + address_length, "ucp_address_list");
+    if (address_list == NULL) {
+        ucs_free(unpacked_address->address_list);
+        unpacked_address->address_list  = NULL;
+        unpacked_address->address_count = 0;
+        status                          = UCS_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    copy = UCS_PTR_BYTE_OFFSET(address_list, list_size);
+    memcpy(copy, expanded, address_length);
+    unpacked_address->address_list = address_list;
+    ucp_unpacked_address_for_each(address, unpacked_address) {
+        address->dev_addr   = ucp_address_rebase(address->dev_addr, expanded,
+                                                 copy);
+        address->iface_addr = ucp_address_rebase(address->iface_addr, expanded,
+                                                 copy);
+        for (ep_addr = address->ep_addrs;
+             ep_addr < (address->ep_addrs + address->num_ep_addrs);
+             ++ep_addr) {
+            ep_addr->addr = ucp_address_rebase(ep_addr->addr, expanded, copy);
+        }
+    }
+
+out:
+    ucs_free(expanded);
+    return status;
+
+err_invalid:
+    ucp_address_error(unpack_flags, "worker %p: invalid compact address",
+                      worker);
+    return UCS_ERR_INVALID_PARAM;
+}
+
 ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                                 unsigned unpack_flags,
                                 ucp_unpacked_address_t *unpacked_address)
@@ -1686,6 +2063,11 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     ptr = ucp_address_unpack_header(buffer, &addr_version, &addr_flags,
                                     &dst_version);
+    if ((addr_version == UCP_OBJECT_VERSION_V2) &&
+        (addr_flags & UCP_ADDRESS_HEADER_FLAG_COMPACT)) {
+        return ucp_address_unpack_compact(worker, buffer, unpack_flags,
+                                          unpacked_address);
+    }
 
     ucp_address_trace(unpack_flags,
                       "unpacking address version %u dst version %u flags 0x%x",
@@ -1725,6 +2107,8 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     /* Empty address list */
     if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        unpacked_address->length = UCS_PTR_BYTE_DIFF(buffer, ptr) +
+                                   sizeof(uint8_t);
         return UCS_OK;
     }
 
@@ -1880,6 +2264,7 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     unpacked_address->dst_version   = dst_version;
     unpacked_address->address_count = address - address_list;
     unpacked_address->address_list  = address_list;
+    unpacked_address->length        = UCS_PTR_BYTE_DIFF(buffer, ptr);
 
     ucp_address_adjust_unpacked_md_index(unpacked_address);
     return UCS_OK;
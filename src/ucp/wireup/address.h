@@ -168,6 +168,7 @@ struct ucp_unpacked_address {
     ucp_address_entry_t         *address_list;  /* Pointer to address list */
     ucp_object_version_t        addr_version;   /* Peer address version */
     unsigned                    dst_version;    /* Peer release version */
+    size_t                      length;         /* Length of packed address */
 };
 
 
@@ -258,6 +259,39 @@ ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Set the address template which compact addresses are encoded relative to.
+ * The previous template, if any, is replaced.
+ *
+ * @param [in] worker   Worker object.
+ * @param [in] address  Full worker address of version 2 to use as template.
+ * @param [in] length   Length of the template address.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_address_set_template(ucp_worker_h worker, const void *address,
+                                      size_t length);
+
+
+/**
+ * Encode a full worker address as a compact address, which contains only the
+ * bytes that differ from the worker's address template. Such address is
+ * expanded by @ref ucp_address_unpack of a worker with the same template.
+ *
+ * @param [in]  worker    Worker object, which has an address template set.
+ * @param [in]  address   Full worker address of version 2.
+ * @param [in]  length    Length of the full address.
+ * @param [out] size_p    Filled with the compact address length.
+ * @param [out] buffer_p  Filled with the compact address, which should be
+ *                        released with ucs_free().
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_address_compact(ucp_worker_h worker, const void *address,
+                                 size_t length, size_t *size_p,
+                                 void **buffer_p);
+
+
 /**
  * Unpack worker unique id from the given address.
  *
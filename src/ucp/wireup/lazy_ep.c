@@ -0,0 +1,487 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "lazy_ep.h"
+#include "wireup.h"
+
+#include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucs/datastruct/queue.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/stubs.h>
+#include <ucs/type/init_once.h>
+#include <ucp/core/ucp_ep.inl>
+#include <string.h>
+
+
+static uct_iface_h ucp_lazy_ep_iface;
+static ucs_init_once_t ucp_lazy_ep_iface_once = UCS_INIT_ONCE_INITIALIZER;
+
+
+static UCS_F_ALWAYS_INLINE ucp_lazy_stub_t *ucp_lazy_stub(uct_ep_h uct_ep)
+{
+    return ucs_derived_of(uct_ep, ucp_lazy_stub_t);
+}
+
+static UCS_F_ALWAYS_INLINE ucp_lazy_ep_t *ucp_lazy_ep(uct_ep_h uct_ep)
+{
+    return ucs_derived_of(uct_ep, ucp_lazy_ep_t);
+}
+
+static inline ucs_queue_elem_t *ucp_lazy_ep_req_priv(uct_pending_req_t *req)
+{
+    UCS_STATIC_ASSERT(sizeof(ucs_queue_elem_t) <= UCT_PENDING_REQ_PRIV_LEN);
+    return (ucs_queue_elem_t*)req->priv;
+}
+
+static ssize_t ucp_lazy_ep_bcopy_send_func(uct_ep_h uct_ep)
+{
+    return UCS_ERR_NO_RESOURCE;
+}
+
+static unsigned ucp_lazy_ep_connect_progress(void *arg)
+{
+    ucp_lazy_ep_t *lazy_ep = arg;
+
+    ucp_lazy_ep_connect(lazy_ep->super.ucp_ep);
+    return 1;
+}
+
+static int
+ucp_lazy_ep_connect_remove_filter(const ucs_callbackq_elem_t *elem, void *arg)
+{
+    return elem->arg == arg;
+}
+
+static ucs_status_t ucp_lazy_ep_pending_add(uct_ep_h uct_ep,
+                                            uct_pending_req_t *req,
+                                            unsigned flags)
+{
+    ucp_lazy_stub_t *stub = ucp_lazy_stub(uct_ep);
+    ucp_worker_h worker   = stub->ucp_ep->worker;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    if (ucs_queue_is_empty(&stub->pending_q)) {
+        /* First operation on the stub, connect it from the progress */
+        ucs_callbackq_add_oneshot(&worker->uct->progress_q, stub,
+                                  stub->connect_cb, stub);
+        ucp_worker_signal_internal(worker);
+    }
+
+    ucs_queue_push(&stub->pending_q, ucp_lazy_ep_req_priv(req));
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return UCS_OK;
+}
+
+static void ucp_lazy_ep_pending_purge(uct_ep_h uct_ep,
+                                      uct_pending_purge_callback_t cb,
+                                      void *arg)
+{
+    ucp_lazy_stub_t *stub = ucp_lazy_stub(uct_ep);
+    uct_pending_req_t *req;
+
+    ucs_queue_for_each_extract(req, &stub->pending_q, priv, 1) {
+        cb(req, arg);
+    }
+}
+
+static ucs_status_t
+ucp_lazy_ep_flush(uct_ep_h uct_ep, unsigned flags, uct_completion_t *comp)
+{
+    ucp_lazy_stub_t *stub = ucp_lazy_stub(uct_ep);
+
+    /* Nothing was sent yet, so the endpoint is flushed unless it has queued
+     * requests */
+    if ((flags & UCT_FLUSH_FLAG_CANCEL) ||
+        ucs_queue_is_empty(&stub->pending_q)) {
+        return UCS_OK;
+    }
+
+    return UCS_ERR_NO_RESOURCE;
+}
+
+static void ucp_lazy_ep_destroy(uct_ep_h uct_ep)
+{
+    ucp_lazy_stub_t *stub = ucp_lazy_stub(uct_ep);
+    ucp_worker_h worker   = stub->ucp_ep->worker;
+
+    ucs_assert(ucs_queue_is_empty(&stub->pending_q));
+    ucs_debug("ep %p: destroy lazy stub %p", stub->ucp_ep, stub);
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucs_callbackq_remove_oneshot(&worker->uct->progress_q, stub,
+                                 ucp_lazy_ep_connect_remove_filter, stub);
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    ucs_free(stub);
+}
+
+static const uct_iface_ops_t ucp_lazy_ep_iface_ops = {
+    .ep_put_short        = (uct_ep_put_short_func_t)ucs_empty_function_return_no_resource,
+    .ep_put_bcopy        = (uct_ep_put_bcopy_func_t)ucp_lazy_ep_bcopy_send_func,
+    .ep_put_zcopy        = (uct_ep_put_zcopy_func_t)ucs_empty_function_return_no_resource,
+    .ep_get_short        = (uct_ep_get_short_func_t)ucs_empty_function_return_no_resource,
+    .ep_get_bcopy        = (uct_ep_get_bcopy_func_t)ucs_empty_function_return_no_resource,
+    .ep_get_zcopy        = (uct_ep_get_zcopy_func_t)ucs_empty_function_return_no_resource,
+    .ep_am_short         = (uct_ep_am_short_func_t)ucs_empty_function_return_no_resource,
+    .ep_am_short_iov     = (uct_ep_am_short_iov_func_t)ucs_empty_function_return_no_resource,
+    .ep_am_bcopy         = (uct_ep_am_bcopy_func_t)ucp_lazy_ep_bcopy_send_func,
+    .ep_am_zcopy         = (uct_ep_am_zcopy_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic_cswap64   = (uct_ep_atomic_cswap64_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic_cswap32   = (uct_ep_atomic_cswap32_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic64_post    = (uct_ep_atomic64_post_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic32_post    = (uct_ep_atomic32_post_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic64_fetch   = (uct_ep_atomic64_fetch_func_t)ucs_empty_function_return_no_resource,
+    .ep_atomic32_fetch   = (uct_ep_atomic32_fetch_func_t)ucs_empty_function_return_no_resource,
+    .ep_tag_eager_short  = (uct_ep_tag_eager_short_func_t)ucs_empty_function_return_no_resource,
+    .ep_tag_eager_bcopy  = (uct_ep_tag_eager_bcopy_func_t)ucp_lazy_ep_bcopy_send_func,
+    .ep_tag_eager_zcopy  = (uct_ep_tag_eager_zcopy_func_t)ucs_empty_function_return_no_resource,
+    .ep_tag_rndv_zcopy   = (uct_ep_tag_rndv_zcopy_func_t)ucs_empty_function_return_ptr_no_resource,
+    .ep_tag_rndv_cancel  = (uct_ep_tag_rndv_cancel_func_t)ucs_empty_function_return_unsupported,
+    .ep_tag_rndv_request = (uct_ep_tag_rndv_request_func_t)ucs_empty_function_return_no_resource,
+    .ep_pending_add      = ucp_lazy_ep_pending_add,
+    .ep_pending_purge    = ucp_lazy_ep_pending_purge,
+    .ep_flush            = ucp_lazy_ep_flush,
+    .ep_fence            = (uct_ep_fence_func_t)ucs_empty_function_return_success,
+    .ep_check            = (uct_ep_check_func_t)ucs_empty_function_return_success,
+    .ep_connect_to_ep    = (uct_ep_connect_to_ep_func_t)ucs_empty_function_return_unsupported,
+    .ep_destroy          = ucp_lazy_ep_destroy,
+    .ep_get_address      = (uct_ep_get_address_func_t)ucs_empty_function_return_unsupported
+};
+
+static uct_iface_h ucp_lazy_ep_iface_get(void)
+{
+    ucs_status_t status;
+
+    UCS_INIT_ONCE(&ucp_lazy_ep_iface_once) {
+        status = ucp_stub_iface_open(UCS_ERR_NO_RESOURCE,
+                                     &ucp_lazy_ep_iface_ops,
+                                     &ucp_lazy_ep_iface);
+        if (status != UCS_OK) {
+            ucs_fatal("failed to create lazy ep iface stub");
+        }
+    }
+
+    return ucp_lazy_ep_iface;
+}
+
+UCS_STATIC_CLEANUP {
+    UCS_CLEANUP_ONCE(&ucp_lazy_ep_iface_once) {
+        uct_iface_close(ucp_lazy_ep_iface);
+    }
+}
+
+static void ucp_lazy_stub_init(ucp_lazy_stub_t *stub, ucp_ep_h ep,
+                               ucs_callback_t connect_cb)
+{
+    stub->super.iface = ucp_lazy_ep_iface_get();
+    stub->ucp_ep      = ep;
+    stub->connect_cb  = connect_cb;
+    ucs_queue_head_init(&stub->pending_q);
+}
+
+int ucp_lazy_ep_test(uct_ep_h uct_ep)
+{
+    return (uct_ep != NULL) &&
+           (uct_ep->iface->ops.ep_pending_add == ucp_lazy_ep_pending_add);
+}
+
+/* Install the lazy endpoint on the only lane of a stub configuration */
+static ucs_status_t ucp_lazy_ep_attach(ucp_ep_h ep, ucp_lazy_ep_t *lazy_ep)
+{
+    ucp_ep_config_key_t key;
+    ucp_worker_cfg_index_t cfg_index;
+    ucs_status_t status;
+
+    ucp_ep_config_key_reset(&key);
+    ucp_ep_config_key_set_err_mode(&key, lazy_ep->ep_init_flags);
+    ucp_ep_config_key_init_flags(&key, lazy_ep->ep_init_flags);
+
+    /* All operations are queued on the first lane until the endpoint is
+     * connected */
+    key.num_lanes = 1;
+    key.am_lane   = 0;
+
+    status = ucp_worker_get_ep_config(ep->worker, &key,
+                                      lazy_ep->ep_init_flags, &cfg_index);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucp_ep_realloc_lanes(ep, key.num_lanes);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_ep_set_cfg_index(ep, cfg_index, 1);
+    ucp_ep_set_lane(ep, 0, &lazy_ep->super.super);
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_LAZY, 0);
+    return UCS_OK;
+}
+
+static void ucp_lazy_ep_detach(ucp_ep_h ep, ucs_queue_head_t *pending_q)
+{
+    uct_ep_h uct_ep = ucp_ep_get_lane(ep, 0);
+
+    ucs_assert(ep->flags & UCP_EP_FLAG_LAZY);
+    ucs_assert(ucp_lazy_ep_test(uct_ep));
+    ucs_assert(ucp_lazy_stub(uct_ep)->connect_cb ==
+               ucp_lazy_ep_connect_progress);
+
+    uct_ep_pending_purge(uct_ep, ucp_request_purge_enqueue_cb, pending_q);
+    ucp_ep_set_lane(ep, 0, NULL);
+    ucp_ep_release_cfg_index(ep);
+    ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_LAZY);
+}
+
+ucs_status_t ucp_lazy_ep_create(ucp_worker_h worker, const void *address,
+                                const ucp_unpacked_address_t *remote_address,
+                                unsigned ep_init_flags, ucp_ep_h *ep_p)
+{
+    ucp_lazy_ep_t *lazy_ep;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    status = ucp_ep_create_base(worker, ep_init_flags, remote_address->name,
+                                "lazy from api call", &ep);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    lazy_ep = ucs_malloc(sizeof(*lazy_ep) + remote_address->length,
+                         "ucp_lazy_ep");
+    if (lazy_ep == NULL) {
+        ucs_error("failed to allocate lazy ep with %zu bytes address",
+                  remote_address->length);
+        status = UCS_ERR_NO_MEMORY;
+        goto err_delete;
+    }
+
+    ucp_lazy_stub_init(&lazy_ep->super, ep, ucp_lazy_ep_connect_progress);
+    lazy_ep->ep_init_flags  = ep_init_flags;
+    lazy_ep->address_length = remote_address->length;
+    memcpy(lazy_ep->address, address, remote_address->length);
+
+    status = ucp_lazy_ep_attach(ep, lazy_ep);
+    if (status != UCS_OK) {
+        ucs_free(lazy_ep);
+        goto err_delete;
+    }
+
+    ucs_trace("ep %p: created lazy ep %p to %s", ep, lazy_ep,
+              ucp_ep_peer_name(ep));
+    *ep_p = ep;
+    return UCS_OK;
+
+err_delete:
+    ucp_ep_delete(ep);
+err:
+    return status;
+}
+
+void ucp_lazy_ep_release(ucp_ep_h ep, ucs_queue_head_t *pending_q)
+{
+    uct_ep_h uct_ep = ucp_ep_get_lane(ep, 0);
+
+    ucs_debug("ep %p: release lazy ep %p", ep, uct_ep);
+    ucp_lazy_ep_detach(ep, pending_q);
+    uct_ep_destroy(uct_ep);
+}
+
+ucs_status_t ucp_lazy_ep_connect(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+    unsigned addr_indices[UCP_MAX_LANES];
+    ucp_unpacked_address_t remote_address;
+    ucs_queue_head_t pending_q;
+    ucp_lazy_ep_t *lazy_ep;
+    unsigned ep_init_flags;
+    ucs_status_t status;
+    int am_need_flush;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    if (!(ep->flags & UCP_EP_FLAG_LAZY)) {
+        status = UCS_OK;
+        goto out;
+    }
+
+    lazy_ep       = ucp_lazy_ep(ucp_ep_get_lane(ep, 0));
+    ep_init_flags = lazy_ep->ep_init_flags;
+    ucs_debug("ep %p: connecting lazy ep %p", ep, lazy_ep);
+
+    status = ucp_address_unpack(worker, lazy_ep->address,
+                                ucp_worker_default_address_pack_flags(worker),
+                                &remote_address);
+    if (status != UCS_OK) {
+        goto err_purge;
+    }
+
+    ucs_queue_head_init(&pending_q);
+    ucp_lazy_ep_detach(ep, &pending_q);
+
+    /* RMA lanes to remote interfaces are connected on their first use */
+    status = ucp_wireup_init_lanes(ep, ep_init_flags | UCP_EP_INIT_LAZY_LANES,
+                                   &ucp_tl_bitmap_max,
+                                   &remote_address, addr_indices,
+                                   &am_need_flush);
+    if ((status != UCS_OK) && (ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL)) {
+        /* No lanes were created, keep the endpoint lazy */
+        ucs_queue_splice(&lazy_ep->super.pending_q, &pending_q);
+        if (ucp_lazy_ep_attach(ep, lazy_ep) != UCS_OK) {
+            ucs_fatal("ep %p: failed to restore lazy ep %p", ep, lazy_ep);
+        }
+        goto err_free_address;
+    }
+
+    uct_ep_destroy(&lazy_ep->super.super);
+    if (status != UCS_OK) {
+        goto err_set_ep_failed;
+    }
+
+    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+        status = ucp_wireup_send_request(ep);
+        if (status != UCS_OK) {
+            goto err_set_ep_failed;
+        }
+    }
+
+    status = ucp_ep_resolve_remote_id_on_create(ep, ep_init_flags);
+    if (status != UCS_OK) {
+        goto err_set_ep_failed;
+    }
+
+    ucp_wireup_replay_pending_requests(ep, &pending_q);
+    ucs_free(remote_address.address_list);
+    goto out;
+
+err_set_ep_failed:
+    /* Pending requests are purged when the lanes are discarded */
+    ucp_wireup_replay_pending_requests(ep, &pending_q);
+    ucp_ep_set_lanes_failed_schedule(ep, 0, status);
+err_free_address:
+    ucs_free(remote_address.address_list);
+err_purge:
+    ucs_diag("ep %p: failed to connect lazy ep: %s", ep,
+              ucs_status_string(status));
+    if (ep->flags & UCP_EP_FLAG_LAZY) {
+        uct_ep_pending_purge(ucp_ep_get_lane(ep, 0), ucp_ep_err_pending_purge,
+                             UCS_STATUS_PTR(status));
+    }
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
+static ucp_lane_index_t ucp_lazy_lane_find(ucp_lazy_lane_t *lazy_lane)
+{
+    ucp_ep_h ep = lazy_lane->super.ucp_ep;
+    ucp_lane_index_t lane;
+
+    /* The lane index may change if the endpoint was reconfigured */
+    for (lane = 0; lane < ucp_ep_num_lanes(ep); ++lane) {
+        if (ucp_ep_get_lane(ep, lane) == &lazy_lane->super.super) {
+            return lane;
+        }
+    }
+
+    return UCP_NULL_LANE;
+}
+
+static unsigned ucp_lazy_lane_connect_progress(void *arg)
+{
+    ucp_lazy_lane_t *lazy_lane = arg;
+    ucp_ep_h ep                = lazy_lane->super.ucp_ep;
+    ucp_worker_h worker        = ep->worker;
+    ucp_address_entry_t address;
+    ucs_queue_head_t pending_q;
+    ucp_lane_index_t lane;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    lane = ucp_lazy_lane_find(lazy_lane);
+    ucs_assert(lane != UCP_NULL_LANE);
+    ucs_debug("ep %p: connecting lazy lane[%d] %p", ep, lane, lazy_lane);
+
+    address.dev_addr       = (const uct_device_addr_t*)lazy_lane->address;
+    address.dev_addr_len   = lazy_lane->dev_addr_len;
+    address.iface_addr     = (const uct_iface_addr_t*)
+            UCS_PTR_BYTE_OFFSET(lazy_lane->address, lazy_lane->dev_addr_len);
+    address.iface_addr_len = lazy_lane->iface_addr_len;
+
+    ucs_queue_head_init(&pending_q);
+    ucs_queue_splice(&pending_q, &lazy_lane->super.pending_q);
+    ucp_ep_set_lane(ep, lane, NULL);
+
+    status = ucp_wireup_connect_lane_to_iface(
+            ep, lane, lazy_lane->path_index,
+            ucp_worker_iface(worker, ucp_ep_get_rsc_index(ep, lane)),
+            &address);
+    if (status != UCS_OK) {
+        ucs_diag("ep %p: failed to connect lazy lane[%d]: %s", ep, lane,
+                 ucs_status_string(status));
+        /* Queued requests are purged when the lane is discarded */
+        ucs_queue_splice(&lazy_lane->super.pending_q, &pending_q);
+        ucp_ep_set_lane(ep, lane, &lazy_lane->super.super);
+        ucp_ep_set_lanes_failed_schedule(ep, UCS_BIT(lane), status);
+        goto out;
+    }
+
+    uct_ep_destroy(&lazy_lane->super.super);
+    ucp_wireup_replay_pending_requests(ep, &pending_q);
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return 1;
+}
+
+int ucp_lazy_lane_is_deferred(ucp_ep_h ep, ucp_lane_index_t lane)
+{
+    const ucp_ep_config_key_t *key = &ucp_ep_config(ep)->key;
+    ucp_lane_type_mask_t rma_types = UCS_BIT(UCP_LANE_TYPE_RMA) |
+                                     UCS_BIT(UCP_LANE_TYPE_RMA_BW) |
+                                     UCS_BIT(UCP_LANE_TYPE_RKEY_PTR);
+
+    /* Lanes which send wireup and active messages, or check the connection,
+     * are needed from the start */
+    return (ucp_ep_get_lane(ep, lane) == NULL) && (lane != key->am_lane) &&
+           (lane != key->wireup_msg_lane) && (lane != key->keepalive_lane) &&
+           (lane != key->tag_lane) &&
+           !(key->lanes[lane].lane_types & ~rma_types);
+}
+
+ucs_status_t ucp_lazy_lane_create(ucp_ep_h ep, ucp_lane_index_t lane,
+                                  unsigned path_index,
+                                  const ucp_address_entry_t *address)
+{
+    ucp_lazy_lane_t *lazy_lane;
+
+    ucs_assert(ucp_ep_get_lane(ep, lane) == NULL);
+
+    lazy_lane = ucs_malloc(sizeof(*lazy_lane) + address->dev_addr_len +
+                                   address->iface_addr_len,
+                           "ucp_lazy_lane");
+    if (lazy_lane == NULL) {
+        ucs_error("failed to allocate lazy lane");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucp_lazy_stub_init(&lazy_lane->super, ep, ucp_lazy_lane_connect_progress);
+    lazy_lane->path_index     = path_index;
+    lazy_lane->dev_addr_len   = address->dev_addr_len;
+    lazy_lane->iface_addr_len = address->iface_addr_len;
+    memcpy(lazy_lane->address, address->dev_addr, address->dev_addr_len);
+    memcpy(UCS_PTR_BYTE_OFFSET(lazy_lane->address, address->dev_addr_len),
+           address->iface_addr, address->iface_addr_len);
+
+    ucs_trace("ep %p: assign lazy uct_ep[%d]=%p", ep, lane, lazy_lane);
+    ucp_ep_set_lane(ep, lane, &lazy_lane->super.super);
+    return UCS_OK;
+}
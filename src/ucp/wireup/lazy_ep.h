@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+
+#ifndef UCP_LAZY_EP_H_
+#define UCP_LAZY_EP_H_
+
+#include "address.h"
+
+#include <ucp/core/ucp_types.h>
+#include <ucs/datastruct/callbackq.h>
+#include <ucs/datastruct/queue_types.h>
+
+
+/**
+ * Stub transport endpoint, which holds no transport resources and queues send
+ * requests until it is connected. The connection is started from the progress
+ * when the first request is queued.
+ */
+typedef struct ucp_lazy_stub {
+    uct_ep_t                  super;         /**< Stub transport endpoint */
+    ucp_ep_h                  ucp_ep;        /**< Owning UCP endpoint */
+    ucs_queue_head_t          pending_q;     /**< Requests waiting for connect */
+    ucs_callback_t            connect_cb;    /**< Connects the stub */
+} ucp_lazy_stub_t;
+
+
+/**
+ * Lazy endpoint, placed on the only lane of an endpoint which was created with
+ * @ref UCP_EP_PARAMS_FLAGS_LAZY_CONNECT. It holds a copy of the remote worker
+ * address and queues send requests until the first operation triggers lane
+ * selection and connection establishment.
+ */
+typedef struct ucp_lazy_ep {
+    ucp_lazy_stub_t           super;         /**< Stub with queued requests */
+    unsigned                  ep_init_flags; /**< UCP EP init flags */
+    size_t                    address_length; /**< Length of remote address */
+    uint8_t                   address[0];    /**< Packed remote address */
+} ucp_lazy_ep_t;
+
+
+/**
+ * Lazy lane, placed on an RMA lane of an endpoint which was connected from a
+ * lazy endpoint. It holds the address of the remote interface, and connects to
+ * it when the first request is queued on the lane.
+ */
+typedef struct ucp_lazy_lane {
+    ucp_lazy_stub_t           super;          /**< Stub with queued requests */
+    unsigned                  path_index;     /**< Path index of the lane */
+    size_t                    dev_addr_len;   /**< Length of device address */
+    size_t                    iface_addr_len; /**< Length of iface address */
+    uint8_t                   address[0];     /**< Device and iface addresses */
+} ucp_lazy_lane_t;
+
+
+/**
+ * Create a lazy endpoint to a remote worker. No transport resources are
+ * allocated, and the endpoint is connected on its first use.
+ *
+ * @param [in]  worker          Worker to create the endpoint on.
+ * @param [in]  address         Packed remote worker address.
+ * @param [in]  remote_address  Unpacked remote worker address.
+ * @param [in]  ep_init_flags   UCP EP init flags.
+ * @param [out] ep_p            Filled with the new endpoint.
+ */
+ucs_status_t ucp_lazy_ep_create(ucp_worker_h worker, const void *address,
+                                const ucp_unpacked_address_t *remote_address,
+                                unsigned ep_init_flags, ucp_ep_h *ep_p);
+
+
+/**
+ * Select lanes and connect a lazy endpoint to the stored remote address, and
+ * replay the requests which were queued on it. Does nothing if the endpoint is
+ * not lazy.
+ */
+ucs_status_t ucp_lazy_ep_connect(ucp_ep_h ep);
+
+
+/**
+ * Remove the lazy endpoint from its lane, and move the queued requests to
+ * @a pending_q. After this call the endpoint has no configuration, and it can
+ * be initialized by a wireup request from the remote peer.
+ */
+void ucp_lazy_ep_release(ucp_ep_h ep, ucs_queue_head_t *pending_q);
+
+
+/**
+ * Check whether the connection of a lane can be deferred to its first use.
+ * Only RMA lanes connected to a remote interface are deferred, since they are
+ * not needed to exchange wireup and active messages.
+ */
+int ucp_lazy_lane_is_deferred(ucp_ep_h ep, ucp_lane_index_t lane);
+
+
+/**
+ * Place a lazy lane on an empty lane of the endpoint, instead of connecting it
+ * to the remote interface @a address.
+ */
+ucs_status_t ucp_lazy_lane_create(ucp_ep_h ep, ucp_lane_index_t lane,
+                                  unsigned path_index,
+                                  const ucp_address_entry_t *address);
+
+
+/**
+ * Check whether a transport endpoint is a lazy endpoint or a lazy lane, which
+ * have no transport resources.
+ */
+int ucp_lazy_ep_test(uct_ep_h uct_ep);
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "select_cache.h"
+#include "address.h"
+#include "wireup.h"
+#include "wireup_cm.h"
+
+#include <ucp/core/ucp_worker.inl>
+#include <ucs/algorithm/crc.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <inttypes.h>
+#include <string.h>
+
+
+/**
+ * Remote address entry attributes which are used by lanes selection
+ */
+typedef struct {
+    uint64_t                    flags;
+    double                      overhead;
+    double                      bandwidth;
+    double                      lat_ovh;
+    ucp_tl_iface_atomic_flags_t atomic;
+    size_t                      seg_size;
+    int                         priority;
+    unsigned                    dev_num_paths;
+    /* Local resources which can reach the entry */
+    ucp_tl_bitmap_t             reachable_tls;
+    /* Local resources which are on the same device as the entry */
+    ucp_tl_bitmap_t             dev_reachable_tls;
+    ucs_sys_device_t            sys_dev;
+    uint16_t                    tl_name_csum;
+    ucp_md_index_t              md_index;
+    ucp_rsc_index_t             dev_index;
+} ucp_wireup_select_sig_entry_t;
+
+
+/*
+ * The signature is allocated zeroed and filled field by field, so the padding
+ * bytes are always zero and signatures can be compared by memcmp.
+ */
+struct ucp_wireup_select_sig {
+    uint32_t                      hash;          /* Hash of the fields below */
+    unsigned                      ep_init_flags;
+    unsigned                      address_count;
+    unsigned                      dst_version;
+    ucp_object_version_t          addr_version;
+    int                           is_self;       /* Remote worker is local */
+    int                           is_uuid_less;  /* Local UUID is less than
+                                                    the remote one */
+    ucp_tl_bitmap_t               tl_bitmap;
+    ucp_wireup_select_sig_entry_t entries[0];
+};
+
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_wireup_select_sig_hashed_length(const ucp_wireup_select_sig_t *sig)
+{
+    return ucs_offsetof(ucp_wireup_select_sig_t, entries) -
+           ucs_offsetof(ucp_wireup_select_sig_t, ep_init_flags) +
+           (sig->address_count * sizeof(ucp_wireup_select_sig_entry_t));
+}
+
+static UCS_F_ALWAYS_INLINE khint32_t
+ucp_wireup_select_sig_hash(const ucp_wireup_select_sig_t *sig)
+{
+    return sig->hash;
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_wireup_select_sig_is_equal(const ucp_wireup_select_sig_t *sig1,
+                               const ucp_wireup_select_sig_t *sig2)
+{
+    return (sig1->hash == sig2->hash) &&
+           (sig1->address_count == sig2->address_count) &&
+           !memcmp(&sig1->ep_init_flags, &sig2->ep_init_flags,
+                   ucp_wireup_select_sig_hashed_length(sig1));
+}
+
+KHASH_IMPL(ucp_wireup_select_cache, const ucp_wireup_select_sig_t*,
+           ucp_wireup_select_result_t*, 1, ucp_wireup_select_sig_hash,
+           ucp_wireup_select_sig_is_equal)
+
+
+static int ucp_wireup_select_sig_is_dev_reachable(ucp_worker_iface_t *wiface,
+                                                  const ucp_address_entry_t *ae)
+{
+    uct_iface_is_reachable_params_t params = {
+        .field_mask         = UCT_IFACE_IS_REACHABLE_FIELD_DEVICE_ADDR |
+                              UCT_IFACE_IS_REACHABLE_FIELD_IFACE_ADDR |
+                              UCT_IFACE_IS_REACHABLE_FIELD_SCOPE |
+                              UCT_IFACE_IS_REACHABLE_FIELD_DEVICE_ADDR_LENGTH |
+                              UCT_IFACE_IS_REACHABLE_FIELD_IFACE_ADDR_LENGTH,
+        .device_addr        = ae->dev_addr,
+        .iface_addr         = ae->iface_addr,
+        .device_addr_length = ae->dev_addr_len,
+        .iface_addr_length  = ae->iface_addr_len,
+        .scope              = UCT_IFACE_REACHABILITY_SCOPE_DEVICE
+    };
+
+    return (wiface->attr.device_addr_len != 0) &&
+           uct_iface_is_reachable_v2(wiface->iface, &params);
+}
+
+ucs_status_t
+ucp_wireup_select_sig_create(ucp_ep_h ep, unsigned ep_init_flags,
+                             const ucp_tl_bitmap_t *tl_bitmap,
+                             const ucp_unpacked_address_t *remote_address,
+                             ucp_wireup_select_sig_t **sig_p)
+{
+    ucp_worker_h worker   = ep->worker;
+    ucp_context_h context = worker->context;
+    ucp_wireup_select_sig_entry_t *entry;
+    const ucp_address_entry_t *ae;
+    ucp_wireup_select_sig_t *sig;
+    ucp_rsc_index_t rsc_index;
+
+    sig = ucs_calloc(1, sizeof(*sig) +
+                     (remote_address->address_count * sizeof(*entry)),
+                     "ucp_wireup_select_sig");
+    if (sig == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    sig->ep_init_flags = ep_init_flags;
+    sig->address_count = remote_address->address_count;
+    sig->dst_version   = remote_address->dst_version;
+    sig->addr_version  = remote_address->addr_version;
+    sig->is_self       = (remote_address->uuid == worker->uuid);
+    sig->is_uuid_less  = context->config.ext.connect_all_to_all &&
+                         (worker->uuid < remote_address->uuid);
+    sig->tl_bitmap     = *tl_bitmap;
+
+    entry = sig->entries;
+    ucp_unpacked_address_for_each(ae, remote_address) {
+        entry->flags         = ae->iface_attr.flags;
+        entry->overhead      = ae->iface_attr.overhead;
+        entry->bandwidth     = ae->iface_attr.bandwidth;
+        entry->lat_ovh       = ae->iface_attr.lat_ovh;
+        entry->atomic        = ae->iface_attr.atomic;
+        entry->seg_size      = ae->iface_attr.seg_size;
+        entry->priority      = ae->iface_attr.priority;
+        entry->dev_num_paths = ae->dev_num_paths;
+        entry->sys_dev       = ae->sys_dev;
+        entry->tl_name_csum  = ae->tl_name_csum;
+        entry->md_index      = ae->md_index;
+        entry->dev_index     = ae->dev_index;
+
+        UCS_STATIC_BITMAP_FOR_EACH_BIT(rsc_index, &context->tl_bitmap) {
+            if (!ucp_wireup_is_reachable(ep, ep_init_flags, rsc_index, ae,
+                                         NULL, 0)) {
+                continue;
+            }
+
+            UCS_STATIC_BITMAP_SET(&entry->reachable_tls, rsc_index);
+            if (ucp_wireup_select_sig_is_dev_reachable(
+                        ucp_worker_iface(worker, rsc_index), ae)) {
+                UCS_STATIC_BITMAP_SET(&entry->dev_reachable_tls, rsc_index);
+            }
+        }
+
+        ++entry;
+    }
+
+    sig->hash = ucs_crc32(0, &sig->ep_init_flags,
+                          ucp_wireup_select_sig_hashed_length(sig));
+    *sig_p    = sig;
+    return UCS_OK;
+}
+
+void ucp_wireup_select_sig_destroy(ucp_wireup_select_sig_t *sig)
+{
+    ucs_free(sig);
+}
+
+static void ucp_wireup_select_cache_purge(ucp_wireup_select_cache_t *cache)
+{
+    const ucp_wireup_select_sig_t *sig;
+    ucp_wireup_select_result_t *result;
+
+    kh_foreach(&cache->hash, sig, result, {
+        ucp_wireup_select_sig_destroy((ucp_wireup_select_sig_t*)sig);
+        ucs_free(result);
+    })
+
+    kh_clear(ucp_wireup_select_cache, &cache->hash);
+}
+
+void ucp_wireup_select_cache_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_wireup_select_cache, &worker->select_cache.hash);
+    worker->select_cache.epoch = worker->epoch;
+}
+
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_wireup_select_cache_purge(&worker->select_cache);
+    kh_destroy_inplace(ucp_wireup_select_cache, &worker->select_cache.hash);
+}
+
+int ucp_wireup_select_cache_is_enabled(ucp_ep_h ep, unsigned ep_init_flags)
+{
+    /* A server endpoint is created before its CM lane is connected, so unlike
+     * the client, its selection does not depend on the connection state */
+    return ep->worker->context->config.ext.wireup_select_cache &&
+           (ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) &&
+           (!ucp_ep_init_flags_has_cm(ep_init_flags) ||
+            (ep_init_flags & UCP_EP_INIT_CM_WIREUP_SERVER));
+}
+
+int ucp_wireup_select_cache_get(ucp_worker_h worker,
+                                const ucp_wireup_select_sig_t *sig,
+                                unsigned *addr_indices,
+                                ucp_ep_config_key_t *key)
+{
+    ucp_wireup_select_cache_t *cache = &worker->select_cache;
+    ucp_rsc_index_t *dst_md_cmpts    = key->dst_md_cmpts;
+    const ucp_wireup_select_result_t *result;
+    khiter_t khiter;
+
+    if (cache->epoch != worker->epoch) {
+        ucs_debug("worker %p: epoch changed from %" PRIu64 " to %" PRIu64
+                  ", dropping %u cached lanes selections", worker,
+                  cache->epoch, worker->epoch, kh_size(&cache->hash));
+        ucp_wireup_select_cache_purge(cache);
+        cache->epoch = worker->epoch;
+        return 0;
+    }
+
+    khiter = kh_get(ucp_wireup_select_cache, &cache->hash, sig);
+    if (khiter == kh_end(&cache->hash)) {
+        return 0;
+    }
+
+    result            = kh_value(&cache->hash, khiter);
+    *key              = result->key;
+    key->dst_md_cmpts = dst_md_cmpts;
+    memcpy(dst_md_cmpts, result->dst_md_cmpts,
+           ucs_popcount(key->reachable_md_map) * sizeof(*dst_md_cmpts));
+    memcpy(addr_indices, result->addr_indices,
+           key->num_lanes * sizeof(*addr_indices));
+    ++worker->counters.lanes_select_cache_hits;
+    return 1;
+}
+
+void ucp_wireup_select_cache_put(ucp_worker_h worker,
+                                 ucp_wireup_select_sig_t *sig,
+                                 const unsigned *addr_indices,
+                                 const ucp_ep_config_key_t *key)
+{
+    ucp_wireup_select_cache_t *cache = &worker->select_cache;
+    ucp_wireup_select_result_t *result;
+    khiter_t khiter;
+    int khret;
+
+    if (cache->epoch != worker->epoch) {
+        /* The result could be selected with the previous state of the
+         * local interfaces */
+        goto err_destroy_sig;
+    }
+
+    result = ucs_malloc(sizeof(*result), "ucp_wireup_select_result");
+    if (result == NULL) {
+        ucs_error("failed to allocate lanes selection result");
+        goto err_destroy_sig;
+    }
+
+    result->key              = *key;
+    result->key.dst_md_cmpts = result->dst_md_cmpts;
+    memcpy(result->dst_md_cmpts, key->dst_md_cmpts,
+           ucs_popcount(key->reachable_md_map) * sizeof(*key->dst_md_cmpts));
+    memcpy(result->addr_indices, addr_indices,
+           key->num_lanes * sizeof(*addr_indices));
+
+    khiter = kh_put(ucp_wireup_select_cache, &cache->hash, sig, &khret);
+    if ((khret == UCS_KH_PUT_FAILED) || (khret == UCS_KH_PUT_KEY_PRESENT)) {
+        ucs_free(result);
+        goto err_destroy_sig;
+    }
+
+    kh_value(&cache->hash, khiter) = result;
+    return;
+
+err_destroy_sig:
+    ucp_wireup_select_sig_destroy(sig);
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_WIREUP_SELECT_CACHE_H_
+#define UCP_WIREUP_SELECT_CACHE_H_
+
+#include <ucp/core/ucp_ep.h>
+#include <ucs/datastruct/khash.h>
+
+
+/* Transport signature of a remote address, see @ref ucp_wireup_select_sig_create */
+typedef struct ucp_wireup_select_sig ucp_wireup_select_sig_t;
+
+
+/**
+ * Result of lanes selection, which is shared by remote addresses with the same
+ * transport signature.
+ */
+typedef struct {
+    ucp_ep_config_key_t key;                        /* Endpoint configuration */
+    ucp_rsc_index_t     dst_md_cmpts[UCP_MAX_MDS];  /* Storage for key.dst_md_cmpts */
+    unsigned            addr_indices[UCP_MAX_LANES]; /* Address entry of each lane */
+} ucp_wireup_select_result_t;
+
+
+/* Lanes selection results by transport signature */
+KHASH_TYPE(ucp_wireup_select_cache, const ucp_wireup_select_sig_t*,
+           ucp_wireup_select_result_t*)
+
+
+/**
+ * Per-worker cache of lanes selection results
+ */
+typedef struct {
+    khash_t(ucp_wireup_select_cache) hash;
+    uint64_t                         epoch; /* Worker epoch of the results */
+} ucp_wireup_select_cache_t;
+
+
+/**
+ * Initialize the lanes selection cache of a worker.
+ */
+void ucp_wireup_select_cache_init(ucp_worker_h worker);
+
+
+/**
+ * Release the lanes selection cache of a worker.
+ */
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker);
+
+
+/**
+ * Check whether lanes selection of a new endpoint can use the cache, see
+ * UCX_WIREUP_SELECT_CACHE. The selection result of an endpoint without a
+ * configuration depends only on the remote address signature, unless it is
+ * the client side of a connection manager.
+ *
+ * @param [in] ep             Endpoint to select the lanes for.
+ * @param [in] ep_init_flags  UCP EP init flags.
+ */
+int ucp_wireup_select_cache_is_enabled(ucp_ep_h ep, unsigned ep_init_flags);
+
+
+/**
+ * Create the transport signature of a remote address. The signature contains
+ * all the inputs of @ref ucp_wireup_select_lanes which depend on the remote
+ * address: the attributes of the address entries and their reachability from
+ * the local transport resources. Addresses of different peers with the same
+ * hardware and software configuration have equal signatures.
+ *
+ * @param [in]  ep              Endpoint to select the lanes for.
+ * @param [in]  ep_init_flags   UCP EP init flags.
+ * @param [in]  tl_bitmap       Local transport resources to select from.
+ * @param [in]  remote_address  Unpacked remote worker address.
+ * @param [out] sig_p           Filled with the new signature.
+ */
+ucs_status_t
+ucp_wireup_select_sig_create(ucp_ep_h ep, unsigned ep_init_flags,
+                             const ucp_tl_bitmap_t *tl_bitmap,
+                             const ucp_unpacked_address_t *remote_address,
+                             ucp_wireup_select_sig_t **sig_p);
+
+
+void ucp_wireup_select_sig_destroy(ucp_wireup_select_sig_t *sig);
+
+
+/**
+ * Look up a lanes selection result by transport signature. The results which
+ * were selected before the last change of the worker epoch are dropped, since
+ * they could depend on the previous state of the local interfaces.
+ *
+ * @param [in]  worker        UCP worker.
+ * @param [in]  sig           Transport signature of the remote address.
+ * @param [out] addr_indices  Filled with the address entry of each lane.
+ * @param [out] key           Filled with the endpoint configuration. The
+ *                            remote MD components are copied to the storage
+ *                            which @a key->dst_md_cmpts points to.
+ *
+ * @return Nonzero if the result was found.
+ */
+int ucp_wireup_select_cache_get(ucp_worker_h worker,
+                                const ucp_wireup_select_sig_t *sig,
+                                unsigned *addr_indices,
+                                ucp_ep_config_key_t *key);
+
+
+/**
+ * Add a lanes selection result to the cache. The cache takes ownership of
+ * @a sig, also in case of failure.
+ *
+ * @param [in] worker        UCP worker.
+ * @param [in] sig           Transport signature of the remote address.
+ * @param [in] addr_indices  Address entry of each lane.
+ * @param [in] key           Selected endpoint configuration.
+ */
+void ucp_wireup_select_cache_put(ucp_worker_h worker,
+                                 ucp_wireup_select_sig_t *sig,
+                                 const unsigned *addr_indices,
+                                 const ucp_ep_config_key_t *key);
+
+#endif
@@ -12,6 +12,7 @@
 #include "address.h"
 #include "wireup_cm.h"
 #include "wireup_ep.h"
+#include "lazy_ep.h"
 
 #include <ucs/async/async.h>
 #include <ucs/datastruct/queue.h>
@@ -674,10 +675,13 @@ ucp_wireup_process_request(ucp_worker_h worker, ucp_ep_h ep,
     ucp_tl_bitmap_t tl_bitmap = UCS_STATIC_BITMAP_ZERO_INITIALIZER;
     ucp_lane_index_t lanes2remote[UCP_MAX_LANES];
     unsigned addr_indices[UCP_MAX_LANES];
+    ucs_queue_head_t lazy_pending_q;
+    uct_pending_req_t *uct_req;
     ucs_status_t status;
     int has_cm_lane, am_need_flush, full_handshake_required;
 
     UCP_WIREUP_MSG_CHECK(msg, ep, UCP_WIREUP_MSG_REQUEST);
+    ucs_queue_head_init(&lazy_pending_q);
     ucs_trace("got wireup request from 0x%"PRIx64" src_ep_id 0x%"PRIx64
               " dst_ep_id 0x%"PRIx64" conn_sn %d address version %u/%u",
               remote_address->uuid, msg->src_ep_id, msg->dst_ep_id,
@@ -719,6 +723,12 @@ ucp_wireup_process_request(ucp_worker_h worker, ucp_ep_h ep,
             if (status != UCS_OK) {
                 goto err_set_ep_failed;
             }
+
+            if (ep->flags & UCP_EP_FLAG_LAZY) {
+                /* The peer connected first, so initialize the lanes of the
+                 * lazy endpoint from its request */
+                ucp_lazy_ep_release(ep, &lazy_pending_q);
+            }
         }
 
         ucp_ep_update_remote_id(ep, msg->src_ep_id);
@@ -798,9 +808,13 @@ ucp_wireup_process_request(ucp_worker_h worker, ucp_ep_h ep,
                             &tl_bitmap, lanes2remote);
     }
 
+    ucp_wireup_replay_pending_requests(ep, &lazy_pending_q);
     return;
 
 err_set_ep_failed:
+    ucs_queue_for_each_extract(uct_req, &lazy_pending_q, priv, 1) {
+        ucp_ep_err_pending_purge(uct_req, UCS_STATUS_PTR(status));
+    }
     ucp_ep_set_lanes_failed_schedule(ep, 0, status);
 }
 
@@ -1286,7 +1300,7 @@ ucp_wireup_iface_ep_create(ucp_worker_iface_t *wiface,
     return uct_ep_create(&uct_ep_params, uct_ep_p);
 }
 
-static ucs_status_t
+ucs_status_t
 ucp_wireup_connect_lane_to_iface(ucp_ep_h ep, ucp_lane_index_t lane,
                                  unsigned path_index,
                                  ucp_worker_iface_t *wiface,
@@ -1425,6 +1439,11 @@ ucp_wireup_connect_lane(ucp_ep_h ep, unsigned ep_init_flags,
                                              remote_address);
     } else if (ucp_worker_is_tl_2iface(worker, rsc_index)) {
         address = &remote_address->address_list[addr_index];
+        if ((ep_init_flags & UCP_EP_INIT_LAZY_LANES) &&
+            ucp_lazy_lane_is_deferred(ep, lane)) {
+            return ucp_lazy_lane_create(ep, lane, path_index, address);
+        }
+
         return ucp_wireup_connect_lane_to_iface(ep, lane, path_index, wiface,
                                                 address);
     } else {
@@ -1976,6 +1995,7 @@ ucp_wireup_try_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
                             unsigned *addr_indices, ucp_ep_config_key_t *key,
                             ucp_rsc_index_t *dst_md_storage)
 {
+    ucp_wireup_select_sig_t *sig = NULL;
     ucs_status_t status;
 
     ucp_ep_config_key_reset(key);
@@ -1984,9 +2004,23 @@ ucp_wireup_try_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     key->dst_version  = remote_address->dst_version;
     key->dst_md_cmpts = dst_md_storage;
 
+    /* The selection result of a new endpoint depends only on the transport
+     * signature of the remote address, so it can be shared by endpoints to
+     * peers with the same configuration */
+    if (ucp_wireup_select_cache_is_enabled(ep, ep_init_flags) &&
+        (ucp_wireup_select_sig_create(ep, ep_init_flags, tl_bitmap,
+                                      remote_address, &sig) == UCS_OK)) {
+        if (ucp_wireup_select_cache_get(ep->worker, sig, addr_indices, key)) {
+            ucs_trace("ep %p: using cached lanes selection", ep);
+            ucp_wireup_select_sig_destroy(sig);
+            return UCS_OK;
+        }
+    }
+
     status = ucp_wireup_select_lanes(ep, ep_init_flags, *tl_bitmap,
                                      remote_address, addr_indices, key, 1);
     if (status != UCS_OK) {
+        ucp_wireup_select_sig_destroy(sig);
         return status;
     }
 
@@ -1994,6 +2028,11 @@ ucp_wireup_try_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
      * current ep configuration
      */
     ucp_wireup_get_reachable_mds(ep, ep_init_flags, remote_address, key);
+
+    if (sig != NULL) {
+        ucp_wireup_select_cache_put(ep->worker, sig, addr_indices, key);
+    }
+
     return UCS_OK;
 }
 
@@ -2236,7 +2275,7 @@ ucs_status_t ucp_wireup_send_pre_request(ucp_ep_h ep)
 
 ucs_status_t ucp_wireup_connect_remote(ucp_ep_h ep, ucp_lane_index_t lane)
 {
-    uct_ep_h uct_ep = ucp_ep_get_lane(ep, lane);
+    uct_ep_h uct_ep;
     ucs_queue_head_t tmp_q;
     ucs_status_t status;
     ucp_request_t *req;
@@ -2246,6 +2285,19 @@ ucs_status_t ucp_wireup_connect_remote(ucp_ep_h ep, ucp_lane_index_t lane)
 
     UCS_ASYNC_BLOCK(&ep->worker->async);
 
+    if (ep->flags & UCP_EP_FLAG_LAZY) {
+        /* Create the lanes first, and then resolve the remote ID on the new
+         * AM lane */
+        status = ucp_lazy_ep_connect(ep);
+        if (status != UCS_OK) {
+            goto out_unlock;
+        }
+
+        lane = ep->am_lane;
+    }
+
+    uct_ep = ucp_ep_get_lane(ep, lane);
+
     /* Checking again, with lock held, if already connected, connection is in
      * progress, or the endpoint is in failed state.
      */
@@ -316,44 +316,29 @@ ucp_wireup_cm_priv_space_check(const ucp_worker_h worker,
 }
 
 static ucs_status_t
-ucp_cm_ep_priv_data_pack(ucp_ep_h ep, const ucp_tl_bitmap_t *tl_bitmap,
-                         ucs_log_level_t log_level,
-                         ucp_object_version_t sa_data_version,
-                         void **data_buf_p, size_t *data_buf_length_p,
-                         unsigned pack_flags, unsigned max_num_paths)
+ucp_cm_ep_priv_data_build(ucp_ep_h ep, const void *ucp_addr,
+                          size_t ucp_addr_size, ucs_log_level_t log_level,
+                          ucp_object_version_t sa_data_version,
+                          void **data_buf_p, size_t *data_buf_length_p)
 {
-    ucp_worker_h worker   = ep->worker;
-    ucp_context_h context = worker->context;
-    void *ucp_addr        = NULL;
     ucp_wireup_sockaddr_data_base_t *sa_data;
     ucs_status_t status;
     void *worker_addr_p;
-    size_t ucp_addr_size, sa_data_length;
+    size_t sa_data_length;
 
     ucs_assert((int)ucp_ep_config(ep)->key.err_mode <= UINT8_MAX);
 
-    /* Don't pack the device address to reduce address size, it will be
-     * delivered by uct_cm_listener_conn_request_callback_t in
-     * uct_cm_remote_data_t */
-    status = ucp_address_pack(worker, ep, tl_bitmap, pack_flags,
-                              context->config.ext.worker_addr_version, NULL,
-                              max_num_paths, &ucp_addr_size, &ucp_addr);
-    if (status != UCS_OK) {
-        goto err;
-    }
-
-    status = ucp_wireup_cm_priv_space_check(worker, ep->ext->cm_idx,
+    status = ucp_wireup_cm_priv_space_check(ep->worker, ep->ext->cm_idx,
                                             ucp_addr_size, sa_data_version,
                                             log_level);
     if (status != UCS_OK) {
-        goto err;
+        return status;
     }
 
     sa_data_length = ucp_cm_priv_data_length(ucp_addr_size, sa_data_version);
     sa_data        = ucs_malloc(sa_data_length, "client_priv_data");
     if (sa_data == NULL) {
-        status = UCS_ERR_NO_MEMORY;
-        goto err;
+        return UCS_ERR_NO_MEMORY;
     }
 
     sa_data->ep_id = ucp_ep_local_id(ep);
@@ -363,12 +348,108 @@ ucp_cm_ep_priv_data_pack(ucp_ep_h ep, const ucp_tl_bitmap_t *tl_bitmap,
 
     *data_buf_p        = sa_data;
     *data_buf_length_p = sa_data_length;
+    return UCS_OK;
+}
 
-err:
+static ucs_status_t
+ucp_cm_ep_priv_data_pack(ucp_ep_h ep, const ucp_tl_bitmap_t *tl_bitmap,
+                         ucs_log_level_t log_level,
+                         ucp_object_version_t sa_data_version,
+                         void **data_buf_p, size_t *data_buf_length_p,
+                         unsigned pack_flags, unsigned max_num_paths)
+{
+    ucp_worker_h worker   = ep->worker;
+    ucp_context_h context = worker->context;
+    void *ucp_addr        = NULL;
+    ucs_status_t status;
+    size_t ucp_addr_size;
+
+    /* Don't pack the device address to reduce address size, it will be
+     * delivered by uct_cm_listener_conn_request_callback_t in
+     * uct_cm_remote_data_t */
+    status = ucp_address_pack(worker, ep, tl_bitmap, pack_flags,
+                              context->config.ext.worker_addr_version, NULL,
+                              max_num_paths, &ucp_addr_size, &ucp_addr);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    status = ucp_cm_ep_priv_data_build(ep, ucp_addr, ucp_addr_size, log_level,
+                                       sa_data_version, data_buf_p,
+                                       data_buf_length_p);
+
+out:
     ucs_free(ucp_addr);
     return status;
 }
 
+static int
+ucp_cm_server_addr_is_valid(ucp_ep_h ep, const ucp_tl_bitmap_t *tl_bitmap,
+                            unsigned pack_flags, unsigned max_num_paths)
+{
+    const ucp_ep_config_t *config = ucp_ep_config(ep);
+
+    return (config->cm_server_addr.buffer != NULL) &&
+           (config->cm_server_addr.epoch == ep->worker->epoch) &&
+           (config->cm_server_addr.pack_flags == pack_flags) &&
+           (config->cm_server_addr.max_num_paths == max_num_paths) &&
+           UCS_STATIC_BITMAP_IS_ZERO(
+                   UCS_STATIC_BITMAP_XOR(config->cm_server_addr.tl_bitmap,
+                                         *tl_bitmap));
+}
+
+/*
+ * Pack the private data of a server endpoint. The worker address is the same
+ * for all endpoints with the same configuration, unless it contains p2p
+ * endpoint addresses, so it is packed once and reused by next connections.
+ */
+static ucs_status_t
+ucp_cm_server_ep_priv_data_pack(ucp_ep_h ep, const ucp_tl_bitmap_t *tl_bitmap,
+                                ucp_object_version_t sa_data_version,
+                                void **data_buf_p, size_t *data_buf_length_p,
+                                unsigned pack_flags, unsigned max_num_paths)
+{
+    ucp_worker_h worker     = ep->worker;
+    ucp_context_h context   = worker->context;
+    ucp_ep_config_t *config = ucp_ep_config(ep);
+    ucs_status_t status;
+    size_t ucp_addr_size;
+    void *ucp_addr;
+
+    if (config->p2p_lanes != 0) {
+        return ucp_cm_ep_priv_data_pack(ep, tl_bitmap, UCS_LOG_LEVEL_ERROR,
+                                        sa_data_version, data_buf_p,
+                                        data_buf_length_p, pack_flags,
+                                        max_num_paths);
+    }
+
+    if (ucp_cm_server_addr_is_valid(ep, tl_bitmap, pack_flags,
+                                    max_num_paths)) {
+        ++worker->counters.cm_server_addr_reuses;
+    } else {
+        status = ucp_address_pack(worker, ep, tl_bitmap, pack_flags,
+                                  context->config.ext.worker_addr_version,
+                                  NULL, max_num_paths, &ucp_addr_size,
+                                  &ucp_addr);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        ucs_free(config->cm_server_addr.buffer);
+        config->cm_server_addr.buffer        = ucp_addr;
+        config->cm_server_addr.length        = ucp_addr_size;
+        config->cm_server_addr.tl_bitmap     = *tl_bitmap;
+        config->cm_server_addr.pack_flags    = pack_flags;
+        config->cm_server_addr.max_num_paths = max_num_paths;
+        config->cm_server_addr.epoch         = worker->epoch;
+    }
+
+    return ucp_cm_ep_priv_data_build(ep, config->cm_server_addr.buffer,
+                                     config->cm_server_addr.length,
+                                     UCS_LOG_LEVEL_ERROR, sa_data_version,
+                                     data_buf_p, data_buf_length_p);
+}
+
 static void
 ucp_wireup_cm_ep_cleanup(ucp_ep_t *ucp_ep)
 {
@@ -1348,10 +1429,10 @@ ucp_ep_server_init_priv_data(ucp_ep_h ep, const char *dev_name,
     ucp_context_dev_tl_bitmap(worker->context, dev_name, &ctx_tl_bitmap);
     ucp_tl_bitmap_validate(&tl_bitmap, &ctx_tl_bitmap);
 
-    status = ucp_cm_ep_priv_data_pack(ep, &tl_bitmap, UCS_LOG_LEVEL_ERROR,
-                                      sa_data_version, (void**)data_buf_p,
-                                      data_buf_size_p, ep_pack_flags,
-                                      max_num_paths);
+    status = ucp_cm_server_ep_priv_data_pack(ep, &tl_bitmap, sa_data_version,
+                                             (void**)data_buf_p,
+                                             data_buf_size_p, ep_pack_flags,
+                                             max_num_paths);
 
 out:
     UCS_ASYNC_UNBLOCK(&worker->async);
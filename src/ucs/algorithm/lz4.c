@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucs/algorithm/lz4.h>
+#include <ucs/sys/compiler_def.h>
+
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+ * LZ4 block format: a sequence of (token, literals, match) tuples. The token
+ * holds 4 bits of literals length and 4 bits of match length, and lengths of
+ * 15 and above continue in the following bytes. The last sequence contains
+ * only literals.
+ */
+#define UCS_LZ4_MIN_MATCH      4
+#define UCS_LZ4_LAST_LITERALS  5   /* Last bytes of the block are literals */
+#define UCS_LZ4_MF_LIMIT       12  /* Last match starts before this limit */
+#define UCS_LZ4_RUN_MASK       15
+#define UCS_LZ4_HASH_LOG       11
+#define UCS_LZ4_SKIP_TRIGGER   6   /* Search faster on incompressible data */
+
+
+static UCS_F_ALWAYS_INLINE uint32_t ucs_lz4_read32(const uint8_t *p)
+{
+    uint32_t value;
+
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static UCS_F_ALWAYS_INLINE uint32_t ucs_lz4_hash(const uint8_t *p)
+{
+    return (ucs_lz4_read32(p) * 2654435761u) >> (32 - UCS_LZ4_HASH_LOG);
+}
+
+static UCS_F_ALWAYS_INLINE uint8_t *ucs_lz4_put_length(uint8_t *op,
+                                                       size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        *(op++) = 255;
+    }
+
+    *(op++) = length;
+    return op;
+}
+
+/* Returns NULL if the sequence does not fit in the output buffer */
+static uint8_t *ucs_lz4_put_sequence(uint8_t *op, const uint8_t *oend,
+                                     const uint8_t *literals,
+                                     size_t literal_length, size_t offset,
+                                     size_t match_length)
+{
+    size_t max_length = 1 + (literal_length / 255) + 1 + literal_length;
+    uint8_t *token;
+
+    if (offset != 0) {
+        max_length += 2 + (match_length / 255) + 1;
+    }
+
+    if ((size_t)(oend - op) < max_length) {
+        return NULL;
+    }
+
+    token = op++;
+    if (literal_length >= UCS_LZ4_RUN_MASK) {
+        *token = UCS_LZ4_RUN_MASK << 4;
+        op     = ucs_lz4_put_length(op, literal_length - UCS_LZ4_RUN_MASK);
+    } else {
+        *token = literal_length << 4;
+    }
+
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (offset == 0) {
+        return op;
+    }
+
+    *(op++)       = offset & UINT8_MAX;
+    *(op++)       = offset >> 8;
+    match_length -= UCS_LZ4_MIN_MATCH;
+    if (match_length >= UCS_LZ4_RUN_MASK) {
+        *token |= UCS_LZ4_RUN_MASK;
+        op      = ucs_lz4_put_length(op, match_length - UCS_LZ4_RUN_MASK);
+    } else {
+        *token |= match_length;
+    }
+
+    return op;
+}
+
+size_t ucs_lz4_compress(const void *src, size_t src_length, void *dst,
+                        size_t dst_capacity)
+{
+    const uint8_t *base        = src;
+    const uint8_t *ip          = base;
+    const uint8_t *anchor      = base;
+    const uint8_t *iend        = base + src_length;
+    uint8_t *op                = dst;
+    const uint8_t *oend        = op + dst_capacity;
+    uint16_t table[UCS_BIT(UCS_LZ4_HASH_LOG)];
+    const uint8_t *mf_limit, *match_limit, *ref;
+    size_t match_length, offset, pos;
+    uint32_t hash;
+
+    if (src_length > UCS_LZ4_MF_LIMIT) {
+        mf_limit    = iend - UCS_LZ4_MF_LIMIT;
+        match_limit = iend - UCS_LZ4_LAST_LITERALS;
+        memset(table, 0, sizeof(table));
+
+        /* The table keeps only the low 16 bits of the positions, which is
+         * enough to find a candidate within the maximal match offset */
+        for (++ip; ip < mf_limit;) {
+            pos         = ip - base;
+            hash        = ucs_lz4_hash(ip);
+            offset      = (uint16_t)(pos - table[hash]);
+            table[hash] = pos;
+
+            if ((offset == 0) || (offset > pos) ||
+                (ucs_lz4_read32(ip - offset) != ucs_lz4_read32(ip))) {
+                ip += 1 + ((ip - anchor) >> UCS_LZ4_SKIP_TRIGGER);
+                continue;
+            }
+
+            ref = ip - offset;
+            /* Extend the match in both directions */
+            while ((ip > anchor) && (ref > base) && (ip[-1] == ref[-1])) {
+                --ip;
+                --ref;
+            }
+
+            match_length = UCS_LZ4_MIN_MATCH;
+            while (((ip + match_length) < match_limit) &&
+                   (ip[match_length] == ref[match_length])) {
+                ++match_length;
+            }
+
+            op = ucs_lz4_put_sequence(op, oend, anchor, ip - anchor, ip - ref,
+                                      match_length);
+            if (op == NULL) {
+                return 0;
+            }
+
+            ip    += match_length;
+            anchor = ip;
+            if (ip < mf_limit) {
+                table[ucs_lz4_hash(ip - 2)] = ip - 2 - base;
+            }
+        }
+    }
+
+    op = ucs_lz4_put_sequence(op, oend, anchor, iend - anchor, 0, 0);
+    if (op == NULL) {
+        return 0;
+    }
+
+    return op - (uint8_t*)dst;
+}
+
+/* Returns 0 if the input ends before the length is complete */
+static UCS_F_ALWAYS_INLINE int
+ucs_lz4_get_length(const uint8_t **ip_p, const uint8_t *iend, size_t *length_p)
+{
+    const uint8_t *ip = *ip_p;
+    uint8_t byte;
+
+    do {
+        if (ip >= iend) {
+            return 0;
+        }
+
+        byte       = *(ip++);
+        *length_p += byte;
+    } while (byte == 255);
+
+    *ip_p = ip;
+    return 1;
+}
+
+ucs_status_t ucs_lz4_decompress(const void *src, size_t src_length, void *dst,
+                                size_t dst_capacity, size_t *length_p)
+{
+    const uint8_t *ip   = src;
+    const uint8_t *iend = ip + src_length;
+    uint8_t *op         = dst;
+    uint8_t *oend       = op + dst_capacity;
+    size_t literal_length, match_length, offset;
+    const uint8_t *match;
+    uint8_t token;
+
+    while (ip < iend) {
+        token          = *(ip++);
+        literal_length = token >> 4;
+        if ((literal_length == UCS_LZ4_RUN_MASK) &&
+            !ucs_lz4_get_length(&ip, iend, &literal_length)) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        if (literal_length > (size_t)(iend - ip)) {
+            return UCS_ERR_INVALID_PARAM;
+        } else if (literal_length > (size_t)(oend - op)) {
+            return UCS_ERR_MESSAGE_TRUNCATED;
+        }
+
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        if (ip == iend) {
+            /* Last sequence has only literals */
+            break;
+        } else if ((iend - ip) < 2) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        offset = ip[0] | ((size_t)ip[1] << 8);
+        ip    += 2;
+        if ((offset == 0) || (offset > (size_t)(op - (uint8_t*)dst))) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        match_length = token & UCS_LZ4_RUN_MASK;
+        if ((match_length == UCS_LZ4_RUN_MASK) &&
+            !ucs_lz4_get_length(&ip, iend, &match_length)) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        match_length += UCS_LZ4_MIN_MATCH;
+        if (match_length > (size_t)(oend - op)) {
+            return UCS_ERR_MESSAGE_TRUNCATED;
+        }
+
+        match = op - offset;
+        if (offset >= match_length) {
+            memcpy(op, match, match_length);
+            op += match_length;
+        } else {
+            /* Overlapping match repeats the last 'offset' bytes */
+            while (match_length-- > 0) {
+                *(op++) = *(match++);
+            }
+        }
+    }
+
+    *length_p = op - (uint8_t*)dst;
+    return UCS_OK;
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_ALGORITHM_LZ4_H_
+#define UCS_ALGORITHM_LZ4_H_
+
+#include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/** @file lz4.h */
+
+/**
+ * Maximal size of a compressed buffer, given the size of the input buffer.
+ */
+#define UCS_LZ4_COMPRESS_BOUND(_length) \
+    ((_length) + ((_length) / 255) + 16)
+
+
+/**
+ * Compress a buffer to the LZ4 block format. The compressor is tuned for speed
+ * over ratio, and gives up quickly on data which does not compress.
+ *
+ * @param [in]  src           Buffer to compress.
+ * @param [in]  src_length    Size of the buffer to compress.
+ * @param [out] dst           Destination buffer for the compressed data.
+ * @param [in]  dst_capacity  Size of the destination buffer.
+ *
+ * @return Size of the compressed data, or 0 if it does not fit in
+ *         @a dst_capacity bytes.
+ */
+size_t ucs_lz4_compress(const void *src, size_t src_length, void *dst,
+                        size_t dst_capacity);
+
+
+/**
+ * Decompress a buffer in the LZ4 block format. The input is fully validated,
+ * so corrupted data never causes access outside of the given buffers.
+ *
+ * @param [in]  src           Compressed data.
+ * @param [in]  src_length    Size of the compressed data.
+ * @param [out] dst           Destination buffer for the decompressed data.
+ * @param [in]  dst_capacity  Size of the destination buffer.
+ * @param [out] length_p      Filled with the size of the decompressed data.
+ *
+ * @return UCS_OK, UCS_ERR_MESSAGE_TRUNCATED if the decompressed data does not
+ *         fit in @a dst_capacity bytes, or UCS_ERR_INVALID_PARAM if the
+ *         compressed data is corrupted.
+ */
+ucs_status_t ucs_lz4_decompress(const void *src, size_t src_length, void *dst,
+                                size_t dst_capacity, size_t *length_p);
+
+END_C_DECLS
+
+#endif
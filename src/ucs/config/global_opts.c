@@ -47,9 +47,12 @@ ucs_global_opts_t ucs_global_opts = {
     .stats_trigger         = "exit",
     .profile_mode          = 0,
     .profile_file          = "",
+    .profile_sample_rate   = 1,
+    .profile_signo         = 0,
     .stats_filter          = { NULL, 0 },
     .stats_format          = UCS_STATS_FULL,
     .topo_prio             = { NULL, 0 },
+    .topo_cache_file       = "",
     .vfs_enable            = 1,
     .vfs_thread_affinity   = 0,
     .rcache_check_pfn      = 0,
@@ -214,6 +217,14 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "The list order decides the priority of the providers.",
   ucs_offsetof(ucs_global_opts_t, topo_prio), UCS_CONFIG_TYPE_STRING_ARRAY},
 
+ {"TOPO_CACHE_FILE", "",
+  "If non-empty, the results of system topology probing are saved to this\n"
+  "file, and later processes on the same node load them instead of reading\n"
+  "sysfs again. The file is ignored if it belongs to another user, or if the\n"
+  "node was rebooted or its PCI devices changed since the file was written.\n"
+  "A node-local path such as /dev/shm/ucx_topo_cache.<user> is recommended.",
+  ucs_offsetof(ucs_global_opts_t, topo_cache_file), UCS_CONFIG_TYPE_STRING},
+
  {"DISTANCE_LAT", "phb:300ns,node:300ns,sys:500ns",
   "Estimated latency between system devices", 0,
   UCS_CONFIG_TYPE_KEY_VALUE(UCS_CONFIG_TYPE_TIME,
@@ -276,7 +287,9 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
   "  udp:<host>[:<port>]   - send over UDP to the given host:port.\n"
   "  stdout                - print to standard output.\n"
   "  stderr                - print to standard error.\n"
-  "  file:<filename>[:bin] - save to a file (%h: host, %p: pid, %c: cpu, %t: time, %u: user, %e: exe)",
+  "  file:<filename>[:bin] - save to a file (%h: host, %p: pid, %c: cpu, %t: time, %u: user, %e: exe)\n"
+  "  vfs                   - only expose in VFS, for live monitoring with 'ucx_vfs top'.\n"
+  "Statistics are also exposed in VFS with any of the above destinations.",
   ucs_offsetof(ucs_global_opts_t, stats_dest), UCS_CONFIG_TYPE_STRING},
 
  {"STATS_TRIGGER", "exit",
@@ -317,7 +330,9 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
  {"PROFILE_MODE", "",
   "Profile collection modes. If none is specified, profiling is disabled.\n"
   " - log   - Record all timestamps.\n"
-  " - accum - Accumulate measurements per location.",
+  " - accum - Accumulate measurements per location.\n"
+  " - ring  - Keep the most recent events in a fixed-size per-thread ring,\n"
+  "           and record only one of every UCX_PROFILE_SAMPLE_RATE scopes.",
   ucs_offsetof(ucs_global_opts_t, profile_mode),
   UCS_CONFIG_TYPE_BITMAP(ucs_profile_mode_names)},
 
@@ -330,6 +345,16 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
   "Maximal size of profiling log. New records will replace old records.",
   ucs_offsetof(ucs_global_opts_t, profile_log_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+ {"PROFILE_SAMPLE_RATE", "1000",
+  "In profiling ring mode, record the timing of one of every this many scopes.\n"
+  "Samples and request events are always recorded.",
+  ucs_offsetof(ucs_global_opts_t, profile_sample_rate), UCS_CONFIG_TYPE_UINT},
+
+ {"PROFILE_SIGNO", "0",
+  "Signal number which causes to save the profiling data to the profiling file\n"
+  "without stopping the profiling. Set to 0 to disable.",
+  ucs_offsetof(ucs_global_opts_t, profile_signo), UCS_CONFIG_TYPE_SIGNO},
+
  {"RCACHE_STAT_MIN", "4k",
   "Registration cache minimum region size, for power-of-2 size distribution "
   "statistics.\nStatistics about smaller regions will be attributed to this "
@@ -113,6 +113,12 @@ typedef struct {
     /* Limit for profiling log size */
     size_t                     profile_log_size;
 
+    /* Record one of every this many scopes in profiling ring mode */
+    unsigned                   profile_sample_rate;
+
+    /* Signal number which causes to save the profiling data */
+    unsigned                   profile_signo;
+
     /* Counters to be included in statistics summary */
     ucs_config_names_array_t   stats_filter;
 
@@ -122,6 +128,9 @@ typedef struct {
     /* Topology detection modules to use */
     ucs_config_names_array_t   topo_prio;
 
+    /* Node-local file which caches the results of topology probing */
+    char                       *topo_cache_file;
+
     /* Enable VFS monitoring */
     int                        vfs_enable;
 
@@ -22,6 +22,7 @@
 #include <ucs/time/time.h>
 #include <ucs/config/ini.h>
 #include <ucs/sys/lib.h>
+#include <ucs/sys/module_int.h>
 #include <ucs/type/init_once.h>
 #include <fnmatch.h>
 #include <ctype.h>
@@ -2556,7 +2557,10 @@ static void ucs_config_parser_print_env_vars(const char *prefix)
 
         iter = kh_get(ucs_config_env_vars, &ucs_config_parser_env_vars, var_name);
         if (iter == kh_end(&ucs_config_parser_env_vars)) {
-            if (ucs_config_parser_env_vars_track()) {
+            /* Variables of the modules skipped by lazy loading are not
+             * parsed, but they are not unused */
+            if (ucs_config_parser_env_vars_track() &&
+                !ucs_module_config_is_skipped(var_name + prefix_len)) {
                 ucs_string_buffer_appendf(&unused_vars_strb, "%s", var_name);
                 ucs_config_parser_append_similar_vars_message(
                         prefix, var_name, &unused_vars_strb);
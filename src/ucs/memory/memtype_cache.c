@@ -11,6 +11,7 @@
 #include "memtype_cache.h"
 
 #include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/type/class.h>
 #include <ucs/datastruct/queue.h>
 #include <ucs/debug/log.h>
@@ -20,6 +21,8 @@
 #include <ucs/sys/sys.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucm/api/ucm.h>
+#include <limits.h>
+#include <stdlib.h>
 
 
 static ucs_spinlock_t ucs_memtype_cache_global_instance_lock;
@@ -184,6 +187,63 @@ static void ucs_memtype_cache_region_collect_callback(const ucs_pgtable_t *pgtab
     ucs_list_add_tail(list, &region->list);
 }
 
+static void
+ucs_memtype_cache_fast_region_collect_callback(const ucs_pgtable_t *pgtable,
+                                               ucs_pgt_region_t *pgt_region,
+                                               void *arg)
+{
+    ucs_memtype_cache_region_t *region = ucs_derived_of(pgt_region,
+                                                        ucs_memtype_cache_region_t);
+    ucs_memtype_cache_t *memtype_cache = arg;
+    ucs_memtype_cache_fast_region_t *fast_region;
+
+    ucs_assert(memtype_cache->fast.num_regions <
+               UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX);
+    fast_region = &memtype_cache->fast.regions[memtype_cache->fast.num_regions++];
+    fast_region->start     = region->super.start;
+    fast_region->end       = region->super.end;
+    fast_region->mem_type  = region->mem_type;
+    fast_region->sys_dev   = region->sys_dev;
+    fast_region->mem_flags = region->mem_flags;
+}
+
+static int ucs_memtype_cache_fast_region_cmp(const void *elem1,
+                                             const void *elem2)
+{
+    const ucs_memtype_cache_fast_region_t *region1 = elem1;
+    const ucs_memtype_cache_fast_region_t *region2 = elem2;
+
+    return (region1->start > region2->start) - (region1->start < region2->start);
+}
+
+/*
+ * Rebuild the lock-free lookup array from the page table.
+ * - Lock must be held
+ */
+static void ucs_memtype_cache_fast_rebuild(ucs_memtype_cache_t *memtype_cache)
+{
+    /* Odd sequence number makes concurrent readers fall back to the page
+     * table lookup */
+    ++memtype_cache->fast.seq;
+    ucs_memory_cpu_store_fence();
+
+    if (ucs_pgtable_num_regions(&memtype_cache->pgtable) >
+        UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX) {
+        memtype_cache->fast.num_regions = UINT_MAX;
+    } else {
+        memtype_cache->fast.num_regions = 0;
+        ucs_pgtable_search_range(&memtype_cache->pgtable, 0, UCS_PGT_ADDR_MAX,
+                                 ucs_memtype_cache_fast_region_collect_callback,
+                                 memtype_cache);
+        qsort(memtype_cache->fast.regions, memtype_cache->fast.num_regions,
+              sizeof(*memtype_cache->fast.regions),
+              ucs_memtype_cache_fast_region_cmp);
+    }
+
+    ucs_memory_cpu_store_fence();
+    ++memtype_cache->fast.seq;
+}
+
 UCS_PROFILE_FUNC_VOID(ucs_memtype_cache_update_internal,
                       (memtype_cache, address, size, mem_type, sys_dev,
                        mem_flags, action),
@@ -277,6 +337,7 @@ UCS_PROFILE_FUNC_VOID(ucs_memtype_cache_update_internal,
     }
 
 out_unlock:
+    ucs_memtype_cache_fast_rebuild(memtype_cache);
     ucs_spin_unlock(&memtype_cache->lock);
 }
 
@@ -342,12 +403,93 @@ static void ucs_memtype_cache_purge(ucs_memtype_cache_t *memtype_cache)
     }
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucs_memtype_cache_region_get_info(const ucs_memtype_cache_fast_region_t *region,
+                                  ucs_pgt_addr_t start, size_t size,
+                                  ucs_memory_info_t *mem_info)
+{
+    if (ucs_likely((start + size) <= region->end)) {
+        mem_info->base_address = (void*)region->start;
+        mem_info->alloc_length = region->end - region->start;
+        mem_info->type         = region->mem_type;
+        mem_info->sys_dev      = region->sys_dev;
+        mem_info->mem_flags    = region->mem_flags;
+        ucs_trace_data("0x%lx..0x%lx found in [0x%lx..0x%lx] %s",
+                       start, start + size, region->start, region->end,
+                       ucs_memory_type_names[region->mem_type]);
+    } else {
+        ucs_trace("0x%lx..0x%lx not contained in [0x%lx..0x%lx] %s",
+                  start, start + size, region->start, region->end,
+                  ucs_memory_type_names[region->mem_type]);
+        ucs_memory_info_set_unknown(mem_info);
+    }
+
+    /* The memory type cache is not expected to return HOST memory type */
+    ucs_assertv(mem_info->type != UCS_MEMORY_TYPE_HOST, "%s (%d)",
+                ucs_memory_type_names[mem_info->type], mem_info->type);
+}
+
+/*
+ * Lookup in the sorted regions array without taking the lock.
+ *
+ * @return UCS_ERR_BUSY if the array is being updated or does not hold all
+ *         regions, and the page table should be searched instead.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucs_memtype_cache_lookup_fast(const ucs_memtype_cache_t *memtype_cache,
+                              ucs_pgt_addr_t start, size_t size,
+                              ucs_memory_info_t *mem_info)
+{
+    ucs_memtype_cache_fast_region_t region;
+    unsigned num_regions, low, high, mid;
+    uint64_t seq;
+
+    seq = memtype_cache->fast.seq;
+    ucs_memory_cpu_load_fence();
+
+    num_regions = memtype_cache->fast.num_regions;
+    if (ucs_unlikely((seq & 1) ||
+                     (num_regions > UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX))) {
+        return UCS_ERR_BUSY;
+    }
+
+    /* Find the last region which starts at or below the address */
+    low  = 0;
+    high = num_regions;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (memtype_cache->fast.regions[mid].start <= start) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    /* Always copy a region, so it is never used uninitialized; the array is
+     * fixed-size, and low == 0 is handled below */
+    region = memtype_cache->fast.regions[(low > 0) ? (low - 1) : 0];
+
+    ucs_memory_cpu_load_fence();
+    if (ucs_unlikely(memtype_cache->fast.seq != seq)) {
+        return UCS_ERR_BUSY;
+    }
+
+    if ((low == 0) || (start >= region.end)) {
+        ucs_trace_data("address 0x%lx not found", start);
+        return UCS_ERR_NO_ELEM;
+    }
+
+    ucs_memtype_cache_region_get_info(&region, start, size, mem_info);
+    return UCS_OK;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
                  (address, size, mem_info),
                  const void *address, size_t size, ucs_memory_info_t *mem_info)
 {
     ucs_memtype_cache_t *memtype_cache = ucs_memtype_cache_get_global();
     const ucs_pgt_addr_t start         = (uintptr_t)address;
+    ucs_memtype_cache_fast_region_t region_info;
     ucs_memtype_cache_region_t *region;
     ucs_pgt_region_t *pgt_region;
     ucs_status_t status;
@@ -356,6 +498,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
         return UCS_ERR_UNSUPPORTED;
     }
 
+    status = ucs_memtype_cache_lookup_fast(memtype_cache, start, size,
+                                           mem_info);
+    if (ucs_likely(status != UCS_ERR_BUSY)) {
+        return status;
+    }
+
     ucs_spin_lock(&memtype_cache->lock);
 
     pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &memtype_cache->pgtable,
@@ -366,27 +514,16 @@ UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
         goto out_unlock;
     }
 
-    region = ucs_derived_of(pgt_region, ucs_memtype_cache_region_t);
-    if (ucs_likely((start + size) <= pgt_region->end)) {
-        mem_info->base_address = (void*)region->super.start;
-        mem_info->alloc_length = region->super.end - region->super.start;
-        mem_info->type         = region->mem_type;
-        mem_info->sys_dev      = region->sys_dev;
-        mem_info->mem_flags    = region->mem_flags;
-        ucs_trace_data("0x%lx..0x%lx found in " UCS_MEMTYPE_CACHE_REGION_FMT,
-                       start, start + size,
-                       UCS_MEMTYPE_CACHE_REGION_ARG(region));
-    } else {
-        ucs_trace("0x%lx..0x%lx not contained in " UCS_MEMTYPE_CACHE_REGION_FMT,
-                  start, start + size, UCS_MEMTYPE_CACHE_REGION_ARG(region));
-        ucs_memory_info_set_unknown(mem_info);
-    }
+    region                = ucs_derived_of(pgt_region,
+                                           ucs_memtype_cache_region_t);
+    region_info.start     = region->super.start;
+    region_info.end       = region->super.end;
+    region_info.mem_type  = region->mem_type;
+    region_info.sys_dev   = region->sys_dev;
+    region_info.mem_flags = region->mem_flags;
+    ucs_memtype_cache_region_get_info(&region_info, start, size, mem_info);
     status = UCS_OK;
 
-    /* The memory type cache is not expected to return HOST memory type */
-    ucs_assertv(mem_info->type != UCS_MEMORY_TYPE_HOST, "%s (%d)",
-                ucs_memory_type_names[mem_info->type], mem_info->type);
-
 out_unlock:
     ucs_spin_unlock(&memtype_cache->lock);
     return status;
@@ -404,6 +541,9 @@ static UCS_CLASS_INIT_FUNC(ucs_memtype_cache_t)
         goto err;
     }
 
+    self->fast.seq         = 0;
+    self->fast.num_regions = 0;
+
     status = ucs_pgtable_init(&self->pgtable, ucs_memtype_cache_pgt_dir_alloc,
                               ucs_memtype_cache_pgt_dir_release);
     if (status != UCS_OK) {
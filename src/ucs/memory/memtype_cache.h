@@ -25,6 +25,10 @@ typedef struct ucs_memtype_cache         ucs_memtype_cache_t;
 typedef struct ucs_memtype_cache_region  ucs_memtype_cache_region_t;
 
 
+/* Maximal number of regions kept in the lock-free lookup array */
+#define UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX 16
+
+
 /* The single global instance of memory type cache */
 extern ucs_memtype_cache_t *ucs_memtype_cache_global_instance;
 
@@ -39,9 +43,32 @@ typedef struct ucs_memory_info {
 } ucs_memory_info_t;
 
 
+/* Region record in the lock-free lookup array */
+typedef struct ucs_memtype_cache_fast_region {
+    ucs_pgt_addr_t    start;     /**< Region start address */
+    ucs_pgt_addr_t    end;       /**< Region end address */
+    ucs_memory_type_t mem_type;  /**< Memory type */
+    ucs_sys_device_t  sys_dev;   /**< System device index */
+    uint8_t           mem_flags; /**< UCS memory flags */
+} ucs_memtype_cache_fast_region_t;
+
+
 struct ucs_memtype_cache {
     ucs_spinlock_t        lock;       /**< protests the page table */
     ucs_pgtable_t         pgtable;    /**< Page table to hold the regions */
+
+    /*
+     * Sorted copy of the page table regions, used for lookup without taking
+     * the lock when the number of regions is small. Readers validate the copy
+     * by the sequence number, which is odd while the array is being rebuilt.
+     */
+    struct {
+        volatile uint64_t               seq;        /**< Sequence number */
+        unsigned                        num_regions;/**< Number of regions, or
+                                                         UINT_MAX if the page
+                                                         table has too many */
+        ucs_memtype_cache_fast_region_t regions[UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX];
+    } fast;
 };
 
 
@@ -10,6 +10,7 @@
 
 #include "profile.h"
 
+#include <ucs/async/pipe.h>
 #include <ucs/datastruct/list.h>
 #include <ucs/debug/debug_int.h>
 #include <ucs/debug/log.h>
@@ -17,7 +18,11 @@
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 #include <ucs/time/time.h>
+#include <ucs/type/init_once.h>
+#include <ucs/vfs/base/vfs_obj.h>
 #include <pthread.h>
+#include <signal.h>
+#include <poll.h>
 
 
 typedef struct ucs_profile_global_location {
@@ -42,6 +47,12 @@ typedef struct ucs_profile_thread_context {
         int                           wraparound;    /**< Whether log was rotated */
     } log;
 
+    struct {
+        unsigned                      countdown;     /**< Scopes to skip until next sample */
+        unsigned                      depth;         /**< Current scope nesting level */
+        int                           is_sampled;    /**< Whether current top-level scope is recorded */
+    } sample;
+
     struct {
         unsigned                      num_locations; /**< Number of valid locations */
         ucs_profile_thread_location_t *locations;    /**< Statistics per location */
@@ -58,12 +69,20 @@ struct ucs_profile_context  {
     unsigned                      profile_mode;     /**< Profiling mode */
     const char                    *file_name;       /**< Profiling output file name */
     size_t                        max_file_size;    /**< Limit for profiling log size */
+    unsigned                      sample_rate;      /**< Scopes sampling rate in ring mode */
     ucs_profile_global_location_t *locations;       /**< Array of all locations */
     unsigned                      num_locations;    /**< Number of valid locations */
     unsigned                      max_locations;    /**< Size of locations array */
     pthread_mutex_t               mutex;            /**< Protects updating the locations array */
     pthread_key_t                 tls_key;          /**< TLS key for per-thread context */
     ucs_list_link_t               thread_list;      /**< List of all thread contexts */
+    struct {
+        ucs_async_pipe_t          pipe;             /**< Wakes up the snapshot thread */
+        ucs_init_once_t           thread_once;      /**< Snapshot thread was started */
+        pthread_t                 thread;           /**< Writes requested snapshots */
+        volatile int              stop;             /**< Snapshot thread should exit */
+        int                       signo;            /**< Signal which requests a snapshot */
+    } snapshot;
 };
 
 
@@ -77,6 +96,7 @@ struct ucs_profile_context  {
 const char *ucs_profile_mode_names[] = {
     [UCS_PROFILE_MODE_ACCUM] = "accum",
     [UCS_PROFILE_MODE_LOG]   = "log",
+    [UCS_PROFILE_MODE_RING]  = "ring",
     [UCS_PROFILE_MODE_LAST]  = NULL
 };
 
@@ -86,6 +106,13 @@ const char *ucs_profile_mode_names[] = {
  */
 ucs_profile_context_t *ucs_profile_default_ctx;
 
+/* Whether the profiling mode keeps a log of records */
+static UCS_F_ALWAYS_INLINE int ucs_profile_is_log_enabled(unsigned profile_mode)
+{
+    return profile_mode & (UCS_BIT(UCS_PROFILE_MODE_LOG) |
+                           UCS_BIT(UCS_PROFILE_MODE_RING));
+}
+
 static ucs_status_t
 ucs_profile_file_write_data(int fd, const void *data, size_t size)
 {
@@ -119,7 +146,7 @@ ucs_profile_write_profiling_records(ucs_profile_context_t *ctx, int fd,
 {
     ucs_status_t status;
 
-    if (!(ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+    if (!ucs_profile_is_log_enabled(ctx->profile_mode)) {
         return UCS_OK;
     }
 
@@ -138,7 +165,7 @@ ucs_profile_write_profiling_records(ucs_profile_context_t *ctx, int fd,
 size_t ucs_profile_calc_num_records(ucs_profile_context_t *ctx,
                                     ucs_profile_thread_context_t *thread_ctx)
 {
-    if (!(ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+    if (!ucs_profile_is_log_enabled(ctx->profile_mode)) {
         return 0;
     }
 
@@ -272,7 +299,7 @@ static void ucs_profile_calc_blocks(ucs_profile_header_t *header,
     header->threads.size   = (thread_header_size + threads_locations_size) *
                              num_threads;
 
-    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (ucs_profile_is_log_enabled(ctx->profile_mode)) {
         ucs_list_for_each(thread_ctx, &ctx->thread_list, list) {
             header->threads.size += 
                     ucs_profile_calc_num_records(ctx, thread_ctx) *
@@ -355,6 +382,8 @@ out_free_env:
     ucs_string_buffer_cleanup(&env_strb);
 }
 
+static void ucs_profile_snapshot_thread_start(ucs_profile_context_t *ctx);
+
 static UCS_F_NOINLINE ucs_profile_thread_context_t*
 ucs_profile_thread_init(ucs_profile_context_t *ctx)
 {
@@ -378,8 +407,8 @@ ucs_profile_thread_init(ucs_profile_context_t *ctx)
               thread_ctx, (unsigned long)pthread_self(), ucs_get_tid(),
               ctx->profile_mode);
 
-    /* Initialize log mode */
-    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    /* Initialize log and ring modes */
+    if (ucs_profile_is_log_enabled(ctx->profile_mode)) {
         num_records = ctx->max_file_size / sizeof(ucs_profile_record_t);
         thread_ctx->log.start = ucs_calloc(num_records,
                                            sizeof(ucs_profile_record_t),
@@ -393,6 +422,11 @@ ucs_profile_thread_init(ucs_profile_context_t *ctx)
         thread_ctx->log.wraparound = 0;
     }
 
+    /* Initialize ring mode */
+    thread_ctx->sample.countdown  = 1;
+    thread_ctx->sample.depth      = 0;
+    thread_ctx->sample.is_sampled = 0;
+
     /* Initialize accumulate mode */
     if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         thread_ctx->accum.num_locations = 0;
@@ -406,6 +440,10 @@ ucs_profile_thread_init(ucs_profile_context_t *ctx)
     ucs_list_add_tail(&ctx->thread_list, &thread_ctx->list);
     pthread_mutex_unlock(&ctx->mutex);
 
+    if (ctx->snapshot.signo > 0) {
+        ucs_profile_snapshot_thread_start(ctx);
+    }
+
     return thread_ctx;
 }
 
@@ -414,7 +452,7 @@ static void ucs_profile_thread_cleanup(unsigned profile_mode,
 {
     ucs_debug("profiling context %p: cleanup", ctx);
 
-    if (profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (ucs_profile_is_log_enabled(profile_mode)) {
         ucs_free(ctx->log.start);
     }
 
@@ -564,6 +602,52 @@ static void ucs_profile_thread_expand_locations(ucs_profile_context_t *ctx,
     thread_ctx->accum.num_locations = new_num_locations;
 }
 
+/*
+ * Check whether an event should be recorded in ring mode. One of every
+ * sample_rate top-level scopes is recorded, together with all its nested
+ * scopes. Other events are always recorded.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucs_profile_thread_sample(ucs_profile_context_t *ctx,
+                          ucs_profile_thread_context_t *thread_ctx,
+                          ucs_profile_type_t type)
+{
+    switch (type) {
+    case UCS_PROFILE_TYPE_SCOPE_BEGIN:
+        if (thread_ctx->sample.is_sampled) {
+            ++thread_ctx->sample.depth;
+            return 1;
+        }
+
+        if ((thread_ctx->sample.depth++ > 0) ||
+            (--thread_ctx->sample.countdown > 0)) {
+            return 0;
+        }
+
+        thread_ctx->sample.countdown  = ctx->sample_rate;
+        thread_ctx->sample.is_sampled = 1;
+        return 1;
+    case UCS_PROFILE_TYPE_SCOPE_END:
+        if (thread_ctx->sample.depth == 0) {
+            /* Scope was started before the thread context was created */
+            return 0;
+        }
+
+        if (--thread_ctx->sample.depth > 0) {
+            return thread_ctx->sample.is_sampled;
+        }
+
+        if (!thread_ctx->sample.is_sampled) {
+            return 0;
+        }
+
+        thread_ctx->sample.is_sampled = 0;
+        return 1;
+    default:
+        return 1;
+    }
+}
+
 void ucs_profile_record(ucs_profile_context_t *ctx, ucs_profile_type_t type,
                         const char *name, uint32_t param32, uint64_t param64,
                         const char *file, int line, const char *function,
@@ -574,6 +658,7 @@ void ucs_profile_record(ucs_profile_context_t *ctx, ucs_profile_type_t type,
     ucs_profile_loc_id_t loc_id;
     ucs_profile_record_t *rec;
     ucs_time_t current_time;
+    int is_logged;
 
     /* If the location id is -1 or 0, need to re-read it with lock held */
     loc_id = *loc_id_p;
@@ -596,6 +681,19 @@ void ucs_profile_record(ucs_profile_context_t *ctx, ucs_profile_type_t type,
         thread_ctx = ucs_profile_thread_init(ctx);
     }
 
+    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+        is_logged = 1;
+    } else if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_RING)) {
+        is_logged = ucs_profile_thread_sample(ctx, thread_ctx, type);
+        if (!is_logged &&
+            !(ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM))) {
+            /* Skip taking a timestamp for scopes which are not sampled */
+            return;
+        }
+    } else {
+        is_logged = 0;
+    }
+
     current_time = ucs_get_time();
     if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) {
         if (ucs_unlikely(loc_id > thread_ctx->accum.num_locations)) {
@@ -620,7 +718,7 @@ void ucs_profile_record(ucs_profile_context_t *ctx, ucs_profile_type_t type,
         ++loc->count;
     }
 
-    if (ctx->profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) {
+    if (is_logged) {
         rec              = thread_ctx->log.current;
         rec->timestamp   = current_time;
         rec->param64     = param64;
@@ -700,6 +798,160 @@ void ucs_profile_dump(ucs_profile_context_t *ctx)
     ucs_profile_cleanup_completed_threads(ctx);
 }
 
+void ucs_profile_snapshot(ucs_profile_context_t *ctx)
+{
+    /*
+     * Threads are not finalized, so they keep recording to their logs while
+     * they are written. In ring mode, the most recent records of a thread may
+     * be overwritten during the write.
+     */
+    ucs_profile_write(ctx);
+}
+
+/* Set by the signal handler, cleared by the snapshot thread */
+static volatile sig_atomic_t ucs_profile_snapshot_requested = 0;
+static volatile int ucs_profile_snapshot_wakeup_fd          = -1;
+
+static void ucs_profile_snapshot_sighandler(int signo)
+{
+    int saved_errno = errno;
+    int dummy       = 0;
+    int fd          = ucs_profile_snapshot_wakeup_fd;
+
+    /*
+     * Writing the profile takes locks, allocates memory and does file IO, so
+     * only mark the request here and let the snapshot thread write it.
+     */
+    ucs_profile_snapshot_requested = 1;
+    if (fd >= 0) {
+        (void)!write(fd, &dummy, sizeof(dummy));
+    }
+
+    errno = saved_errno;
+}
+
+static void *ucs_profile_snapshot_thread_func(void *arg)
+{
+    ucs_profile_context_t *ctx = arg;
+    struct pollfd pfd;
+
+    ucs_log_set_thread_name("p");
+
+    pfd.fd     = ctx->snapshot.pipe.read_fd;
+    pfd.events = POLLIN;
+    while (!ctx->snapshot.stop) {
+        if ((poll(&pfd, 1, -1) < 0) && (errno != EINTR)) {
+            ucs_error("poll() on profile snapshot pipe failed: %m");
+            break;
+        }
+
+        ucs_async_pipe_drain(&ctx->snapshot.pipe);
+        if (ucs_profile_snapshot_requested && !ctx->snapshot.stop) {
+            ucs_profile_snapshot_requested = 0;
+            ucs_profile_snapshot(ctx);
+        }
+    }
+
+    return NULL;
+}
+
+static ucs_status_t ucs_profile_snapshot_signal_init(ucs_profile_context_t *ctx)
+{
+    ucs_status_t status;
+    int ret;
+
+    status = ucs_async_pipe_create(&ctx->snapshot.pipe);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ret = pthread_mutex_init(&ctx->snapshot.thread_once.lock, NULL);
+    if (ret != 0) {
+        ucs_error("failed to initialize mutex: %s", strerror(ret));
+        ucs_async_pipe_destroy(&ctx->snapshot.pipe);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    /* The snapshot thread is started by the first thread which records
+     * profiling data, and not here, since this runs from the library
+     * constructor. A signal which arrives before that is kept in the pipe. */
+    ctx->snapshot.thread_once.initialized = 0;
+    ctx->snapshot.stop                    = 0;
+    ucs_profile_snapshot_requested        = 0;
+    ucs_profile_snapshot_wakeup_fd        = ctx->snapshot.pipe.write_fd;
+    ctx->snapshot.signo                   = ucs_global_opts.profile_signo;
+    signal(ctx->snapshot.signo, ucs_profile_snapshot_sighandler);
+    return UCS_OK;
+}
+
+static void ucs_profile_snapshot_thread_start(ucs_profile_context_t *ctx)
+{
+    ucs_status_t status;
+
+    UCS_INIT_ONCE(&ctx->snapshot.thread_once) {
+        status = ucs_pthread_create(&ctx->snapshot.thread,
+                                    ucs_profile_snapshot_thread_func, ctx,
+                                    "profile");
+        if (status != UCS_OK) {
+            ucs_warn("failed to start profiling snapshot thread, signal %d "
+                     "is ignored", ctx->snapshot.signo);
+            signal(ctx->snapshot.signo, SIG_IGN);
+            ctx->snapshot.stop = 1;
+        }
+    }
+}
+
+static void ucs_profile_snapshot_signal_cleanup(ucs_profile_context_t *ctx)
+{
+    signal(ctx->snapshot.signo, SIG_DFL);
+    ucs_profile_snapshot_wakeup_fd = -1;
+
+    UCS_CLEANUP_ONCE(&ctx->snapshot.thread_once) {
+        if (!ctx->snapshot.stop) {
+            ctx->snapshot.stop = 1;
+            ucs_async_pipe_push(&ctx->snapshot.pipe);
+            pthread_join(ctx->snapshot.thread, NULL);
+        }
+    }
+
+    pthread_mutex_destroy(&ctx->snapshot.thread_once.lock);
+    ucs_async_pipe_destroy(&ctx->snapshot.pipe);
+}
+
+static void ucs_profile_vfs_read_mode(void *obj, ucs_string_buffer_t *strb,
+                                      void *arg_ptr, uint64_t arg_u64)
+{
+    ucs_profile_context_t *ctx = obj;
+
+    ucs_string_buffer_append_flags(strb, ctx->profile_mode,
+                                   ucs_profile_mode_names);
+    ucs_string_buffer_appendf(strb, "\n");
+}
+
+static void ucs_profile_vfs_read_file(void *obj, ucs_string_buffer_t *strb,
+                                      void *arg_ptr, uint64_t arg_u64)
+{
+    ucs_profile_context_t *ctx = obj;
+
+    ucs_string_buffer_appendf(strb, "%s\n", ctx->file_name);
+}
+
+static ucs_status_t ucs_profile_vfs_write_dump(void *obj, const char *buffer,
+                                               size_t size, void *arg_ptr,
+                                               uint64_t arg_u64)
+{
+    ucs_profile_snapshot(obj);
+    return UCS_OK;
+}
+
+static void ucs_profile_vfs_init(ucs_profile_context_t *ctx)
+{
+    ucs_vfs_obj_add_dir(NULL, ctx, "ucs/profile");
+    ucs_vfs_obj_add_ro_file(ctx, ucs_profile_vfs_read_mode, NULL, 0, "mode");
+    ucs_vfs_obj_add_rw_file(ctx, ucs_profile_vfs_read_file,
+                            ucs_profile_vfs_write_dump, NULL, 0, "dump");
+}
+
 unsigned ucs_profile_calc_num_threads(size_t total_num_records,
                                       const ucs_profile_header_t *header)
 {
@@ -716,7 +968,8 @@ unsigned ucs_profile_calc_num_threads(size_t total_num_records,
 }
 
 ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
-                              size_t max_file_size, ucs_profile_context_t **ctx_p)
+                              size_t max_file_size, unsigned sample_rate,
+                              ucs_profile_context_t **ctx_p)
 {
     ucs_profile_context_t *ctx;
     ucs_status_t status;
@@ -739,10 +992,12 @@ ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
     ctx->profile_mode     = profile_mode;
     ctx->file_name        = file_name;
     ctx->max_file_size    = max_file_size;
+    ctx->sample_rate      = ucs_max(sample_rate, 1);
     /* coverity[missing_lock] */
     ctx->num_locations    = 0;
     ctx->locations        = NULL;
     ctx->max_locations    = 0;
+    ctx->snapshot.signo   = 0;
 
     if (profile_mode && !strlen(file_name)) {
         // TODO make sure profiling file is writeable
@@ -750,6 +1005,17 @@ ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
     }
 
     pthread_key_create(&(ctx->tls_key), ucs_profile_thread_key_destr);
+
+    if (profile_mode) {
+        if ((ucs_global_opts.profile_signo > 0) &&
+            (ucs_profile_snapshot_signal_init(ctx) != UCS_OK)) {
+            ucs_warn("failed to set up profiling snapshot on signal %d",
+                     ucs_global_opts.profile_signo);
+        }
+
+        ucs_profile_vfs_init(ctx);
+    }
+
     *ctx_p = ctx;
 
     return UCS_OK;
@@ -761,6 +1027,13 @@ free_ctx:
 
 void ucs_profile_cleanup(ucs_profile_context_t *ctx)
 {
+    if (ctx->profile_mode) {
+        ucs_vfs_obj_remove(ctx);
+        if (ctx->snapshot.signo > 0) {
+            ucs_profile_snapshot_signal_cleanup(ctx);
+        }
+    }
+
     ucs_profile_dump(ctx);
     ucs_profile_check_active_threads(ctx);
     ucs_profile_reset_locations(ctx);
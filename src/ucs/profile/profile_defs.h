@@ -30,6 +30,7 @@ BEGIN_C_DECLS
 enum {
     UCS_PROFILE_MODE_ACCUM, /**< Accumulate elapsed time per location */
     UCS_PROFILE_MODE_LOG,   /**< Record all events */
+    UCS_PROFILE_MODE_RING,  /**< Record recent events and sampled scopes */
     UCS_PROFILE_MODE_LAST
 };
 
@@ -146,12 +147,15 @@ extern ucs_profile_context_t *ucs_profile_default_ctx;
  * @param [in]  profile_mode  Profiling mode.
  * @param [in]  file_name     Profiling file.
  * @param [in]  max_file_size Limit for profiling log size.
+ * @param [in]  sample_rate   Record one of every this many scopes in ring
+ *                            mode.
  * @param [out] ctx_p         Profile context.
  *
  * @return Status code.
  */
 ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
-                              size_t max_file_size, ucs_profile_context_t **ctx_p);
+                              size_t max_file_size, unsigned sample_rate,
+                              ucs_profile_context_t **ctx_p);
 
 
 /**
@@ -170,6 +174,15 @@ void ucs_profile_cleanup(ucs_profile_context_t *ctx);
 void ucs_profile_dump(ucs_profile_context_t *ctx);
 
 
+/**
+ * Save profiling data without resetting it. The profiled threads may continue
+ * recording while the data is saved.
+ *
+ * @param [in] ctx       Profile context.
+ */
+void ucs_profile_snapshot(ucs_profile_context_t *ctx);
+
+
 /*
  * Store a new record with the given data.
  * SHOULD NOT be used directly - use UCS_PROFILE macros instead.
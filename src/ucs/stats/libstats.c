@@ -57,14 +57,76 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
             return status;
         }
     }
+    for (i = 0; i < cls->num_histograms; ++i) {
+        status = ucs_stats_name_check(cls->histogram_names[i]);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
 
     /* Set up node */
     node->cls = cls;
     ucs_vsnprintf_safe(node->name, UCS_STAT_NAME_MAX, name, ap);
     ucs_list_head_init(&node->children[UCS_STATS_INACTIVE_CHILDREN]);
     ucs_list_head_init(&node->children[UCS_STATS_ACTIVE_CHILDREN]);
-    memset(node->counters, 0, cls->num_counters * sizeof(ucs_stats_counter_t));
+    memset(node->counters, 0,
+           ucs_stats_class_num_values(cls) * sizeof(ucs_stats_counter_t));
 
     return UCS_OK;
 }
 
+uint64_t ucs_stats_histogram_bucket_min(unsigned bucket)
+{
+    unsigned shift;
+
+    if (bucket < UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS + 1)) {
+        return bucket;
+    }
+
+    shift = (bucket >> UCS_STATS_HISTOGRAM_SUB_BITS) - 1;
+    return ((uint64_t)((bucket & UCS_MASK(UCS_STATS_HISTOGRAM_SUB_BITS)) |
+                       UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS))) << shift;
+}
+
+uint64_t ucs_stats_histogram_count(const ucs_stats_counter_t *buckets)
+{
+    uint64_t count = 0;
+    unsigned i;
+
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS; ++i) {
+        count += buckets[i];
+    }
+
+    return count;
+}
+
+uint64_t ucs_stats_histogram_percentile(const ucs_stats_counter_t *buckets,
+                                        double percentile)
+{
+    uint64_t count, rank, acc;
+    double target;
+    unsigned i;
+
+    count = ucs_stats_histogram_count(buckets);
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Rank of the requested percentile, rounded up */
+    target = count * percentile / 100.0;
+    rank   = ucs_max((uint64_t)target, 1);
+    if (rank < target) {
+        ++rank;
+    }
+
+    acc = 0;
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS - 1; ++i) {
+        acc += buckets[i];
+        if (acc >= rank) {
+            break;
+        }
+    }
+
+    return ucs_stats_histogram_bucket_min(i + 1) - 1;
+}
+
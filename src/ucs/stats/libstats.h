@@ -36,6 +36,18 @@ enum {
 #define UCS_STATS_NODE_ARG(_node) \
     (_node)->cls->name, (_node)->name
 
+/*
+ * Latency histograms use HDR-style log-linear buckets: every power-of-two
+ * range is split into 2^UCS_STATS_HISTOGRAM_SUB_BITS equal sub-buckets, which
+ * bounds the relative error of a reported percentile to 1/16. Values above
+ * 2^UCS_STATS_HISTOGRAM_MAX_BITS are accounted in the last bucket.
+ */
+#define UCS_STATS_HISTOGRAM_SUB_BITS    4
+#define UCS_STATS_HISTOGRAM_MAX_BITS    40
+#define UCS_STATS_HISTOGRAM_NUM_BUCKETS \
+    ((UCS_STATS_HISTOGRAM_MAX_BITS - UCS_STATS_HISTOGRAM_SUB_BITS + 1) << \
+     UCS_STATS_HISTOGRAM_SUB_BITS)
+
 #define UCS_STATS_INDENT(_is_sum, _indent)  _is_sum ? 0 : (_indent) * 2, ""
 #define UCS_STATS_IS_LAST_COUNTER(_counters_bits, _current) \
     (_counters_bits > ((2ull<<_current) - 1))
@@ -56,6 +68,8 @@ struct ucs_stats_class {
     const char           *name;
     unsigned             num_counters;
     unsigned             class_id;
+    unsigned             num_histograms;
+    const char           **histogram_names;
     const char*          counter_names[];
 };
 
@@ -129,7 +143,8 @@ struct ucs_stats_node {
     ucs_list_link_t          type_list;          /* nodes with same class/es
                                                     hierarchy */
     ucs_stats_filter_node_t  *filter_node;       /* ptr to type list head */
-    ucs_stats_counter_t      counters[1];        /* instance counters */
+    ucs_stats_counter_t      counters[1];        /* instance counters, followed
+                                                    by histogram buckets */
 };
 
 struct ucs_stats_filter_node {
@@ -140,8 +155,91 @@ struct ucs_stats_filter_node {
     int                       type_list_len;      /* length of list */
     int                       ref_count;          /* report node when non zero */
     uint64_t                  counters_bitmask;   /* which counters to print */
+    uint64_t                  histograms_bitmask; /* which histograms to print */
 };
 
+
+/**
+ * Get the bucket index of a value in a latency histogram.
+ *
+ * @param value  Value to account.
+ *
+ * @return Bucket index, less than UCS_STATS_HISTOGRAM_NUM_BUCKETS.
+ */
+static UCS_F_ALWAYS_INLINE unsigned ucs_stats_histogram_bucket(uint64_t value)
+{
+    unsigned shift;
+
+    if (value < UCS_BIT(UCS_STATS_HISTOGRAM_SUB_BITS + 1)) {
+        return value;
+    }
+
+    if (value >= UCS_BIT(UCS_STATS_HISTOGRAM_MAX_BITS)) {
+        return UCS_STATS_HISTOGRAM_NUM_BUCKETS - 1;
+    }
+
+    shift = ucs_ilog2(value) - UCS_STATS_HISTOGRAM_SUB_BITS;
+    return (shift << UCS_STATS_HISTOGRAM_SUB_BITS) + (value >> shift);
+}
+
+
+/**
+ * Get the buckets of a histogram in a statistics node.
+ *
+ * @param node   Statistics node.
+ * @param index  Histogram index in the node class.
+ *
+ * @return Array of UCS_STATS_HISTOGRAM_NUM_BUCKETS counters.
+ */
+static UCS_F_ALWAYS_INLINE ucs_stats_counter_t *
+ucs_stats_node_histogram(ucs_stats_node_t *node, unsigned index)
+{
+    return node->counters + node->cls->num_counters +
+           (index * UCS_STATS_HISTOGRAM_NUM_BUCKETS);
+}
+
+
+/**
+ * Get the number of counters to allocate for a node of a given class,
+ * including histogram buckets.
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucs_stats_class_num_values(const ucs_stats_class_t *cls)
+{
+    return cls->num_counters +
+           (cls->num_histograms * UCS_STATS_HISTOGRAM_NUM_BUCKETS);
+}
+
+
+/**
+ * Get the lowest value which is accounted in a histogram bucket.
+ *
+ * @param bucket  Bucket index.
+ */
+uint64_t ucs_stats_histogram_bucket_min(unsigned bucket);
+
+
+/**
+ * Estimate a percentile of the values accounted in a histogram. The result
+ * is the highest value which is accounted in the same bucket as the requested
+ * percentile.
+ *
+ * @param buckets     Histogram buckets.
+ * @param percentile  Requested percentile, in the range [0..100].
+ *
+ * @return Estimated value, or 0 if the histogram is empty.
+ */
+uint64_t ucs_stats_histogram_percentile(const ucs_stats_counter_t *buckets,
+                                        double percentile);
+
+
+/**
+ * Get the total number of values accounted in a histogram.
+ *
+ * @param buckets  Histogram buckets.
+ */
+uint64_t ucs_stats_histogram_count(const ucs_stats_counter_t *buckets);
+
 /**
  * Initialize statistics node.
  *
@@ -182,6 +280,35 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root);
 void ucs_stats_free(ucs_stats_node_t *root);
 
 
+/**
+ * Serialize the difference between two snapshots of the same statistics tree,
+ * as returned by ucs_stats_deserialize(). Only the values which changed are
+ * written, as variable-length encoded deltas, so a delta of a mostly idle
+ * tree takes just a few bytes.
+ *
+ * @param stream     Destination.
+ * @param prev_root  Previous snapshot.
+ * @param root       Current snapshot.
+ *
+ * @return UCS_ERR_INVALID_PARAM if the trees have different layouts, in which
+ *         case nothing is written and a full snapshot should be sent instead.
+ */
+ucs_status_t ucs_stats_serialize_delta(FILE *stream, ucs_stats_node_t *prev_root,
+                                       ucs_stats_node_t *root);
+
+
+/**
+ * Apply a difference written by ucs_stats_serialize_delta() to a statistics
+ * tree which holds the previous snapshot.
+ *
+ * @param stream   Source data.
+ * @param root     Statistics tree to update in-place.
+ *
+ * @return UCS_ERR_INVALID_PARAM if the delta does not match the tree layout.
+ */
+ucs_status_t ucs_stats_deserialize_delta(FILE *stream, ucs_stats_node_t *root);
+
+
 /**
  * Initialize statistics client.
  *
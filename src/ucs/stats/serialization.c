@@ -35,6 +35,15 @@
 #define UCS_STATS_COUNTER_U64        3
 
 
+/* Binary data format version. Version 2 adds histograms. */
+#define UCS_STATS_DATA_VERSION       2
+#define UCS_STATS_DATA_VERSION_HIST  2
+
+
+/* Histogram buckets are encoded in chunks to bound the size of stack buffers */
+#define UCS_STATS_HISTOGRAM_CHUNK    64
+
+
 /* Compression mode */
 #define UCS_STATS_COMPRESSION_NONE   0
 #define UCS_STATS_COMPRESSION_BZIP2  1
@@ -226,10 +235,55 @@ static void ucs_stats_write_counters(ucs_stats_counter_t *counters,
     FWRITE(counter_data, pos - counter_data, stream);
 }
 
+static void ucs_stats_read_histogram(ucs_stats_counter_t *buckets, FILE *stream)
+{
+    unsigned i;
+
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS;
+         i += UCS_STATS_HISTOGRAM_CHUNK) {
+        ucs_stats_read_counters(buckets + i,
+                                ucs_min(UCS_STATS_HISTOGRAM_CHUNK,
+                                        UCS_STATS_HISTOGRAM_NUM_BUCKETS - i),
+                                stream);
+    }
+}
+
+static void ucs_stats_write_histogram(ucs_stats_counter_t *buckets, FILE *stream)
+{
+    unsigned i;
+
+    for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS;
+         i += UCS_STATS_HISTOGRAM_CHUNK) {
+        ucs_stats_write_counters(buckets + i,
+                                 ucs_min(UCS_STATS_HISTOGRAM_CHUNK,
+                                         UCS_STATS_HISTOGRAM_NUM_BUCKETS - i),
+                                 stream);
+    }
+}
+
+static void
+ucs_stats_histogram_filtered(ucs_stats_filter_node_t *filter_node,
+                             unsigned histogram_index,
+                             ucs_stats_counter_t *buckets)
+{
+    ucs_stats_counter_t *node_buckets;
+    ucs_stats_node_t *temp_node;
+    unsigned i;
+
+    memset(buckets, 0, sizeof(*buckets) * UCS_STATS_HISTOGRAM_NUM_BUCKETS);
+    ucs_list_for_each(temp_node, &filter_node->type_list_head, type_list) {
+        node_buckets = ucs_stats_node_histogram(temp_node, histogram_index);
+        for (i = 0; i < UCS_STATS_HISTOGRAM_NUM_BUCKETS; ++i) {
+            buckets[i] += node_buckets[i];
+        }
+    }
+}
+
 static void
 ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
                                   ucs_stats_children_sel_t sel,
-                                  ucs_stats_clsid_t **cls_hash)
+                                  ucs_stats_clsid_t **cls_hash,
+                                  ucs_stats_counter_t *buckets)
 {
     ucs_stats_counter_t filtered_counters[64] = {};
     ucs_stats_filter_node_t *filter_node      = node->filter_node;
@@ -238,7 +292,7 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
     ucs_stats_clsid_t *elem, search;
     ucs_stats_node_t *temp_node;
     ucs_stats_node_t *child;
-    uint32_t counter_index;
+    uint32_t counter_index, histogram_index;
     uint8_t sentinel;
 
     /* Search the class */
@@ -263,9 +317,16 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
     /* Write counters */
     ucs_stats_write_counters(filtered_counters, filtered_counter_index, stream);
 
+    /* Write histograms, zero buckets take only 2 bits */
+    ucs_for_each_bit(histogram_index, filter_node->histograms_bitmask) {
+        ucs_stats_histogram_filtered(filter_node, histogram_index, buckets);
+        ucs_stats_write_histogram(buckets, stream);
+    }
+
     /* Children */
     ucs_list_for_each(child, &node->children[sel], list) {
-        ucs_stats_serialize_binary_recurs(stream, child, sel, cls_hash);
+        ucs_stats_serialize_binary_recurs(stream, child, sel, cls_hash,
+                                          buckets);
     }
 
     /* Write sentinel which is not valid class id to mark end of children */
@@ -275,19 +336,20 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
 
 static ucs_status_t
 ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
-                           ucs_stats_children_sel_t sel)
+                           ucs_stats_children_sel_t sel,
+                           ucs_stats_counter_t *buckets)
 {
     ucs_stats_clsid_t* cls_hash[UCS_STATS_CLS_HASH_SIZE];
     struct sglib_hashed_ucs_stats_clsid_t_iterator it;
     ucs_stats_class_t *cls;
     ucs_stats_clsid_t *elem;
     ucs_stats_data_header_t hdr;
-    unsigned idx, counter;
+    unsigned idx, counter, histogram;
 
     sglib_hashed_ucs_stats_clsid_t_init(cls_hash);
 
     /* Write header */
-    hdr.version     = 1;
+    hdr.version     = UCS_STATS_DATA_VERSION;
     hdr.compression = UCS_STATS_COMPRESSION_NONE;
     hdr.reserved    = 0;
     hdr.num_classes = ucs_stats_get_all_classes_recurs(root, sel, cls_hash);
@@ -300,7 +362,7 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
          elem != NULL; elem = sglib_hashed_ucs_stats_clsid_t_it_next(&it))
     {
         ucs_stats_filter_node_t *filter_node;
-        unsigned num_counters_filtered;
+        unsigned num_counters_filtered, num_histograms_filtered;
 
         cls = elem->cls;
         ucs_stats_write_str(cls->name, stream);
@@ -312,13 +374,20 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
         ucs_for_each_bit(counter, filter_node->counters_bitmask) {
            ucs_stats_write_str(cls->counter_names[counter], stream);
         }
+
+        num_histograms_filtered = ucs_popcount(filter_node->histograms_bitmask);
+        FWRITE_ONE(&num_histograms_filtered, stream);
+
+        ucs_for_each_bit(histogram, filter_node->histograms_bitmask) {
+           ucs_stats_write_str(cls->histogram_names[histogram], stream);
+        }
         elem->clsid = idx++;
     }
 
     assert(idx == hdr.num_classes);
 
     /* Write stats nodes */
-    ucs_stats_serialize_binary_recurs(stream, root, sel, cls_hash);
+    ucs_stats_serialize_binary_recurs(stream, root, sel, cls_hash, buckets);
 
     /* Free classes */
     for (elem = sglib_hashed_ucs_stats_clsid_t_it_init(&it, cls_hash);
@@ -333,7 +402,8 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
 static ucs_status_t
 ucs_stats_serialize_text_recurs_filtered(FILE *stream,
                                          ucs_stats_filter_node_t *filter_node,
-                                         unsigned indent)
+                                         unsigned indent,
+                                         ucs_stats_counter_t *buckets)
 {
     ucs_stats_filter_node_t *filter_child;
     ucs_stats_node_t *node;
@@ -398,9 +468,28 @@ ucs_stats_serialize_text_recurs_filtered(FILE *stream,
         }
     }
 
+    /* Histograms are reported as count and percentiles, in nanoseconds */
+    ucs_for_each_bit(i, filter_node->histograms_bitmask) {
+        if (is_sum && ((filter_node->counters_bitmask != 0) ||
+                       (filter_node->histograms_bitmask & UCS_MASK(i)))) {
+            fputs(" ", stream);
+        }
+
+        ucs_stats_histogram_filtered(filter_node, i, buckets);
+        fprintf(stream,
+                "%*s%s:%scount %" PRIu64 " p50 %" PRIu64 " p99 %" PRIu64
+                " p999 %" PRIu64 "%s",
+                UCS_STATS_INDENT(is_sum, indent + 1),
+                node->cls->histogram_names[i], space,
+                ucs_stats_histogram_count(buckets),
+                ucs_stats_histogram_percentile(buckets, 50.0),
+                ucs_stats_histogram_percentile(buckets, 99.0),
+                ucs_stats_histogram_percentile(buckets, 99.9), nl);
+    }
+
     ucs_list_for_each(filter_child, &filter_node->children, list) {
         ucs_stats_serialize_text_recurs_filtered(stream, filter_child,
-                                                 indent + 1);
+                                                 indent + 1, buckets);
     }
 
     if (filter_node->parent) {
@@ -420,14 +509,25 @@ ucs_status_t ucs_stats_serialize(FILE *stream, ucs_stats_node_t *root, int optio
                     (options & UCS_STATS_SERIALIZE_INACTVIVE) ?
                                     UCS_STATS_INACTIVE_CHILDREN :
                                     UCS_STATS_ACTIVE_CHILDREN;
+    ucs_stats_counter_t *buckets;
+    ucs_status_t status;
+
+    /* Histogram buckets are too large for the stack of the recursive calls */
+    buckets = malloc(sizeof(*buckets) * UCS_STATS_HISTOGRAM_NUM_BUCKETS);
+    if (buckets == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
 
     if (options & UCS_STATS_SERIALIZE_BINARY) {
-        return ucs_stats_serialize_binary(stream, root, sel);
+        status = ucs_stats_serialize_binary(stream, root, sel, buckets);
     } else {
-        return ucs_stats_serialize_text_recurs_filtered(stream,
-                                                        root->filter_node,
-                                                        0);
+        status = ucs_stats_serialize_text_recurs_filtered(stream,
+                                                          root->filter_node, 0,
+                                                          buckets);
     }
+
+    free(buckets);
+    return status;
 }
 
 static ucs_status_t
@@ -438,6 +538,7 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
     ucs_stats_node_t *node, *child;
     ucs_stats_class_t *cls;
     uint8_t clsid, namelen;
+    unsigned i;
     ucs_status_t status;
     void *ptr;
 
@@ -467,10 +568,12 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
     }
 
     cls = classes[clsid];
-    ptr = malloc(headroom + sizeof *node + sizeof(ucs_stats_counter_t) * cls->num_counters);
+    ptr = malloc(headroom + sizeof *node +
+                 sizeof(ucs_stats_counter_t) * ucs_stats_class_num_values(cls));
     if (ptr == NULL) {
-        ucs_error("Failed to allocate statistics counters (headroom %zu, %u counters)",
-                  headroom, cls->num_counters);
+        ucs_error("Failed to allocate statistics counters (headroom %zu, %u counters, "
+                  "%u histograms)", headroom, cls->num_counters,
+                  cls->num_histograms);
         return UCS_ERR_NO_MEMORY;
     }
 
@@ -485,6 +588,11 @@ ucs_stats_deserialize_recurs(FILE *stream, ucs_stats_class_t **classes,
     /* Read counters */
     ucs_stats_read_counters(node->counters, cls->num_counters, stream);
 
+    /* Read histograms */
+    for (i = 0; i < cls->num_histograms; ++i) {
+        ucs_stats_read_histogram(ucs_stats_node_histogram(node, i), stream);
+    }
+
     /* Read children */
     do {
         status = ucs_stats_deserialize_recurs(stream, classes, num_classes, 0,
@@ -513,6 +621,10 @@ static void ucs_stats_free_classes(ucs_stats_class_t **classes, unsigned num_cla
         for (j = 0; j < classes[i]->num_counters; ++j) {
             free((char*)classes[i]->counter_names[j]);
         }
+        for (j = 0; j < classes[i]->num_histograms; ++j) {
+            free((char*)classes[i]->histogram_names[j]);
+        }
+        free(classes[i]->histogram_names);
         free(classes[i]);
     }
     free(classes);
@@ -523,7 +635,7 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
     ucs_stats_data_header_t hdr;
     ucs_stats_root_storage_t *s;
     ucs_stats_class_t **classes, *cls;
-    unsigned i, j, num_counters;
+    unsigned i, j, num_counters, num_histograms;
     ucs_status_t status;
     size_t nread;
     char *name;
@@ -534,7 +646,7 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
         goto err;
     }
 
-    if (hdr.version != 1) {
+    if ((hdr.version < 1) || (hdr.version > UCS_STATS_DATA_VERSION)) {
         ucs_error("invalid file version");
         status = UCS_ERR_UNSUPPORTED;
         goto err;
@@ -561,6 +673,20 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
         for (j = 0; j < cls->num_counters; ++j) {
             cls->counter_names[j] = ucs_stats_read_str(stream);
         }
+
+        if (hdr.version >= UCS_STATS_DATA_VERSION_HIST) {
+            FREAD_ONE(&num_histograms, stream);
+        } else {
+            num_histograms = 0;
+        }
+
+        /* coverity[tainted_data] */
+        cls->num_histograms  = num_histograms;
+        cls->histogram_names = malloc(num_histograms *
+                                      sizeof(*cls->histogram_names));
+        for (j = 0; j < cls->num_histograms; ++j) {
+            cls->histogram_names[j] = ucs_stats_read_str(stream);
+        }
         classes[i] = cls;
 
     }
@@ -611,3 +737,235 @@ void ucs_stats_free(ucs_stats_node_t *root)
     free(s);
 }
 
+
+/* Delta stream: total number of values in the tree, number of changed values,
+ * and for each changed value - a pair of variable-length integers: the number
+ * of unchanged values before it, and the zigzag-encoded signed difference */
+typedef struct {
+    FILE     *stream;      /* NULL to only count the changes */
+    uint64_t num_values;
+    uint64_t num_changes;
+    uint64_t skip;
+    int64_t  delta;
+} ucs_stats_delta_ctx_t;
+
+
+static void ucs_stats_write_varint(uint64_t value, FILE *stream)
+{
+    uint8_t byte;
+
+    while (value >= 0x80) {
+        byte    = (value & 0x7f) | 0x80;
+        value >>= 7;
+        FWRITE_ONE(&byte, stream);
+    }
+
+    byte = value;
+    FWRITE_ONE(&byte, stream);
+}
+
+static ucs_status_t ucs_stats_read_varint(FILE *stream, uint64_t *value_p)
+{
+    uint64_t value = 0;
+    unsigned shift = 0;
+    int c;
+
+    do {
+        c = fgetc(stream);
+        if ((c == EOF) || (shift >= 64)) {
+            ucs_error("Error parsing statistics delta - invalid varint");
+            return UCS_ERR_MESSAGE_TRUNCATED;
+        }
+
+        value |= (uint64_t)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    *value_p = value;
+    return UCS_OK;
+}
+
+static int
+ucs_stats_layout_is_equal(ucs_stats_node_t *node1, ucs_stats_node_t *node2)
+{
+    ucs_list_link_t *head1 = &node1->children[UCS_STATS_ACTIVE_CHILDREN];
+    ucs_list_link_t *head2 = &node2->children[UCS_STATS_ACTIVE_CHILDREN];
+    ucs_stats_node_t *child1, *child2;
+
+    if (strcmp(node1->cls->name, node2->cls->name) ||
+        strcmp(node1->name, node2->name) ||
+        (ucs_stats_class_num_values(node1->cls) !=
+         ucs_stats_class_num_values(node2->cls)) ||
+        (ucs_list_length(head1) != ucs_list_length(head2))) {
+        return 0;
+    }
+
+    child2 = ucs_list_head(head2, ucs_stats_node_t, list);
+    ucs_list_for_each(child1, head1, list) {
+        if (!ucs_stats_layout_is_equal(child1, child2)) {
+            return 0;
+        }
+
+        child2 = ucs_list_next(&child2->list, ucs_stats_node_t, list);
+    }
+
+    return 1;
+}
+
+static uint64_t ucs_stats_num_values_recurs(ucs_stats_node_t *node)
+{
+    uint64_t num_values = ucs_stats_class_num_values(node->cls);
+    ucs_stats_node_t *child;
+
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
+        num_values += ucs_stats_num_values_recurs(child);
+    }
+
+    return num_values;
+}
+
+static void ucs_stats_serialize_delta_recurs(ucs_stats_delta_ctx_t *ctx,
+                                             ucs_stats_node_t *prev_node,
+                                             ucs_stats_node_t *node)
+{
+    size_t i, num_values = ucs_stats_class_num_values(node->cls);
+    ucs_stats_node_t *prev_child, *child;
+    int64_t delta;
+
+    for (i = 0; i < num_values; ++i) {
+        if (node->counters[i] == prev_node->counters[i]) {
+            ++ctx->skip;
+            continue;
+        }
+
+        if (ctx->stream != NULL) {
+            delta = (int64_t)(node->counters[i] - prev_node->counters[i]);
+            ucs_stats_write_varint(ctx->skip, ctx->stream);
+            ucs_stats_write_varint(((uint64_t)delta << 1) ^ (delta >> 63),
+                                   ctx->stream);
+        }
+
+        ctx->skip = 0;
+        ++ctx->num_changes;
+    }
+
+    prev_child = ucs_list_head(&prev_node->children[UCS_STATS_ACTIVE_CHILDREN],
+                               ucs_stats_node_t, list);
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
+        ucs_stats_serialize_delta_recurs(ctx, prev_child, child);
+        prev_child = ucs_list_next(&prev_child->list, ucs_stats_node_t, list);
+    }
+}
+
+ucs_status_t ucs_stats_serialize_delta(FILE *stream, ucs_stats_node_t *prev_root,
+                                       ucs_stats_node_t *root)
+{
+    ucs_stats_delta_ctx_t ctx = {};
+
+    if (!ucs_stats_layout_is_equal(prev_root, root)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* First pass only counts the changes, second pass writes them */
+    ucs_stats_serialize_delta_recurs(&ctx, prev_root, root);
+    ucs_stats_write_varint(ucs_stats_num_values_recurs(root), stream);
+    ucs_stats_write_varint(ctx.num_changes, stream);
+
+    ctx.stream = stream;
+    ctx.skip   = 0;
+    ucs_stats_serialize_delta_recurs(&ctx, prev_root, root);
+    return UCS_OK;
+}
+
+static ucs_status_t ucs_stats_read_delta(ucs_stats_delta_ctx_t *ctx)
+{
+    uint64_t value;
+    ucs_status_t status;
+
+    status = ucs_stats_read_varint(ctx->stream, &ctx->skip);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_stats_read_varint(ctx->stream, &value);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ctx->delta = (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucs_stats_deserialize_delta_recurs(ucs_stats_delta_ctx_t *ctx,
+                                   ucs_stats_node_t *node)
+{
+    size_t i, num_values = ucs_stats_class_num_values(node->cls);
+    ucs_stats_node_t *child;
+    ucs_status_t status;
+
+    for (i = 0; (i < num_values) && (ctx->num_changes > 0); ++i) {
+        if (ctx->skip > 0) {
+            --ctx->skip;
+            continue;
+        }
+
+        node->counters[i] += ctx->delta;
+        if (--ctx->num_changes > 0) {
+            status = ucs_stats_read_delta(ctx);
+            if (status != UCS_OK) {
+                return status;
+            }
+        }
+    }
+
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
+        status = ucs_stats_deserialize_delta_recurs(ctx, child);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t ucs_stats_deserialize_delta(FILE *stream, ucs_stats_node_t *root)
+{
+    ucs_stats_delta_ctx_t ctx = {.stream = stream};
+    ucs_status_t status;
+
+    status = ucs_stats_read_varint(stream, &ctx.num_values);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (ctx.num_values != ucs_stats_num_values_recurs(root)) {
+        ucs_error("Error parsing statistics delta - expected %" PRIu64
+                  " values, got %" PRIu64, ucs_stats_num_values_recurs(root),
+                  ctx.num_values);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    status = ucs_stats_read_varint(stream, &ctx.num_changes);
+    if ((status != UCS_OK) || (ctx.num_changes == 0)) {
+        return status;
+    }
+
+    status = ucs_stats_read_delta(&ctx);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_stats_deserialize_delta_recurs(&ctx, root);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (ctx.num_changes > 0) {
+        ucs_error("Error parsing statistics delta - %" PRIu64
+                  " changes out of range", ctx.num_changes);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    return UCS_OK;
+}
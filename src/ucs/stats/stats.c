@@ -22,6 +22,7 @@
 #include <ucs/datastruct/array.h>
 #include <ucs/datastruct/khash.h>
 #include <ucs/sys/string.h>
+#include <ucs/vfs/base/vfs_obj.h>
 
 #include <sys/ioctl.h>
 #ifdef HAVE_LINUX_FUTEX_H
@@ -135,6 +136,13 @@ static void ucs_stats_free_class(ucs_stats_class_t *cls)
         ucs_free((void*)cls->counter_names[i]);
     }
 
+    if (cls->histogram_names != NULL) {
+        for (i = 0; i < cls->num_histograms; i++) {
+            ucs_free((void*)cls->histogram_names[i]);
+        }
+        ucs_free(cls->histogram_names);
+    }
+
     ucs_free((void*)cls->name);
     ucs_free(cls);
 }
@@ -168,6 +176,30 @@ static ucs_stats_class_t *ucs_stats_dup_class(ucs_stats_class_t *cls)
         }
     }
 
+    if (cls->num_histograms == 0) {
+        return class_dup;
+    }
+
+    class_dup->histogram_names = ucs_calloc(cls->num_histograms,
+                                            sizeof(*cls->histogram_names),
+                                            "ucs_stats_class_t histograms");
+    if (!class_dup->histogram_names) {
+        ucs_error("failed to allocate statistics histogram names");
+        goto err_free;
+    }
+
+    for (class_dup->num_histograms = 0;
+         class_dup->num_histograms < cls->num_histograms;
+         class_dup->num_histograms++) {
+        class_dup->histogram_names[class_dup->num_histograms] =
+            ucs_strdup(cls->histogram_names[class_dup->num_histograms],
+                       "ucs_stats_class_t histogram");
+        if (!class_dup->histogram_names[class_dup->num_histograms]) {
+            ucs_error("failed to allocate statistics histogram name");
+            goto err_free;
+        }
+    }
+
     return class_dup;
 
 err_free:
@@ -241,6 +273,7 @@ static void ucs_stats_filter_node_init_root() {
     ucs_list_add_tail(&ucs_stats_context.root_filter_node.type_list_head,
                       &ucs_stats_context.root_node.type_list);
     ucs_stats_context.root_filter_node.counters_bitmask = 0;
+    ucs_stats_context.root_filter_node.histograms_bitmask = 0;
     ucs_stats_context.root_filter_node.ref_count = 0;
     ucs_stats_context.root_filter_node.type_list_len = 1;
     ucs_list_head_init(&ucs_stats_context.root_filter_node.children);
@@ -269,11 +302,12 @@ static void ucs_stats_node_init_root(const char *name, ...)
 
 static ucs_status_t ucs_stats_node_new(ucs_stats_class_t *cls, ucs_stats_node_t **p_node)
 {
+    size_t num_values = ucs_stats_class_num_values(cls);
     ucs_stats_node_t *node;
 
     node = ucs_malloc(sizeof(ucs_stats_node_t) +
                       sizeof(ucs_stats_counter_t) *
-                      (cls->num_counters > 0 ? cls->num_counters - 1 : 0),
+                      (num_values > 0 ? num_values - 1 : 0),
                       "stats node");
     if (node == NULL) {
         ucs_error("Failed to allocate stats node for %s", cls->name);
@@ -345,6 +379,7 @@ static void ucs_stats_add_to_filter(ucs_stats_node_t *node,
         filter_node->type_list_len = 0;
         filter_node->ref_count = 0;
         filter_node->counters_bitmask = 0;
+        filter_node->histograms_bitmask = 0;
         ucs_list_head_init(&filter_node->children);
         ucs_list_head_init(&filter_node->type_list_head);
         filter_node->parent = filter_parent;
@@ -364,6 +399,15 @@ static void ucs_stats_add_to_filter(ucs_stats_node_t *node,
         }
     }
 
+    for (i = 0; (i < node->cls->num_histograms) && (i < 64); ++i) {
+        filter_index = ucs_config_names_search(&ucs_global_opts.stats_filter,
+                                               node->cls->histogram_names[i]);
+        if (filter_index >= 0) {
+            filter_node->histograms_bitmask |= UCS_BIT(i);
+            found = 1;
+        }
+    }
+
     if (found) {
         temp_filter_node = filter_node;
         while (temp_filter_node != NULL) {
@@ -701,6 +745,8 @@ static void ucs_stats_open_dest()
         }
 
         ucs_stats_context_flags |= UCS_STATS_FLAG_SOCKET;
+    } else if (!strcmp(ucs_global_opts.stats_dest, "vfs")) {
+        ucs_stats_context_flags |= UCS_STATS_FLAG_VFS;
     } else if (strcmp(ucs_global_opts.stats_dest, "") != 0) {
         status = ucs_open_output_stream(ucs_global_opts.stats_dest,
                                         UCS_LOG_LEVEL_ERROR,
@@ -728,6 +774,7 @@ out_free:
 
 static void ucs_stats_close_dest()
 {
+    ucs_stats_context_flags &= ~UCS_STATS_FLAG_VFS;
     if (ucs_stats_context_flags & UCS_STATS_FLAG_SOCKET) {
         ucs_stats_context_flags &= ~UCS_STATS_FLAG_SOCKET;
         ucs_stats_client_cleanup(ucs_stats_context.client);
@@ -814,6 +861,46 @@ static void ucs_stats_unset_trigger()
     }
 }
 
+static void ucs_stats_vfs_read(void *obj, ucs_string_buffer_t *strb,
+                               void *arg_ptr, uint64_t arg_u64)
+{
+    int options = arg_u64;
+    char *buffer;
+    size_t size;
+    FILE *f;
+
+    f = open_memstream(&buffer, &size);
+    if (f == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&ucs_stats_context.lock);
+    UCS_STATS_SET_TIME(&ucs_stats_context.root_node, UCS_ROOT_STATS_RUNTIME,
+                       ucs_stats_context.start_time);
+    ucs_stats_serialize(f, &ucs_stats_context.root_node, options);
+    pthread_mutex_unlock(&ucs_stats_context.lock);
+    fclose(f);
+
+    if (options & UCS_STATS_SERIALIZE_BINARY) {
+        /* VFS files are text, so hex-encode the binary snapshot */
+        ucs_string_buffer_append_hex(strb, buffer, size, 32);
+        ucs_string_buffer_appendf(strb, "\n");
+    } else {
+        ucs_string_buffer_appendf(strb, "%s", buffer);
+    }
+
+    free(buffer);
+}
+
+static void ucs_stats_vfs_init()
+{
+    ucs_vfs_obj_add_dir(NULL, &ucs_stats_context, "ucs/stats");
+    ucs_vfs_obj_add_ro_file(&ucs_stats_context, ucs_stats_vfs_read, NULL, 0,
+                            "all");
+    ucs_vfs_obj_add_ro_file(&ucs_stats_context, ucs_stats_vfs_read, NULL,
+                            UCS_STATS_SERIALIZE_BINARY, "binary");
+}
+
 static void
 ucs_stats_node_clean_children(ucs_stats_node_t *node, int children_sel)
 {
@@ -857,14 +944,17 @@ void ucs_stats_init()
     /* Aggregate-sum class id to name database initialize */
     ucs_array_init_dynamic(&ucs_stats_context.aggrgt_counter_names);
 
-    ucs_debug("statistics enabled, flags: %c%c%c%c%c%c%c",
+    ucs_stats_vfs_init();
+
+    ucs_debug("statistics enabled, flags: %c%c%c%c%c%c%c%c",
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_TIMER)      ? 't' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_EXIT)       ? 'e' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_SIGNAL)     ? 's' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_SOCKET)        ? 'u' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM)        ? 'f' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_BINARY) ? 'b' : '-',
-              (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_CLOSE)  ? 'c' : '-');
+              (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_CLOSE)  ? 'c' : '-',
+              (ucs_stats_context_flags & UCS_STATS_FLAG_VFS)           ? 'v' : '-');
 }
 
 void ucs_stats_cleanup()
@@ -875,6 +965,7 @@ void ucs_stats_cleanup()
         return;
     }
 
+    ucs_vfs_obj_remove(&ucs_stats_context);
     ucs_stats_unset_trigger();
     ucs_stats_clean_node_recurs(&ucs_stats_context.root_node);
     ucs_stats_close_dest();
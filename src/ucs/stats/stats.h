@@ -87,7 +87,8 @@ enum {
     UCS_STATS_FLAG_SOCKET        = UCS_BIT(8),
     UCS_STATS_FLAG_STREAM        = UCS_BIT(9),
     UCS_STATS_FLAG_STREAM_CLOSE  = UCS_BIT(10),
-    UCS_STATS_FLAG_STREAM_BINARY = UCS_BIT(11)
+    UCS_STATS_FLAG_STREAM_BINARY = UCS_BIT(11),
+    UCS_STATS_FLAG_VFS           = UCS_BIT(12)
 };
 
 /**
@@ -140,6 +141,12 @@ void ucs_stats_node_free(ucs_stats_node_t *node);
         } \
     }
 
+#define UCS_STATS_UPDATE_HISTOGRAM(_node, _index, _value) \
+    if (UCS_STATS_NODE_VALID(_node)) { \
+        ucs_stats_node_histogram(_node, _index) \
+            [ucs_stats_histogram_bucket(_value)]++; \
+    }
+
 #define UCS_STATS_START_TIME(_start_time) \
     { \
         _start_time = ucs_get_time(); \
@@ -160,12 +167,21 @@ void ucs_stats_node_free(ucs_stats_node_t *node);
                               (long)ucs_time_to_nsec(ucs_get_time() - (_start_time))); \
    }
 
+#define UCS_STATS_UPDATE_HISTOGRAM_TIME(_node, _index, _start_time) \
+    { \
+        ucs_compiler_fence(); \
+        UCS_STATS_UPDATE_HISTOGRAM(_node, _index, \
+                                   ucs_time_to_nsec(ucs_get_time() - \
+                                                    (_start_time))); \
+    }
+
 extern volatile unsigned ucs_stats_context_flags;
 
 static UCS_F_ALWAYS_INLINE int ucs_stats_is_active(void)
 {
     return ucs_stats_context_flags &
-           (UCS_STATS_FLAG_SOCKET | UCS_STATS_FLAG_STREAM);
+           (UCS_STATS_FLAG_SOCKET | UCS_STATS_FLAG_STREAM |
+            UCS_STATS_FLAG_VFS);
 }
 
 #else
@@ -181,9 +197,11 @@ static UCS_F_ALWAYS_INLINE int ucs_stats_is_active(void)
 #define UCS_STATS_SET_COUNTER(_node, _index, _value)
 #define UCS_STATS_GET_COUNTER(_node, _index)    0
 #define UCS_STATS_UPDATE_MAX(_node, _index, _value)
+#define UCS_STATS_UPDATE_HISTOGRAM(_node, _index, _value)
 #define UCS_STATS_START_TIME(_start_time)
 #define UCS_STATS_UPDATE_TIME(_node, _index, _start_time)
 #define UCS_STATS_SET_TIME(_node, _index, _start_time)
+#define UCS_STATS_UPDATE_HISTOGRAM_TIME(_node, _index, _start_time)
 
 #endif
 
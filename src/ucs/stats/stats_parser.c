@@ -19,6 +19,7 @@
 static ucs_status_t
 dump_stats_recurs(FILE *stream, ucs_stats_node_t *node, unsigned indent)
 {
+    ucs_stats_counter_t *buckets;
     ucs_stats_node_t *child;
     unsigned i;
 
@@ -29,6 +30,17 @@ dump_stats_recurs(FILE *stream, ucs_stats_node_t *node, unsigned indent)
         fprintf(stream, "%*s%s: %" PRIu64 "\n", (indent + 1) * 2, "",
                 node->cls->counter_names[i], node->counters[i]);
     }
+    for (i = 0; i < node->cls->num_histograms; ++i) {
+        buckets = ucs_stats_node_histogram(node, i);
+        fprintf(stream,
+                "%*s%s: count %" PRIu64 " p50 %" PRIu64 " p99 %" PRIu64
+                " p999 %" PRIu64 "\n", (indent + 1) * 2, "",
+                node->cls->histogram_names[i],
+                ucs_stats_histogram_count(buckets),
+                ucs_stats_histogram_percentile(buckets, 50.0),
+                ucs_stats_histogram_percentile(buckets, 99.0),
+                ucs_stats_histogram_percentile(buckets, 99.9));
+    }
     ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN], list) {
         dump_stats_recurs(stream, child, indent + 1);
     }
@@ -110,6 +110,7 @@ void UCS_F_CTOR ucs_init()
     status = ucs_profile_init(ucs_global_opts.profile_mode,
                               ucs_global_opts.profile_file,
                               ucs_global_opts.profile_log_size,
+                              ucs_global_opts.profile_sample_rate,
                               &ucs_profile_default_ctx);
     if (status != UCS_OK) {
         ucs_fatal("failed to init ucs profile - aborting");
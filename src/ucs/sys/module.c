@@ -1,5 +1,5 @@
 /**
- * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2019. ALL RIGHTS RESERVED.
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2026. ALL RIGHTS RESERVED.
  *
  * See file LICENSE for terms.
  */
@@ -24,6 +24,7 @@
 #include <ucs/sys/string.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
+#include <stdio.h>
 #include <string.h>
 #include <limits.h>
 #include <dlfcn.h>
@@ -36,6 +37,7 @@
 
 #define UCS_MODULE_PATH_MEMTRACK_NAME   "module_path"
 #define UCS_MODULE_SRCH_PATH_MAX        2
+#define UCS_MODULE_MANIFEST_EXT         ".manifest"
 
 #define ucs_module_debug(_fmt, ...) \
     ucs_log(ucs_min(UCS_LOG_LEVEL_DEBUG, ucs_global_opts.module_log_level), \
@@ -50,11 +52,15 @@ static struct {
     ucs_init_once_t              init;
     char                         module_ext[NAME_MAX];
     ucs_array_s(unsigned, char*) srch_path;
+    /* Configuration prefixes of the modules skipped by lazy loading */
+    pthread_mutex_t              skipped_config_lock;
+    ucs_string_set_t             skipped_config;
 } ucs_module_loader_state = {
-    .init       = UCS_INIT_ONCE_INITIALIZER,
-    .module_ext = ".so", /* default extension */
-    .srch_path  = UCS_ARRAY_FIXED_INITIALIZER(ucs_module_srch_paths_buf,
-                                              UCS_MODULE_SRCH_PATH_MAX)
+    .init                = UCS_INIT_ONCE_INITIALIZER,
+    .module_ext          = ".so", /* default extension */
+    .srch_path           = UCS_ARRAY_FIXED_INITIALIZER(ucs_module_srch_paths_buf,
+                                                       UCS_MODULE_SRCH_PATH_MAX),
+    .skipped_config_lock = PTHREAD_MUTEX_INITIALIZER
 };
 
 /* Should be called with lock held */
@@ -296,11 +302,28 @@ ucs_module_filename_to_base(const char *filename, char *base, size_t base_max)
     base[base_len] = '\0';
 }
 
+static int ucs_module_manifest_add_skipped_config(const char *prefix,
+                                                  void *arg)
+{
+    (void)ucs_string_set_add(&ucs_module_loader_state.skipped_config, prefix);
+    return 0;
+}
+
+static void ucs_module_skip(const char *manifest_path)
+{
+    pthread_mutex_lock(&ucs_module_loader_state.skipped_config_lock);
+    ucs_module_manifest_foreach(manifest_path, "config",
+                                ucs_module_manifest_add_skipped_config, NULL);
+    pthread_mutex_unlock(&ucs_module_loader_state.skipped_config_lock);
+}
+
 static void ucs_module_load_from_dir(const char *dir, const char *framework,
-                                     int mode, ucs_string_set_t *loaded_set)
+                                     int mode, const char * const *provides,
+                                     ucs_string_set_t *loaded_set)
 {
     char prefix[NAME_MAX];
     char base[NAME_MAX];
+    char *manifest_path;
     char *module_path;
     size_t prefix_len;
     struct dirent *entry;
@@ -319,6 +342,11 @@ static void ucs_module_load_from_dir(const char *dir, const char *framework,
         goto out_closedir;
     }
 
+    status = ucs_string_alloc_path_buffer(&manifest_path, "manifest_path");
+    if (status != UCS_OK) {
+        goto out_free_module_path;
+    }
+
     snprintf(prefix, sizeof(prefix), "lib%s_", framework);
     prefix_len = strlen(prefix);
 
@@ -328,6 +356,8 @@ static void ucs_module_load_from_dir(const char *dir, const char *framework,
         }
 
         ucs_module_filename_to_base(entry->d_name, base, sizeof(base));
+        snprintf(manifest_path, PATH_MAX, "%s/%s" UCS_MODULE_MANIFEST_EXT, dir,
+                 base);
         ucs_module_normalize_base(base, prefix);
         if (strchr(base + prefix_len, '_') != NULL) {
             ucs_module_debug("module name contains '_': %s, skipping", base + prefix_len);
@@ -344,6 +374,14 @@ static void ucs_module_load_from_dir(const char *dir, const char *framework,
             continue;
         }
 
+        if ((provides != NULL) &&
+            !ucs_module_manifest_provides(manifest_path, provides)) {
+            ucs_module_trace("module %s does not provide requested components, "
+                             "skipping", base + prefix_len);
+            ucs_module_skip(manifest_path);
+            continue;
+        }
+
         dl = ucs_module_try_load(module_path, mode);
         if (dl == NULL) {
             continue;
@@ -353,6 +391,8 @@ static void ucs_module_load_from_dir(const char *dir, const char *framework,
         (void)ucs_string_set_add(loaded_set, base);
     }
 
+    ucs_free(manifest_path);
+out_free_module_path:
     ucs_free(module_path);
 out_closedir:
     closedir(dp);
@@ -387,41 +427,131 @@ static void ucs_module_check_expected_loaded(const char *framework,
     ucs_string_buffer_cleanup(&strb);
 }
 
+static void ucs_module_load_all_dirs(const char *framework, unsigned flags,
+                                     const char * const *provides,
+                                     ucs_string_set_t *loaded_set)
+{
+    int mode = ucs_module_flags_to_dlopen_mode(flags);
+    unsigned i;
+
+    ucs_assert(ucs_sys_is_dynamic_lib());
+
+    /* Load modules from directories */
+    for (i = 0; i < ucs_global_opts.plugin_path.count; ++i) {
+        ucs_module_load_from_dir(ucs_global_opts.plugin_path.names[i],
+                                 framework, mode, provides, loaded_set);
+    }
+
+    for (i = 0; i < ucs_array_length(&ucs_module_loader_state.srch_path);
+         ++i) {
+        ucs_module_load_from_dir(
+                ucs_array_elem(&ucs_module_loader_state.srch_path, i),
+                framework, mode, provides, loaded_set);
+    }
+}
+
 #endif /* UCX_SHARED_LIB */
 
-void ucs_load_modules(const char *framework, const char *expected_modules,
-                      ucs_init_once_t *init_once, unsigned flags)
+int ucs_module_manifest_foreach(const char *manifest_path, const char *keyword,
+                                ucs_module_manifest_cb_t cb, void *arg)
 {
-#ifdef UCX_SHARED_LIB
-    unsigned i;
-    int mode;
-    ucs_string_set_t loaded_set;
+    char line[256];
+    char *token, *saveptr;
+    int ret;
+    FILE *stream;
 
-    ucs_module_loader_init_paths();
+    stream = fopen(manifest_path, "r");
+    if (stream == NULL) {
+        return -1;
+    }
 
-    UCS_INIT_ONCE(init_once) {
-        ucs_assert(ucs_sys_is_dynamic_lib());
+    ret = 0;
+    while (!ret && (fgets(line, sizeof(line), stream) != NULL)) {
+        token = strtok_r(line, " \t\n", &saveptr);
+        if ((token == NULL) || strcmp(token, keyword)) {
+            continue;
+        }
 
-        ucs_string_set_init(&loaded_set);
-        mode = ucs_module_flags_to_dlopen_mode(flags);
+        while (!ret && ((token = strtok_r(NULL, " \t\n", &saveptr)) != NULL)) {
+            ret = cb(token, arg);
+        }
+    }
+
+    fclose(stream);
+    return ret;
+}
 
-        /* Load modules from directories */
-        for (i = 0; i < ucs_global_opts.plugin_path.count; ++i) {
-            ucs_module_load_from_dir(ucs_global_opts.plugin_path.names[i],
-                                     framework, mode, &loaded_set);
+static int ucs_module_manifest_match_name(const char *value, void *arg)
+{
+    const char * const *name;
+
+    for (name = (const char * const*)arg; *name != NULL; ++name) {
+        if (!strcmp(value, *name)) {
+            return 1;
         }
+    }
 
-        for (i = 0; i < ucs_array_length(&ucs_module_loader_state.srch_path);
-             ++i) {
-            ucs_module_load_from_dir(
-                    ucs_array_elem(&ucs_module_loader_state.srch_path, i),
-                    framework, mode, &loaded_set);
+    return 0;
+}
+
+int ucs_module_manifest_provides(const char *manifest_path,
+                                 const char * const *provides)
+{
+    /* A module without a manifest is always loaded */
+    return ucs_module_manifest_foreach(manifest_path, "provides",
+                                       ucs_module_manifest_match_name,
+                                       (void*)provides) != 0;
+}
+
+int ucs_module_config_is_skipped(const char *name)
+{
+#ifdef UCX_SHARED_LIB
+    const char *prefix;
+    int skipped;
+
+    skipped = 0;
+    pthread_mutex_lock(&ucs_module_loader_state.skipped_config_lock);
+    kh_foreach_key(&ucs_module_loader_state.skipped_config, prefix, {
+        if (!strncmp(name, prefix, strlen(prefix))) {
+            skipped = 1;
+            break;
         }
+    })
+    pthread_mutex_unlock(&ucs_module_loader_state.skipped_config_lock);
 
-        ucs_module_check_expected_loaded(framework, expected_modules,
-                                         &loaded_set);
+    return skipped;
+#else
+    return 0;
+#endif
+}
+
+void ucs_load_modules(const char *framework, const char *expected_modules,
+                      ucs_module_framework_t *module_framework, unsigned flags,
+                      const char * const *provides)
+{
+#ifdef UCX_SHARED_LIB
+    ucs_init_once_t *init_once = &module_framework->init_once;
+
+    ucs_module_loader_init_paths();
 
-        ucs_string_set_cleanup(&loaded_set);
+    if (provides != NULL) {
+        /* Keep the loaded modules set, since the remaining modules can be
+         * loaded later */
+        pthread_mutex_lock(&init_once->lock);
+        if (!init_once->initialized) {
+            ucs_module_load_all_dirs(framework, flags, provides,
+                                     &module_framework->loaded);
+        }
+        pthread_mutex_unlock(&init_once->lock);
+        return;
+    }
+
+    UCS_INIT_ONCE(init_once) {
+        ucs_module_load_all_dirs(framework, flags, NULL,
+                                 &module_framework->loaded);
+        ucs_module_check_expected_loaded(framework, expected_modules,
+                                         &module_framework->loaded);
+        ucs_string_set_cleanup(&module_framework->loaded);
     }
 #endif /* UCX_SHARED_LIB */
 }
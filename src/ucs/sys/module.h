@@ -1,5 +1,5 @@
 /**
- * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2019. ALL RIGHTS RESERVED.
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2026. ALL RIGHTS RESERVED.
  *
  * See file LICENSE for terms.
  */
@@ -8,6 +8,7 @@
 #ifndef UCS_MODULE_H_
 #define UCS_MODULE_H_
 
+#include <ucs/datastruct/string_set.h>
 #include <ucs/type/init_once.h>
 #include <ucs/sys/compiler_def.h>
 
@@ -21,6 +22,20 @@ typedef enum {
 } ucs_module_load_flags_t;
 
 
+/**
+ * Loading state of a framework, see @ref UCS_MODULE_FRAMEWORK_DECLARE
+ */
+typedef struct ucs_module_framework {
+    ucs_init_once_t  init_once; /* All modules were loaded */
+    ucs_string_set_t loaded;    /* Modules loaded so far, until all are loaded */
+} ucs_module_framework_t;
+
+
+/* Static initializer for @ref ucs_module_framework_t */
+#define UCS_MODULE_FRAMEWORK_INITIALIZER \
+    { UCS_INIT_ONCE_INITIALIZER, {0} }
+
+
 /**
  * Declare a "framework", which is a context for a specific collection of
  * loadable modules. Usually the modules in a particular framework provide
@@ -29,8 +44,8 @@ typedef enum {
  * @param [in] _name  Framework name (as a token)
  */
 #define UCS_MODULE_FRAMEWORK_DECLARE(_name) \
-    static ucs_init_once_t ucs_framework_init_once_##_name = \
-        UCS_INIT_ONCE_INITIALIZER
+    static ucs_module_framework_t ucs_framework_##_name = \
+        UCS_MODULE_FRAMEWORK_INITIALIZER
 
 
 /**
@@ -66,8 +81,32 @@ typedef enum {
  * @param [in] _name  Framework name (as a token)
  */
 #define UCS_MODULE_FRAMEWORK_LOAD(_name, _flags) \
-    ucs_load_modules(#_name, _name##_MODULES, &ucs_framework_init_once_##_name, \
-                     _flags)
+    ucs_load_modules(#_name, _name##_MODULES, &ucs_framework_##_name, _flags, \
+                     NULL)
+
+
+/**
+ * Load only the modules in a particular framework which provide at least one
+ * of the given names, for example transport or component names.
+ *
+ * A module can be described by a manifest file "lib<framework>_<module>.manifest"
+ * next to the module shared library, which is generated by the build system
+ * from the module_provides variable of the module Makefile.am. The manifest
+ * contains a line "provides <name1> <name2> ...", and optionally a line
+ * "config <prefix1> <prefix2> ..." from module_config_prefixes. A module without
+ * a manifest is always loaded. Modules skipped by this function are loaded by
+ * the next call with a matching name, or by @ref UCS_MODULE_FRAMEWORK_LOAD.
+ * Environment variables which start with the configuration prefixes of a
+ * skipped module are not reported as unused.
+ *
+ * @param [in]  _name      Framework name, same as passed to
+ *                         @ref UCS_MODULE_FRAMEWORK_DECLARE
+ * @param [in]  _flags     Modules load flags, see @ref ucs_module_load_flags_t
+ * @param [in]  _provides  NULL-terminated array of names.
+ */
+#define UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS(_name, _flags, _provides) \
+    ucs_load_modules(#_name, _name##_MODULES, &ucs_framework_##_name, _flags, \
+                     _provides)
 
 
 /**
@@ -92,10 +131,12 @@ typedef enum {
 
 
 /**
- * Internal function. Please use @ref UCS_MODULE_FRAMEWORK_LOAD macro instead.
+ * Internal function. Please use @ref UCS_MODULE_FRAMEWORK_LOAD or
+ * @ref UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS macros instead.
  */
 void ucs_load_modules(const char *framework, const char *expected_modules,
-                      ucs_init_once_t *init_once, unsigned flags);
+                      ucs_module_framework_t *module_framework, unsigned flags,
+                      const char * const *provides);
 
 
 #endif
@@ -11,9 +11,69 @@
 #  include "config.h"
 #endif
 
+#include <ucs/sys/compiler_def.h>
 #include <string.h>
 
 
+BEGIN_C_DECLS
+
+/**
+ * Callback for the values of a manifest line, see
+ * @ref ucs_module_manifest_foreach.
+ *
+ * @param [in] value  Value token from the manifest line.
+ * @param [in] arg    User-defined argument.
+ *
+ * @return Nonzero to stop the iteration.
+ */
+typedef int (*ucs_module_manifest_cb_t)(const char *value, void *arg);
+
+
+/**
+ * Call a callback for every value of the manifest lines which start with the
+ * given keyword, for example "provides", until the callback returns nonzero.
+ *
+ * @param [in] manifest_path  Path to the manifest file of the module.
+ * @param [in] keyword        Keyword of the lines to iterate on.
+ * @param [in] cb             Callback to call for every value.
+ * @param [in] arg            User-defined argument for the callback.
+ *
+ * @return -1 if the manifest file does not exist, otherwise the last value
+ *         returned by the callback, or 0 if it was not called.
+ */
+int ucs_module_manifest_foreach(const char *manifest_path, const char *keyword,
+                                ucs_module_manifest_cb_t cb, void *arg);
+
+
+/**
+ * Check whether a module provides at least one of the given names, according
+ * to its manifest file, see @ref UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS.
+ *
+ * @param [in] manifest_path  Path to the manifest file of the module.
+ * @param [in] provides       NULL-terminated array of names.
+ *
+ * @return Nonzero if one of the names is provided by the module, or if the
+ *         manifest file does not exist.
+ */
+int ucs_module_manifest_provides(const char *manifest_path,
+                                 const char * const *provides);
+
+
+/**
+ * Check whether a configuration variable belongs to a module which was skipped
+ * by @ref UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS, according to the "config" line
+ * of its manifest file.
+ *
+ * @param [in] name  Variable name, without the environment prefix.
+ *
+ * @return Nonzero if the name starts with a configuration prefix of a skipped
+ *         module.
+ */
+int ucs_module_config_is_skipped(const char *name);
+
+END_C_DECLS
+
+
 static inline void ucs_module_normalize_base(char *base, const char *prefix)
 {
 #ifdef UCX_MODULE_FILE_SUFFIX
@@ -11,6 +11,7 @@
 #include <ucs/memory/numa.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/topo/base/topo.h>
+#include <ucs/sys/topo/base/topo_cache.h>
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 
@@ -335,10 +336,18 @@ ucs_topo_bus_id_to_sysfs_path(const ucs_sys_bus_id_t *bus_id, char *path,
     ucs_strncpy_safe(link_path, UCS_TOPO_SYSFS_PCI_PREFIX, PATH_MAX);
     ucs_topo_bus_id_str(bus_id, 0, link_path + prefix_length,
                         PATH_MAX - prefix_length);
+    if (ucs_topo_cache_get("bus_path", link_path + prefix_length, path, max)) {
+        goto out_free;
+    }
+
     if (realpath(link_path, path) == NULL) {
         status = UCS_ERR_IO_ERROR;
+        goto out_free;
     }
 
+    ucs_topo_cache_put("bus_path", link_path + prefix_length, path);
+
+out_free:
     ucs_free(link_path);
 out:
     return status;
@@ -348,9 +357,17 @@ static int
 ucs_topo_read_device_numa_node(const ucs_sys_bus_id_t *bus_id)
 {
     int numa_node = UCS_NUMA_NODE_UNDEFINED;
+    char bus_id_str[UCS_SYS_BDF_NAME_MAX];
+    char numa_node_str[16];
     char *path;
     ucs_status_t status;
 
+    ucs_topo_bus_id_str(bus_id, 0, bus_id_str, sizeof(bus_id_str));
+    if (ucs_topo_cache_get("numa_node", bus_id_str, numa_node_str,
+                           sizeof(numa_node_str))) {
+        return atoi(numa_node_str);
+    }
+
     status = ucs_string_alloc_path_buffer(&path, "sysfs_path");
     if (status != UCS_OK) {
         goto out;
@@ -362,6 +379,8 @@ ucs_topo_read_device_numa_node(const ucs_sys_bus_id_t *bus_id)
     }
 
     numa_node = ucs_numa_node_of_device(path);
+    ucs_snprintf_safe(numa_node_str, sizeof(numa_node_str), "%d", numa_node);
+    ucs_topo_cache_put("numa_node", bus_id_str, numa_node_str);
 
 out_free_path:
     ucs_free(path);
@@ -1408,10 +1427,13 @@ void ucs_topo_init()
                       &ucs_sys_topo_provider_default.list);
     ucs_list_add_tail(&ucs_sys_topo_providers_list,
                       &ucs_sys_topo_provider_sysfs.list);
+    ucs_topo_cache_init();
 }
 
 void ucs_topo_cleanup()
 {
+    ucs_topo_cache_cleanup();
+
     while (!ucs_list_is_empty(&ucs_sys_topo_provider_stack)) {
         ucs_sys_topo_provider_pop();
     }
@@ -1498,7 +1520,7 @@ static const ucs_topo_pci_info_t ucs_topo_pci_info[] = {
      .decoding      = 130},
 };
 
-double ucs_topo_get_pci_bw(const char *dev_name, const char *sysfs_path)
+static double ucs_topo_read_pci_bw(const char *dev_name, const char *sysfs_path)
 {
     const char *pci_width_file_name = "current_link_width";
     const char *pci_speed_file_name = "current_link_speed";
@@ -1564,7 +1586,24 @@ out_max_bw:
     return UCS_INFINITY;
 }
 
-const char *ucs_topo_resolve_sysfs_path(const char *dev_path, char *path_buffer)
+double ucs_topo_get_pci_bw(const char *dev_name, const char *sysfs_path)
+{
+    char bw_str[64];
+    double bw;
+
+    if (ucs_topo_cache_get("pci_bw", sysfs_path, bw_str, sizeof(bw_str))) {
+        return strtod(bw_str, NULL);
+    }
+
+    bw = ucs_topo_read_pci_bw(dev_name, sysfs_path);
+    /* Hexadecimal format keeps the exact value */
+    ucs_snprintf_safe(bw_str, sizeof(bw_str), "%a", bw);
+    ucs_topo_cache_put("pci_bw", sysfs_path, bw_str);
+    return bw;
+}
+
+static const char *
+ucs_topo_probe_sysfs_path(const char *dev_path, char *path_buffer)
 {
     const char *detected_type = NULL;
     char *device_file_path, *sysfs_realpath, *sysfs_path;
@@ -1615,3 +1654,19 @@ out_detected:
     ucs_free(device_file_path);
     return sysfs_path;
 }
+
+const char *ucs_topo_resolve_sysfs_path(const char *dev_path, char *path_buffer)
+{
+    const char *sysfs_path;
+
+    if (ucs_topo_cache_get("sysfs_path", dev_path, path_buffer, PATH_MAX)) {
+        return path_buffer;
+    }
+
+    sysfs_path = ucs_topo_probe_sysfs_path(dev_path, path_buffer);
+    if (sysfs_path != NULL) {
+        ucs_topo_cache_put("sysfs_path", dev_path, sysfs_path);
+    }
+
+    return sysfs_path;
+}
@@ -0,0 +1,366 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "topo_cache.h"
+
+#include <ucs/algorithm/crc.h>
+#include <ucs/config/global_opts.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <ucs/type/spinlock.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* Version of the cache file format */
+#define UCS_TOPO_CACHE_VERSION   1
+
+/* Prefix of the first line of the cache file */
+#define UCS_TOPO_CACHE_MAGIC     "ucx_topo_cache"
+
+/* Maximal length of a line in the cache file: key and value can be paths */
+#define UCS_TOPO_CACHE_LINE_MAX  ((2 * PATH_MAX) + 64)
+
+/* Maximal length of the first line of the cache file */
+#define UCS_TOPO_CACHE_HEADER_MAX 128
+
+#define UCS_TOPO_CACHE_SYSFS_PCI "/sys/bus/pci/devices"
+
+
+KHASH_INIT(ucs_topo_cache, kh_cstr_t, char*, 1, kh_str_hash_func,
+           kh_str_hash_equal)
+
+
+typedef struct {
+    uint32_t hash;  /* XOR of the hashes of the device names */
+    unsigned count; /* Number of devices */
+} ucs_topo_cache_hw_fingerprint_t;
+
+
+static struct {
+    ucs_spinlock_t           lock;
+    khash_t(ucs_topo_cache)  hash;
+    char                     *filename; /* NULL if the cache is disabled */
+    int                      dirty;     /* New values since the file was loaded */
+    char                     header[UCS_TOPO_CACHE_HEADER_MAX];
+} ucs_topo_cache_ctx;
+
+
+static ucs_status_t
+ucs_topo_cache_pci_device_cb(const struct dirent *entry, void *arg)
+{
+    ucs_topo_cache_hw_fingerprint_t *fp = arg;
+
+    if (entry->d_name[0] == '.') {
+        return UCS_OK;
+    }
+
+    /* Do not depend on the order of the directory entries */
+    fp->hash ^= ucs_crc32(0, entry->d_name, strlen(entry->d_name));
+    ++fp->count;
+    return UCS_OK;
+}
+
+/*
+ * The cached values are valid as long as the node was not rebooted and the
+ * set of PCI devices did not change.
+ */
+static ucs_status_t ucs_topo_cache_make_header(char *header, size_t max)
+{
+    ucs_topo_cache_hw_fingerprint_t fp = {0, 0};
+    uint64_t boot_id_high, boot_id_low;
+    ucs_status_t status;
+
+    status = ucs_sys_get_boot_id(&boot_id_high, &boot_id_low);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_sys_readdir(UCS_TOPO_CACHE_SYSFS_PCI,
+                             ucs_topo_cache_pci_device_cb, &fp);
+    if (status != UCS_OK) {
+        ucs_debug("failed to read '%s', topology cache fingerprint does not "
+                  "include PCI devices", UCS_TOPO_CACHE_SYSFS_PCI);
+    }
+
+    ucs_snprintf_safe(header, max,
+                      UCS_TOPO_CACHE_MAGIC " %d boot_id=%016" PRIx64
+                      "%016" PRIx64 " pci=%u:%08x",
+                      UCS_TOPO_CACHE_VERSION, boot_id_high, boot_id_low,
+                      fp.count, fp.hash);
+    return UCS_OK;
+}
+
+static void ucs_topo_cache_add(const char *key, const char *value)
+{
+    char *key_copy, *value_copy;
+    khiter_t khiter;
+    int khret;
+
+    value_copy = ucs_strdup(value, "topo_cache_value");
+    if (value_copy == NULL) {
+        return;
+    }
+
+    khiter = kh_get(ucs_topo_cache, &ucs_topo_cache_ctx.hash, key);
+    if (khiter != kh_end(&ucs_topo_cache_ctx.hash)) {
+        ucs_free(kh_value(&ucs_topo_cache_ctx.hash, khiter));
+        kh_value(&ucs_topo_cache_ctx.hash, khiter) = value_copy;
+        return;
+    }
+
+    key_copy = ucs_strdup(key, "topo_cache_key");
+    if (key_copy == NULL) {
+        goto err_free_value;
+    }
+
+    khiter = kh_put(ucs_topo_cache, &ucs_topo_cache_ctx.hash, key_copy,
+                    &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        goto err_free_key;
+    }
+
+    kh_value(&ucs_topo_cache_ctx.hash, khiter) = value_copy;
+    return;
+
+err_free_key:
+    ucs_free(key_copy);
+err_free_value:
+    ucs_free(value_copy);
+}
+
+static void ucs_topo_cache_load(const char *filename, char *line)
+{
+    struct stat st_buf;
+    unsigned count;
+    FILE *stream;
+    char *value;
+
+    stream = fopen(filename, "r");
+    if (stream == NULL) {
+        /* The file does not exist before the first run */
+        if (errno != ENOENT) {
+            ucs_debug("failed to open topology cache file '%s': %m", filename);
+        }
+        return;
+    }
+
+    /* Values from a file written by another user could redirect the probing */
+    if ((fstat(fileno(stream), &st_buf) != 0) ||
+        (st_buf.st_uid != geteuid())) {
+        ucs_debug("ignoring topology cache file '%s' not owned by uid %d",
+                  filename, geteuid());
+        goto out_close;
+    }
+
+    if (fgets(line, UCS_TOPO_CACHE_LINE_MAX, stream) == NULL) {
+        goto out_close;
+    }
+
+    line[strcspn(line, "\n")] = '\0';
+    if (strcmp(line, ucs_topo_cache_ctx.header)) {
+        ucs_debug("ignoring stale topology cache file '%s'", filename);
+        goto out_close;
+    }
+
+    count = 0;
+    while (fgets(line, UCS_TOPO_CACHE_LINE_MAX, stream) != NULL) {
+        line[strcspn(line, "\n")] = '\0';
+        value                     = strchr(line, ' ');
+        if (value == NULL) {
+            ucs_debug("%s: ignoring malformed line '%s'", filename, line);
+            continue;
+        }
+
+        *(value++) = '\0';
+        ucs_topo_cache_add(line, value);
+        ++count;
+    }
+
+    ucs_debug("loaded %u topology values from '%s'", count, filename);
+
+out_close:
+    fclose(stream);
+}
+
+static void ucs_topo_cache_save(const char *filename)
+{
+    const char *key, *value;
+    char *tmp_filename;
+    ucs_status_t status;
+    FILE *stream;
+    int fd;
+
+    /* Write to a private file and rename it, so concurrent processes never
+     * read a partially written cache */
+    status = ucs_string_alloc_formatted_path(&tmp_filename, "tmp_filename",
+                                             "%s.%d.tmp", filename, getpid());
+    if (status != UCS_OK) {
+        return;
+    }
+
+    fd = open(tmp_filename, O_WRONLY | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        ucs_warn("failed to create topology cache file '%s': %m",
+                 tmp_filename);
+        goto out_free;
+    }
+
+    stream = fdopen(fd, "w");
+    if (stream == NULL) {
+        ucs_warn("failed to open topology cache file '%s': %m", tmp_filename);
+        close(fd);
+        goto err_unlink;
+    }
+
+    fprintf(stream, "%s\n", ucs_topo_cache_ctx.header);
+    kh_foreach(&ucs_topo_cache_ctx.hash, key, value,
+        fprintf(stream, "%s %s\n", key, value);
+    )
+
+    if (fclose(stream) != 0) {
+        ucs_warn("failed to write topology cache file '%s': %m",
+                 tmp_filename);
+        goto err_unlink;
+    }
+
+    if (rename(tmp_filename, filename) != 0) {
+        ucs_warn("failed to rename '%s' to '%s': %m", tmp_filename, filename);
+        goto err_unlink;
+    }
+
+    ucs_debug("saved %u topology values to '%s'",
+              kh_size(&ucs_topo_cache_ctx.hash), filename);
+    goto out_free;
+
+err_unlink:
+    unlink(tmp_filename);
+out_free:
+    ucs_free(tmp_filename);
+}
+
+void ucs_topo_cache_init(void)
+{
+    const char *filename = ucs_global_opts.topo_cache_file;
+    char *line;
+
+    ucs_spinlock_init(&ucs_topo_cache_ctx.lock, 0);
+    kh_init_inplace(ucs_topo_cache, &ucs_topo_cache_ctx.hash);
+    ucs_topo_cache_ctx.filename = NULL;
+    ucs_topo_cache_ctx.dirty    = 0;
+
+    if (ucs_string_is_empty(filename)) {
+        return;
+    }
+
+    if (ucs_topo_cache_make_header(ucs_topo_cache_ctx.header,
+                                   sizeof(ucs_topo_cache_ctx.header)) !=
+        UCS_OK) {
+        ucs_debug("failed to get boot id, topology cache is disabled");
+        return;
+    }
+
+    line = ucs_malloc(UCS_TOPO_CACHE_LINE_MAX, "topo_cache_line");
+    if (line == NULL) {
+        return;
+    }
+
+    ucs_topo_cache_ctx.filename = ucs_strdup(filename, "topo_cache_file");
+    if (ucs_topo_cache_ctx.filename != NULL) {
+        ucs_topo_cache_load(filename, line);
+    }
+
+    ucs_free(line);
+}
+
+void ucs_topo_cache_cleanup(void)
+{
+    const char *key;
+    char *value;
+
+    if ((ucs_topo_cache_ctx.filename != NULL) && ucs_topo_cache_ctx.dirty) {
+        ucs_topo_cache_save(ucs_topo_cache_ctx.filename);
+    }
+
+    kh_foreach(&ucs_topo_cache_ctx.hash, key, value,
+        ucs_free((void*)key);
+        ucs_free(value);
+    )
+    kh_destroy_inplace(ucs_topo_cache, &ucs_topo_cache_ctx.hash);
+    ucs_free(ucs_topo_cache_ctx.filename);
+    ucs_topo_cache_ctx.filename = NULL;
+    ucs_spinlock_destroy(&ucs_topo_cache_ctx.lock);
+}
+
+int ucs_topo_cache_get(const char *type, const char *name, char *value,
+                       size_t max)
+{
+    int found = 0;
+    khiter_t khiter;
+    char *key;
+
+    if (ucs_topo_cache_ctx.filename == NULL) {
+        return 0;
+    }
+
+    if (ucs_string_alloc_formatted_path(&key, "topo_cache_key", "%s:%s",
+                                        type, name) != UCS_OK) {
+        return 0;
+    }
+
+    ucs_spin_lock(&ucs_topo_cache_ctx.lock);
+    khiter = kh_get(ucs_topo_cache, &ucs_topo_cache_ctx.hash, key);
+    if ((khiter != kh_end(&ucs_topo_cache_ctx.hash)) &&
+        (strlen(kh_value(&ucs_topo_cache_ctx.hash, khiter)) < max)) {
+        ucs_strncpy_safe(value, kh_value(&ucs_topo_cache_ctx.hash, khiter),
+                         max);
+        found = 1;
+    }
+    ucs_spin_unlock(&ucs_topo_cache_ctx.lock);
+
+    ucs_free(key);
+    return found;
+}
+
+void ucs_topo_cache_put(const char *type, const char *name, const char *value)
+{
+    khiter_t khiter;
+    char *key;
+
+    if ((ucs_topo_cache_ctx.filename == NULL) ||
+        (strpbrk(name, " \t\n") != NULL) || (strchr(value, '\n') != NULL)) {
+        return;
+    }
+
+    if (ucs_string_alloc_formatted_path(&key, "topo_cache_key", "%s:%s",
+                                        type, name) != UCS_OK) {
+        return;
+    }
+
+    ucs_spin_lock(&ucs_topo_cache_ctx.lock);
+    khiter = kh_get(ucs_topo_cache, &ucs_topo_cache_ctx.hash, key);
+    if ((khiter == kh_end(&ucs_topo_cache_ctx.hash)) ||
+        strcmp(kh_value(&ucs_topo_cache_ctx.hash, khiter), value)) {
+        ucs_topo_cache_add(key, value);
+        ucs_topo_cache_ctx.dirty = 1;
+    }
+    ucs_spin_unlock(&ucs_topo_cache_ctx.lock);
+
+    ucs_free(key);
+}
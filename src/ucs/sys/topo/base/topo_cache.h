@@ -0,0 +1,56 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifndef UCS_TOPO_CACHE_H
+#define UCS_TOPO_CACHE_H
+
+#include <ucs/sys/compiler_def.h>
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/**
+ * Load the node-local topology cache from UCX_TOPO_CACHE_FILE. The file is
+ * ignored if it was created by another user, before the last boot of the node,
+ * or on a different set of PCI devices.
+ */
+void ucs_topo_cache_init(void);
+
+
+/**
+ * Save the topology cache file if new values were added to the cache since it
+ * was loaded, and release the cache.
+ */
+void ucs_topo_cache_cleanup(void);
+
+
+/**
+ * Look up a cached result of topology probing.
+ *
+ * @param [in]  type   Type of the value, for example "numa_node".
+ * @param [in]  name   Object the value refers to, for example a sysfs path.
+ * @param [out] value  Filled with the cached value.
+ * @param [in]  max    Size of @a value buffer.
+ *
+ * @return Nonzero if the value was found.
+ */
+int ucs_topo_cache_get(const char *type, const char *name, char *value,
+                       size_t max);
+
+
+/**
+ * Add a result of topology probing to the cache. Does nothing if the cache is
+ * disabled.
+ *
+ * @param [in] type   Type of the value.
+ * @param [in] name   Object the value refers to. Must not contain whitespace.
+ * @param [in] value  Value to store. Must not contain newlines.
+ */
+void ucs_topo_cache_put(const char *type, const char *name, const char *value);
+
+END_C_DECLS
+
+#endif
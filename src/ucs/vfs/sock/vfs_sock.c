@@ -31,6 +31,13 @@ typedef struct {
 } UCS_S_PACKED ucs_vfs_msg_t;
 
 
+/* Follows ucs_vfs_msg_t if action==STATS */
+typedef struct {
+    uint32_t pid;
+    uint32_t interval_ms;
+} UCS_S_PACKED ucs_vfs_msg_stats_t;
+
+
 void ucs_vfs_sock_get_address(struct sockaddr_un *un_addr)
 {
     memset(un_addr, 0, sizeof(*un_addr));
@@ -98,20 +105,29 @@ static int ucs_vfs_sock_retval(ssize_t ret, size_t expected)
 int ucs_vfs_sock_send(int sockfd, const ucs_vfs_sock_message_t *vfs_msg)
 {
     char cbuf[CMSG_SPACE(sizeof(*vfs_msg))] UCS_V_ALIGNED(sizeof(size_t));
+    ucs_vfs_msg_stats_t stats_msg;
     struct cmsghdr *cmsgp;
     struct msghdr msgh;
     ucs_vfs_msg_t msg;
-    struct iovec iov;
+    struct iovec iov[2];
     ssize_t nsent;
 
     memset(cbuf, 0, sizeof(cbuf));
     memset(&msgh, 0, sizeof(msgh));
     msg.action      = vfs_msg->action;
-    iov.iov_base    = &msg;
-    iov.iov_len     = sizeof(msg);
-    msgh.msg_iov    = &iov;
+    iov[0].iov_base = &msg;
+    iov[0].iov_len  = sizeof(msg);
+    msgh.msg_iov    = iov;
     msgh.msg_iovlen = 1;
 
+    if (vfs_msg->action == UCS_VFS_SOCK_ACTION_STATS) {
+        stats_msg.pid         = vfs_msg->pid;
+        stats_msg.interval_ms = vfs_msg->interval_ms;
+        iov[1].iov_base       = &stats_msg;
+        iov[1].iov_len        = sizeof(stats_msg);
+        msgh.msg_iovlen       = 2;
+    }
+
     if (vfs_msg->action == UCS_VFS_SOCK_ACTION_MOUNT_REPLY) {
         /* send file descriptor */
         msgh.msg_control    = cbuf;
@@ -126,12 +142,15 @@ int ucs_vfs_sock_send(int sockfd, const ucs_vfs_sock_message_t *vfs_msg)
     do {
         nsent = sendmsg(sockfd, &msgh, 0);
     } while ((nsent < 0) && (errno == EINTR));
-    return ucs_vfs_sock_retval(nsent, iov.iov_len);
+    return ucs_vfs_sock_retval(nsent, iov[0].iov_len +
+                                      ((msgh.msg_iovlen > 1) ?
+                                       iov[1].iov_len : 0));
 }
 
 int ucs_vfs_sock_recv(int sockfd, ucs_vfs_sock_message_t *vfs_msg)
 {
     char cbuf[CMSG_SPACE(sizeof(*vfs_msg))] UCS_V_ALIGNED(sizeof(size_t));
+    ucs_vfs_msg_stats_t stats_msg;
     const struct ucred *cred;
     struct cmsghdr *cmsgp;
     struct msghdr msgh;
@@ -141,8 +160,9 @@ int ucs_vfs_sock_recv(int sockfd, ucs_vfs_sock_message_t *vfs_msg)
 
     /* initialize to invalid values */
     vfs_msg->action = UCS_VFS_SOCK_ACTION_LAST;
-    vfs_msg->fd     = -1;
-    vfs_msg->pid    = -1;
+    vfs_msg->fd          = -1;
+    vfs_msg->pid         = -1;
+    vfs_msg->interval_ms = 0;
 
     memset(cbuf, 0, sizeof(cbuf));
     memset(&msgh, 0, sizeof(msgh));
@@ -193,5 +213,17 @@ int ucs_vfs_sock_recv(int sockfd, ucs_vfs_sock_message_t *vfs_msg)
         }
     }
 
+    if (msg.action == UCS_VFS_SOCK_ACTION_STATS) {
+        do {
+            nrecvd = recv(sockfd, &stats_msg, sizeof(stats_msg), MSG_WAITALL);
+        } while ((nrecvd < 0) && (errno == EINTR));
+        if (nrecvd != sizeof(stats_msg)) {
+            return ucs_vfs_sock_retval(nrecvd, sizeof(stats_msg));
+        }
+
+        vfs_msg->pid         = stats_msg.pid;
+        vfs_msg->interval_ms = stats_msg.interval_ms;
+    }
+
     return 0;
 }
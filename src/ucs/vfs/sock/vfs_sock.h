@@ -26,6 +26,7 @@ typedef enum {
     UCS_VFS_SOCK_ACTION_MOUNT,       /* daemon is asked to mount a file system */
     UCS_VFS_SOCK_ACTION_MOUNT_REPLY, /* daemon sends back FUSE file descriptor */
     UCS_VFS_SOCK_ACTION_NOP,         /* no-operation, used to test connection */
+    UCS_VFS_SOCK_ACTION_STATS,       /* daemon is asked to stream statistics */
     UCS_VFS_SOCK_ACTION_LAST
 } ucs_vfs_sock_action_t;
 
@@ -42,9 +43,17 @@ typedef struct {
     int                   fd;
 
     /* If action==MOUNT: out parameter, holds the pid of sender process.
+     * If action==STATS: in/out parameter, holds the pid of the process whose
+     * statistics are streamed.
      * Otherwise: unused
      */
     pid_t                 pid;
+
+    /* If action==STATS: in/out parameter, holds the streaming interval in
+     * milliseconds, or 0 to use the daemon default.
+     * Otherwise: unused
+     */
+    uint32_t              interval_ms;
 } ucs_vfs_sock_message_t;
 
 
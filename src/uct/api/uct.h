@@ -1246,6 +1246,9 @@ struct uct_iface_params {
         struct {
             /** Status returned by stub internal operations. */
             ucs_status_t                         status;
+            /** Operations of the stub interface, except iface_close. Can be
+             *  NULL, in which case all operations are NULL. */
+            const uct_iface_ops_t                *ops;
         } stub;
     } mode;
 
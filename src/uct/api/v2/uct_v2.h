@@ -1972,6 +1972,59 @@ uct_ep_outstanding_purge(uct_ep_h ep,
                          const uct_ep_outstanding_purge_params_t *params);
 
 
+/**
+ * @ingroup UCT_RESOURCE
+ * @brief Field mask for @ref uct_component_query_params_t.
+ */
+typedef enum {
+    UCT_COMPONENT_QUERY_PARAM_FIELD_PROVIDES = UCS_BIT(0)
+} uct_component_query_params_field_t;
+
+
+/**
+ * @ingroup UCT_RESOURCE
+ * @brief Parameters for @ref uct_query_components_v2.
+ */
+typedef struct {
+    /** Mask of valid fields in this structure, using bits from
+     *  @ref uct_component_query_params_field_t. */
+    uint64_t          field_mask;
+
+    /**
+     * NULL-terminated array of transport and component names. If set, only
+     * the transport modules which provide at least one of these names are
+     * loaded. Modules which do not describe the names they provide, for
+     * example modules which detect memory types, are always loaded. If not
+     * set, all the transport modules are loaded.
+     */
+    const char * const *provides;
+} uct_component_query_params_t;
+
+
+/**
+ * @ingroup UCT_RESOURCE
+ * @brief Query for list of components, loading only the required modules.
+ *
+ * Same as @ref uct_query_components, but allows to skip loading transport
+ * modules which are not going to be used. Components of modules loaded by
+ * previous calls are returned as well. The returned array should be released
+ * by @ref uct_release_component_list.
+ *
+ * @param [in]  params            Query parameters.
+ * @param [out] components_p      Filled with a pointer to an array of component
+ *                                handles.
+ * @param [out] num_components_p  Filled with the number of elements in the
+ *                                array.
+ *
+ * @return UCS_OK if successful, or UCS_ERR_NO_MEMORY if failed to allocate the
+ *         array of component handles.
+ */
+ucs_status_t
+uct_query_components_v2(const uct_component_query_params_t *params,
+                        uct_component_h **components_p,
+                        unsigned *num_components_p);
+
+
 END_C_DECLS
 
 #endif
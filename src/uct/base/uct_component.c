@@ -1,5 +1,5 @@
 /**
- * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2021. ALL RIGHTS RESERVED.
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2026. ALL RIGHTS RESERVED.
  *
  * See file LICENSE for terms.
  */
@@ -45,15 +45,15 @@ void UCS_F_DTOR uct_cleanup()
     uct_self_cleanup();
 }
 
-ucs_status_t uct_query_components(uct_component_h **components_p,
-                                  unsigned *num_components_p)
+UCS_MODULE_FRAMEWORK_DECLARE(uct);
+
+static ucs_status_t uct_components_list_get(uct_component_h **components_p,
+                                            unsigned *num_components_p)
 {
-    UCS_MODULE_FRAMEWORK_DECLARE(uct);
     uct_component_h *components;
     uct_component_t *component;
     size_t num_components;
 
-    UCS_MODULE_FRAMEWORK_LOAD(uct, 0);
     num_components = ucs_list_length(&uct_components_list);
     components = ucs_malloc(num_components * sizeof(*components),
                             "uct_components");
@@ -74,6 +74,27 @@ ucs_status_t uct_query_components(uct_component_h **components_p,
     return UCS_OK;
 }
 
+ucs_status_t uct_query_components(uct_component_h **components_p,
+                                  unsigned *num_components_p)
+{
+    UCS_MODULE_FRAMEWORK_LOAD(uct, 0);
+    return uct_components_list_get(components_p, num_components_p);
+}
+
+ucs_status_t
+uct_query_components_v2(const uct_component_query_params_t *params,
+                        uct_component_h **components_p,
+                        unsigned *num_components_p)
+{
+    if (params->field_mask & UCT_COMPONENT_QUERY_PARAM_FIELD_PROVIDES) {
+        UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS(uct, 0, params->provides);
+    } else {
+        UCS_MODULE_FRAMEWORK_LOAD(uct, 0);
+    }
+
+    return uct_components_list_get(components_p, num_components_p);
+}
+
 void uct_release_component_list(uct_component_h *components)
 {
     ucs_free(components);
@@ -1193,7 +1193,9 @@ static uct_iface_internal_ops_t uct_stub_internal_ops = {
     .ep_outstanding_purge  = (uct_ep_outstanding_purge_func_t)uct_stub_ep_return_status,
 };
 
-ucs_status_t uct_stub_iface_open(ucs_status_t status, uct_iface_h *iface_p)
+ucs_status_t uct_stub_iface_open(ucs_status_t status,
+                                 const uct_iface_ops_t *ops,
+                                 uct_iface_h *iface_p)
 {
     uct_stub_iface_t *stub;
 
@@ -1205,6 +1207,10 @@ ucs_status_t uct_stub_iface_open(ucs_status_t status, uct_iface_h *iface_p)
         return UCS_ERR_NO_MEMORY;
     }
 
+    if (ops != NULL) {
+        stub->super.ops = *ops;
+    }
+
     stub->super.ops.iface_close = uct_stub_iface_close;
     stub->internal_ops          = &uct_stub_internal_ops;
     stub->status                = status;
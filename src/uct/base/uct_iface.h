@@ -1084,7 +1084,9 @@ uct_base_ep_connect_to_ep(uct_ep_h tl_ep,
                           const uct_device_addr_t *device_addr,
                           const uct_ep_addr_t *ep_addr);
 
-ucs_status_t uct_stub_iface_open(ucs_status_t status, uct_iface_h *iface_p);
+ucs_status_t uct_stub_iface_open(ucs_status_t status,
+                                 const uct_iface_ops_t *ops,
+                                 uct_iface_h *iface_p);
 
 static UCS_F_ALWAYS_INLINE int uct_ep_op_is_short(uct_ep_operation_t op)
 {
@@ -420,16 +420,18 @@ static UCS_F_ALWAYS_INLINE int uct_ud_ep_no_window(uct_ud_ep_t *ep)
  */
 static UCS_F_ALWAYS_INLINE int uct_ud_ep_req_ack(uct_ud_ep_t *ep)
 {
-    uct_ud_psn_t acked_psn, max_psn, psn;
+    uct_ud_psn_t acked_psn, max_psn, psn, cwnd;
 
     max_psn   = ep->tx.max_psn;
     acked_psn = ep->tx.acked_psn;
     psn       = ep->tx.psn;
+    cwnd      = max_psn - acked_psn;
 
-    return UCT_UD_PSN_COMPARE(psn, ==, ((acked_psn * 3 + max_psn) >> 2)) ||
+    /* Same as (3 * acked_psn + max_psn) / 4, but also correct when the PSN
+     * wraps around inside the window */
+    return UCT_UD_PSN_COMPARE(psn, ==, acked_psn + (cwnd >> 2)) ||
            UCT_UD_PSN_COMPARE(psn + 1, ==, max_psn) ||
            uct_ud_ep_ctl_op_check(ep, UCT_UD_EP_OP_ACK_REQ);
-
 }
 
 
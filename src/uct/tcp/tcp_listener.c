@@ -14,11 +14,8 @@
 #include <ucs/async/async.h>
 
 
-static void
-uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
-                                  void *arg)
+static ucs_status_t uct_tcp_listener_accept(uct_tcp_listener_t *listener)
 {
-    uct_tcp_listener_t *listener = (uct_tcp_listener_t *)arg;
     char ip_port_str[UCS_SOCKADDR_STRING_LEN];
     struct sockaddr_storage client_addr;
     ucs_async_context_t *async_ctx;
@@ -28,14 +25,12 @@ uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
     socklen_t addrlen;
     int conn_fd;
 
-    ucs_assert(fd == listener->listen_fd);
-
     addrlen   = sizeof(struct sockaddr_storage);
     status    = ucs_socket_accept(listener->listen_fd,
                                   (struct sockaddr*)&client_addr,
                                   &addrlen, &conn_fd);
     if (status != UCS_OK) {
-        return;
+        return status;
     }
 
     ucs_assert(conn_fd != -1);
@@ -85,12 +80,34 @@ uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
     /* Adding the ep to a list on the cm for cleanup purposes */
     ucs_list_add_tail(&listener->sockcm->ep_list, &ep->list);
 
-    return;
+    return UCS_OK;
 
 err_delete_ep:
     UCS_CLASS_DELETE(uct_tcp_sockcm_ep_t, ep);
 err:
     ucs_close_fd(&conn_fd);
+    return status;
+}
+
+static void
+uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
+                                  void *arg)
+{
+    uct_tcp_listener_t *listener = (uct_tcp_listener_t *)arg;
+    unsigned count;
+
+    ucs_assert(fd == listener->listen_fd);
+
+    /* Drain the backlog, so a burst of clients does not cost an event per
+     * connection. The batch is limited to not starve other handlers. */
+    for (count = 0; count < listener->sockcm->accept_batch; ++count) {
+        if (uct_tcp_listener_accept(listener) != UCS_OK) {
+            break;
+        }
+    }
+
+    ucs_trace("listener %p: accepted %u connections (fd=%d)", listener, count,
+              fd);
 }
 
 UCS_CLASS_INIT_FUNC(uct_tcp_listener_t, uct_cm_h cm,
@@ -28,6 +28,11 @@ ucs_config_field_t uct_tcp_sockcm_config_table[] = {
 
    UCT_TCP_USER_TIMEOUT(ucs_offsetof(uct_tcp_sockcm_config_t, user_timeout)),
 
+  {"ACCEPT_BATCH", "16",
+   "Maximal number of connections which are accepted from the listen backlog\n"
+   "on a single listener event.",
+   ucs_offsetof(uct_tcp_sockcm_config_t, accept_batch), UCS_CONFIG_TYPE_UINT},
+
   {NULL}
 };
 
@@ -225,6 +230,7 @@ UCS_CLASS_INIT_FUNC(uct_tcp_sockcm_t, uct_component_h component,
     self->sockopt_rcvbuf = cm_config->sockopt.rcvbuf;
     self->syn_cnt        = cm_config->syn_cnt;
     self->user_timeout   = cm_config->user_timeout;
+    self->accept_batch   = ucs_max(cm_config->accept_batch, 1);
 
     ucs_list_head_init(&self->ep_list);
 
@@ -989,6 +989,21 @@ UCS_TEST_P(test_ucp_am_nbx, rx_am_mpools,
     ucp_am_data_release(receiver().worker(), rx_data);
 }
 
+UCS_TEST_P(test_ucp_am_nbx, frags_alloc_on_demand, "RNDV_THRESH=inf")
+{
+    ucp_ep_h r_ep       = receiver().ep();
+    size_t usage_before = ucp_ep_memory_usage(r_ep);
+
+    EXPECT_EQ(nullptr, r_ep->ext->am.frags);
+    EXPECT_GE(usage_before, sizeof(ucp_ep_t) + sizeof(ucp_ep_ext_t));
+
+    /* Fragmented message allocates the reassembly state */
+    test_am_send_recv(256 * UCS_KBYTE, 8);
+    EXPECT_NE(nullptr, r_ep->ext->am.frags);
+    EXPECT_GE(ucp_ep_memory_usage(r_ep),
+              usage_before + sizeof(*r_ep->ext->am.frags));
+}
+
 /*
  * Regression test for FLAG_RESEND orphan eviction: forges a partial
  * first_rdesc on the receiver, drives a single-fragment resend at
@@ -1028,6 +1043,7 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
             UCS_PTR_BYTE_OFFSET(forged_alloc, sizeof(ucs_interval_tree_t)));
     forged_rdesc->release_desc_offset = sizeof(ucs_interval_tree_t);
     forged_rdesc->payload_offset      = UCP_AM_FIRST_FRAG_META_LEN;
+    forged_rdesc->flags               = 0;
 
     ucp_am_first_ftr_t *partial_ftr = reinterpret_cast<ucp_am_first_ftr_t*>(
             forged_rdesc + 1);
@@ -1040,7 +1056,7 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
 
     auto orphan_is_linked = [&]() -> bool {
         ucp_recv_desc_t *rdesc;
-        ucs_list_for_each(rdesc, &r_ep_ext->am.started_ams,
+        ucs_list_for_each(rdesc, &r_ep_ext->am.frags->started_ams,
                           am_first.list) {
             if (rdesc == forged_rdesc) {
                 return true;
@@ -1051,8 +1067,10 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
 
     {
         UCS_ASYNC_BLOCK(&r_worker->async);
-        ucs_list_add_tail(&r_ep_ext->am.started_ams,
-                          &forged_rdesc->am_first.list);
+        ucp_am_ep_frags_t *frags;
+        ucs_status_t status = ucp_am_ep_frags_get(r_ep, &frags);
+        ucs_assert_always(status == UCS_OK);
+        ucs_list_add_tail(&frags->started_ams, &forged_rdesc->am_first.list);
         UCS_ASYNC_UNBLOCK(&r_worker->async);
     }
     EXPECT_TRUE(orphan_is_linked());
@@ -1342,6 +1360,496 @@ UCS_TEST_P(test_ucp_am_nbx_send_flag, eager, "RNDV_THRESH=128")
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_send_flag)
 
 
+class test_ucp_am_nbx_coalesce : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_coalesce()
+    {
+        modify_config("AM_COALESCE", "y");
+        modify_config("AM_COALESCE_TIMEOUT", "1s");
+    }
+
+protected:
+    enum {
+        NUM_MSGS   = 200,
+        LARGE_SIZE = 4096
+    };
+
+    size_t coalesced_length()
+    {
+        ucp_am_coalesce_frame_t *frame = sender().ep()->ext->am.coalesce;
+        return (frame == NULL) ? 0 : frame->length;
+    }
+
+    /* Every 16th message is too large to be coalesced */
+    static size_t msg_size(uint32_t seq)
+    {
+        return ((seq % 16) == 15) ? LARGE_SIZE : (8 << (seq % 4));
+    }
+
+    void send_msgs(unsigned flags = 0, uint32_t count = NUM_MSGS)
+    {
+        std::vector<ucs_status_ptr_t> sptrs;
+        ucp_request_param_t param;
+
+        param.op_attr_mask = 0;
+        if (flags != 0) {
+            param.op_attr_mask |= UCP_OP_ATTR_FIELD_FLAGS;
+            param.flags         = flags;
+        }
+
+        m_seqs.resize(count);
+        m_bufs.resize(count);
+        for (uint32_t seq = 0; seq < count; ++seq) {
+            m_seqs[seq] = seq;
+            m_bufs[seq].resize(msg_size(seq));
+            mem_buffer::pattern_fill(m_bufs[seq].data(), m_bufs[seq].size(),
+                                     seq);
+            sptrs.push_back(update_counter_and_send_am(&m_seqs[seq],
+                                                       sizeof(m_seqs[seq]),
+                                                       m_bufs[seq].data(),
+                                                       m_bufs[seq].size(),
+                                                       TEST_AM_NBX_ID,
+                                                       &param));
+            if ((seq == 0) && !(flags & UCP_AM_SEND_FLAG_REPLY)) {
+                /* Small message is held until the next progress */
+                EXPECT_NE(0, coalesced_length());
+            }
+        }
+
+        requests_wait(sptrs);
+    }
+
+    static ucs_status_t am_seq_cb(void *arg, const void *header,
+                                  size_t header_length, void *data,
+                                  size_t length,
+                                  const ucp_am_recv_param_t *param)
+    {
+        test_ucp_am_nbx_coalesce *self =
+                reinterpret_cast<test_ucp_am_nbx_coalesce*>(arg);
+        uint32_t seq;
+
+        EXPECT_EQ(sizeof(seq), header_length);
+        memcpy(&seq, header, sizeof(seq));
+        EXPECT_EQ(self->m_recv_counter, seq);
+        EXPECT_EQ(msg_size(seq), length);
+        mem_buffer::pattern_check(data, length, seq);
+        self->m_recv_counter++;
+
+        if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA) {
+            self->m_rx_data.push_back(data);
+            return UCS_INPROGRESS;
+        }
+
+        return UCS_OK;
+    }
+
+    void release_rx_data()
+    {
+        for (void *data : m_rx_data) {
+            ucp_am_data_release(receiver().worker(), data);
+        }
+        m_rx_data.clear();
+    }
+
+    std::vector<uint32_t>          m_seqs;
+    std::vector<std::vector<char>> m_bufs;
+    std::vector<void*>             m_rx_data;
+};
+
+UCS_TEST_P(test_ucp_am_nbx_coalesce, send_recv, "RNDV_THRESH=inf")
+{
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_seq_cb, this);
+    send_msgs();
+    wait_receives();
+    release_rx_data();
+}
+
+UCS_TEST_P(test_ucp_am_nbx_coalesce, reply, "RNDV_THRESH=inf")
+{
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_seq_cb, this);
+    send_msgs(UCP_AM_SEND_FLAG_REPLY);
+    EXPECT_EQ(0, coalesced_length());
+    wait_receives();
+    release_rx_data();
+}
+
+UCS_TEST_P(test_ucp_am_nbx_coalesce, persistent_data, "RNDV_THRESH=inf")
+{
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_seq_cb, this,
+                        UCP_AM_FLAG_PERSISTENT_DATA);
+    send_msgs();
+    wait_receives();
+
+    /* Data of all messages is still valid after the frames are released */
+    ASSERT_EQ(NUM_MSGS, m_rx_data.size());
+    for (uint32_t seq = 0; seq < NUM_MSGS; ++seq) {
+        mem_buffer::pattern_check(m_rx_data[seq], msg_size(seq), seq);
+    }
+
+    release_rx_data();
+}
+
+UCS_TEST_P(test_ucp_am_nbx_coalesce, flush)
+{
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_seq_cb, this);
+    send_msgs(0, 8);
+    EXPECT_NE(0, coalesced_length());
+
+    flush_ep(sender());
+    EXPECT_EQ(0, coalesced_length());
+    wait_receives();
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_coalesce)
+
+
+class test_ucp_am_nbx_user_buffer : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_user_buffer() :
+        m_buffer_cb_count(0), m_aborted_count(0), m_use_buffer(true)
+    {
+    }
+
+protected:
+    enum {
+        NUM_MSGS = 8
+    };
+
+    void set_handler()
+    {
+        ucp_am_handler_param_t param;
+
+        param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                           UCP_AM_HANDLER_PARAM_FIELD_CB |
+                           UCP_AM_HANDLER_PARAM_FIELD_ARG |
+                           UCP_AM_HANDLER_PARAM_FIELD_BUFFER_CB;
+        param.id         = TEST_AM_NBX_ID;
+        param.cb         = am_recv_cb;
+        param.buffer_cb  = am_buffer_cb;
+        param.arg        = this;
+        ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(receiver().worker(),
+                                                     &param));
+    }
+
+    void test_send_recv(size_t size)
+    {
+        std::vector<ucs_status_ptr_t> sptrs;
+        ucp_request_param_t param;
+
+        set_handler();
+        m_size             = size;
+        param.op_attr_mask = 0;
+        m_seqs.resize(NUM_MSGS);
+        m_bufs.resize(NUM_MSGS);
+        m_user_bufs.resize(NUM_MSGS);
+        for (uint32_t seq = 0; seq < NUM_MSGS; ++seq) {
+            m_seqs[seq] = seq;
+            m_bufs[seq].resize(size);
+            mem_buffer::pattern_fill(m_bufs[seq].data(), size, seq);
+            sptrs.push_back(update_counter_and_send_am(&m_seqs[seq],
+                                                       sizeof(m_seqs[seq]),
+                                                       m_bufs[seq].data(),
+                                                       size, TEST_AM_NBX_ID,
+                                                       &param));
+        }
+
+        requests_wait(sptrs);
+        wait_receives();
+    }
+
+    static void *am_buffer_cb(void *arg, const void *header,
+                              size_t header_length, size_t length,
+                              const ucp_am_recv_param_t *param)
+    {
+        test_ucp_am_nbx_user_buffer *self =
+                reinterpret_cast<test_ucp_am_nbx_user_buffer*>(arg);
+        uint32_t seq;
+
+        EXPECT_EQ(sizeof(seq), header_length);
+        EXPECT_EQ(self->m_size, length);
+        EXPECT_TRUE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+        memcpy(&seq, header, sizeof(seq));
+        self->m_buffer_cb_count++;
+
+        if (!self->m_use_buffer) {
+            return NULL;
+        }
+
+        EXPECT_LT(seq, self->m_user_bufs.size());
+        EXPECT_TRUE(self->m_user_bufs[seq].empty());
+        self->m_user_bufs[seq].resize(length);
+        return self->m_user_bufs[seq].data();
+    }
+
+    static ucs_status_t am_recv_cb(void *arg, const void *header,
+                                   size_t header_length, void *data,
+                                   size_t length,
+                                   const ucp_am_recv_param_t *param)
+    {
+        test_ucp_am_nbx_user_buffer *self =
+                reinterpret_cast<test_ucp_am_nbx_user_buffer*>(arg);
+        uint32_t seq;
+
+        EXPECT_EQ(sizeof(seq), header_length);
+        memcpy(&seq, header, sizeof(seq));
+        EXPECT_EQ(self->m_size, length);
+
+        if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_ABORTED) {
+            EXPECT_TRUE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+            EXPECT_EQ(self->m_user_bufs[seq].data(), data);
+            self->m_aborted_count++;
+            return UCS_OK;
+        }
+
+        mem_buffer::pattern_check(data, length, seq);
+
+        if (self->m_use_buffer) {
+            EXPECT_TRUE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+            EXPECT_FALSE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA);
+            EXPECT_EQ(self->m_user_bufs[seq].data(), data);
+        } else {
+            EXPECT_FALSE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+        }
+
+        self->m_recv_counter++;
+        return UCS_OK;
+    }
+
+    size_t                         m_size;
+    size_t                         m_buffer_cb_count;
+    size_t                         m_aborted_count;
+    bool                           m_use_buffer;
+    std::vector<uint32_t>          m_seqs;
+    std::vector<std::vector<char>> m_bufs;
+    std::vector<std::vector<char>> m_user_bufs;
+};
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, multi_frag, "ZCOPY_THRESH=inf",
+           "RNDV_THRESH=inf")
+{
+    test_send_recv(fragment_size() * 4);
+    EXPECT_EQ(NUM_MSGS, m_buffer_cb_count);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, no_buffer, "ZCOPY_THRESH=inf",
+           "RNDV_THRESH=inf")
+{
+    m_use_buffer = false;
+    test_send_recv(fragment_size() * 4);
+    EXPECT_EQ(NUM_MSGS, m_buffer_cb_count);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_user_buffer)
+
+
+class test_ucp_am_nbx_user_buffer_closed_ep :
+        public test_ucp_am_nbx_user_buffer {
+public:
+    test_ucp_am_nbx_user_buffer_closed_ep()
+    {
+        modify_config("RESOLVE_REMOTE_EP_ID", "auto");
+    }
+
+protected:
+    virtual ucp_ep_params_t get_ep_params()
+    {
+        ucp_ep_params_t ep_params = test_ucp_am_nbx::get_ep_params();
+        ep_params.field_mask     |= UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+        ep_params.err_mode        = UCP_ERR_HANDLING_MODE_PEER;
+        return ep_params;
+    }
+};
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer_closed_ep, abort_on_close,
+           "ZCOPY_THRESH=inf", "RNDV_THRESH=inf")
+{
+    const size_t size = fragment_size() * 64;
+    ucp_request_param_t param;
+    ucs_status_ptr_t sreq;
+
+    skip_loopback();
+    set_handler();
+
+    m_size             = size;
+    param.op_attr_mask = 0;
+    m_seqs.assign(1, 0);
+    m_bufs.assign(1, std::vector<char>(size));
+    m_user_bufs.resize(1);
+    mem_buffer::pattern_fill(m_bufs[0].data(), size, 0);
+    sreq = update_counter_and_send_am(&m_seqs[0], sizeof(m_seqs[0]),
+                                      m_bufs[0].data(), size, TEST_AM_NBX_ID,
+                                      &param);
+
+    ucs_time_t deadline = ucs::get_deadline();
+    while ((m_buffer_cb_count == 0) && (ucs_get_time() < deadline)) {
+        sender().progress();
+        receiver().progress();
+    }
+
+    if ((m_buffer_cb_count == 0) || (m_recv_counter != 0)) {
+        request_wait(sreq);
+        UCS_TEST_SKIP_R("message was not partially received");
+    }
+
+    void *close_req = receiver().disconnect_nb();
+    deadline        = ucs::get_deadline(10);
+    while (!is_request_completed(close_req) && (ucs_get_time() < deadline)) {
+        progress();
+    }
+
+    receiver().close_ep_req_free(close_req);
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+    request_wait(sreq);
+    EXPECT_EQ(0, m_recv_counter);
+    EXPECT_EQ(1, m_aborted_count);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_user_buffer_closed_ep)
+
+
+class test_ucp_am_nbx_buffer_pool : public test_ucp_am_nbx {
+public:
+    virtual void init()
+    {
+        test_ucp_am_nbx::init();
+        /* Multi-fragment messages are always assembled in the pool */
+        m_buffer_size = fragment_size() * 2;
+        m_pool.resize(m_buffer_size * POOL_BUFFERS);
+        set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_hold_cb, this,
+                            UCP_AM_FLAG_PERSISTENT_DATA);
+    }
+
+    virtual void cleanup()
+    {
+        release_rx_data();
+        test_ucp_am_nbx::cleanup();
+    }
+
+protected:
+    enum {
+        POOL_BUFFERS = 8
+    };
+
+    ucs_status_t set_pool(size_t length = 0)
+    {
+        ucp_am_buffer_pool_params_t params;
+
+        params.field_mask  = UCP_AM_BUFFER_POOL_PARAM_FIELD_ADDRESS |
+                             UCP_AM_BUFFER_POOL_PARAM_FIELD_LENGTH |
+                             UCP_AM_BUFFER_POOL_PARAM_FIELD_BUFFER_SIZE;
+        params.address     = m_pool.data();
+        params.length      = (length != 0) ? length : m_pool.size();
+        params.buffer_size = m_buffer_size;
+        return ucp_worker_set_am_buffer_pool(receiver().worker(), &params);
+    }
+
+    /* Send a message and return whether it was received to the pool */
+    bool send_recv(size_t size)
+    {
+        std::vector<char> sbuf(size, 'p');
+        ucp_request_param_t param;
+        size_t count;
+        void *data;
+
+        param.op_attr_mask = 0;
+        count              = m_rx_data.size();
+        request_wait(ucp_am_send_nbx(sender().ep(), TEST_AM_NBX_ID, NULL, 0,
+                                     sbuf.data(), size, &param));
+        wait_for_value(&m_rx_count, count + 1);
+        EXPECT_EQ(count + 1, m_rx_data.size());
+
+        data = m_rx_data.back();
+        EXPECT_EQ(0, memcmp(data, sbuf.data(), size));
+        return (data >= m_pool.data()) &&
+               (data < (m_pool.data() + m_pool.size()));
+    }
+
+    static ucs_status_t am_hold_cb(void *arg, const void *header,
+                                   size_t header_length, void *data,
+                                   size_t length,
+                                   const ucp_am_recv_param_t *param)
+    {
+        test_ucp_am_nbx_buffer_pool *self =
+                reinterpret_cast<test_ucp_am_nbx_buffer_pool*>(arg);
+
+        EXPECT_TRUE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA);
+        self->m_rx_data.push_back(data);
+        self->m_rx_count = self->m_rx_data.size();
+        return UCS_INPROGRESS;
+    }
+
+    void release_rx_data()
+    {
+        for (void *data : m_rx_data) {
+            ucp_am_data_release(receiver().worker(), data);
+        }
+        m_rx_data.clear();
+        m_rx_count = 0;
+    }
+
+    size_t             m_buffer_size;
+    std::vector<char>  m_pool;
+    std::vector<void*> m_rx_data;
+    size_t             m_rx_count = 0;
+};
+
+UCS_TEST_P(test_ucp_am_nbx_buffer_pool, recv_to_pool, "ZCOPY_THRESH=inf",
+           "RNDV_THRESH=inf")
+{
+    ASSERT_UCS_OK(set_pool());
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        EXPECT_EQ(UCS_ERR_ALREADY_EXISTS, set_pool());
+    }
+
+    /* Multi-fragment message is assembled in the pool */
+    EXPECT_TRUE(send_recv(m_buffer_size));
+    EXPECT_TRUE(send_recv(fragment_size() + 1));
+
+    /* Single fragment message is received to the pool only if the transport
+     * does not provide its own descriptor, so only check the data */
+    send_recv(1);
+
+    /* Message does not fit the pool buffer */
+    EXPECT_FALSE(send_recv(m_buffer_size + 1));
+}
+
+UCS_TEST_P(test_ucp_am_nbx_buffer_pool, too_small)
+{
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        EXPECT_EQ(UCS_ERR_INVALID_PARAM, set_pool(m_buffer_size - 1));
+    }
+
+    /* Failed call does not set the pool */
+    ASSERT_UCS_OK(set_pool());
+}
+
+UCS_TEST_P(test_ucp_am_nbx_buffer_pool, exhaust, "ZCOPY_THRESH=inf",
+           "RNDV_THRESH=inf")
+{
+    unsigned num_in_pool = 0;
+
+    ASSERT_UCS_OK(set_pool());
+
+    /* Fall back to internal buffers when the pool is empty */
+    while (send_recv(m_buffer_size)) {
+        ++num_in_pool;
+        ASSERT_LT(num_in_pool, (unsigned)POOL_BUFFERS);
+    }
+    EXPECT_GT(num_in_pool, 0u);
+
+    /* Released buffers are reused */
+    release_rx_data();
+    for (unsigned i = 0; i < num_in_pool; ++i) {
+        EXPECT_TRUE(send_recv(m_buffer_size));
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_buffer_pool)
+
+
 class test_ucp_am_nbx_reply : public test_ucp_am_nbx {
 public:
     static void get_test_variants(variant_vec_t &variants)
@@ -2213,6 +2721,8 @@ public:
         modify_config("RNDV_THRESH", "128");
         modify_config("RNDV_SCHEME", "put_ppln");
         modify_config("RNDV_PIPELINE_SHM_ENABLE", "n");
+        /* Use fixed-size fragments to check the number of fragments */
+        modify_config("RNDV_PIPELINE_ADAPTIVE", "n");
         /* FIXME: Advertise error handling support for RNDV PPLN protocol.
          * Remove this once invalidation workflow is implemented. */
         modify_config("RNDV_PIPELINE_ERROR_HANDLING", "y");
@@ -2268,6 +2778,21 @@ protected:
         check_stats(receiver(), UCP_WORKER_STAT_RNDV_RTR_MTYPE, stats_cntr_value);
     }
 
+    void test_ppln_send_adaptive(size_t num_frags)
+    {
+        if (!sender().is_rndv_put_ppln_supported()) {
+            UCS_TEST_SKIP_R("RNDV pipeline is not supported");
+        }
+
+        test_am_send_recv(get_rndv_frag_size(UCS_MEMORY_TYPE_CUDA) * num_frags);
+
+        /* Fragments start from a smaller size, so there are at least as many
+         * fragments as with the fixed fragment size */
+        EXPECT_GE(UCS_STATS_GET_COUNTER(sender().worker()->stats,
+                                        UCP_WORKER_STAT_RNDV_PUT_MTYPE_ZCOPY),
+                  num_frags);
+    }
+
     void set_mem_type(ucs_memory_type_t mem_type) {
         m_mem_type = mem_type;
     }
@@ -2308,6 +2833,18 @@ UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, host_buff_cuda_frag,
     test_ppln_send(UCS_MEMORY_TYPE_CUDA, num_frags, num_frags);
 }
 
+UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, host_buff_max_inflight,
+           "RNDV_FRAG_MEM_TYPE=cuda", "RNDV_PIPELINE_MAX_INFLIGHT=2")
+{
+    const size_t num_frags = 16;
+
+    test_ppln_send(UCS_MEMORY_TYPE_CUDA, num_frags, num_frags);
+
+    auto max_inflight = sender().worker()->counters.rndv_ppln_max_inflight;
+    EXPECT_GT(max_inflight, 0ul);
+    EXPECT_LE(max_inflight, 2ul);
+}
+
 UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, host_buff_host_frag,
            "RNDV_FRAG_MEM_TYPE=host")
 {
@@ -2326,6 +2863,13 @@ UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, cuda_buff_cuda_frag,
     test_ppln_send(UCS_MEMORY_TYPE_CUDA, num_frags, num_frags);
 }
 
+UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, cuda_buff_adaptive_frag,
+           "RNDV_FRAG_MEM_TYPE=cuda", "RNDV_PIPELINE_ADAPTIVE=y")
+{
+    set_mem_type(UCS_MEMORY_TYPE_CUDA);
+    test_ppln_send_adaptive(8);
+}
+
 UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, empty_rndv_frag_mem_type,
            "RNDV_FRAG_MEM_TYPE=")
 {
@@ -2346,6 +2890,63 @@ UCS_TEST_P(test_ucp_am_nbx_rndv_ppln, cuda_managed_buff,
 
 UCP_INSTANTIATE_TEST_CASE_GPU_AWARE(test_ucp_am_nbx_rndv_ppln);
 
+
+class test_ucp_am_nbx_latency_stats : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_latency_stats()
+    {
+        stats_activate();
+    }
+
+    ~test_ucp_am_nbx_latency_stats()
+    {
+        stats_restore();
+    }
+
+    void init() override
+    {
+        if (!is_proto_enabled()) {
+            UCS_TEST_SKIP_R("proto v1");
+        }
+        test_ucp_am_nbx::init();
+    }
+
+protected:
+    uint64_t latency_count(unsigned lat_index)
+    {
+        return ucs_stats_histogram_count(
+                ucs_stats_node_histogram(sender().ep()->stats, lat_index));
+    }
+};
+
+UCS_TEST_P(test_ucp_am_nbx_latency_stats, eager, "RNDV_THRESH=inf")
+{
+    test_am_send_recv(64 * UCS_KBYTE);
+
+    EXPECT_EQ(1u, latency_count(UCP_EP_STAT_LAT_AM));
+    EXPECT_EQ(0u, latency_count(UCP_EP_STAT_LAT_RNDV));
+    EXPECT_EQ(0u, latency_count(UCP_EP_STAT_LAT_TAG));
+}
+
+UCS_TEST_P(test_ucp_am_nbx_latency_stats, short_msg)
+{
+    /* Sent inline without a request */
+    test_am_send_recv(8);
+
+    EXPECT_EQ(1u, latency_count(UCP_EP_STAT_LAT_AM));
+    EXPECT_EQ(0u, latency_count(UCP_EP_STAT_LAT_STREAM));
+}
+
+UCS_TEST_P(test_ucp_am_nbx_latency_stats, rndv, "RNDV_THRESH=0")
+{
+    test_am_send_recv(64 * UCS_KBYTE);
+
+    EXPECT_EQ(0u, latency_count(UCP_EP_STAT_LAT_AM));
+    EXPECT_EQ(1u, latency_count(UCP_EP_STAT_LAT_RNDV));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_latency_stats)
+
 #endif
 
 /* Test class for AM PSN protocol */
@@ -12,6 +12,7 @@
 extern "C" {
 #include <ucp/core/ucp_context.h>
 #include <ucp/core/ucp_mm.h>
+#include <ucp/core/ucp_worker.h>
 #include <ucs/sys/sys.h>
 }
 
@@ -72,6 +73,37 @@ UCS_TEST_P(test_ucp_context, max_hca_per_gpu_config)
     EXPECT_EQ(2u, ucp_reg_devices_count(e->ucph()->config.ext.max_hca_per_gpu));
 }
 
+UCS_TEST_P(test_ucp_context, rndv_ppln_pool_depth,
+           "RNDV_FRAG_MEM_TYPES=host,cuda",
+           "RNDV_FRAG_ALLOC_COUNT=host:32,cuda:8")
+{
+    entity *e = create_entity();
+
+    EXPECT_EQ(UCS_ULUNITS_AUTO, e->ucph()->config.ext.rndv_ppln_max_inflight);
+    EXPECT_EQ(8u, e->ucph()->config.rndv_ppln_pool_depth);
+    EXPECT_EQ(0u, e->worker()->rndv_ppln_inflight);
+}
+
+UCS_TEST_P(test_ucp_context, rndv_ppln_zero_max_inflight)
+{
+    ucs::handle<ucp_config_t*> config;
+    UCS_TEST_CREATE_HANDLE(ucp_config_t*, config, ucp_config_release,
+                           ucp_config_read, NULL, NULL);
+    ASSERT_UCS_OK(ucp_config_modify(config, "RNDV_PIPELINE_MAX_INFLIGHT",
+                                    "0"));
+
+    ucp_context_h ucph;
+    ucs_status_t status;
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        status = ucp_init(&get_variant_ctx_params(), config.get(), &ucph);
+    }
+    if (status == UCS_OK) {
+        ucp_cleanup(ucph);
+    }
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, status);
+}
+
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_context, all, "all")
 
 class test_ucp_aliases : public test_ucp_context {
@@ -81,6 +113,10 @@ UCS_TEST_P(test_ucp_aliases, aliases) {
     create_entity();
 }
 
+UCS_TEST_P(test_ucp_aliases, eager_tl_modules, "LAZY_TL_MODULES=n") {
+    create_entity();
+}
+
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_aliases, rcv, "rc_v")
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_aliases, rcx, "rc_x")
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_aliases, ud, "ud")
@@ -415,3 +415,269 @@ UCS_TEST_F(test_ucp_dt_sgl, init_zero_count) {
     EXPECT_EQ(UCS_MEMORY_TYPE_HOST, m_dt_iter.mem_info.type);
     EXPECT_EQ(UCS_SYS_DEVICE_ID_UNKNOWN, m_dt_iter.mem_info.sys_dev);
 }
+
+class test_ucp_dt_strided : public ucs::test {
+protected:
+    virtual void init() {
+        ucp_params_t ctx_params;
+        ctx_params.field_mask = UCP_PARAM_FIELD_FEATURES;
+        ctx_params.features   = UCP_FEATURE_TAG;
+        UCS_TEST_CREATE_HANDLE(ucp_context_h, m_ucph, ucp_cleanup, ucp_init,
+                               &ctx_params, NULL);
+    }
+
+    virtual void cleanup() {
+        destroy_dt_iter();
+        m_ucph.reset();
+    }
+
+    void destroy_dt_iter()
+    {
+        if (m_datatype != 0) {
+            ucp_datatype_iter_cleanup(&m_dt_iter, 1, UINT_MAX);
+            ucp_dt_destroy(m_datatype);
+            m_datatype = 0;
+        }
+    }
+
+    static ucp_dt_strided_params_t
+    make_params(size_t block_size, unsigned num_dims, const size_t *counts,
+                const size_t *strides)
+    {
+        ucp_dt_strided_params_t params = {};
+
+        params.field_mask = UCP_DT_STRIDED_PARAM_FIELD_BLOCK_SIZE |
+                            UCP_DT_STRIDED_PARAM_FIELD_DIMS;
+        params.block_size = block_size;
+        params.num_dims   = num_dims;
+        for (unsigned dim = 0; dim < ucs_min(num_dims, UCP_DT_STRIDED_MAX_DIMS);
+             ++dim) {
+            params.dims[dim].count  = counts[dim];
+            params.dims[dim].stride = strides[dim];
+        }
+
+        return params;
+    }
+
+    /* Random layout with gaps between the blocks in every dimension */
+    static ucp_dt_strided_params_t random_params()
+    {
+        static const size_t block_sizes[] = {1, 4, 8, 16, 13, 100};
+        size_t counts[UCP_DT_STRIDED_MAX_DIMS], strides[UCP_DT_STRIDED_MAX_DIMS];
+        size_t block_size = block_sizes[ucs::rand() %
+                                        ucs_static_array_size(block_sizes)];
+        unsigned num_dims = (ucs::rand() % UCP_DT_STRIDED_MAX_DIMS) + 1;
+        size_t inner_span = block_size;
+
+        for (unsigned dim = 0; dim < num_dims; ++dim) {
+            counts[dim]  = (ucs::rand() % 6) + 1;
+            strides[dim] = inner_span + (ucs::rand() % 3) * 8;
+            inner_span   = counts[dim] * strides[dim];
+        }
+
+        return make_params(block_size, num_dims, counts, strides);
+    }
+
+    void init_dt_iter(const ucp_dt_strided_params_t &params, size_t count,
+                      bool is_pack)
+    {
+        destroy_dt_iter();
+        ASSERT_UCS_OK(ucp_dt_create_strided(&params, &m_datatype));
+
+        m_offsets = ucp::dt_strided_block_offsets(params, count);
+        m_params  = params;
+        m_buffer.resize(count * ucp::dt_strided_extent(params), 0);
+        ucs::fill_random(m_buffer);
+        m_packed.resize(m_offsets.size() * params.block_size, 0);
+        ucs::fill_random(m_packed);
+
+        ucp_request_param_t param;
+        param.op_attr_mask = 0;
+
+        uint8_t sg_count;
+        ASSERT_UCS_OK(ucp_datatype_iter_init(m_ucph.get(), &m_buffer[0], count,
+                                             m_datatype, 0, is_pack,
+                                             &m_dt_iter, &sg_count, &param));
+        EXPECT_EQ(m_packed.size(), m_dt_iter.length);
+        EXPECT_EQ(std::min(m_offsets.size(), (size_t)UINT8_MAX), sg_count);
+
+        ucp_datatype_attr_t attr;
+        attr.field_mask = UCP_DATATYPE_ATTR_FIELD_PACKED_SIZE |
+                          UCP_DATATYPE_ATTR_FIELD_COUNT;
+        attr.count      = count;
+        ASSERT_UCS_OK(ucp_dt_query(m_datatype, &attr));
+        EXPECT_EQ(m_packed.size(), attr.packed_size);
+    }
+
+    /* Buffer contents as expected after unpacking m_packed into m_buffer */
+    std::string expected_unpacked(const std::string &orig_buffer) const
+    {
+        std::string expected = orig_buffer;
+
+        for (size_t i = 0; i < m_offsets.size(); ++i) {
+            expected.replace(m_offsets[i], m_params.block_size, m_packed,
+                             i * m_params.block_size, m_params.block_size);
+        }
+        return expected;
+    }
+
+    std::string expected_packed() const
+    {
+        std::string packed;
+
+        for (size_t i = 0; i < m_offsets.size(); ++i) {
+            packed.append(m_buffer, m_offsets[i], m_params.block_size);
+        }
+        return packed;
+    }
+
+    size_t random_seg_size() const
+    {
+        return (ucs::rand() % (m_params.block_size * 3)) + 1;
+    }
+
+    ucs::handle<ucp_context_h> m_ucph;
+    ucp_datatype_t             m_datatype = 0;
+    ucp_dt_strided_params_t    m_params;
+    std::vector<size_t>        m_offsets;
+    std::string                m_buffer;
+    std::string                m_packed;
+    ucp_datatype_iter_t        m_dt_iter;
+};
+
+UCS_TEST_F(test_ucp_dt_strided, create_invalid) {
+    static const size_t counts[]      = {4, 2};
+    static const size_t strides[]     = {8, 64};
+    static const size_t bad_strides[] = {8, 16};
+    ucp_dt_strided_params_t params;
+    ucp_datatype_t datatype;
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+
+    params = make_params(8, 2, counts, strides);
+    ASSERT_UCS_OK(ucp_dt_create_strided(&params, &datatype));
+    ucp_dt_destroy(datatype);
+
+    /* Overlapping blocks */
+    params = make_params(16, 2, counts, strides);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(&params, &datatype));
+
+    /* Overlapping rows */
+    params = make_params(8, 2, counts, bad_strides);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(&params, &datatype));
+
+    params = make_params(8, UCP_DT_STRIDED_MAX_DIMS + 1, counts, strides);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(&params, &datatype));
+
+    params = make_params(8, 2, counts, strides);
+    params.field_mask = UCP_DT_STRIDED_PARAM_FIELD_DIMS;
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(&params, &datatype));
+
+    /* Extent of the outer dimension overflows size_t */
+    static const size_t huge_counts[]  = {4, SIZE_MAX / 32};
+    static const size_t huge_strides[] = {8, 64};
+    params = make_params(8, 2, huge_counts, huge_strides);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(&params, &datatype));
+}
+
+UCS_TEST_F(test_ucp_dt_strided, move_partial_block) {
+    static const size_t counts[]  = {4};
+    static const size_t strides[] = {16};
+
+    init_dt_iter(make_params(8, 1, counts, strides), 1, false);
+
+    /* Move a length which ends in the middle of the third block */
+    ucp_datatype_iter_t moved_iter;
+    uint8_t sg_count;
+    ucp_datatype_iter_move(&moved_iter, &m_dt_iter, 20, &sg_count);
+    EXPECT_EQ(3u, sg_count);
+    EXPECT_EQ(2 * 16 + 8u, ucp_datatype_iter_strided_span(&moved_iter));
+
+    ucp_datatype_iter_move(&m_dt_iter, &moved_iter, m_packed.size(),
+                           &sg_count);
+}
+
+UCS_TEST_F(test_ucp_dt_strided, pack) {
+    for (int iter = 0; iter < 50; ++iter) {
+        init_dt_iter(random_params(), (ucs::rand() % 4) + 1, true);
+
+        while (!ucp_datatype_iter_is_end(&m_dt_iter)) {
+            ucp_datatype_iter_t next_iter;
+            ucp_datatype_iter_next_pack(&m_dt_iter, NULL, random_seg_size(),
+                                        &next_iter,
+                                        &m_packed[m_dt_iter.offset]);
+            ucp_datatype_iter_copy_position(&m_dt_iter, &next_iter, UINT_MAX);
+        }
+
+        ASSERT_EQ(expected_packed(), m_packed);
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, unpack) {
+    for (int iter = 0; iter < 50; ++iter) {
+        init_dt_iter(random_params(), (ucs::rand() % 4) + 1, false);
+
+        std::string expected = expected_unpacked(m_buffer);
+        size_t offset        = 0;
+        while (offset < m_packed.size()) {
+            size_t length = std::min(random_seg_size(),
+                                     m_packed.size() - offset);
+            ASSERT_UCS_OK(ucp_datatype_iter_unpack(&m_dt_iter, NULL, length,
+                                                   offset, &m_packed[offset]));
+            offset += length;
+        }
+
+        ASSERT_EQ(expected, m_buffer);
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, next_iov) {
+    static const size_t max_iov = 4;
+    uct_iov_t iov[max_iov];
+
+    for (int iter = 0; iter < 50; ++iter) {
+        init_dt_iter(random_params(), (ucs::rand() % 4) + 1, true);
+
+        std::string packed;
+        while (!ucp_datatype_iter_is_end(&m_dt_iter)) {
+            ucp_datatype_iter_t next_iter;
+            size_t max_length = random_seg_size();
+            size_t iov_count  = ucp_datatype_iter_next_iov(
+                    &m_dt_iter, max_length, UCP_NULL_RESOURCE, UINT_MAX,
+                    &next_iter, iov, max_iov);
+            ASSERT_GT(iov_count, 0u);
+            ASSERT_LE(iov_count, max_iov);
+
+            size_t length = 0;
+            for (size_t i = 0; i < iov_count; ++i) {
+                packed.append((const char*)iov[i].buffer, iov[i].length);
+                length += iov[i].length;
+            }
+            EXPECT_LE(length, max_length);
+            EXPECT_EQ(m_dt_iter.offset + length, next_iter.offset);
+            ucp_datatype_iter_copy_position(&m_dt_iter, &next_iter, UINT_MAX);
+        }
+
+        ASSERT_EQ(expected_packed(), packed);
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, next_iov_merge_adjacent) {
+    /* Blocks of every row are adjacent, so a row is sent as one iov entry */
+    static const size_t counts[]  = {4, 3};
+    static const size_t strides[] = {8, 64};
+    uct_iov_t iov[3];
+
+    init_dt_iter(make_params(8, 2, counts, strides), 1, true);
+
+    ucp_datatype_iter_t next_iter;
+    size_t iov_count = ucp_datatype_iter_next_iov(&m_dt_iter, SIZE_MAX,
+                                                  UCP_NULL_RESOURCE, UINT_MAX,
+                                                  &next_iter, iov, 3);
+    ASSERT_EQ(3u, iov_count);
+    for (size_t i = 0; i < iov_count; ++i) {
+        EXPECT_EQ(&m_buffer[i * 64], iov[i].buffer);
+        EXPECT_EQ(32u, iov[i].length);
+    }
+    EXPECT_EQ(m_dt_iter.length, next_iter.offset);
+}
@@ -8,17 +8,24 @@
 
 #include <common/test.h>
 #include <common/mem_buffer.h>
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <unordered_map>
 #include <memory>
+#include <numeric>
+#include <set>
 
 extern "C" {
+#include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_rkey.h>
 #include <ucp/dt/datatype_iter.inl>
 #include <ucp/proto/proto.h>
 #include <ucp/proto/proto_debug.h>
 #include <ucp/proto/proto_perf.h>
 #include <ucp/proto/proto_init.h>
+#include <ucp/proto/proto_multi.h>
+#include <ucp/proto/proto_tune.h>
 #include <ucp/rndv/proto_rndv.h>
 #include <ucs/datastruct/linear_func.h>
 #include <ucp/proto/proto_select.inl>
@@ -269,6 +276,19 @@ protected:
                                                           mem_type));
     }
 
+    void send_recv(size_t size)
+    {
+        std::string sbuf(size, 'x'), rbuf(size, 0);
+        ucp_request_param_t param;
+
+        param.op_attr_mask = 0;
+        void *sreq = ucp_tag_send_nbx(sender().ep(), &sbuf[0], size, 1, &param);
+        void *rreq = ucp_tag_recv_nbx(receiver().worker(), &rbuf[0], size, 1,
+                                      UINT64_MAX, &param);
+        ASSERT_UCS_OK(requests_wait({sreq, rreq}));
+        EXPECT_EQ(sbuf, rbuf);
+    }
+
     std::string proto_config_info(const ucp_proto_config_t *proto_config,
                                   size_t msg_length = UCS_MBYTE)
     {
@@ -1208,6 +1228,702 @@ UCS_TEST_P(test_perf_node, replace_null)
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_perf_node, all, "all")
 
+class test_ucp_proto_tune : public test_ucp_proto {
+protected:
+    enum {
+        NUM_SAMPLES = 8
+    };
+
+    virtual void init() {
+        const char *tmp_dir = getenv("TMPDIR");
+
+        m_tune_file = std::string((tmp_dir != NULL) ? tmp_dir : "/tmp") +
+                      "/gtest_ucp_proto_tune." + ucs::to_string(getpid());
+        unlink(m_tune_file.c_str());
+
+        modify_config("PROTO_TUNE", "y");
+        modify_config("PROTO_TUNE_SAMPLES", ucs::to_string(NUM_SAMPLES));
+        modify_config("PROTO_TUNE_FILE", m_tune_file);
+        test_ucp_proto::init();
+    }
+
+    virtual void cleanup() {
+        test_ucp_proto::cleanup();
+        unlink(m_tune_file.c_str());
+    }
+
+    /* Complete a fake request which took 'factor' times the estimated time */
+    void add_sample(const ucp_proto_threshold_elem_t *thresh_elem,
+                    size_t msg_length, double factor)
+    {
+        const ucp_proto_init_elem_t *init_elem =
+                thresh_elem->proto_config.init_elem;
+        const ucp_proto_flat_perf_range_t *range;
+        ucp_proto_tune_slot_t *slot;
+        ucp_request_t req;
+
+        range = ucp_proto_flat_perf_find_lb(init_elem->flat_perf, msg_length);
+        ASSERT_NE(nullptr, range);
+
+        memset(&req, 0, sizeof(req));
+        req.flags                     = UCP_REQUEST_FLAG_PROTO_SEND |
+                                        UCP_REQUEST_FLAG_PROTO_TUNE;
+        req.send.ep                   = sender().ep();
+        req.send.state.dt_iter.length = msg_length;
+
+        slot               = ucp_proto_tune_slot(&worker()->proto_tune, &req);
+        slot->req          = &req;
+        slot->proto_config = &thresh_elem->proto_config;
+        slot->start_time   = ucs_get_time() -
+                             ucs_time_from_sec(factor *
+                                               ucs_linear_func_apply(
+                                                       range->value,
+                                                       msg_length));
+        ucp_proto_tune_sample(&req);
+        EXPECT_FALSE(req.flags & UCP_REQUEST_FLAG_PROTO_TUNE);
+        EXPECT_EQ(nullptr, slot->req);
+    }
+
+    /* Protocols of the sender endpoint which have collected samples */
+    std::vector<const ucp_proto_init_elem_t*> tuned_protocols()
+    {
+        std::vector<const ucp_proto_init_elem_t*> result;
+        const ucp_proto_select_elem_t *select_elem;
+        const ucp_proto_init_elem_t *init_elem;
+        ucp_proto_select_t *proto_select;
+
+        proto_select = &ucs_array_elem(&worker()->ep_config,
+                                       sender().ep()->cfg_index).proto_select;
+        for (khiter_t iter = kh_begin(proto_select->hash);
+             iter != kh_end(proto_select->hash); ++iter) {
+            if (!kh_exist(proto_select->hash, iter)) {
+                continue;
+            }
+
+            select_elem = &kh_value(proto_select->hash, iter);
+            ucs_array_for_each(init_elem, &select_elem->proto_init.protocols) {
+                if ((init_elem->tune.count > 0) ||
+                    (init_elem->tune.num_fits > 0)) {
+                    result.push_back(init_elem);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::string m_tune_file;
+};
+
+UCS_TEST_P(test_ucp_proto_tune, correct_and_reload)
+{
+    static const size_t msg_length = UCS_MBYTE;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    const ucp_proto_init_elem_t *init_elem;
+    ucp_proto_id_t proto_id;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+    init_elem = thresh_elem->proto_config.init_elem;
+    proto_id  = init_elem->proto_id;
+
+    for (unsigned i = 0; i < NUM_SAMPLES; ++i) {
+        add_sample(thresh_elem, msg_length, 3.0);
+    }
+
+    /* Thresholds are recalculated with the corrected estimation, and the
+     * previous ones are kept for in-flight requests */
+    EXPECT_NEAR(3.0, init_elem->tune.corr.m, 0.5);
+    EXPECT_EQ(1u, ucs_array_length(&worker()->proto_tune.retired));
+    EXPECT_NE(thresh_elem, select_tag_send_protocol(UCS_MEMORY_TYPE_HOST,
+                                                    msg_length));
+
+    /* Corrections are saved when the worker is destroyed */
+    m_entities.clear();
+    std::ifstream file(m_tune_file);
+    ASSERT_TRUE(file.good()) << m_tune_file;
+
+    create_entity();
+    if (!is_self()) {
+        create_entity();
+    }
+    sender().connect(&receiver(), get_ep_params());
+    EXPECT_EQ(1u, kh_size(&worker()->proto_tune.corrs));
+
+    /* A new worker starts with the learned correction */
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+
+    auto proto_select = &ucs_array_elem(&worker()->ep_config,
+                                        sender().ep()->cfg_index).proto_select;
+    bool found        = false;
+    for (khiter_t iter = kh_begin(proto_select->hash);
+         iter != kh_end(proto_select->hash); ++iter) {
+        if (!kh_exist(proto_select->hash, iter)) {
+            continue;
+        }
+
+        /* Find the selection which the tag send protocol belongs to */
+        auto select_elem = &kh_value(proto_select->hash, iter);
+        if ((thresh_elem->proto_config.init_elem <
+             ucs_array_begin(&select_elem->proto_init.protocols)) ||
+            (thresh_elem->proto_config.init_elem >=
+             ucs_array_end(&select_elem->proto_init.protocols))) {
+            continue;
+        }
+
+        ucs_array_for_each(init_elem, &select_elem->proto_init.protocols) {
+            if (init_elem->proto_id == proto_id) {
+                EXPECT_NEAR(3.0, init_elem->tune.corr.m, 0.5);
+                found = true;
+            }
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+UCS_TEST_P(test_ucp_proto_tune, retired_limit)
+{
+    static const size_t msg_length = UCS_MBYTE;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+
+    /* Threshold arrays which are replaced by tuning are not released until
+     * the worker is destroyed, so their number is limited */
+    while (ucs_array_length(&worker()->proto_tune.retired) <
+           UCP_PROTO_TUNE_MAX_RETIRED) {
+        *ucs_array_append(&worker()->proto_tune.retired, FAIL()) = NULL;
+    }
+
+    for (unsigned i = 0; i < NUM_SAMPLES; ++i) {
+        add_sample(thresh_elem, msg_length, 3.0);
+    }
+
+    /* The correction is learned, but the thresholds are not replaced */
+    EXPECT_NEAR(3.0, thresh_elem->proto_config.init_elem->tune.corr.m, 0.5);
+    EXPECT_EQ(UCP_PROTO_TUNE_MAX_RETIRED,
+              ucs_array_length(&worker()->proto_tune.retired));
+    EXPECT_EQ(thresh_elem, select_tag_send_protocol(UCS_MEMORY_TYPE_HOST,
+                                                    msg_length));
+}
+
+UCS_TEST_P(test_ucp_proto_tune, converge)
+{
+    static const size_t msg_length = UCS_MBYTE;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    const ucp_proto_tune_t *tune;
+    unsigned window;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+    tune = &thresh_elem->proto_config.init_elem->tune;
+
+    /* Every fit doubles the number of samples for the next one, and the same
+     * measurements do not replace the thresholds again */
+    window = NUM_SAMPLES;
+    for (unsigned fit = 1; fit <= 4; ++fit) {
+        for (unsigned i = 0; i < window; ++i) {
+            add_sample(thresh_elem, msg_length, 3.0);
+        }
+
+        EXPECT_EQ(fit, tune->num_fits);
+        EXPECT_EQ(0u, tune->count);
+        EXPECT_NEAR(3.0, tune->corr.m, 0.5);
+        EXPECT_EQ(1u, ucs_array_length(&worker()->proto_tune.retired));
+        window *= 2;
+    }
+}
+
+UCS_TEST_P(test_ucp_proto_tune, cancel)
+{
+    static const size_t msg_length = UCS_MBYTE;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    ucp_proto_tune_slot_t *slot;
+    ucp_request_t req;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+
+    memset(&req, 0, sizeof(req));
+    req.flags   = UCP_REQUEST_FLAG_PROTO_SEND | UCP_REQUEST_FLAG_PROTO_TUNE;
+    req.send.ep = sender().ep();
+
+    slot               = ucp_proto_tune_slot(&worker()->proto_tune, &req);
+    slot->req          = &req;
+    slot->proto_config = &thresh_elem->proto_config;
+    slot->start_time   = ucs_get_time();
+
+    /* A request which waited for resources is not accounted */
+    ucp_proto_tune_cancel(&req);
+    EXPECT_FALSE(req.flags & UCP_REQUEST_FLAG_PROTO_TUNE);
+    EXPECT_EQ(nullptr, slot->req);
+    EXPECT_EQ(0u, thresh_elem->proto_config.init_elem->tune.count);
+}
+
+UCS_TEST_P(test_ucp_proto_tune, short_thresh)
+{
+    static const size_t msg_length = 1;
+    const ucp_ep_config_t *ep_config = ucp_ep_config(sender().ep());
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    const ucp_memtype_thresh_t *max_short;
+    ssize_t prev_max_short;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+
+    max_short      = ucp_ep_config_key_has_tag_lane(&ep_config->key) ?
+                             &ep_config->tag.offload.max_eager_short :
+                             &ep_config->tag.max_eager_short;
+    prev_max_short = max_short->memtype_on;
+    if (prev_max_short < 0) {
+        UCS_TEST_SKIP_R("no fast-path short protocol");
+    }
+
+    /* Short sends turn out to be much slower than estimated, so the fast-path
+     * threshold is reduced together with the selection thresholds */
+    for (unsigned i = 0; i < NUM_SAMPLES; ++i) {
+        add_sample(thresh_elem, msg_length, 100.0);
+    }
+
+    EXPECT_EQ(1u, ucs_array_length(&worker()->proto_tune.retired));
+    EXPECT_LT(max_short->memtype_on, prev_max_short);
+}
+
+UCS_TEST_P(test_ucp_proto_tune, short_sample)
+{
+    static const size_t msg_length = 8;
+    const ucp_proto_threshold_elem_t *thresh_elem;
+    const ucp_proto_tune_t *tune;
+
+    thresh_elem = select_tag_send_protocol(UCS_MEMORY_TYPE_HOST, msg_length);
+    ASSERT_NE(nullptr, thresh_elem);
+    tune = &thresh_elem->proto_config.init_elem->tune;
+
+    /* Sends which complete inline on the fast path are measured as well */
+    for (unsigned i = 0; i < NUM_SAMPLES / 2; ++i) {
+        send_recv(msg_length);
+    }
+
+    EXPECT_GT(tune->count + tune->num_fits, 0u);
+}
+
+UCS_TEST_P(test_ucp_proto_tune, traffic)
+{
+    static const unsigned num_sizes = 20;
+    unsigned num_sends              = 0;
+    unsigned max_fits;
+
+    /* Recalculate thresholds while sending messages of different sizes */
+    for (unsigned pass = 0; pass < 3; ++pass) {
+        for (unsigned i = 0; i < NUM_SAMPLES * num_sizes; ++i) {
+            send_recv(ucs_min(UCS_BIT(i % num_sizes), 256 * UCS_KBYTE));
+        }
+        num_sends += NUM_SAMPLES * num_sizes;
+
+        /* Every send is sampled at most once by a protocol, and the sample
+         * window doubles with every fit, so the number of fits grows only
+         * logarithmically with the traffic */
+        max_fits = ucs_ilog2(num_sends / NUM_SAMPLES + 1);
+        for (auto init_elem : tuned_protocols()) {
+            EXPECT_LE(init_elem->tune.num_fits, max_fits)
+                    << ucp_proto_id_field(init_elem->proto_id, name);
+
+            if (init_elem->tune.corr.m != 0) {
+                EXPECT_GT(init_elem->tune.corr.m, 0);
+                EXPECT_GE(init_elem->tune.corr.c, 0);
+            }
+        }
+    }
+
+    EXPECT_LT(ucs_array_length(&worker()->proto_tune.retired),
+              (unsigned)UCP_PROTO_TUNE_MAX_RETIRED);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_tune, self, "self")
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_tune, shm, "shm")
+
+class test_ucp_proto_cache : public test_ucp_proto {
+protected:
+    virtual void init() {
+        const char *tmp_dir = getenv("TMPDIR");
+
+        m_cache_file = std::string((tmp_dir != NULL) ? tmp_dir : "/tmp") +
+                       "/gtest_ucp_proto_cache." + ucs::to_string(getpid());
+        unlink(m_cache_file.c_str());
+
+        modify_config("PROTO_CACHE_FILE", m_cache_file);
+        test_ucp_proto::init();
+    }
+
+    virtual void cleanup() {
+        test_ucp_proto::cleanup();
+        unlink(m_cache_file.c_str());
+    }
+
+    typedef std::vector<std::pair<size_t, std::string>> table_t;
+
+    khash_t(ucp_proto_select_hash) *sender_select_hash()
+    {
+        return ucs_array_elem(&sender().worker()->ep_config,
+                              sender().ep()->cfg_index).proto_select.hash;
+    }
+
+    /* Select a protocol which is not selected when the endpoint is created */
+    const ucp_proto_select_elem_t *select_tag_sync(uint64_t *key_p)
+    {
+        ucp_worker_cfg_index_t ep_cfg_index = sender().ep()->cfg_index;
+        ucp_memory_info_t mem_info          = {
+            .type    = UCS_MEMORY_TYPE_HOST,
+            .sys_dev = UCS_SYS_DEVICE_ID_UNKNOWN,
+            .flags   = UCS_MEM_FLAG_REGISTRABLE
+        };
+        ucp_proto_select_key_t key;
+
+        ucp_proto_select_param_init(&key.param, UCP_OP_ID_TAG_SEND_SYNC, 0, 0,
+                                    UCP_DATATYPE_CONTIG, &mem_info, 1);
+        *key_p = key.u64;
+        return ucp_proto_select_lookup_slow(
+                sender().worker(),
+                &ucs_array_elem(&sender().worker()->ep_config, ep_cfg_index)
+                         .proto_select,
+                0, ep_cfg_index, UCP_WORKER_CFG_INDEX_NULL, &key.param);
+    }
+
+    static table_t get_table(const ucp_proto_select_elem_t *select_elem)
+    {
+        const ucp_proto_threshold_elem_t *thresh_elem = select_elem->thresholds;
+        table_t table;
+
+        do {
+            table.emplace_back(thresh_elem->max_msg_length,
+                               thresh_elem->proto_config.proto->name);
+        } while ((thresh_elem++)->max_msg_length != SIZE_MAX);
+
+        return table;
+    }
+
+    /* Save the selections by destroying the worker */
+    void save()
+    {
+        m_entities.clear();
+        std::ifstream file(m_cache_file);
+        ASSERT_TRUE(file.good()) << m_cache_file;
+    }
+
+    void reconnect()
+    {
+        create_entity();
+        if (!is_self()) {
+            create_entity();
+        }
+        sender().connect(&receiver(), get_ep_params());
+    }
+
+    std::string m_cache_file;
+};
+
+UCS_TEST_P(test_ucp_proto_cache, load_table)
+{
+    const ucp_proto_select_elem_t *select_elem;
+    unsigned num_protocols;
+    std::set<std::string> protocols;
+    table_t table;
+    uint64_t key;
+
+    select_elem = select_tag_sync(&key);
+    ASSERT_NE(nullptr, select_elem);
+    table         = get_table(select_elem);
+    num_protocols = ucs_array_length(&select_elem->proto_init.protocols);
+
+    save();
+    reconnect();
+
+    /* The selection is built on the first lookup */
+    EXPECT_EQ(kh_end(sender_select_hash()),
+              kh_get(ucp_proto_select_hash, sender_select_hash(), key));
+
+    select_elem = select_tag_sync(&key);
+    ASSERT_NE(nullptr, select_elem);
+    EXPECT_EQ(table, get_table(select_elem));
+
+    /* Only the protocols of the saved table are probed */
+    for (auto &range : table) {
+        protocols.insert(range.second);
+    }
+
+    const ucp_proto_init_elem_t *init_elem;
+    ucs_array_for_each(init_elem, &select_elem->proto_init.protocols) {
+        EXPECT_EQ(1, protocols.count(
+                             ucp_proto_id_field(init_elem->proto_id, name)));
+    }
+    EXPECT_LE(ucs_array_length(&select_elem->proto_init.protocols),
+              num_protocols);
+}
+
+UCS_TEST_P(test_ucp_proto_cache, other_host)
+{
+    const ucp_proto_select_elem_t *select_elem;
+    std::vector<std::string> lines;
+    unsigned num_protocols;
+    std::string line;
+    uint64_t key;
+
+    select_elem = select_tag_sync(&key);
+    ASSERT_NE(nullptr, select_elem);
+    num_protocols = ucs_array_length(&select_elem->proto_init.protocols);
+
+    save();
+
+    /* Replace the host fingerprint */
+    {
+        std::ifstream file(m_cache_file);
+        while (std::getline(file, line)) {
+            lines.push_back((line.compare(0, 5, "host ") == 0) ?
+                            "host other" : line);
+        }
+    }
+    {
+        std::ofstream file(m_cache_file);
+        for (auto &l : lines) {
+            file << l << std::endl;
+        }
+    }
+
+    /* The file is ignored, so all protocols are probed */
+    reconnect();
+    select_elem = select_tag_sync(&key);
+    ASSERT_NE(nullptr, select_elem);
+    EXPECT_EQ(num_protocols,
+              ucs_array_length(&select_elem->proto_init.protocols));
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_cache, self, "self")
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_cache, shm, "shm")
+
+class test_ucp_proto_dynamic_striping : public test_ucp_proto {
+protected:
+    virtual void init() {
+        modify_config("MULTI_LANE_STRIPING", "dynamic");
+        modify_config("MAX_EAGER_LANES", "2");
+        modify_config("MAX_RNDV_LANES", "2");
+        test_ucp_proto::init();
+    }
+
+    void set_stripe_factor(double factor)
+    {
+        for (auto e : {&sender(), &receiver()}) {
+            for (ucp_rsc_index_t i = 0; i < e->worker()->num_ifaces; ++i) {
+                e->worker()->ifaces[i]->stripe_factor = factor;
+            }
+        }
+    }
+
+    void check_stripe_factor()
+    {
+        for (ucp_rsc_index_t i = 0; i < sender().worker()->num_ifaces; ++i) {
+            double factor = sender().worker()->ifaces[i]->stripe_factor;
+            EXPECT_GE(factor, UCP_PROTO_MULTI_STRIPE_FACTOR_MIN);
+            EXPECT_LE(factor, 1.0);
+        }
+    }
+
+    void reset_stripe_bytes()
+    {
+        for (auto e : {&sender(), &receiver()}) {
+            for (ucp_rsc_index_t i = 0; i < e->worker()->num_ifaces; ++i) {
+                e->worker()->ifaces[i]->stripe_bytes = 0;
+            }
+        }
+    }
+
+    /* Bytes sent on every interface, by the side which sends the data */
+    std::vector<uint64_t> stripe_bytes()
+    {
+        std::vector<uint64_t> bytes;
+
+        for (auto e : {&sender(), &receiver()}) {
+            for (ucp_rsc_index_t i = 0; i < e->worker()->num_ifaces; ++i) {
+                bytes.push_back(e->worker()->ifaces[i]->stripe_bytes);
+            }
+        }
+        return bytes;
+    }
+
+    ucp_worker_iface_t *stripe_iface(size_t index)
+    {
+        ucp_rsc_index_t num_ifaces = sender().worker()->num_ifaces;
+
+        return (index < num_ifaces) ?
+                       sender().worker()->ifaces[index] :
+                       receiver().worker()->ifaces[index - num_ifaces];
+    }
+};
+
+UCS_TEST_P(test_ucp_proto_dynamic_striping, send_recv)
+{
+    for (size_t size = 1; size <= 4 * UCS_MBYTE; size *= 4) {
+        send_recv(size);
+    }
+
+    check_stripe_factor();
+}
+
+UCS_TEST_P(test_ucp_proto_dynamic_striping, congested)
+{
+    /* Lanes start as congested and recover while sending */
+    set_stripe_factor(UCP_PROTO_MULTI_STRIPE_FACTOR_MIN);
+    for (size_t size = 1; size <= 4 * UCS_MBYTE; size *= 4) {
+        send_recv(size + 1);
+    }
+
+    check_stripe_factor();
+}
+
+UCS_TEST_P(test_ucp_proto_dynamic_striping, lane_bytes)
+{
+    static const size_t size = 4 * UCS_MBYTE;
+
+    send_recv(size);
+    reset_stripe_bytes();
+    send_recv(size);
+
+    std::vector<uint64_t> bytes = stripe_bytes();
+    uint64_t total = std::accumulate(bytes.begin(), bytes.end(), UINT64_C(0));
+    if (total == 0) {
+        UCS_TEST_SKIP_R("message is not sent by a multi-lane protocol");
+    }
+
+    /* Every byte of the message is accounted on exactly one lane */
+    EXPECT_EQ(size, total);
+    if (std::count_if(bytes.begin(), bytes.end(),
+                      [](uint64_t b) { return b > 0; }) < 2) {
+        UCS_TEST_SKIP_R("message is sent on one lane");
+    }
+
+    /* A congested lane carries a smaller part of the message */
+    size_t congested = std::max_element(bytes.begin(), bytes.end()) -
+                       bytes.begin();
+    set_stripe_factor(1.0);
+    stripe_iface(congested)->stripe_factor = UCP_PROTO_MULTI_STRIPE_FACTOR_MIN;
+    reset_stripe_bytes();
+    send_recv(size);
+
+    std::vector<uint64_t> congested_bytes = stripe_bytes();
+    EXPECT_EQ(size, std::accumulate(congested_bytes.begin(),
+                                    congested_bytes.end(), UINT64_C(0)));
+    EXPECT_LT(congested_bytes[congested], bytes[congested]);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_dynamic_striping, tcp, "tcp")
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_dynamic_striping, shm, "shm")
+
+class test_ucp_proto_rndv_compress : public test_ucp_proto {
+protected:
+    virtual void init() {
+        modify_config("RNDV_COMPRESS", "y");
+        test_ucp_proto::init();
+    }
+
+    /* Protocol which sends rendezvous data after receiving RTR without rkey */
+    std::string rndv_send_am_protocol_name(size_t msg_length)
+    {
+        ucp_worker_cfg_index_t ep_cfg_index = sender().ep()->cfg_index;
+        ucp_proto_select_param_t select_param;
+        const ucp_proto_select_elem_t *select_elem;
+        const ucp_proto_threshold_elem_t *threshold;
+
+        ucp_proto_select_param_init(&select_param, UCP_OP_ID_RNDV_SEND, 0, 0,
+                                    UCP_DATATYPE_CONTIG, &ucp_mem_info_unknown,
+                                    1);
+        select_param.mem_type = UCS_MEMORY_TYPE_HOST;
+        select_elem = ucp_proto_select_lookup_slow(
+                worker(),
+                &ucs_array_elem(&worker()->ep_config, ep_cfg_index).proto_select,
+                1, ep_cfg_index, UCP_WORKER_CFG_INDEX_NULL, &select_param);
+        if (select_elem == nullptr) {
+            return "";
+        }
+
+        threshold = ucp_proto_thresholds_search_slow(select_elem->thresholds,
+                                                     msg_length);
+        return threshold->proto_config.proto->name;
+    }
+
+    void send_recv_iov(const std::string &sbuf, size_t num_iov)
+    {
+        std::string rbuf(sbuf.size(), 0);
+        std::vector<ucp_dt_iov_t> iov(num_iov);
+        ucp_request_param_t sparam, rparam;
+        size_t offset = 0;
+
+        for (size_t i = 0; i < num_iov; ++i) {
+            iov[i].buffer = &rbuf[offset];
+            iov[i].length = (i == (num_iov - 1)) ? (rbuf.size() - offset) :
+                                                   (rbuf.size() / num_iov);
+            offset       += iov[i].length;
+        }
+
+        sparam.op_attr_mask = 0;
+        rparam.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE;
+        rparam.datatype     = ucp_dt_make_iov();
+        void *sreq = ucp_tag_send_nbx(sender().ep(), sbuf.data(), sbuf.size(),
+                                      1, &sparam);
+        void *rreq = ucp_tag_recv_nbx(receiver().worker(), iov.data(),
+                                      num_iov, 1, UINT64_MAX, &rparam);
+        ASSERT_UCS_OK(requests_wait({sreq, rreq}));
+        EXPECT_EQ(sbuf, rbuf);
+    }
+
+    static std::string compressible_buffer(size_t size)
+    {
+        static const std::string text = "compressed rendezvous protocol ";
+        std::string buffer(size, 0);
+
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = text[i % text.size()] + ((i % 1013) == 0);
+        }
+
+        return buffer;
+    }
+
+    static std::string random_buffer(size_t size)
+    {
+        std::string buffer(size, 0);
+
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = ucs::rand();
+        }
+
+        return buffer;
+    }
+};
+
+UCS_TEST_P(test_ucp_proto_rndv_compress, select, "RNDV_COMPRESS_RATIO=20",
+           "RNDV_COMPRESS_BW=100GBs")
+{
+    EXPECT_EQ("rndv/am/lz4", rndv_send_am_protocol_name(UCS_MBYTE));
+}
+
+UCS_TEST_P(test_ucp_proto_rndv_compress, no_gain, "RNDV_COMPRESS_RATIO=0.5")
+{
+    EXPECT_NE("rndv/am/lz4", rndv_send_am_protocol_name(UCS_MBYTE));
+}
+
+UCS_TEST_P(test_ucp_proto_rndv_compress, send_recv, "RNDV_COMPRESS_RATIO=20",
+           "RNDV_COMPRESS_BW=100GBs", "RNDV_THRESH=1k", "RNDV_SCHEME=am")
+{
+    for (size_t size = UCS_KBYTE; size <= 4 * UCS_MBYTE; size *= 4) {
+        UCS_TEST_MESSAGE << "size " << size;
+        send_recv_iov(compressible_buffer(size + 1), 1);
+        send_recv_iov(random_buffer(size), 1);
+        send_recv_iov(compressible_buffer(size), 3);
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_rndv_compress, tcp, "tcp")
+
 static std::ostream &operator<<(std::ostream &os, const ucp_proto_perf_t *perf)
 {
     ucs_string_buffer_t strb = UCS_STRING_BUFFER_INITIALIZER;
@@ -1257,7 +1257,8 @@ public:
 };
 
 UCS_TEST_P(test_ucp_proto_mock_gpu, cuda_managed_ppln_host_frag,
-           "RNDV_FRAG_MEM_TYPES=host", "IB_NUM_PATHS?=1", "MAX_RNDV_LANES=1")
+           "RNDV_FRAG_MEM_TYPES=host", "IB_NUM_PATHS?=1", "MAX_RNDV_LANES=1",
+           "RNDV_PIPELINE_ADAPTIVE=n")
 {
     send_recv_am(1024, UCS_MEMORY_TYPE_CUDA_MANAGED);
 
@@ -104,6 +104,212 @@ UCS_TEST_P(test_ucp_request, test_request_query)
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_request, all, "all")
 
+
+class test_ucp_send_batch : public ucp_test {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant(variants,
+                    UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_RMA);
+    }
+
+    virtual void init()
+    {
+        ucp_test::init();
+        sender().connect(&receiver(), get_ep_params());
+    }
+
+protected:
+    enum {
+        NUM_OPS  = 3 * 64,
+        MSG_SIZE = 64,
+        AM_ID    = 1
+    };
+
+    static void send_cb(void *request, ucs_status_t status, void *user_data)
+    {
+        EXPECT_UCS_OK(status);
+        *reinterpret_cast<bool*>(user_data) = true;
+    }
+
+    static ucs_status_t am_cb(void *arg, const void *header,
+                              size_t header_length, void *data, size_t length,
+                              const ucp_am_recv_param_t *param)
+    {
+        test_ucp_send_batch *self = reinterpret_cast<test_ucp_send_batch*>(arg);
+
+        EXPECT_EQ(MSG_SIZE, length);
+        mem_buffer::pattern_check(data, length, (uint64_t)AM_ID);
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+    size_t m_am_count = 0;
+};
+
+UCS_TEST_P(test_ucp_send_batch, mixed_ops)
+{
+    std::vector<char> sbuf(MSG_SIZE), am_buf(MSG_SIZE);
+    std::vector<std::vector<char>> rbufs(NUM_OPS / 3,
+                                         std::vector<char>(MSG_SIZE));
+    mapped_buffer put_buf(MSG_SIZE * (NUM_OPS / 3), receiver());
+    ucs::handle<ucp_rkey_h> rkey = put_buf.rkey(sender());
+    std::vector<ucp_batch_op_t> ops(NUM_OPS);
+    std::vector<void*> rreqs;
+    bool completed[NUM_OPS] = {};
+    ucp_am_handler_param_t am_param;
+    ucp_request_param_t param;
+    size_t i;
+
+    am_param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                          UCP_AM_HANDLER_PARAM_FIELD_CB |
+                          UCP_AM_HANDLER_PARAM_FIELD_ARG;
+    am_param.id         = AM_ID;
+    am_param.cb         = am_cb;
+    am_param.arg        = this;
+    ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(receiver().worker(),
+                                                 &am_param));
+
+    param.op_attr_mask = 0;
+    for (i = 0; i < rbufs.size(); ++i) {
+        rreqs.push_back(ucp_tag_recv_nbx(receiver().worker(), rbufs[i].data(),
+                                         MSG_SIZE, i, UCP_TAG_MASK_FULL,
+                                         &param));
+    }
+
+    mem_buffer::pattern_fill(sbuf.data(), MSG_SIZE, 0ul);
+    mem_buffer::pattern_fill(am_buf.data(), MSG_SIZE, (uint64_t)AM_ID);
+    for (i = 0; i < NUM_OPS; ++i) {
+        ops[i].ep        = sender().ep();
+        ops[i].count     = MSG_SIZE;
+        ops[i].user_data = &completed[i];
+        switch (i % 3) {
+        case 0:
+            ops[i].type     = UCP_BATCH_OP_TAG_SEND;
+            ops[i].buffer   = sbuf.data();
+            ops[i].args.tag = i / 3;
+            break;
+        case 1:
+            ops[i].type                 = UCP_BATCH_OP_AM_SEND;
+            ops[i].buffer               = am_buf.data();
+            ops[i].args.am.id            = AM_ID;
+            ops[i].args.am.header        = NULL;
+            ops[i].args.am.header_length = 0;
+            break;
+        default:
+            ops[i].type                 = UCP_BATCH_OP_PUT;
+            ops[i].buffer               = sbuf.data();
+            ops[i].args.rma.remote_addr = (uintptr_t)put_buf.ptr() +
+                                          (MSG_SIZE * (i / 3));
+            ops[i].args.rma.rkey        = rkey;
+            break;
+        }
+    }
+
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK;
+    param.cb.send      = send_cb;
+    ASSERT_UCS_OK(ucp_send_batch_nbx(sender().worker(), ops.data(), NUM_OPS,
+                                     &param));
+
+    for (i = 0; i < NUM_OPS; ++i) {
+        ASSERT_FALSE(UCS_PTR_IS_ERR(ops[i].request));
+        if (ops[i].request != NULL) {
+            ASSERT_UCS_OK(request_wait(ops[i].request));
+            /* The callback got the user data of its own operation */
+            EXPECT_TRUE(completed[i]) << "op " << i;
+        }
+    }
+
+    requests_wait(rreqs);
+    flush_ep(sender());
+    wait_for_value(&m_am_count, (size_t)(NUM_OPS / 3));
+
+    for (i = 0; i < rbufs.size(); ++i) {
+        mem_buffer::pattern_check(rbufs[i].data(), MSG_SIZE, 0ul);
+        mem_buffer::pattern_check(UCS_PTR_BYTE_OFFSET(put_buf.ptr(),
+                                                      MSG_SIZE * i),
+                                  MSG_SIZE, 0ul);
+    }
+}
+
+UCS_TEST_P(test_ucp_send_batch, am_coalesce)
+{
+    std::vector<char> am_buf(MSG_SIZE);
+    std::vector<ucp_batch_op_t> ops(NUM_OPS);
+    ucp_am_handler_param_t am_param;
+    ucp_request_param_t param;
+    size_t i;
+
+    am_param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                          UCP_AM_HANDLER_PARAM_FIELD_CB |
+                          UCP_AM_HANDLER_PARAM_FIELD_ARG;
+    am_param.id         = AM_ID;
+    am_param.cb         = am_cb;
+    am_param.arg        = this;
+    ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(receiver().worker(),
+                                                 &am_param));
+
+    mem_buffer::pattern_fill(am_buf.data(), MSG_SIZE, (uint64_t)AM_ID);
+    for (i = 0; i < NUM_OPS; ++i) {
+        ops[i].type                  = UCP_BATCH_OP_AM_SEND;
+        ops[i].ep                    = sender().ep();
+        ops[i].buffer                = am_buf.data();
+        ops[i].count                 = MSG_SIZE;
+        ops[i].args.am.id            = AM_ID;
+        ops[i].args.am.header        = NULL;
+        ops[i].args.am.header_length = 0;
+        ops[i].user_data             = NULL;
+    }
+
+    param.op_attr_mask = 0;
+    ASSERT_UCS_OK(ucp_send_batch_nbx(sender().worker(), ops.data(), NUM_OPS,
+                                     &param));
+
+    /* Small messages are packed to frames, so they complete immediately, and
+     * no frame is left behind when the batch is submitted */
+    for (i = 0; i < NUM_OPS; ++i) {
+        EXPECT_EQ(NULL, ops[i].request) << "op " << i;
+    }
+    EXPECT_TRUE(ucs_list_is_empty(&sender().worker()->am.coalesce_frames));
+
+    wait_for_value(&m_am_count, (size_t)NUM_OPS);
+    EXPECT_EQ(NUM_OPS, m_am_count);
+}
+
+UCS_TEST_P(test_ucp_send_batch, invalid_op)
+{
+    std::vector<char> sbuf(MSG_SIZE);
+    ucp_request_param_t param;
+    ucp_batch_op_t ops[2];
+
+    ops[0].type      = (ucp_batch_op_type_t)-1;
+    ops[0].ep        = sender().ep();
+    ops[1].type      = UCP_BATCH_OP_TAG_SEND;
+    ops[1].ep        = sender().ep();
+    ops[1].buffer    = sbuf.data();
+    ops[1].count     = MSG_SIZE;
+    ops[1].args.tag  = 0;
+    ops[1].user_data = NULL;
+
+    param.op_attr_mask = 0;
+    {
+        scoped_log_handler wrap_err(wrap_errors_logger);
+        EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+                  ucp_send_batch_nbx(sender().worker(), ops, 2, &param));
+    }
+
+    /* The valid operation is submitted anyway */
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, UCS_PTR_STATUS(ops[0].request));
+    ASSERT_FALSE(UCS_PTR_IS_ERR(ops[1].request));
+
+    std::vector<char> rbuf(MSG_SIZE);
+    request_wait(ucp_tag_recv_nbx(receiver().worker(), rbuf.data(), MSG_SIZE,
+                                  0, UCP_TAG_MASK_FULL, &param));
+    request_wait(ops[1].request);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_send_batch)
+
 class test_proto_reset : public ucp_test {
 public:
     typedef enum {
@@ -1175,6 +1175,63 @@ UCS_TEST_SKIP_COND_P(test_ucp_sockaddr, reject, nonparameterized_test()) {
     listen_and_reject(false);
 }
 
+UCS_TEST_P(test_ucp_sockaddr, accept_multiple_clients) {
+    const int num_clients = 4;
+    ucp_worker_h server_worker;
+    uint64_t select_hits;
+
+    listen(cb_type());
+    server_worker = receiver().worker();
+    select_hits   = server_worker->counters.lanes_select_cache_hits;
+
+    {
+        scoped_log_handler slh(detect_error_logger);
+        for (int i = 0; i < num_clients; ++i) {
+            client_ep_connect(i);
+        }
+
+        wait_progress([this, num_clients]() {
+            return (receiver().get_num_eps() == num_clients) ||
+                   (sender().get_err_num() > 0);
+        });
+        if (receiver().get_num_eps() < num_clients) {
+            UCS_TEST_SKIP_R("cannot connect to server");
+        }
+    }
+
+    /* The clients are equal, so the next server endpoints reuse the lanes
+     * selection and the packed address of the first one */
+    EXPECT_GE(server_worker->counters.lanes_select_cache_hits - select_hits,
+              num_clients - 1);
+    if (ucp_ep_config(receiver().ep())->p2p_lanes == 0) {
+        EXPECT_EQ(num_clients - 1,
+                  server_worker->counters.cm_server_addr_reuses);
+    }
+
+    /* Close all connections from both sides, since the entities expect an
+     * error from a single endpoint during the teardown */
+    std::vector<void*> close_reqs;
+    for (int i = 0; i < num_clients; ++i) {
+        close_reqs.push_back(sender().disconnect_nb(0, i, 0));
+        close_reqs.push_back(receiver().disconnect_nb(0, i, 0));
+    }
+
+    scoped_log_handler slh(detect_error_logger);
+    wait_progress([&close_reqs]() {
+        for (void *req : close_reqs) {
+            if (!is_request_completed(req)) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    for (int i = 0; i < num_clients; ++i) {
+        sender().close_ep_req_free(close_reqs[2 * i]);
+        receiver().close_ep_req_free(close_reqs[(2 * i) + 1]);
+    }
+}
+
 UCS_TEST_P(test_ucp_sockaddr, listener_query) {
     ucp_listener_attr_t listener_attr;
     ucs_status_t status;
@@ -127,6 +127,8 @@ public:
     void test_xfer_contig(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_generic(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_iov(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_strided(size_t size, bool expected, bool sync,
+                           bool truncated);
     void test_xfer_generic_err(size_t size, bool expected, bool sync, bool truncated);
 
 protected:
@@ -446,6 +448,54 @@ void test_ucp_tag_xfer::test_xfer_iov(size_t size, bool expected, bool sync,
                                "IOV"));
 }
 
+void test_ucp_tag_xfer::test_xfer_strided(size_t size, bool expected,
+                                          bool sync, bool truncated)
+{
+    /* Both layouts pack 180 bytes per element, but with different geometry */
+    static const ucp_dt_strided_params_t send_params = {
+        UCP_DT_STRIDED_PARAM_FIELD_BLOCK_SIZE | UCP_DT_STRIDED_PARAM_FIELD_DIMS,
+        12, 2, {{5, 20}, {3, 128}}
+    };
+    static const ucp_dt_strided_params_t recv_params = {
+        UCP_DT_STRIDED_PARAM_FIELD_BLOCK_SIZE | UCP_DT_STRIDED_PARAM_FIELD_DIMS,
+        9, 3, {{4, 16}, {5, 80}, {1, 400}}
+    };
+    const size_t count = size / 180;
+    ucp_datatype_t send_dt, recv_dt;
+
+    ASSERT_UCS_OK(ucp_dt_create_strided(&send_params, &send_dt));
+    ASSERT_UCS_OK(ucp_dt_create_strided(&recv_params, &recv_dt));
+
+    std::vector<char> sendbuf(count * ucp::dt_strided_extent(send_params), 0);
+    std::vector<char> recvbuf(count * ucp::dt_strided_extent(recv_params), 0);
+    ucs::fill_random(sendbuf);
+
+    size_t recvd = do_xfer(sendbuf.data(), recvbuf.data(), count, send_dt,
+                           recv_dt, expected, sync, truncated);
+    ASSERT_EQ(count * 180, recvd);
+
+    std::vector<size_t> send_offsets =
+            ucp::dt_strided_block_offsets(send_params, count);
+    std::vector<size_t> recv_offsets =
+            ucp::dt_strided_block_offsets(recv_params, count);
+    std::vector<char> sent, received;
+    for (size_t offset : send_offsets) {
+        sent.insert(sent.end(), sendbuf.begin() + offset,
+                    sendbuf.begin() + offset + send_params.block_size);
+    }
+    for (size_t offset : recv_offsets) {
+        received.insert(received.end(), recvbuf.begin() + offset,
+                        recvbuf.begin() + offset + recv_params.block_size);
+    }
+
+    EXPECT_TRUE(!check_buffers(sent, received, recvd, send_offsets.size(),
+                               recv_offsets.size(), size, expected, sync,
+                               "strided"));
+
+    ucp_dt_destroy(send_dt);
+    ucp_dt_destroy(recv_dt);
+}
+
 void test_ucp_tag_xfer::test_xfer_generic_err(size_t size, bool expected,
                                               bool sync, bool truncated)
 {
@@ -640,6 +690,22 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_exp_truncated) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_iov, true, false, true);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp) {
+    if (!is_proto_enabled()) {
+        UCS_TEST_SKIP_R("strided datatype requires proto v2");
+    }
+
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_unexp) {
+    if (!is_proto_enabled()) {
+        UCS_TEST_SKIP_R("strided datatype requires proto v2");
+    }
+
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, false, false, false);
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, iov_unexp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_iov, false, false, false);
 }
@@ -1093,6 +1159,19 @@ public:
         EXPECT_EQ(1ul, cnt) << "RX counter";
     }
 
+    void validate_latency(unsigned lat_index) {
+        if (!is_proto_enabled()) {
+            return;
+        }
+
+        for (unsigned i = 0; i < UCP_EP_STAT_LAT_LAST; ++i) {
+            uint64_t count = ucs_stats_histogram_count(
+                    ucs_stats_node_histogram(ep_stats(sender()), i));
+            EXPECT_EQ((i == lat_index) ? 1ul : 0ul, count)
+                    << ep_stats(sender())->cls->histogram_names[i];
+        }
+    }
+
     bool has_xpmem() {
         return ucp_context_find_tl_md(receiver().ucph(), "xpmem") != NULL;
     }
@@ -1197,6 +1276,7 @@ UCS_TEST_P(test_ucp_tag_stats, rndv_expected, "RNDV_THRESH=1000") {
     test_run_xfer(true, true, true, false, false);
     validate_counters(UCP_EP_STAT_TAG_TX_RNDV, UCP_WORKER_STAT_RNDV_RX_EXP);
     validate_rndv_counters();
+    validate_latency(UCP_EP_STAT_LAT_RNDV);
 }
 
 UCS_TEST_P(test_ucp_tag_stats, rndv_unexpected, "RNDV_THRESH=1000") {
@@ -1204,6 +1284,7 @@ UCS_TEST_P(test_ucp_tag_stats, rndv_unexpected, "RNDV_THRESH=1000") {
     test_run_xfer(true, true, false, false, false);
     validate_counters(UCP_EP_STAT_TAG_TX_RNDV, UCP_WORKER_STAT_RNDV_RX_UNEXP);
     validate_rndv_counters();
+    validate_latency(UCP_EP_STAT_LAT_RNDV);
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_stats)
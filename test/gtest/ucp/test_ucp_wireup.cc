@@ -17,6 +17,7 @@
 
 extern "C" {
 #include <ucp/wireup/address.h>
+#include <ucp/wireup/lazy_ep.h>
 #include <ucp/wireup/wireup.h>
 #include <ucp/wireup/wireup_cm.h>
 #include <ucp/wireup/wireup_ep.h>
@@ -568,6 +569,136 @@ UCS_TEST_P(test_ucp_wireup_1sided, empty_address) {
     ucs_free(buffer);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address) {
+    if (address_version() != UCP_OBJECT_VERSION_V2) {
+        UCS_TEST_SKIP_R("compact address requires address version 2");
+    }
+
+    ucp_worker_attr_t attr;
+    attr.field_mask    = UCP_WORKER_ATTR_FIELD_ADDRESS |
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS;
+    attr.address_flags = UCP_WORKER_ADDRESS_FLAG_COMPACT;
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        EXPECT_EQ(UCS_ERR_NO_ELEM, ucp_worker_query(receiver().worker(), &attr));
+    }
+
+    /* Use the sender address as the template of the receiver address */
+    ucp_address_t *tmpl, *address;
+    size_t tmpl_length, address_length;
+    ASSERT_UCS_OK(ucp_worker_get_address(sender().worker(), &tmpl,
+                                         &tmpl_length));
+    ASSERT_UCS_OK(ucp_worker_get_address(receiver().worker(), &address,
+                                         &address_length));
+    ASSERT_UCS_OK(ucp_worker_set_address_template(sender().worker(), tmpl,
+                                                  tmpl_length));
+    ASSERT_UCS_OK(ucp_worker_set_address_template(receiver().worker(), tmpl,
+                                                  tmpl_length));
+
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+    UCS_TEST_MESSAGE << "full address " << address_length << " bytes, compact "
+                     << attr.address_length << " bytes";
+    EXPECT_LT(attr.address_length, address_length);
+    EXPECT_EQ(receiver().worker()->uuid,
+              ucp_address_get_uuid(attr.address));
+
+    unsigned unpack_flags = ucp_worker_default_address_pack_flags(
+                                    sender().worker());
+    ucp_unpacked_address_t full_unpacked, compact_unpacked;
+    ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), address, unpack_flags,
+                                     &full_unpacked));
+    ASSERT_UCS_OK(ucp_address_unpack(sender().worker(), attr.address,
+                                     unpack_flags, &compact_unpacked));
+    EXPECT_EQ(full_unpacked.uuid, compact_unpacked.uuid);
+    EXPECT_EQ(std::string(full_unpacked.name),
+              std::string(compact_unpacked.name));
+    ASSERT_EQ(full_unpacked.address_count, compact_unpacked.address_count);
+    for (unsigned i = 0; i < full_unpacked.address_count; ++i) {
+        const ucp_address_entry_t &ae1 = full_unpacked.address_list[i];
+        const ucp_address_entry_t &ae2 = compact_unpacked.address_list[i];
+        EXPECT_EQ(ae1.tl_name_csum, ae2.tl_name_csum);
+        EXPECT_EQ(ae1.md_index, ae2.md_index);
+        ASSERT_EQ(ae1.dev_addr_len, ae2.dev_addr_len);
+        ASSERT_EQ(ae1.iface_addr_len, ae2.iface_addr_len);
+        EXPECT_EQ(0, memcmp(ae1.dev_addr, ae2.dev_addr, ae1.dev_addr_len));
+        EXPECT_EQ(0, memcmp(ae1.iface_addr, ae2.iface_addr,
+                            ae1.iface_addr_len));
+    }
+
+    ucs_free(full_unpacked.address_list);
+    ucs_free(compact_unpacked.address_list);
+    ucp_worker_release_address(receiver().worker(), address);
+    ucp_worker_release_address(sender().worker(), tmpl);
+
+    /* Connect to the compact address */
+    ucp_ep_params_t ep_params = get_ep_params();
+    ep_params.field_mask     |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address         = attr.address;
+    ucp_ep_h ep;
+    ASSERT_UCS_OK(ucp_ep_create(sender().worker(), &ep_params, &ep));
+    ucp_worker_release_address(receiver().worker(), attr.address);
+
+    send_recv(ep, receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+    disconnect(ep);
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address_mismatch) {
+    skip_loopback();
+    if (address_version() != UCP_OBJECT_VERSION_V2) {
+        UCS_TEST_SKIP_R("compact address requires address version 2");
+    }
+
+    ucp_address_t *tmpl;
+    size_t tmpl_length;
+    ASSERT_UCS_OK(ucp_worker_get_address(sender().worker(), &tmpl,
+                                         &tmpl_length));
+    ASSERT_UCS_OK(ucp_worker_set_address_template(receiver().worker(), tmpl,
+                                                  tmpl_length));
+
+    ucp_worker_attr_t attr;
+    attr.field_mask    = UCP_WORKER_ATTR_FIELD_ADDRESS |
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS;
+    attr.address_flags = UCP_WORKER_ADDRESS_FLAG_COMPACT;
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+
+    {
+        scoped_log_handler slh(hide_errors_logger);
+
+        /* A compact address can not be a template */
+        EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+                  ucp_worker_set_address_template(sender().worker(),
+                                                  attr.address,
+                                                  attr.address_length));
+
+        /* The sender has no template */
+        ucp_unpacked_address_t unpacked;
+        EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+                  ucp_address_unpack(sender().worker(), attr.address,
+                                     ucp_worker_default_address_pack_flags(
+                                             sender().worker()),
+                                     &unpacked));
+
+        /* The sender has a different template */
+        ucp_address_t *other_tmpl;
+        size_t other_tmpl_length;
+        ASSERT_UCS_OK(ucp_worker_get_address(receiver().worker(), &other_tmpl,
+                                             &other_tmpl_length));
+        ASSERT_UCS_OK(ucp_worker_set_address_template(sender().worker(),
+                                                      other_tmpl,
+                                                      other_tmpl_length));
+        ucp_worker_release_address(receiver().worker(), other_tmpl);
+        EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+                  ucp_address_unpack(sender().worker(), attr.address,
+                                     ucp_worker_default_address_pack_flags(
+                                             sender().worker()),
+                                     &unpacked));
+    }
+
+    ucp_worker_release_address(receiver().worker(), attr.address);
+    ucp_worker_release_address(sender().worker(), tmpl);
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, one_sided_wireup) {
     sender().connect(&receiver(), get_ep_params());
     send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
@@ -760,6 +891,77 @@ UCS_TEST_P(test_ucp_wireup_1sided, multi_ep_1sided) {
     }
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, bulk_connect) {
+    const unsigned count = 10;
+    std::vector<ucp_ep_params_t> ep_params(count, get_ep_params());
+    std::vector<ucp_ep_h> eps(count);
+    std::vector<void*> reqs;
+    ucp_request_param_t param;
+    ucp_address_t *address;
+    size_t address_length;
+    void *req;
+
+    ASSERT_UCS_OK(ucp_worker_get_address(receiver().worker(), &address,
+                                         &address_length));
+    for (auto &ep_param : ep_params) {
+        ep_param.field_mask |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+        ep_param.address     = address;
+    }
+
+    param.op_attr_mask = 0;
+    {
+        scoped_log_handler slh(hide_errors_logger);
+        req = ucp_ep_create_bulk_nbx(sender().worker(), &ep_params[0], count,
+                                     &eps[0], &param);
+    }
+    ucp_worker_release_address(receiver().worker(), address);
+
+    if (UCS_PTR_STATUS(req) == UCS_ERR_UNREACHABLE) {
+        UCS_TEST_SKIP_R("Unreachable");
+    }
+
+    /* All the endpoints are connected when the request is completed */
+    ASSERT_UCS_OK(request_wait(req));
+    for (unsigned i = 0; i < count; ++i) {
+        EXPECT_TRUE(eps[i]->flags & UCP_EP_FLAG_LOCAL_CONNECTED);
+        EXPECT_EQ(eps[0]->cfg_index, eps[i]->cfg_index);
+        send_recv(eps[i], receiver().worker(), receiver().ep(), 8, 1);
+    }
+
+    for (auto ep : eps) {
+        reqs.push_back(ucp_ep_close_nbx(ep, &param));
+    }
+    requests_wait(reqs);
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_wireup_1sided, select_cache, is_self()) {
+    entity *other = create_entity();
+    uint64_t hits;
+
+    sender().connect(&receiver(), get_ep_params());
+    hits = sender().worker()->counters.lanes_select_cache_hits;
+
+    /* A peer with the same configuration reuses the lanes selection */
+    sender().connect(other, get_ep_params(), 1);
+    EXPECT_GT(sender().worker()->counters.lanes_select_cache_hits, hits);
+    EXPECT_EQ(sender().ep()->cfg_index, sender().ep(0, 1)->cfg_index);
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 8, 1);
+    send_recv(sender().ep(0, 1), other->worker(), other->ep(), 8, 1);
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_wireup_1sided, select_cache_disable, is_self(),
+                     "WIREUP_SELECT_CACHE=n") {
+    entity *other = create_entity();
+
+    sender().connect(&receiver(), get_ep_params());
+    sender().connect(other, get_ep_params(), 1);
+    EXPECT_EQ(0u, sender().worker()->counters.lanes_select_cache_hits);
+    EXPECT_EQ(sender().ep()->cfg_index, sender().ep(0, 1)->cfg_index);
+
+    send_recv(sender().ep(0, 1), other->worker(), other->ep(), 8, 1);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_1sided)
 
 class test_ucp_wireup_2sided : public test_ucp_wireup {
@@ -846,6 +1048,88 @@ UCS_TEST_P(test_ucp_wireup_2sided, no_loopback_with_delay) {
     test_connect_loopback(true, false);
 }
 
+UCS_TEST_P(test_ucp_wireup_2sided, lazy_connect) {
+    ucp_ep_params_t params = get_ep_params();
+    params.field_mask     |= UCP_EP_PARAM_FIELD_FLAGS;
+    params.flags          |= UCP_EP_PARAMS_FLAGS_LAZY_CONNECT;
+
+    sender().connect(&receiver(), params);
+    if (!is_loopback()) {
+        receiver().connect(&sender(), params);
+    }
+
+    /* No lanes are created until the first operation */
+    ASSERT_TRUE(sender().ep()->flags & UCP_EP_FLAG_LAZY);
+    EXPECT_EQ(1, ucp_ep_num_lanes(sender().ep()));
+    short_progress_loop();
+    EXPECT_TRUE(sender().ep()->flags & UCP_EP_FLAG_LAZY);
+    EXPECT_TRUE(receiver().ep()->flags & UCP_EP_FLAG_LAZY);
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+    EXPECT_FALSE(sender().ep()->flags & UCP_EP_FLAG_LAZY);
+
+    /* The receiver endpoint is connected either by a wireup request from the
+     * sender, or by its own first operation */
+    send_recv(receiver().ep(), sender().worker(), sender().ep(), 1, 1);
+    flush_worker(receiver());
+    EXPECT_FALSE(receiver().ep()->flags & UCP_EP_FLAG_LAZY);
+}
+
+UCS_TEST_P(test_ucp_wireup_2sided, lazy_connect_close) {
+    ucp_ep_params_t params = get_ep_params();
+    params.field_mask     |= UCP_EP_PARAM_FIELD_FLAGS;
+    params.flags          |= UCP_EP_PARAMS_FLAGS_LAZY_CONNECT;
+
+    sender().connect(&receiver(), params);
+    ASSERT_TRUE(sender().ep()->flags & UCP_EP_FLAG_LAZY);
+
+    /* An unused lazy endpoint is flushed and closed without connecting */
+    flush_worker(sender());
+    disconnect(sender());
+    short_progress_loop();
+    EXPECT_EQ(0u, receiver().worker()->num_all_eps);
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_wireup_2sided, lazy_connect_rma,
+                     !(get_variant_value() & TEST_RMA)) {
+    ucp_ep_params_t params = get_ep_params();
+    params.field_mask     |= UCP_EP_PARAM_FIELD_FLAGS;
+    params.flags          |= UCP_EP_PARAMS_FLAGS_LAZY_CONNECT;
+
+    sender().connect(&receiver(), params);
+    if (!is_loopback()) {
+        receiver().connect(&sender(), params);
+    }
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+    ASSERT_FALSE(sender().ep()->flags & UCP_EP_FLAG_LAZY);
+
+    /* Only RMA lanes, which are not needed for the wireup, are still lazy */
+    ucp_ep_h ep                     = sender().ep();
+    const ucp_ep_config_key_t &key  = ucp_ep_config(ep)->key;
+    ucp_lane_map_t lazy_lanes       = 0;
+    for (ucp_lane_index_t lane = 0; lane < key.num_lanes; ++lane) {
+        if (ucp_lazy_ep_test(ucp_ep_get_lane(ep, lane))) {
+            EXPECT_NE(key.am_lane, lane);
+            EXPECT_NE(key.wireup_msg_lane, lane);
+            EXPECT_NE(key.keepalive_lane, lane);
+            lazy_lanes |= UCS_BIT(lane);
+        }
+    }
+
+    /* Large transfers connect the lazy lanes they use on demand */
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(),
+              BUFFER_LENGTH, 1);
+    flush_worker(sender());
+    for (ucp_lane_index_t lane = 0; lane < key.num_lanes; ++lane) {
+        if (ucp_lazy_ep_test(ucp_ep_get_lane(ep, lane))) {
+            EXPECT_TRUE(lazy_lanes & UCS_BIT(lane)) << "lane " << (int)lane;
+        }
+    }
+}
+
 UCS_TEST_SKIP_COND_P(test_ucp_wireup_2sided, async_connect,
                      !(get_variant_ctx_params().features & UCP_FEATURE_TAG)) {
     sender().connect(&receiver(), get_ep_params());
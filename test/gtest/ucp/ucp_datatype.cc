@@ -246,6 +246,40 @@ std::string datatype_name(ucp_datatype_t dt)
     return ucp_datatype_class_names[ucp_datatype_class(dt)];
 }
 
+std::vector<size_t>
+dt_strided_block_offsets(const ucp_dt_strided_params_t &params, size_t count)
+{
+    size_t counts[UCP_DT_STRIDED_MAX_DIMS]  = {1, 1, 1};
+    size_t strides[UCP_DT_STRIDED_MAX_DIMS] = {0, 0, 0};
+    std::vector<size_t> offsets;
+
+    for (unsigned dim = 0; dim < params.num_dims; ++dim) {
+        counts[dim]  = params.dims[dim].count;
+        strides[dim] = params.dims[dim].stride;
+    }
+
+    for (size_t elem = 0; elem < count; ++elem) {
+        for (size_t k = 0; k < counts[2]; ++k) {
+            for (size_t j = 0; j < counts[1]; ++j) {
+                for (size_t i = 0; i < counts[0]; ++i) {
+                    offsets.push_back((elem * dt_strided_extent(params)) +
+                                      (k * strides[2]) + (j * strides[1]) +
+                                      (i * strides[0]));
+                }
+            }
+        }
+    }
+
+    return offsets;
+}
+
+size_t dt_strided_extent(const ucp_dt_strided_params_t &params)
+{
+    const ucp_dt_strided_dim_t &outer = params.dims[params.num_dims - 1];
+
+    return outer.count * outer.stride;
+}
+
 std::vector<std::vector<ucp_datatype_t> >
 datatype_pairs(const ucp_generic_dt_ops_t *ops, size_t contig_elem_size)
 {
@@ -122,6 +122,13 @@ datatype_pairs(const ucp_generic_dt_ops_t *ops, size_t contig_elem_size = 1);
 
 std::string datatype_name(ucp_datatype_t dt);
 
+/* Offsets of the blocks of a strided layout, in packed order */
+std::vector<size_t>
+dt_strided_block_offsets(const ucp_dt_strided_params_t &params, size_t count);
+
+/* Extent of one element of a strided layout */
+size_t dt_strided_extent(const ucp_dt_strided_params_t &params);
+
 extern int dt_gen_start_count;
 extern int dt_gen_finish_count;
 extern ucp_generic_dt_ops test_dt_uint32_ops;
@@ -7,6 +7,7 @@
 #include <common/test.h>
 extern "C" {
 #include <ucs/algorithm/crc.h>
+#include <ucs/algorithm/lz4.h>
 #include <ucs/algorithm/qsort_r.h>
 #include <ucs/algorithm/string_distance.h>
 }
@@ -27,6 +28,36 @@ protected:
     }
 
     static void *MAGIC;
+
+    static void lz4_check(const std::vector<uint8_t> &data,
+                          bool expect_compressed)
+    {
+        std::vector<uint8_t> comp(UCS_LZ4_COMPRESS_BOUND(data.size()));
+        std::vector<uint8_t> decomp(data.size() + 1);
+        size_t comp_length, decomp_length;
+        ucs_status_t status;
+
+        comp_length = ucs_lz4_compress(data.data(), data.size(), comp.data(),
+                                       comp.size());
+        ASSERT_GT(comp_length, 0u);
+        if (expect_compressed) {
+            EXPECT_LT(comp_length, data.size() / 2);
+        }
+
+        status = ucs_lz4_decompress(comp.data(), comp_length, decomp.data(),
+                                    decomp.size(), &decomp_length);
+        ASSERT_UCS_OK(status);
+        ASSERT_EQ(data.size(), decomp_length);
+        decomp.resize(decomp_length);
+        EXPECT_EQ(data, decomp);
+
+        if (!data.empty()) {
+            /* Too small output buffer */
+            status = ucs_lz4_decompress(comp.data(), comp_length, decomp.data(),
+                                        data.size() - 1, &decomp_length);
+            EXPECT_EQ(UCS_ERR_MESSAGE_TRUNCATED, status);
+        }
+    }
 };
 
 void *test_algorithm::MAGIC = (void*)0xdeadbeef1ee7a880ull;
@@ -155,3 +186,89 @@ UCS_TEST_F(test_algorithm, string_distance) {
     EXPECT_EQ(4u, ucs_string_distance("aabbccddeeff", "ababccdgedeff"));
     EXPECT_EQ(6u, ucs_string_distance("aabbccddeeff", "aagbbhddefefii"));
 }
+
+UCS_TEST_F(test_algorithm, lz4) {
+    static const size_t sizes[] = {0, 1, 12, 13, 100, 4096, 65536 + 1000,
+                                   300000};
+    static const std::string text = "The quick brown fox jumps over the "
+                                    "lazy dog. ";
+
+    for (size_t i = 0; i < ucs_static_array_size(sizes); ++i) {
+        size_t size = sizes[i];
+        std::vector<uint8_t> data(size);
+        UCS_TEST_MESSAGE << "size " << size;
+
+        /* Constant */
+        std::fill(data.begin(), data.end(), 0x5a);
+        lz4_check(data, size > 100);
+
+        /* Repeating text with small changes */
+        for (size_t j = 0; j < size; ++j) {
+            data[j] = text[j % text.size()] + ((j % 997) == 0);
+        }
+        lz4_check(data, size > 100);
+
+        /* Short-range repetitions of random values */
+        for (size_t j = 0; j < size; ++j) {
+            data[j] = (j % 64 < 32) ? ucs::rand() : data[j - (j % 64) + 32];
+        }
+        lz4_check(data, false);
+
+        /* Random */
+        for (size_t j = 0; j < size; ++j) {
+            data[j] = ucs::rand();
+        }
+        lz4_check(data, false);
+    }
+}
+
+UCS_TEST_F(test_algorithm, lz4_incompressible) {
+    std::vector<uint8_t> data(8192), comp(data.size());
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = ucs::rand();
+    }
+
+    /* Does not fit in the original size */
+    EXPECT_EQ(0u, ucs_lz4_compress(data.data(), data.size(), comp.data(),
+                                   comp.size()));
+}
+
+UCS_TEST_F(test_algorithm, lz4_corrupted) {
+    std::vector<uint8_t> data(10000), comp(UCS_LZ4_COMPRESS_BOUND(data.size()));
+    std::vector<uint8_t> decomp(data.size());
+    size_t comp_length, decomp_length;
+    ucs_status_t status;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = "abcdefgh"[(i / 3) % 8];
+    }
+
+    comp_length = ucs_lz4_compress(data.data(), data.size(), comp.data(),
+                                   comp.size());
+    ASSERT_GT(comp_length, 0u);
+
+    /* Truncated input */
+    for (size_t length = 1; length < comp_length; ++length) {
+        status = ucs_lz4_decompress(comp.data(), length, decomp.data(),
+                                    decomp.size(), &decomp_length);
+        if (status == UCS_OK) {
+            EXPECT_LT(decomp_length, data.size());
+        }
+    }
+
+    /* Match offset before the start of the output */
+    const uint8_t bad_offset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+    status = ucs_lz4_decompress(bad_offset, sizeof(bad_offset), decomp.data(),
+                                decomp.size(), &decomp_length);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, status);
+
+    /* Random garbage must not crash */
+    for (int iter = 0; iter < 1000; ++iter) {
+        for (size_t i = 0; i < comp_length; ++i) {
+            comp[i] = ucs::rand();
+        }
+        ucs_lz4_decompress(comp.data(), comp_length, decomp.data(),
+                           decomp.size(), &decomp_length);
+    }
+}
@@ -427,6 +427,57 @@ UCS_TEST_P(test_memtype_cache, merge_regions_by_mem_flags) {
     ucs_memtype_cache_remove(base, total_size);
 }
 
+UCS_TEST_P(test_memtype_cache, fast_lookup_overflow) {
+    const size_t region_size = UCS_PGT_ADDR_ALIGN;
+    const unsigned count     = 2 * UCS_MEMTYPE_CACHE_FAST_REGIONS_MAX;
+    void *base               = reinterpret_cast<void*>(0x7f6ef0000000);
+    ucs_memory_type_t mem_type;
+    ucs_memory_info_t mem_info;
+    void *ptr;
+
+    if (GetParam() == UCS_MEMORY_TYPE_HOST) {
+        UCS_TEST_SKIP_R("memtype cache does not store host memory");
+    }
+
+    mem_type = GetParam();
+
+    ucs_memtype_cache_remove(base, 2 * count * region_size);
+
+    /* Insert non-adjacent regions, so they are not merged, until the number
+     * of regions exceeds the lock-free lookup array size */
+    for (unsigned i = 0; i < count; ++i) {
+        ptr = UCS_PTR_BYTE_OFFSET(base, 2 * i * region_size);
+        ucs_memtype_cache_update(ptr, region_size, mem_type,
+                                 UCS_SYS_DEVICE_ID_UNKNOWN, 0);
+    }
+
+    for (unsigned i = 0; i < count; ++i) {
+        ptr = UCS_PTR_BYTE_OFFSET(base, 2 * i * region_size);
+        ASSERT_UCS_OK(ucs_memtype_cache_lookup(ptr, region_size, &mem_info));
+        EXPECT_EQ(mem_type, mem_info.type);
+        EXPECT_EQ(ptr, mem_info.base_address);
+        EXPECT_EQ(UCS_ERR_NO_ELEM,
+                  ucs_memtype_cache_lookup(UCS_PTR_BYTE_OFFSET(ptr,
+                                                               region_size),
+                                           1, &mem_info));
+    }
+
+    /* Remove most of the regions, so the lookup array is used again */
+    for (unsigned i = 1; i < count; ++i) {
+        ptr = UCS_PTR_BYTE_OFFSET(base, 2 * i * region_size);
+        ucs_memtype_cache_remove(ptr, region_size);
+        EXPECT_EQ(UCS_ERR_NO_ELEM,
+                  ucs_memtype_cache_lookup(ptr, 1, &mem_info));
+    }
+
+    ASSERT_UCS_OK(ucs_memtype_cache_lookup(base, region_size, &mem_info));
+    EXPECT_EQ(mem_type, mem_info.type);
+    EXPECT_EQ(base, mem_info.base_address);
+
+    ucs_memtype_cache_remove(base, 2 * count * region_size);
+    EXPECT_EQ(UCS_ERR_NO_ELEM, ucs_memtype_cache_lookup(base, 1, &mem_info));
+}
+
 UCS_TEST_P(test_memtype_cache, shared_page_regions) {
     const size_t size = 1000000;
 
@@ -32,6 +32,7 @@ public:
         ucs_profile_init(ucs_global_opts.profile_mode,
                          ucs_global_opts.profile_file,
                          ucs_global_opts.profile_log_size,
+                         ucs_global_opts.profile_sample_rate,
                          &ucs_profile_default_ctx);
         ucp_config_release(config);
     }
@@ -51,6 +52,7 @@ public:
         ucs_profile_init(ucs_global_opts.profile_mode,
                          ucs_global_opts.profile_file,
                          ucs_global_opts.profile_log_size,
+                         ucs_global_opts.profile_sample_rate,
                          &ucs_profile_default_ctx);
     }
 
@@ -109,7 +111,8 @@ protected:
 
     void test_env(const void **ptr, const ucs_profile_block_header_t &env_vars);
 
-    void do_test(unsigned int_mode, const std::string &str_mode);
+    void do_test(unsigned int_mode, const std::string &str_mode,
+                 unsigned num_records_per_iter = NUM_LOCAITONS);
 };
 
 static int sum(int a, int b)
@@ -300,13 +303,16 @@ void test_profile::test_env(const void **ptr,
     *ptr = UCS_PTR_BYTE_OFFSET(*ptr, env_vars.size);
 }
 
-void test_profile::do_test(unsigned int_mode, const std::string& str_mode)
+void test_profile::do_test(unsigned int_mode, const std::string& str_mode,
+                           unsigned num_records_per_iter)
 {
     const int ITER           = 5;
+    const unsigned log_mask  = UCS_BIT(UCS_PROFILE_MODE_LOG) |
+                               UCS_BIT(UCS_PROFILE_MODE_RING);
     uint64_t exp_count       = (int_mode & UCS_BIT(UCS_PROFILE_MODE_ACCUM)) ?
                                ITER : 0;
-    uint64_t exp_num_records = (int_mode & UCS_BIT(UCS_PROFILE_MODE_LOG)) ?
-                               (NUM_LOCAITONS * ITER) : 0;
+    uint64_t exp_num_records = (int_mode & log_mask) ?
+                               (num_records_per_iter * ITER) : 0;
 
 
     scoped_profile p(*this, PROFILE_FILENAME, str_mode.c_str());
@@ -354,7 +360,7 @@ void test_profile::do_test(unsigned int_mode, const std::string& str_mode)
         uint64_t prev_ts = records[0].timestamp;
         int nesting      = 0;
 
-        if (!(hdr->mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+        if (!(hdr->mode & log_mask)) {
             EXPECT_EQ(0, thread_hdr->num_records);
         }
 
@@ -420,6 +426,50 @@ UCS_TEST_P(test_profile, log_accum) {
             "log,accum");
 }
 
+UCS_TEST_P(test_profile, ring) {
+    modify_config("PROFILE_SAMPLE_RATE", "1");
+    do_test(UCS_BIT(UCS_PROFILE_MODE_RING), "ring");
+}
+
+UCS_TEST_P(test_profile, ring_sampled) {
+    /* Every iteration has two top-level scopes, so only profile_test_func1
+     * is sampled, and profile_test_func2 with its nested scope is skipped */
+    modify_config("PROFILE_SAMPLE_RATE", "2");
+    do_test(UCS_BIT(UCS_PROFILE_MODE_RING), "ring", NUM_LOCAITONS - 4);
+}
+
+UCS_TEST_P(test_profile, snapshot_signal) {
+    const ucs_time_t deadline = ucs_get_time() +
+                                ucs_time_from_sec(10.0 *
+                                                  ucs::test_time_multiplier());
+    std::string data;
+
+    unlink(PROFILE_FILENAME);
+    modify_config("PROFILE_SIGNO", "SIGUSR2");
+    scoped_profile p(*this, PROFILE_FILENAME, "log");
+    run_profiled_code(1);
+
+    /* The snapshot is written by the profiling thread after the handler
+     * returns */
+    raise(SIGUSR2);
+    while (ucs_get_time() < deadline) {
+        std::ifstream f(PROFILE_FILENAME);
+        data.assign(std::istreambuf_iterator<char>(f),
+                    std::istreambuf_iterator<char>());
+        if (data.size() >= sizeof(ucs_profile_header_t)) {
+            break;
+        }
+
+        usleep(1000);
+    }
+
+    ASSERT_GE(data.size(), sizeof(ucs_profile_header_t));
+    /* coverity[tainted_data_downcast] */
+    const ucs_profile_header_t *hdr =
+            reinterpret_cast<const ucs_profile_header_t*>(&data[0]);
+    EXPECT_EQ(UCS_BIT(UCS_PROFILE_MODE_LOG), hdr->mode);
+}
+
 INSTANTIATE_TEST_SUITE_P(st, test_profile, ::testing::Values(1));
 INSTANTIATE_TEST_SUITE_P(mt, test_profile, ::testing::Values(2, 4, 8));
 
@@ -9,6 +9,7 @@
 extern "C" {
 #include <ucs/stats/stats.h>
 #include <ucs/stats/client_server.h>
+#include <ucs/vfs/base/vfs_obj.h>
 }
 
 #include <netinet/in.h>
@@ -35,6 +36,8 @@ public:
         m_data_stats_class->counter_names[2] = "counter2";
         m_data_stats_class->counter_names[3] = "counter3";
         m_data_stats_class->class_id         = UCS_STATS_CLASS_ID_INVALID;
+        m_data_stats_class->num_histograms   = 0;
+        m_data_stats_class->histogram_names  = NULL;
     }
 
     ~stats_test() {
@@ -212,6 +215,13 @@ protected:
     int m_pipefds[2];
 };
 
+class stats_text_file_test : public stats_file_test {
+public:
+    virtual std::string stats_dest_config() {
+        return "file:/dev/fd/" + ucs::to_string(m_pipefds[1]);
+    }
+};
+
 class stats_on_demand_test : public stats_udp_test {
 public:
     virtual std::string stats_trigger_config() {
@@ -382,6 +392,241 @@ UCS_TEST_F(stats_aggregate_sum_test, report) {
     free_nodes(cat_node, data_nodes);
 }
 
+static const char *hist_stats_names[] = {"lat0", "lat1"};
+
+static ucs_stats_class_t hist_stats_class = {
+    .name            = "hist",
+    .num_counters    = 0,
+    .class_id        = (unsigned)UCS_STATS_CLASS_ID_INVALID,
+    .num_histograms  = 2,
+    .histogram_names = hist_stats_names
+};
+
+static void prepare_hist_node(ucs_stats_node_t **node_p)
+{
+    ucs_status_t status = UCS_STATS_NODE_ALLOC(node_p, &hist_stats_class,
+                                               ucs_stats_get_root(), "");
+    ASSERT_UCS_OK(status);
+
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        UCS_STATS_UPDATE_HISTOGRAM(*node_p, 0, value);
+    }
+}
+
+UCS_TEST_F(stats_file_test, histogram) {
+    ucs_stats_node_t *hist_node, *root, *node;
+    ucs_stats_counter_t *buckets;
+
+    prepare_hist_node(&hist_node);
+    ucs_stats_dump();
+    UCS_STATS_NODE_FREE(hist_node);
+
+    std::string data = get_data();
+    FILE *f          = fmemopen(&data[0], data.size(), "rb");
+    ucs_status_t status = ucs_stats_deserialize(f, &root);
+    ASSERT_UCS_OK(status);
+    fclose(f);
+
+    ASSERT_EQ(1ul, ucs_list_length(&root->children[UCS_STATS_ACTIVE_CHILDREN]));
+    node = ucs_list_head(&root->children[UCS_STATS_ACTIVE_CHILDREN],
+                         ucs_stats_node_t, list);
+    ASSERT_EQ(2u, node->cls->num_histograms);
+    EXPECT_EQ(std::string("lat1"), node->cls->histogram_names[1]);
+
+    /* Values 1..1000: the reported percentile is the upper bound of the
+     * bucket which contains it */
+    buckets = ucs_stats_node_histogram(node, 0);
+    EXPECT_EQ(1000u, ucs_stats_histogram_count(buckets));
+    EXPECT_EQ(511u,  ucs_stats_histogram_percentile(buckets, 50.0));
+    EXPECT_EQ(991u,  ucs_stats_histogram_percentile(buckets, 99.0));
+    EXPECT_EQ(1023u, ucs_stats_histogram_percentile(buckets, 99.9));
+
+    buckets = ucs_stats_node_histogram(node, 1);
+    EXPECT_EQ(0u, ucs_stats_histogram_count(buckets));
+    EXPECT_EQ(0u, ucs_stats_histogram_percentile(buckets, 50.0));
+
+    ucs_stats_free(root);
+}
+
+UCS_TEST_F(stats_text_file_test, histogram) {
+    ucs_stats_node_t *hist_node;
+
+    prepare_hist_node(&hist_node);
+    ucs_stats_dump();
+    UCS_STATS_NODE_FREE(hist_node);
+
+    std::string data = get_data();
+    EXPECT_NE(std::string::npos,
+              data.find("lat0: count 1000 p50 511 p99 991 p999 1023"))
+            << data;
+    EXPECT_NE(std::string::npos, data.find("lat1: count 0 p50 0")) << data;
+}
+
+static ucs_stats_node_t *deserialize_stats(std::string &data)
+{
+    ucs_stats_node_t *root = NULL;
+    FILE *f                = fmemopen(&data[0], data.size(), "rb");
+
+    EXPECT_UCS_OK(ucs_stats_deserialize(f, &root));
+    fclose(f);
+    return root;
+}
+
+static void expect_equal_values(ucs_stats_node_t *node1, ucs_stats_node_t *node2)
+{
+    ucs_stats_node_t *child1, *child2;
+
+    ASSERT_EQ(std::string(node1->name), std::string(node2->name));
+    for (size_t i = 0; i < ucs_stats_class_num_values(node1->cls); ++i) {
+        EXPECT_EQ(node2->counters[i], node1->counters[i])
+                << node1->cls->name << node1->name << " value " << i;
+    }
+
+    child2 = ucs_list_head(&node2->children[UCS_STATS_ACTIVE_CHILDREN],
+                           ucs_stats_node_t, list);
+    ucs_list_for_each(child1, &node1->children[UCS_STATS_ACTIVE_CHILDREN],
+                      list) {
+        expect_equal_values(child1, child2);
+        child2 = ucs_list_next(&child2->list, ucs_stats_node_t, list);
+    }
+}
+
+UCS_TEST_F(stats_file_test, delta) {
+    ucs_stats_node_t *data_nodes[NUM_DATA_NODES] = {NULL};
+    ucs_stats_node_t *cat_node, *hist_node, *extra_node;
+    ucs_stats_node_t *root1, *root2, *root3;
+    char *buffer;
+    size_t size;
+    FILE *f;
+
+    prepare_nodes(&cat_node, data_nodes);
+    prepare_hist_node(&hist_node);
+    ucs_stats_dump();
+    std::string data1 = get_data();
+
+    UCS_STATS_UPDATE_COUNTER(data_nodes[3], 1, 5);
+    UCS_STATS_UPDATE_COUNTER(data_nodes[7], 2, -30);
+    UCS_STATS_UPDATE_HISTOGRAM(hist_node, 1, 12345);
+    ucs_stats_dump();
+    std::string data2 = get_data();
+
+    ASSERT_UCS_OK(UCS_STATS_NODE_ALLOC(&extra_node, m_data_stats_class,
+                                       cat_node, "-extra"));
+    ucs_stats_dump();
+    std::string data3 = get_data();
+
+    UCS_STATS_NODE_FREE(extra_node);
+    UCS_STATS_NODE_FREE(hist_node);
+    free_nodes(cat_node, data_nodes);
+
+    root1 = deserialize_stats(data1);
+    root2 = deserialize_stats(data2);
+    root3 = deserialize_stats(data3);
+    ASSERT_TRUE((root1 != NULL) && (root2 != NULL) && (root3 != NULL));
+
+    f = open_memstream(&buffer, &size);
+    ASSERT_UCS_OK(ucs_stats_serialize_delta(f, root1, root2));
+    fclose(f);
+
+    /* Only the runtime, two counters and one bucket have changed */
+    EXPECT_LT(size, 32u);
+
+    f = fmemopen(buffer, size, "rb");
+    EXPECT_UCS_OK(ucs_stats_deserialize_delta(f, root1));
+    fclose(f);
+    free(buffer);
+    expect_equal_values(root1, root2);
+
+    /* A delta can't be applied to a tree with a different layout */
+    f = open_memstream(&buffer, &size);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucs_stats_serialize_delta(f, root2, root3));
+    fclose(f);
+    free(buffer);
+
+    ucs_stats_free(root3);
+    ucs_stats_free(root2);
+    ucs_stats_free(root1);
+}
+
+class stats_vfs_test : public stats_test {
+public:
+    virtual std::string stats_dest_config() {
+        return "vfs";
+    }
+
+    virtual std::string stats_trigger_config() {
+        return "";
+    }
+
+    std::string read_file(const char *path) {
+        ucs_string_buffer_t strb;
+
+        ucs_string_buffer_init(&strb);
+        EXPECT_UCS_OK(ucs_vfs_path_read_file(path, &strb));
+        std::string result = ucs_string_buffer_cstr(&strb);
+        ucs_string_buffer_cleanup(&strb);
+        return result;
+    }
+
+    static std::string hex_decode(const std::string &hex) {
+        std::string data, digits;
+
+        for (char c : hex) {
+            if (isxdigit(c)) {
+                digits += c;
+            }
+        }
+
+        for (size_t i = 0; i + 1 < digits.size(); i += 2) {
+            data += (char)strtol(digits.substr(i, 2).c_str(), NULL, 16);
+        }
+        return data;
+    }
+};
+
+UCS_TEST_F(stats_vfs_test, read) {
+    ucs_stats_node_t *data_nodes[NUM_DATA_NODES] = {NULL};
+    ucs_stats_node_t *cat_node, *root;
+
+    prepare_nodes(&cat_node, data_nodes);
+    std::string text = read_file("/ucs/stats/all");
+    std::string data = hex_decode(read_file("/ucs/stats/binary"));
+    free_nodes(cat_node, data_nodes);
+
+    EXPECT_NE(std::string::npos, text.find("counter3: 40")) << text;
+
+    root = deserialize_stats(data);
+    ASSERT_TRUE(root != NULL);
+    check_tree(root, data_nodes);
+    ucs_stats_free(root);
+}
+
+class stats_histogram_test : public ucs::test {
+};
+
+UCS_TEST_F(stats_histogram_test, buckets) {
+    unsigned prev_bucket = 0;
+    unsigned bucket;
+    uint64_t value;
+
+    for (value = 0; value < UCS_BIT(UCS_STATS_HISTOGRAM_MAX_BITS);
+         value = (value * 9 / 8) + 1) {
+        bucket = ucs_stats_histogram_bucket(value);
+        ASSERT_LT(bucket, UCS_STATS_HISTOGRAM_NUM_BUCKETS) << value;
+        ASSERT_GE(bucket, prev_bucket) << value;
+        EXPECT_LE(ucs_stats_histogram_bucket_min(bucket), value);
+        EXPECT_GT(ucs_stats_histogram_bucket_min(bucket + 1), value);
+        /* Relative error is bounded by the number of sub-buckets */
+        EXPECT_LE(value - ucs_stats_histogram_bucket_min(bucket),
+                  value >> UCS_STATS_HISTOGRAM_SUB_BITS);
+        prev_bucket = bucket;
+    }
+
+    EXPECT_EQ(UCS_STATS_HISTOGRAM_NUM_BUCKETS - 1,
+              ucs_stats_histogram_bucket(UINT64_MAX));
+}
+
 class stats_entity_cmp_test : public ucs::test {
 public:
     static stats_entity_t create_stats_entity(uint32_t ip, uint16_t port)
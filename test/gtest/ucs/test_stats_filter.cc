@@ -31,6 +31,8 @@ public:
         m_data_stats_class->counter_names[2] = "counter2";
         m_data_stats_class->counter_names[3] = "counter3";
         m_data_stats_class->class_id         = UCS_STATS_CLASS_ID_INVALID;
+        m_data_stats_class->num_histograms   = 0;
+        m_data_stats_class->histogram_names  = NULL;
 
         cat_node = NULL;
         data_nodes[0] = data_nodes[1] = data_nodes[2] = NULL;
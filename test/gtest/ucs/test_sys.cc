@@ -1,5 +1,5 @@
 /**
-* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2019. ALL RIGHTS RESERVED.
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2001-2026. ALL RIGHTS RESERVED.
 *
 * See file LICENSE for terms.
 */
@@ -137,6 +137,61 @@ extern "C" {
 int test_module_loaded = 0;
 }
 
+static int module_manifest_collect(const char *value, void *arg)
+{
+    static_cast<std::vector<std::string>*>(arg)->push_back(value);
+    return 0;
+}
+
+UCS_TEST_F(test_sys, module_manifest) {
+    const char *tmp_dir    = getenv("TMPDIR");
+    std::string path       = std::string((tmp_dir != NULL) ? tmp_dir : "/tmp") +
+                             "/gtest_module_manifest." +
+                             ucs::to_string(getpid());
+    const char *match[]    = {"tl2", NULL};
+    const char *no_match[] = {"tl", "provides", NULL};
+    FILE *stream;
+
+    /* A module without a manifest is always loaded */
+    EXPECT_TRUE(ucs_module_manifest_provides(path.c_str(), no_match));
+
+    stream = fopen(path.c_str(), "w");
+    ASSERT_TRUE(stream != NULL);
+    fprintf(stream, "provides tl1 tl2 tl3\n");
+    fprintf(stream, "config TL_ TL1_\n");
+    fclose(stream);
+
+    EXPECT_TRUE(ucs_module_manifest_provides(path.c_str(), match));
+    EXPECT_FALSE(ucs_module_manifest_provides(path.c_str(), no_match));
+
+    std::vector<std::string> prefixes;
+    EXPECT_EQ(0, ucs_module_manifest_foreach(path.c_str(), "config",
+                                             module_manifest_collect,
+                                             &prefixes));
+    ASSERT_EQ(2u, prefixes.size());
+    EXPECT_EQ("TL_", prefixes[0]);
+    EXPECT_EQ("TL1_", prefixes[1]);
+
+    unlink(path.c_str());
+}
+
+UCS_TEST_F(test_sys, module_lazy) {
+    UCS_MODULE_FRAMEWORK_DECLARE(test);
+    const char *provides[] = {"other_tl", NULL};
+
+    /* Must run before test_sys.module, which loads the test module */
+    if (test_module_loaded != 0) {
+        UCS_TEST_SKIP_R("test module is already loaded");
+    }
+
+    UCS_MODULE_FRAMEWORK_LOAD_PROVIDERS(test, 0, provides);
+    EXPECT_EQ(0, test_module_loaded);
+
+    /* Variables of the skipped module are not reported as unused */
+    EXPECT_TRUE(ucs_module_config_is_skipped("TEST_MODULE_VAR"));
+    EXPECT_FALSE(ucs_module_config_is_skipped("TEST_VAR"));
+}
+
 UCS_TEST_F(test_sys, module) {
     UCS_MODULE_FRAMEWORK_DECLARE(test);
 
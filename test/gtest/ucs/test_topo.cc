@@ -8,7 +8,9 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <limits>
+#include <sys/stat.h>
 #include <unistd.h>
 
 extern "C" {
@@ -566,6 +568,61 @@ UCS_TEST_F(test_topo, numa_distance) {
     }
 }
 
+static void write_file(const std::string &path, const std::string &contents)
+{
+    std::ofstream file(path.c_str());
+    file << contents;
+}
+
+UCS_TEST_F(test_topo, cache_file) {
+    const char *tmp_dir = getenv("TMPDIR");
+    std::string dir     = std::string((tmp_dir != NULL) ? tmp_dir : "/tmp") +
+                          "/gtest_topo_cache.XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(&dir[0]));
+
+    std::string cache_file = dir + "/cache";
+    std::string width_file = dir + "/current_link_width";
+    std::string speed_file = dir + "/current_link_speed";
+    struct stat st_buf;
+
+    write_file(width_file, "16");
+    write_file(speed_file, "16.0 GT/s");
+
+    /* The first process probes the device and saves the cache */
+    modify_config("TOPO_CACHE_FILE", cache_file);
+    ucs_topo_cleanup();
+    ucs_topo_init();
+    double bw = ucs_topo_get_pci_bw("dev", dir.c_str());
+    EXPECT_NE(UCS_INFINITY, bw);
+    ucs_topo_cleanup();
+
+    ASSERT_EQ(0, stat(cache_file.c_str(), &st_buf));
+    EXPECT_EQ(0600, st_buf.st_mode & 0777);
+
+    /* The next process loads the value instead of reading sysfs */
+    write_file(width_file, "1");
+    ucs_topo_init();
+    EXPECT_EQ(bw, ucs_topo_get_pci_bw("dev", dir.c_str()));
+    ucs_topo_cleanup();
+
+    /* The cache is ignored after a reboot or a change of the devices */
+    write_file(cache_file, "ucx_topo_cache 1 boot_id=0 pci=0:00000000\n"
+                           "pci_bw:" + dir + " 0x1p+0\n");
+    ucs_topo_init();
+    double new_bw = ucs_topo_get_pci_bw("dev", dir.c_str());
+    EXPECT_LT(new_bw, bw);
+    EXPECT_NE(1.0, new_bw);
+    ucs_topo_cleanup();
+
+    modify_config("TOPO_CACHE_FILE", "");
+    ucs_topo_init();
+
+    unlink(cache_file.c_str());
+    unlink(width_file.c_str());
+    unlink(speed_file.c_str());
+    rmdir(dir.c_str());
+}
+
 // Scan and classify PCI devices
 void test_topo::read_pcie_devices()
 {
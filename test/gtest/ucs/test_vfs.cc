@@ -110,6 +110,24 @@ UCS_TEST_F(test_vfs_sock, send_recv_nop) {
                  &msg_out);
 }
 
+UCS_TEST_F(test_vfs_sock, send_recv_stats) {
+    ucs_vfs_sock_message_t msg_in = {}, msg_out = {};
+
+    /* request statistics of another process from socket[0] to socket[1] */
+    msg_in.action      = UCS_VFS_SOCK_ACTION_STATS;
+    msg_in.pid         = 1234;
+    msg_in.interval_ms = 250;
+    ASSERT_EQ(0, ucs_vfs_sock_send(m_sockets[0], &msg_in));
+    ASSERT_EQ(0, ucs_vfs_sock_recv(m_sockets[1], &msg_out));
+    EXPECT_EQ(UCS_VFS_SOCK_ACTION_STATS, msg_out.action);
+    EXPECT_EQ(1234, msg_out.pid);
+    EXPECT_EQ(250u, msg_out.interval_ms);
+
+    /* the next message is received intact */
+    do_send_recv(UCS_VFS_SOCK_ACTION_NOP, m_sockets[0], m_sockets[1], -1,
+                 &msg_out);
+}
+
 class test_vfs_obj : public ucs::test {
 public:
     static void file_show_cb(void *obj, ucs_string_buffer_t *strb,
@@ -1179,3 +1179,29 @@ UCS_TEST_P(test_ud_iface_attrs, iface_attrs)
 
 UCT_INSTANTIATE_UD_TEST_CASE(test_ud_iface_attrs)
 
+
+
+class test_ud_req_ack : public ucs::test {
+};
+
+UCS_TEST_F(test_ud_req_ack, psn_wraparound) {
+    const uct_ud_psn_t cwnd = 16;
+    unsigned num_req_ack    = 0;
+    uct_ud_ep_t ep;
+
+    memset(&ep, 0, sizeof(ep));
+    ep.tx.acked_psn = UINT16_MAX - 3;
+    ep.tx.max_psn   = ep.tx.acked_psn + cwnd;
+
+    /* The window [acked_psn+1, max_psn) wraps around, and an ack should be
+     * requested after 1/4 of the window and at its end */
+    for (ep.tx.psn = ep.tx.acked_psn + 1; !uct_ud_ep_no_window(&ep);
+         ++ep.tx.psn) {
+        num_req_ack += uct_ud_ep_req_ack(&ep);
+    }
+
+    EXPECT_EQ(2u, num_req_ack);
+
+    ep.tx.psn = ep.tx.acked_psn + (cwnd / 4);
+    EXPECT_TRUE(uct_ud_ep_req_ack(&ep));
+}